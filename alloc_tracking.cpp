@@ -0,0 +1,130 @@
+/**
+ * The replacements of the global operator new and delete, which count every
+ * allocation in alloc_tracking.h, then allocate by malloc, or by
+ * posix_memalign when over-aligned, in the same way as libstdc++ does.
+ *
+ * Linked into the test executables only with the cmake option
+ * DOJO_ALLOC_TRACKING; C++17 for the aligned forms.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_tracking.h"
+
+namespace {
+
+void *allocate(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (auto *const p = std::malloc(size)) {
+            dojo::alloc::detail::on_allocate(size);
+            return p;
+        }
+        auto const handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void *allocate_aligned(std::size_t size, std::align_val_t const alignment) {
+    auto const align = std::max(static_cast<std::size_t>(alignment), sizeof(void *));
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        auto *p = static_cast<void *>(nullptr);
+        if (posix_memalign(&p, align, size) == 0) {
+            dojo::alloc::detail::on_allocate(size);
+            return p;
+        }
+        auto const handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocate(void *const p) noexcept {
+    if (p != nullptr) {
+        dojo::alloc::detail::on_deallocate();
+        std::free(p);
+    }
+}
+
+}
+
+void *operator new(std::size_t const size) { return allocate(size); }
+
+void *operator new[](std::size_t const size) { return allocate(size); }
+
+void *operator new(std::size_t const size, std::nothrow_t const &) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t const size, std::nothrow_t const &) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new(std::size_t const size, std::align_val_t const alignment) {
+    return allocate_aligned(size, alignment);
+}
+
+void *operator new[](std::size_t const size, std::align_val_t const alignment) {
+    return allocate_aligned(size, alignment);
+}
+
+void *operator new(std::size_t const size, std::align_val_t const alignment, std::nothrow_t const &) noexcept {
+    try {
+        return allocate_aligned(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t const size, std::align_val_t const alignment, std::nothrow_t const &) noexcept {
+    try {
+        return allocate_aligned(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *const p) noexcept { deallocate(p); }
+
+void operator delete[](void *const p) noexcept { deallocate(p); }
+
+void operator delete(void *const p, std::size_t) noexcept { deallocate(p); }
+
+void operator delete[](void *const p, std::size_t) noexcept { deallocate(p); }
+
+void operator delete(void *const p, std::nothrow_t const &) noexcept { deallocate(p); }
+
+void operator delete[](void *const p, std::nothrow_t const &) noexcept { deallocate(p); }
+
+void operator delete(void *const p, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete[](void *const p, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete(void *const p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete[](void *const p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+
+void operator delete(void *const p, std::align_val_t, std::nothrow_t const &) noexcept { deallocate(p); }
+
+void operator delete[](void *const p, std::align_val_t, std::nothrow_t const &) noexcept { deallocate(p); }
@@ -0,0 +1,191 @@
+#ifndef CPP_XX_DOJO_ALLOC_TRACKING_H_
+#define CPP_XX_DOJO_ALLOC_TRACKING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+
+/**
+ * Counting of the heap allocations, by the global operator new and delete of
+ * alloc_tracking.cpp, which replace those of the standard library when built
+ * with the cmake option DOJO_ALLOC_TRACKING; otherwise nothing is counted, and
+ * every count below stays 0.
+ *
+ *   - every thread counts in counters of its own, which only it writes, so
+ *     counting takes neither a lock nor a read-modify-write;
+ *   - the counters are kept until the program exits, so that the total still
+ *     counts the threads which have exited, such as the workers of a pool.
+ *
+ * Only C++11, since the cases of C++11 are counted as well.
+ *
+ * reference from https://en.cppreference.com/w/cpp/memory/new/operator_new#Global_replacements
+ */
+
+namespace dojo {
+namespace alloc {
+
+#ifdef DOJO_ALLOC_TRACKING
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+struct counts {
+    std::uint64_t allocations;
+    std::uint64_t deallocations;
+    // the bytes asked for by the allocations
+    std::uint64_t bytes;
+
+    friend counts operator-(counts const &a, counts const &b) {
+        return counts{a.allocations - b.allocations, a.deallocations - b.deallocations, a.bytes - b.bytes};
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, counts const &c) {
+        return os << c.allocations << " allocations, " << c.deallocations << " deallocations, "
+                  << c.bytes << " bytes";
+    }
+};
+
+namespace detail {
+
+struct thread_counters {
+    std::atomic<std::uint64_t> allocations;
+    std::atomic<std::uint64_t> deallocations;
+    std::atomic<std::uint64_t> bytes;
+    // the counters of all the threads are linked into a list, which is only
+    // ever prepended
+    thread_counters *next;
+};
+
+inline std::atomic<thread_counters *> &all_counters() {
+    // initialized with a constant, so it's there before any allocation
+    static std::atomic<thread_counters *> head(nullptr);
+    return head;
+}
+
+inline thread_counters *&local_counters_slot() {
+    // initialized with a constant, which saves the guard on every access
+    thread_local thread_counters *counters = nullptr;
+    return counters;
+}
+
+/**
+ * The counters of the current thread, registered on first use, or nullptr if
+ * they can't be allocated. They're allocated by malloc, which operator new
+ * can't count in turn.
+ */
+inline thread_counters *find_local_counters() noexcept {
+    auto *&counters = local_counters_slot();
+    if (counters == nullptr) {
+        auto *const p = std::malloc(sizeof(thread_counters));
+        if (p == nullptr) {
+            return nullptr;
+        }
+        auto *const c = new(p) thread_counters{};
+        auto &head = all_counters();
+        c->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(c->next, c, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        counters = c;
+    }
+    return counters;
+}
+
+inline thread_counters &local_counters() {
+    auto *const counters = find_local_counters();
+    if (counters == nullptr) {
+        throw std::bad_alloc();
+    }
+    return *counters;
+}
+
+/**
+ * Only the owning thread adds, hence a plain load and store, as atomics
+ * all the same for the other threads reading.
+ */
+inline void add_owned(std::atomic<std::uint64_t> &value, std::uint64_t const n) noexcept {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void on_allocate(std::size_t const size) {
+    auto &c = local_counters();
+    add_owned(c.allocations, 1);
+    add_owned(c.bytes, size);
+}
+
+/**
+ * Called by the noexcept operator delete, hence skips the count rather than
+ * throws if the counters of a thread whose first event it is can't be
+ * registered.
+ */
+inline void on_deallocate() noexcept {
+    if (auto *const counters = find_local_counters()) {
+        add_owned(counters->deallocations, 1);
+    }
+}
+
+inline counts read(thread_counters const &c) {
+    return counts{c.allocations.load(std::memory_order_relaxed), c.deallocations.load(std::memory_order_relaxed),
+                  c.bytes.load(std::memory_order_relaxed)};
+}
+
+}
+
+/**
+ * The counts of the current thread so far.
+ */
+inline counts this_thread() {
+    return detail::read(detail::local_counters());
+}
+
+/**
+ * The counts of all the threads so far, summed on read, hence seeing the
+ * counts of the other threads eventually rather than at once.
+ */
+inline counts total() {
+    auto sum = counts{0, 0, 0};
+    for (auto const *c = detail::all_counters().load(std::memory_order_acquire); c != nullptr; c = c->next) {
+        auto const n = detail::read(*c);
+        sum.allocations += n.allocations;
+        sum.deallocations += n.deallocations;
+        sum.bytes += n.bytes;
+    }
+    return sum;
+}
+
+/**
+ * Count the allocations of the current thread from its construction on.
+ */
+class scope {
+public:
+    scope() : m_start(this_thread()) {}
+
+    counts counted() const { return this_thread() - m_start; }
+
+private:
+    counts const m_start;
+};
+
+}
+}
+
+/**
+ * Expect or assert that `statement` allocates nothing on the current thread,
+ * as EXPECT_NO_THROW does for exceptions, to lock a hot path in as free of
+ * allocations; always met unless built with DOJO_ALLOC_TRACKING.
+ */
+#define DOJO_NO_ALLOC_IMPL(statement, check) \
+    do { \
+        ::dojo::alloc::scope const dojo_alloc_scope_; \
+        statement; \
+        auto const dojo_alloc_counted_ = dojo_alloc_scope_.counted(); \
+        check(dojo_alloc_counted_.allocations, 0u) \
+                << "Expected: " #statement " allocates nothing.\n  Actual: it made " << dojo_alloc_counted_; \
+    } while (false)
+
+#define EXPECT_NO_ALLOC(statement) DOJO_NO_ALLOC_IMPL(statement, EXPECT_EQ)
+#define ASSERT_NO_ALLOC(statement) DOJO_NO_ALLOC_IMPL(statement, ASSERT_EQ)
+
+#endif //CPP_XX_DOJO_ALLOC_TRACKING_H_
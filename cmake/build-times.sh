@@ -0,0 +1,57 @@
+#!/bin/sh
+#
+# The wall time of every compilation, as a compiler launcher:
+#
+#   build-times.sh record <log> <compiler> <arguments>...
+#       run the compiler, then append its wall time in milliseconds and the
+#       object it wrote to the log;
+#   build-times.sh report <log>
+#       print the count and the total time of the compilations in the log,
+#       and the slowest of them.
+#
+# The log keeps growing over the builds, so remove it before a build to
+# measure that build alone.
+
+set -u
+
+command=$1
+log=$2
+shift 2
+
+case "$command" in
+record)
+    start=$(date +%s%N)
+    "$@"
+    status=$?
+    stop=$(date +%s%N)
+
+    object=
+    previous=
+    for argument in "$@"; do
+        if [ "$previous" = "-o" ]; then
+            object=$argument
+        fi
+        previous=$argument
+    done
+    # a single short write, which is atomic among the parallel compilations
+    echo "$(((stop - start) / 1000000)) $object" >>"$log"
+    exit $status
+    ;;
+report)
+    if [ ! -s "$log" ]; then
+        echo "nothing compiled since $log was removed"
+        exit 0
+    fi
+    sort -rn "$log" | awk '
+        { total += $1; count += 1 }
+        count <= 10 { slowest = slowest sprintf("%10d ms  %s\n", $1, $2) }
+        END {
+            printf "%d compilations, %.1f s in total\n", count, total / 1000
+            printf "the slowest:\n%s", slowest
+        }'
+    ;;
+*)
+    echo "usage: $0 record <log> <compiler> <arguments>... | report <log>" >&2
+    exit 2
+    ;;
+esac
@@ -1,6 +1,98 @@
+#include <cstring>
+#include <iostream>
+
 #include <gtest/gtest.h>
 
+#include "alloc_tracking.h"
+#include "perf_counters.h"
+#include "tracing.h"
+
+#ifdef DOJO_TRACING
+/**
+ * Record a span for every test, under which the spans of the test itself
+ * show up on the timeline.
+ */
+class TraceListener : public ::testing::EmptyTestEventListener {
+    void OnTestStart(::testing::TestInfo const &) override {
+        m_begin = dojo::trace::now_ticks();
+    }
+
+    void OnTestEnd(::testing::TestInfo const &info) override {
+        dojo::trace::local_buffer().record(
+                dojo::trace::event{info.name(), info.test_suite_name(), m_begin, dojo::trace::now_ticks()});
+    }
+
+    std::uint64_t m_begin = 0;
+};
+#endif
+
+#ifdef DOJO_ALLOC_TRACKING
+/**
+ * Report the allocations of every test, by all the threads, such as those of
+ * the pools it starts, rather than only by the thread running the test.
+ */
+class AllocListener : public ::testing::EmptyTestEventListener {
+    void OnTestStart(::testing::TestInfo const &) override {
+        m_start = dojo::alloc::total();
+    }
+
+    void OnTestEnd(::testing::TestInfo const &info) override {
+        std::cout << "[  ALLOC   ] " << info.test_suite_name() << "." << info.name() << ": "
+                  << dojo::alloc::total() - m_start << std::endl;
+    }
+
+    dojo::alloc::counts m_start{0, 0, 0};
+};
+#endif
+
+#ifdef DOJO_PERF_COUNTERS
+/**
+ * Report the counters of the cpu for every test, by the main thread and the
+ * threads it has started and joined since, and which of them can't be
+ * counted, once up front.
+ */
+class PerfListener : public ::testing::EmptyTestEventListener {
+    void OnTestProgramStart(::testing::UnitTest const &) override {
+        for (auto i = std::size_t{0}; i < dojo::perf::event_count; ++i) {
+            auto const e = static_cast<dojo::perf::event>(i);
+            if (!m_counters.available(e)) {
+                std::cout << "[  PERF    ] " << dojo::perf::name_of(e) << " not available: "
+                          << std::strerror(m_counters.error_of(e)) << std::endl;
+            }
+        }
+    }
+
+    void OnTestStart(::testing::TestInfo const &) override {
+        m_start = m_counters.read();
+    }
+
+    void OnTestEnd(::testing::TestInfo const &info) override {
+        std::cout << "[  PERF    ] " << info.test_suite_name() << "." << info.name() << ": "
+                  << m_counters.read() - m_start << std::endl;
+    }
+
+    dojo::perf::counter_group const m_counters;
+    dojo::perf::reading m_start = dojo::perf::reading();
+};
+#endif
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+#ifdef DOJO_PERF_COUNTERS
+    ::testing::UnitTest::GetInstance()->listeners().Append(new PerfListener());
+#endif
+#ifdef DOJO_ALLOC_TRACKING
+    ::testing::UnitTest::GetInstance()->listeners().Append(new AllocListener());
+#endif
+#ifdef DOJO_TRACING
+    ::testing::UnitTest::GetInstance()->listeners().Append(new TraceListener());
+    auto const result = RUN_ALL_TESTS();
+    auto const path = dojo::trace::output_path();
+    if (dojo::trace::write_chrome_trace_file(path)) {
+        std::cout << "Trace written to " << path << std::endl;
+    }
+    return result;
+#else
     return RUN_ALL_TESTS();
+#endif
 }
@@ -0,0 +1,264 @@
+#ifndef CPP_XX_DOJO_PERF_COUNTERS_H_
+#define CPP_XX_DOJO_PERF_COUNTERS_H_
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * The hardware and software counters of the cpu, read by perf_event_open, to
+ * tell why one case is faster than another where the wall-clock time only
+ * tells that it is: cycles, instructions, branch misses, cache misses and
+ * context switches.
+ *
+ *   - every counter is opened on its own rather than in a group of the
+ *     kernel, since a group is counted all or nothing, and a single counter
+ *     missing would take the others with it; the counters multiplexed on
+ *     fewer registers of the cpu are scaled by the time they've run;
+ *   - a counter which can't be opened, when perf_event_paranoid forbids it,
+ *     in a virtual machine without a PMU, or in a container which filters
+ *     the syscall, reads as not available rather than failing the program;
+ *   - the counters are inherited by the threads the opening thread starts
+ *     afterwards, whose counts are included once they're read.
+ *
+ * Only C++11, since the cases of C++11 are counted as well.
+ *
+ * reference from https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+ */
+
+namespace dojo {
+namespace perf {
+
+enum class event : std::size_t {
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_read_misses,
+    llc_misses,
+    context_switches,
+};
+
+constexpr std::size_t event_count = 6;
+
+inline char const *name_of(event const e) {
+    static char const *const names[event_count] = {
+            "cycles", "instructions", "branch misses", "L1d read misses", "LLC misses", "context switches",
+    };
+    return names[static_cast<std::size_t>(e)];
+}
+
+/**
+ * The counts of all the events at one time, or between two times when
+ * subtracted.
+ */
+struct reading {
+    std::uint64_t values[event_count];
+    bool available[event_count];
+
+    std::uint64_t operator[](event const e) const { return values[static_cast<std::size_t>(e)]; }
+
+    bool has(event const e) const { return available[static_cast<std::size_t>(e)]; }
+
+    friend reading operator-(reading const &a, reading const &b) {
+        auto r = reading();
+        for (auto i = std::size_t{0}; i < event_count; ++i) {
+            r.values[i] = a.values[i] - b.values[i];
+            r.available[i] = a.available[i] && b.available[i];
+        }
+        return r;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, reading const &r) {
+        return r.write(os);
+    }
+
+    /**
+     * Write the counts divided by `per`, such as the operations of a
+     * benchmark, with the instructions per cycle after the instructions.
+     */
+    std::ostream &write(std::ostream &os, double const per = 1) const {
+        auto const flags = os.flags();
+        auto const precision = os.precision();
+        os << std::fixed << std::setprecision(per == 1 ? 0 : 2);
+        for (auto i = std::size_t{0}; i < event_count; ++i) {
+            auto const e = static_cast<event>(i);
+            os << (i == 0 ? "" : ", ") << name_of(e) << ' ';
+            if (!available[i]) {
+                os << "n/a";
+                continue;
+            }
+            os << static_cast<double>(values[i]) / per;
+            if (e == event::instructions && has(event::cycles) && (*this)[event::cycles] != 0) {
+                os << std::setprecision(2) << " (IPC " << static_cast<double>((*this)[event::instructions])
+                                                          / static_cast<double>((*this)[event::cycles]) << ")"
+                   << std::setprecision(per == 1 ? 0 : 2);
+            }
+        }
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+};
+
+namespace detail {
+
+struct event_spec {
+    std::uint32_t type;
+    std::uint64_t config;
+    // whether to count in the user space only, when not allowed to count in
+    // the kernel as well, which says nothing of a context switch
+    bool user_only_fallback;
+};
+
+inline event_spec spec_of(event const e) {
+#ifdef __linux__
+    static event_spec const specs[event_count] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, true},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), true},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, true},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false},
+    };
+    return specs[static_cast<std::size_t>(e)];
+#else
+    return event_spec{0, 0, false};
+#endif
+}
+
+/**
+ * Open the counter of `e` for the calling thread on any cpu, or return -1
+ * with the errno set.
+ */
+inline int open_counter(event const e) {
+#ifdef __linux__
+    auto const spec = spec_of(e);
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    auto fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0 && (errno == EACCES || errno == EPERM) && spec.user_only_fallback) {
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+    return fd;
+#else
+    static_cast<void>(e);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * Read the counter of `fd`, scaled up by the time it's been enabled over the
+ * time it's run, or return false when it hasn't run at all.
+ */
+inline bool read_counter(int const fd, std::uint64_t &value) {
+#ifdef __linux__
+    std::uint64_t data[3];  // value, time enabled, time running
+    if (::read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+        return false;
+    }
+    auto const enabled = data[1];
+    auto const running = data[2];
+    if (running == 0) {
+        // never scheduled on the cpu, which is only a count of 0 if it has
+        // never been enabled either
+        value = 0;
+        return enabled == 0;
+    }
+    value = running < enabled
+            ? static_cast<std::uint64_t>(static_cast<double>(data[0]) * static_cast<double>(enabled)
+                                         / static_cast<double>(running))
+            : data[0];
+    return true;
+#else
+    static_cast<void>(fd);
+    static_cast<void>(value);
+    return false;
+#endif
+}
+
+inline void close_counter(int const fd) {
+#ifdef __linux__
+    ::close(fd);
+#else
+    static_cast<void>(fd);
+#endif
+}
+
+}
+
+/**
+ * The counters of all the events for the calling thread, and the threads it
+ * starts afterwards, counting from the construction on.
+ */
+class counter_group {
+public:
+    counter_group() {
+        for (auto i = std::size_t{0}; i < event_count; ++i) {
+            m_fds[i] = detail::open_counter(static_cast<event>(i));
+            m_errors[i] = m_fds[i] < 0 ? errno : 0;
+        }
+    }
+
+    counter_group(counter_group &&other) noexcept {
+        for (auto i = std::size_t{0}; i < event_count; ++i) {
+            m_fds[i] = other.m_fds[i];
+            m_errors[i] = other.m_errors[i];
+            other.m_fds[i] = -1;
+        }
+    }
+
+    counter_group(counter_group const &) = delete;
+    counter_group &operator=(counter_group const &) = delete;
+    counter_group &operator=(counter_group &&) = delete;
+
+    ~counter_group() {
+        for (auto const fd: m_fds) {
+            if (fd >= 0) {
+                detail::close_counter(fd);
+            }
+        }
+    }
+
+    bool available(event const e) const { return m_fds[static_cast<std::size_t>(e)] >= 0; }
+
+    /**
+     * The errno of opening the counter of `e`, or 0 if it's open.
+     */
+    int error_of(event const e) const { return m_errors[static_cast<std::size_t>(e)]; }
+
+    reading read() const {
+        auto r = reading();
+        for (auto i = std::size_t{0}; i < event_count; ++i) {
+            r.values[i] = 0;
+            r.available[i] = m_fds[i] >= 0 && detail::read_counter(m_fds[i], r.values[i]);
+        }
+        return r;
+    }
+
+private:
+    int m_fds[event_count];
+    int m_errors[event_count];
+};
+
+}
+}
+
+#endif //CPP_XX_DOJO_PERF_COUNTERS_H_
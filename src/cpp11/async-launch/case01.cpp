@@ -19,6 +19,7 @@
 TEST(TestAsyncLaunch, test_async) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " <<  __PRETTY_FUNCTION__ << " ..." << std::endl;
 
+    DOJO_TRACE_INSTANT("async");
     auto result = std::async(std::launch::async, []() {
         fake_costly_computing(3);
         return 10;
@@ -26,6 +27,7 @@ TEST(TestAsyncLaunch, test_async) { // NOLINT(cert-err58-cpp)
 
     std::cout << "Do other things..." << std::endl;
     std::this_thread::sleep_for(std::chrono::seconds(4));
+    DOJO_TRACE_SPAN("future.get");
     std::cout << "Got the result: " << result.get() << std::endl;
 }
 
@@ -43,5 +45,7 @@ TEST(TestAsyncLaunch, test_defered) { // NOLINT(cert-err58-cpp)
 
     std::cout << "Do other things..." << std::endl;
     std::this_thread::sleep_for(std::chrono::seconds(4));
+    // the computing runs in this span, on this thread
+    DOJO_TRACE_SPAN("future.get");
     std::cout << "Got the result: " << result.get() << std::endl;
 }
\ No newline at end of file
@@ -29,9 +29,13 @@ TEST(TestPackagedTask, test_func_task) { // NOLINT(cert-err58-cpp)
     std::packaged_task<int(int, std::string)> task(computing);
     auto fut = task.get_future();
 
+    DOJO_TRACE_INSTANT("spawn");
     std::thread td(std::move(task), 10, "20");
 
-    std::cout << "waiting ... " << std::endl << fut.get() << std::endl;
+    {
+        DOJO_TRACE_SPAN("future.get");
+        std::cout << "waiting ... " << std::endl << fut.get() << std::endl;
+    }
 
     td.join();
 }
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../../../perf_counters.h"
+#include "../../../utils.h"
+
+/**
+ * The counters of the cpu of perf_counters.h, used directly here, so that the
+ * tests work whether the option DOJO_PERF_COUNTERS is on or not, and whether
+ * the counters can be opened on this machine or not.
+ */
+
+static void sleep_times(int const times) {
+    for (auto i = 0; i < times; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * Every counter is either open or tells why not, and those not open read and
+ * print as not available, without failing the others.
+ */
+TEST(TestPerfCounters, test_degrade_gracefully) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const counters = dojo::perf::counter_group();
+    sleep_times(1);
+    auto const reading = counters.read();
+    std::cout << "  " << reading << std::endl;
+
+    auto os = std::ostringstream();
+    os << reading;
+    auto const printed = os.str();
+    for (auto i = std::size_t{0}; i < dojo::perf::event_count; ++i) {
+        auto const e = static_cast<dojo::perf::event>(i);
+        auto const field = std::string(dojo::perf::name_of(e)) + " n/a";
+        if (counters.available(e)) {
+            ASSERT_EQ(counters.error_of(e), 0);
+        } else {
+            std::cout << "  " << dojo::perf::name_of(e) << ": " << std::strerror(counters.error_of(e)) << std::endl;
+            ASSERT_NE(counters.error_of(e), 0);
+            ASSERT_FALSE(reading.has(e));
+        }
+        ASSERT_EQ(printed.find(field) == std::string::npos, reading.has(e));
+    }
+}
+
+TEST(TestPerfCounters, test_count_instructions) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const counters = dojo::perf::counter_group();
+    if (!counters.available(dojo::perf::event::instructions)) {
+        GTEST_SKIP() << "instructions can't be counted on this machine";
+    }
+
+    auto const before = counters.read();
+    for (auto i = std::uint64_t{0}; i < 1000000; ++i) {
+        do_not_optimize(i);
+    }
+    auto const counted = counters.read() - before;
+    std::cout << "  " << counted << std::endl;
+    // at least an increment and a branch per iteration
+    ASSERT_GE(counted[dojo::perf::event::instructions], 2000000u);
+}
+
+/**
+ * The threads started after the counters are opened are counted with the
+ * thread opening them.
+ */
+TEST(TestPerfCounters, test_count_started_threads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const counters = dojo::perf::counter_group();
+    if (!counters.available(dojo::perf::event::context_switches)) {
+        GTEST_SKIP() << "context switches can't be counted on this machine";
+    }
+
+    auto const before = counters.read();
+    std::thread(sleep_times, 10).join();
+    auto const counted = counters.read() - before;
+    std::cout << "  " << counted << std::endl;
+    // every sleep switches out of the thread
+    ASSERT_GE(counted[dojo::perf::event::context_switches], 10u);
+}
@@ -40,10 +40,16 @@ TEST(TestPromiseFuture, test_promise) { // NOLINT(cert-err58-cpp)
     auto future = promise.get_future();
     auto worker_thread = std::thread([](std::promise<int> p) {
         fake_costly_computing();
+        DOJO_TRACE_INSTANT("set_value");
         p.set_value(10);
     }, std::move(promise));
 
-    std::cout << "waiting ..." << std::endl << future.get() << std::endl;
+    {
+        // the gap between set_value and the end of this span is the latency
+        // of waking up the waiting thread
+        DOJO_TRACE_SPAN("future.get");
+        std::cout << "waiting ..." << std::endl << future.get() << std::endl;
+    }
 
     worker_thread.join();
 }
@@ -61,10 +67,14 @@ TEST(TestPromiseFuture, test_promise_set_at_thread_exit) { // NOLINT(cert-err58-
     auto future = promise.get_future();
     auto worker_thread = std::thread([](std::promise<int> p) {
         fake_costly_computing();
+        DOJO_TRACE_INSTANT("set_value_at_thread_exit");
         p.set_value_at_thread_exit(10);
     }, std::move(promise));
 
-    std::cout << "waiting ..." << std::endl << future.get() << std::endl;
+    {
+        DOJO_TRACE_SPAN("future.get");
+        std::cout << "waiting ..." << std::endl << future.get() << std::endl;
+    }
 
     worker_thread.join();
 }
@@ -81,7 +91,10 @@ TEST(TestPromiseFuture, test_promise_wait) { // NOLINT(cert-err58-cpp)
 
     std::cout << "waiting " << std::endl;
     // wait() will block the current thread until set_value in working thread
-    future.wait();
+    {
+        DOJO_TRACE_SPAN("future.wait");
+        future.wait();
+    }
     std::cout << "get the value - " << future.get() << std::endl;
 
     worker_thread.join();
@@ -23,7 +23,9 @@ void goo(int const val) {
  */
 TEST(TestThread, test_join_by_function) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " <<  __PRETTY_FUNCTION__ << " ..." << std::endl;
+    DOJO_TRACE_INSTANT("spawn");
     auto th = std::thread(foo);
+    DOJO_TRACE_SPAN("join");
     th.join();  // this will cause the current thread blocked until thread th finished
 }
 
@@ -60,9 +62,12 @@ TEST(TestThread, test_by_function_with_arguments) { // NOLINT(cert-err58-cpp)
 
 TEST(TestThread, test_by_lambda) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " <<  __PRETTY_FUNCTION__ << " ..." << std::endl;
+    DOJO_TRACE_INSTANT("spawn");
     auto th = std::thread([]() {
+        DOJO_TRACE_INSTANT("started");
         std::cout << "You have called a lambda!" << std::endl;
         fake_costly_computing();
     });
+    DOJO_TRACE_SPAN("join");
     th.join();
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../../../tracing.h"
+#include "../../../utils.h"
+
+/**
+ * The tracer of tracing.h records scoped spans into per-thread buffers, and
+ * exports them as a Chrome trace. Here the tracer is used directly, so that
+ * the tests work whether the option DOJO_TRACING is on or not.
+ */
+
+static std::string export_trace() {
+    auto os = std::ostringstream();
+    dojo::trace::write_chrome_trace(os);
+    return os.str();
+}
+
+static std::size_t count_of(std::string const &text, std::string const &pattern) {
+    auto count = std::size_t{0};
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+TEST(TestTracer, test_scoped_span) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    {
+        dojo::trace::scoped_span const span("test_scoped_span.outer");
+        dojo::trace::record_instant("test_scoped_span.instant");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto const trace = export_trace();
+    ASSERT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    ASSERT_EQ(count_of(trace, "{\"name\":\"test_scoped_span.outer\",\"cat\":\"dojo\",\"ph\":\"X\""), 1u);
+    ASSERT_EQ(count_of(trace, "{\"name\":\"test_scoped_span.instant\",\"cat\":\"dojo\",\"ph\":\"i\""), 1u);
+}
+
+/**
+ * The spans of a thread stay in its buffer after the thread has exited, and
+ * show up on a timeline of their own.
+ */
+TEST(TestTracer, test_spans_of_exited_threads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const main_tid = dojo::trace::local_buffer().tid();
+    auto worker_tid = std::uint32_t{0};
+    auto worker = std::thread([&worker_tid] {
+        dojo::trace::scoped_span const span("test_spans_of_exited_threads.worker");
+        worker_tid = dojo::trace::local_buffer().tid();
+    });
+    worker.join();
+    ASSERT_NE(worker_tid, main_tid);
+
+    auto const trace = export_trace();
+    auto const pos = trace.find("test_spans_of_exited_threads.worker");
+    ASSERT_NE(pos, std::string::npos);
+    auto const tid = "\"tid\":" + std::to_string(worker_tid) + "}";
+    ASSERT_EQ(trace.find(tid, pos), trace.find('}', pos) - tid.size() + 1);
+}
+
+/**
+ * A buffer grows by chunks, which are published to the exporter one by one.
+ */
+TEST(TestTracer, test_many_spans) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const count = dojo::trace::thread_buffer::chunk_capacity * 3 + 1;
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        dojo::trace::scoped_span const span("test_many_spans");
+    }
+    ASSERT_EQ(count_of(export_trace(), "\"test_many_spans\""), count);
+}
+
+/**
+ * The cost of a span is mostly reading the time stamp counter twice, which
+ * takes a few nanoseconds on bare metal, but may be several times slower in a
+ * virtual machine.
+ */
+TEST(TestTracerBenchmark, test_span_cost) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const count = std::size_t{200000};
+    benchmark("dojo::trace::scoped_span", count, [count] {
+        for (auto i = std::size_t{0}; i < count; ++i) {
+            dojo::trace::scoped_span const span("test_span_cost");
+        }
+    });
+    benchmark("dojo::trace::record_instant", count, [count] {
+        for (auto i = std::size_t{0}; i < count; ++i) {
+            dojo::trace::record_instant("test_span_cost.instant");
+        }
+    });
+}
@@ -0,0 +1,308 @@
+#ifndef CPP_XX_DOJO_AGGREGATE_HASH_H
+#define CPP_XX_DOJO_AGGREGATE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../aggregate-reflection/aggregate_reflection.h"
+
+/**
+ * A hash and an equality for the aggregates and the tuples, generated from
+ * their fields instead of being written out by hand.
+ *
+ * The bytes are hashed by wyhash, whose mixing step is a 64 x 64 -> 128-bit
+ * multiplication folded by xor, which passes SMHasher while being one of the
+ * fastest hashes of the small keys. The fields are fed to it as follows:
+ *   - what has a unique object representation, i.e. whose equal values have
+ *     equal bytes and which has no padding, e.g. the integers, the enums and
+ *     the structs of them without holes, is hashed as its bytes;
+ *   - the adjacent fields of that kind are merged into one run of bytes, and
+ *     hashed at once, as long as there's no padding between them;
+ *   - a float or a double is hashed as its bytes, except that -0.0 is hashed
+ *     as 0.0, which it's equal to;
+ *   - a contiguous range, e.g. std::string or std::vector, is hashed as its
+ *     elements, in bulk if they are bytes as above;
+ *   - a std::pair, a std::tuple or an aggregate is hashed field by field;
+ *   - anything else is hashed by its std::hash.
+ * Each piece is hashed with the hash so far as the seed, and its length is
+ * mixed in, so ("ab", "c") and ("a", "bc") hash differently.
+ *
+ * The equality compares the same way, byte-wise where the hash is byte-wise,
+ * hence the two always agree.
+ *
+ * reference from https://github.com/wangyi-fudan/wyhash
+ */
+
+namespace dojo {
+
+namespace detail {
+
+inline constexpr std::uint64_t wyp[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+};
+
+inline void wymum(std::uint64_t &a, std::uint64_t &b) {
+    auto const product = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<std::uint64_t>(product);
+    b = static_cast<std::uint64_t>(product >> 64);
+}
+
+inline std::uint64_t wymix(std::uint64_t a, std::uint64_t b) {
+    wymum(a, b);
+    return a ^ b;
+}
+
+inline std::uint64_t wyr8(unsigned char const *const p) {
+    auto v = std::uint64_t();
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t wyr4(unsigned char const *const p) {
+    auto v = std::uint32_t();
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t wyr3(unsigned char const *const p, std::size_t const k) {
+    return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[k >> 1]} << 8) | p[k - 1];
+}
+
+}
+
+/**
+ * wyhash of the bytes.
+ */
+inline std::uint64_t hash_bytes(void const *const data, std::size_t const size, std::uint64_t seed = 0) {
+    using detail::wymix;
+    using detail::wyp;
+    using detail::wyr4;
+    using detail::wyr8;
+
+    auto const *p = static_cast<unsigned char const *>(data);
+    seed ^= wymix(seed ^ wyp[0], wyp[1]);
+    auto a = std::uint64_t(), b = std::uint64_t();
+    if (size <= 16) {
+        if (size >= 4) {
+            a = (wyr4(p) << 32) | wyr4(p + ((size >> 3) << 2));
+            b = (wyr4(p + size - 4) << 32) | wyr4(p + size - 4 - ((size >> 3) << 2));
+        } else if (size > 0) {
+            a = detail::wyr3(p, size);
+        }
+    } else {
+        auto i = size;
+        if (i > 48) {
+            auto see1 = seed, see2 = seed;
+            do {
+                seed = wymix(wyr8(p) ^ wyp[1], wyr8(p + 8) ^ seed);
+                see1 = wymix(wyr8(p + 16) ^ wyp[2], wyr8(p + 24) ^ see1);
+                see2 = wymix(wyr8(p + 32) ^ wyp[3], wyr8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wymix(wyr8(p) ^ wyp[1], wyr8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wyr8(p + i - 16);
+        b = wyr8(p + i - 8);
+    }
+    a ^= wyp[1];
+    b ^= seed;
+    detail::wymum(a, b);
+    return wymix(a ^ wyp[0] ^ size, b ^ wyp[1]);
+}
+
+namespace detail {
+
+template<typename T, typename = void>
+struct is_contiguous_range : std::false_type {};
+
+template<typename T>
+struct is_contiguous_range<T, std::void_t<decltype(std::data(std::declval<T const &>())),
+        decltype(std::size(std::declval<T const &>()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct is_tuple_like : std::false_type {};
+
+template<typename T>
+struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type {};
+
+template<typename T, typename = void>
+struct has_std_hash : std::false_type {};
+
+template<typename T>
+struct has_std_hash<T, std::void_t<decltype(std::hash<T>{}(std::declval<T const &>()))>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_hashed_as_bytes = std::has_unique_object_representations_v<T>;
+
+template<typename T>
+constexpr bool always_false = false;
+
+template<typename T>
+std::uint64_t hash_value(T const &value, std::uint64_t seed);
+
+/**
+ * Feed the fields one by one, merging the adjacent ones which are hashed as
+ * bytes. Whether two fields are adjacent only depends on the layout of the
+ * type, so the equal values always merge the same way; and with the
+ * addresses known to be offsets of the same object, the checks are folded
+ * away by the optimizer.
+ */
+class run_hasher {
+public:
+    explicit run_hasher(std::uint64_t const seed) : m_seed(seed) {}
+
+    template<typename T>
+    void add(T const &field) {
+        if constexpr (is_hashed_as_bytes<T>) {
+            auto const *const p = reinterpret_cast<unsigned char const *>(std::addressof(field));
+            if (p != m_end) {
+                flush();
+                m_begin = p;
+            }
+            m_end = p + sizeof(T);
+        } else {
+            flush();
+            m_seed = hash_value(field, m_seed);
+        }
+    }
+
+    std::uint64_t finish() {
+        flush();
+        return m_seed;
+    }
+
+private:
+    void flush() {
+        if (m_begin != m_end) {
+            m_seed = hash_bytes(m_begin, static_cast<std::size_t>(m_end - m_begin), m_seed);
+        }
+        m_begin = m_end = nullptr;
+    }
+
+    unsigned char const *m_begin = nullptr;
+    unsigned char const *m_end = nullptr;
+    std::uint64_t m_seed;
+};
+
+template<typename T>
+std::uint64_t hash_value(T const &value, std::uint64_t const seed) {
+    if constexpr (is_hashed_as_bytes<T>) {
+        return hash_bytes(std::addressof(value), sizeof(T), seed);
+    } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        // -0.0 == 0.0, whereas a NaN is equal to nothing, hence hashed as it is
+        auto const normalized = value == 0 ? T(0) : value;
+        return hash_bytes(&normalized, sizeof(T), seed);
+    } else if constexpr (is_contiguous_range<T>::value) {
+        using element = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(value))>>;
+        auto const size = std::size(value);
+        if constexpr (is_hashed_as_bytes<element>) {
+            return hash_bytes(std::data(value), size * sizeof(element), seed);
+        } else {
+            auto h = seed;
+            for (auto const *p = std::data(value), *end = p + size; p != end; ++p) {
+                h = hash_value(*p, h);
+            }
+            return hash_bytes(&size, sizeof(size), h);
+        }
+    } else if constexpr (is_tuple_like<T>::value) {
+        auto hasher = run_hasher(seed);
+        std::apply([&hasher](auto const &...elements) {
+            (hasher.add(elements), ...);
+        }, value);
+        return hasher.finish();
+    } else if constexpr (reflect::is_reflectable_v<T>) {
+        auto hasher = run_hasher(seed);
+        reflect::for_each_field(value, [&hasher](auto const &field) {
+            hasher.add(field);
+        });
+        return hasher.finish();
+    } else if constexpr (has_std_hash<T>::value) {
+        return wymix(seed ^ wyp[0], static_cast<std::uint64_t>(std::hash<T>{}(value)) ^ wyp[1]);
+    } else {
+        static_assert(always_false<T>, "neither bytes, a range, a tuple, an aggregate nor std::hash-able");
+    }
+}
+
+}
+
+/**
+ * Whether the two are equal field by field, see the note of the file.
+ */
+template<typename T>
+bool equal(T const &a, T const &b) {
+    if constexpr (detail::is_hashed_as_bytes<T>) {
+        return std::memcmp(std::addressof(a), std::addressof(b), sizeof(T)) == 0;
+    } else if constexpr (detail::is_contiguous_range<T>::value) {
+        using element = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(a))>>;
+        auto const size = std::size(a);
+        if (size != std::size(b)) {
+            return false;
+        }
+        if constexpr (detail::is_hashed_as_bytes<element>) {
+            return size == 0 || std::memcmp(std::data(a), std::data(b), size * sizeof(element)) == 0;
+        } else {
+            for (auto i = std::size_t{0}; i < size; ++i) {
+                if (!equal(std::data(a)[i], std::data(b)[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } else if constexpr (detail::is_tuple_like<T>::value) {
+        return std::apply([&b](auto const &...x) {
+            return std::apply([&x...](auto const &...y) {
+                return (equal(x, y) && ...);
+            }, b);
+        }, a);
+    } else if constexpr (reflect::is_reflectable_v<T>) {
+        return reflect::apply_fields(a, [&b](auto const &...x) {
+            return reflect::apply_fields(b, [&x...](auto const &...y) {
+                return (equal(x, y) && ...);
+            });
+        });
+    } else {
+        return a == b;
+    }
+}
+
+/**
+ * A hash of the aggregates and the tuples, to be used in place of std::hash,
+ * which can't be specialized for all the aggregates at once:
+ *
+ *     std::unordered_set<point, dojo::hash<point>, dojo::equal_to<point>>
+ */
+template<typename T>
+struct hash {
+    std::size_t operator()(T const &value) const {
+        return static_cast<std::size_t>(detail::hash_value(value, 0));
+    }
+};
+
+template<typename T>
+struct equal_to {
+    bool operator()(T const &a, T const &b) const {
+        return equal(a, b);
+    }
+};
+
+template<typename T>
+std::uint64_t hash_value(T const &value, std::uint64_t const seed = 0) {
+    return detail::hash_value(value, seed);
+}
+
+}
+
+#endif //CPP_XX_DOJO_AGGREGATE_HASH_H
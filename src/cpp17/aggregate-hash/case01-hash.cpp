@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "aggregate_hash.h"
+
+/**
+ * The hash and the equality of the aggregates and the tuples, generated from
+ * their fields, so that they can be the keys of the unordered containers
+ * without a hand-written std::hash.
+ *
+ * reference from https://en.cppreference.com/w/cpp/types/has_unique_object_representations
+ */
+
+namespace {
+
+struct point {
+    std::int32_t x;
+    std::int32_t y;
+};
+
+// the same fields as S of the tie case
+struct S {
+    int n;
+    std::string s;
+    float d;
+};
+
+// 7 bytes of padding after the tag
+struct tagged {
+    char tag;
+    std::int64_t value;
+};
+
+struct record {
+    std::uint32_t id;
+    std::uint32_t version;
+    double score;
+    std::string name;
+    std::vector<point> path;
+    std::int64_t rank;
+};
+
+}
+
+TEST(TestAggregateHash, test_equal_values_equal_hashes) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const h = dojo::hash<S>();
+    ASSERT_EQ(h(S{1, "one", 1.0f}), h(S{1, "one", 1.0f}));
+    ASSERT_NE(h(S{1, "one", 1.0f}), h(S{2, "one", 1.0f}));
+    ASSERT_NE(h(S{1, "one", 1.0f}), h(S{1, "two", 1.0f}));
+
+    // -0.0 is equal to 0.0, though their bytes differ
+    ASSERT_TRUE(dojo::equal(S{1, "", -0.0f}, S{1, "", 0.0f}));
+    ASSERT_EQ(h(S{1, "", -0.0f}), h(S{1, "", 0.0f}));
+
+    // the lengths are mixed in, so the characters can't move across strings
+    using pair = std::pair<std::string, std::string>;
+    ASSERT_NE(dojo::hash<pair>()(pair{"ab", "c"}), dojo::hash<pair>()(pair{"a", "bc"}));
+}
+
+TEST(TestAggregateHash, test_padding_is_ignored) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    static_assert(!std::has_unique_object_representations_v<tagged>);
+
+    // the same fields, with different garbage in the padding
+    alignas(tagged) unsigned char a_bytes[sizeof(tagged)];
+    alignas(tagged) unsigned char b_bytes[sizeof(tagged)];
+    std::memset(a_bytes, 0xaa, sizeof(a_bytes));
+    std::memset(b_bytes, 0x55, sizeof(b_bytes));
+    auto *const a = new(a_bytes) tagged;
+    auto *const b = new(b_bytes) tagged;
+    a->tag = b->tag = 'x';
+    a->value = b->value = 42;
+
+    ASSERT_TRUE(dojo::equal(*a, *b));
+    ASSERT_EQ(dojo::hash<tagged>()(*a), dojo::hash<tagged>()(*b));
+}
+
+TEST(TestAggregateHash, test_merged_runs) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // without any hole, the whole struct is hashed as one run of bytes
+    static_assert(std::has_unique_object_representations_v<point>);
+    auto const p = point{3, 4};
+    ASSERT_EQ(dojo::hash_value(p), dojo::hash_bytes(&p, sizeof(p)));
+
+    // so are the adjacent fields of a struct with holes elsewhere: the id and
+    // the version are one run of 8 bytes, before the double
+    auto const r = record{1, 2, 0.5, "r", {{1, 2}}, 7};
+    auto const expected = [&r] {
+        auto h = dojo::hash_bytes(&r.id, sizeof(r.id) + sizeof(r.version));
+        h = dojo::hash_value(r.score, h);
+        h = dojo::hash_value(r.name, h);
+        h = dojo::hash_value(r.path, h);
+        return dojo::hash_value(r.rank, h);
+    }();
+    ASSERT_EQ(dojo::hash_value(r), expected);
+}
+
+TEST(TestAggregateHash, test_tuples) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    using key = std::tuple<int, std::string, point>;
+    auto const h = dojo::hash<key>();
+    ASSERT_EQ(h(key{1, "a", {2, 3}}), h(key{1, "a", {2, 3}}));
+    ASSERT_NE(h(key{1, "a", {2, 3}}), h(key{1, "a", {3, 2}}));
+    ASSERT_TRUE(dojo::equal(key{1, "a", {2, 3}}, key{1, "a", {2, 3}}));
+    ASSERT_FALSE(dojo::equal(key{1, "a", {2, 3}}, key{1, "b", {2, 3}}));
+}
+
+TEST(TestAggregateHash, test_unordered_containers) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto points = std::unordered_set<point, dojo::hash<point>, dojo::equal_to<point>>();
+    for (auto x = 0; x < 32; ++x) {
+        for (auto y = 0; y < 32; ++y) {
+            points.insert(point{x, y});
+        }
+    }
+    points.insert(point{0, 0});
+    ASSERT_EQ(points.size(), 32u * 32u);
+    ASSERT_EQ(points.count(point{31, 31}), 1u);
+    ASSERT_EQ(points.count(point{32, 0}), 0u);
+
+    auto records = std::unordered_map<record, int, dojo::hash<record>, dojo::equal_to<record>>();
+    records[record{1, 1, 0.5, "a", {}, 3}] = 1;
+    records[record{1, 1, 0.5, "a", {}, 3}] += 1;
+    records[record{1, 1, 0.5, "a", {{0, 0}}, 3}] = 1;
+    ASSERT_EQ(records.size(), 2u);
+    ASSERT_EQ((records[record{1, 1, 0.5, "a", {}, 3}]), 2);
+}
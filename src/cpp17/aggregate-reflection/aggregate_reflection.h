@@ -0,0 +1,180 @@
+#ifndef CPP_XX_DOJO_AGGREGATE_REFLECTION_H
+#define CPP_XX_DOJO_AGGREGATE_REFLECTION_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * The fields of an aggregate, counted and visited at compile time without any
+ * macro or registration, the same way as boost.pfr does:
+ *   - the count is the most initializers `T{...}` takes, each of them being
+ *     an object convertible to any type;
+ *   - the fields are visited by binding that many names to the aggregate with
+ *     a structured binding, whose declarations are spelled out for each count
+ *     up to max_fields.
+ *
+ * Only the aggregates which a structured binding can decompose, i.e. without
+ * base classes, and whose fields are neither C arrays, which brace elision
+ * counts element by element, nor types constructible from anything, e.g.
+ * std::optional or std::any, which make the probing initializer ambiguous.
+ * Use std::array for the arrays; the other cases fail to compile rather than
+ * miscount, as the structured binding then declares the wrong number of names.
+ *
+ * reference from https://www.boost.org/doc/libs/release/doc/html/boost_pfr/how_it_works.html
+ */
+
+namespace dojo::reflect {
+
+constexpr auto max_fields = std::size_t{16};
+
+namespace detail {
+
+/**
+ * Converts to anything, only ever named in unevaluated operands.
+ */
+template<std::size_t I>
+struct any_field {
+    template<typename U>
+    constexpr operator U() const noexcept;  // NOLINT(google-explicit-constructor)
+};
+
+template<typename T, typename Indices, typename = void>
+struct is_brace_constructible : std::false_type {};
+
+template<typename T, std::size_t... I>
+struct is_brace_constructible<T, std::index_sequence<I...>, std::void_t<decltype(T{any_field<I>{}...})>> :
+        std::true_type {};
+
+template<typename T, std::size_t N = 0>
+constexpr std::size_t count_fields() {
+    if constexpr (N <= max_fields && is_brace_constructible<T, std::make_index_sequence<N + 1>>::value) {
+        return count_fields<T, N + 1>();
+    } else {
+        return N;
+    }
+}
+
+template<typename T>
+using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+}
+
+template<typename T>
+constexpr bool is_reflectable_v = std::is_aggregate_v<T> && !std::is_array_v<T>;
+
+template<typename T>
+constexpr std::size_t field_count_v = [] {
+    static_assert(is_reflectable_v<T>, "only an aggregate has its fields reflected");
+    constexpr auto count = detail::count_fields<T>();
+    static_assert(count <= max_fields, "more fields than the structured bindings are spelled out for");
+    return count;
+}();
+
+/**
+ * Call `fn` with every field of the aggregate, in the order of declaration,
+ * as lvalues as const as the aggregate itself, and return what it returns.
+ */
+template<typename T, typename Fn>
+constexpr decltype(auto) apply_fields(T &&aggregate, Fn &&fn) {
+    constexpr auto count = field_count_v<detail::remove_cvref_t<T>>;
+    if constexpr (count == 0) {
+        return std::forward<Fn>(fn)();
+    } else if constexpr (count == 1) {
+        auto &&[f0] = aggregate;
+        return std::forward<Fn>(fn)(f0);
+    } else if constexpr (count == 2) {
+        auto &&[f0, f1] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1);
+    } else if constexpr (count == 3) {
+        auto &&[f0, f1, f2] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2);
+    } else if constexpr (count == 4) {
+        auto &&[f0, f1, f2, f3] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3);
+    } else if constexpr (count == 5) {
+        auto &&[f0, f1, f2, f3, f4] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4);
+    } else if constexpr (count == 6) {
+        auto &&[f0, f1, f2, f3, f4, f5] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5);
+    } else if constexpr (count == 7) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6);
+    } else if constexpr (count == 8) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7);
+    } else if constexpr (count == 9) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+    } else if constexpr (count == 10) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+    } else if constexpr (count == 11) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+    } else if constexpr (count == 12) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+    } else if constexpr (count == 13) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+    } else if constexpr (count == 14) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+    } else if constexpr (count == 15) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+    } else if constexpr (count == 16) {
+        auto &&[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = aggregate;
+        return std::forward<Fn>(fn)(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+    } else {
+        static_assert(count <= max_fields);
+    }
+}
+
+/**
+ * Call `fn` with every field of the aggregate, one by one.
+ */
+template<typename T, typename Fn>
+constexpr void for_each_field(T &&aggregate, Fn &&fn) {
+    apply_fields(aggregate, [&fn](auto &...fields) {
+        (fn(fields), ...);
+    });
+}
+
+/**
+ * The I-th field of the aggregate, as an lvalue.
+ */
+template<std::size_t I, typename T>
+constexpr auto &get_field(T &aggregate) {
+    return std::get<I>(apply_fields(aggregate, [](auto &...fields) {
+        return std::tie(fields...);
+    }));
+}
+
+namespace detail {
+
+// only called in unevaluated operands
+template<typename T>
+auto field_types(T &aggregate) {
+    return apply_fields(aggregate, [](auto &...fields) {
+        return static_cast<std::tuple<remove_cvref_t<decltype(fields)>...> *>(nullptr);
+    });
+}
+
+}
+
+/**
+ * The types of the fields, as a std::tuple.
+ */
+template<typename T>
+using field_types_t = std::remove_pointer_t<decltype(detail::field_types(std::declval<T &>()))>;
+
+template<std::size_t I, typename T>
+using field_t = std::tuple_element_t<I, field_types_t<T>>;
+
+}
+
+#endif //CPP_XX_DOJO_AGGREGATE_REFLECTION_H
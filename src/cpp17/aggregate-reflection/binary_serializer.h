@@ -0,0 +1,569 @@
+#ifndef CPP_XX_DOJO_BINARY_SERIALIZER_H
+#define CPP_XX_DOJO_BINARY_SERIALIZER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aggregate_reflection.h"
+
+/**
+ * A binary serializer of the aggregates, with the fields found by
+ * aggregate_reflection.h instead of being written out by hand.
+ *
+ * The format is the fields one after another, without any tag or padding:
+ *   - an arithmetic or an enum is its bytes in the byte order of the machine,
+ *     except a bool, which is a byte of 0 or 1;
+ *   - a std::string or a std::vector is its size as a std::uint64_t, followed
+ *     by its elements;
+ *   - a std::array or an aggregate is its elements or fields.
+ * So it's for the machines of the same byte order, e.g. the cache or the ipc
+ * among the hosts of a cluster, not for files kept across platforms.
+ *
+ * What's "packed", i.e. trivially copyable and without any padding, has the
+ * same bytes in memory as on the wire, hence is copied with a single memcpy,
+ * which matters for the vectors of them: a std::vector of packed structs is
+ * one memcpy of all its elements, rather than a loop over their fields.
+ *
+ * The reads come in two flavours:
+ *   - deserialize<T>, which copies out a T;
+ *   - deserialize_view<T>, which copies nothing but the packed values, and
+ *     gives a std::string_view for each string, and an array_view for each
+ *     vector of packed elements, both pointing into the input, which must
+ *     outlive them. The aggregates which are not packed become tuples of the
+ *     views of their fields, to be taken apart by a structured binding.
+ * A truncated or an oversized input, or a bool of neither 0 nor 1, throws a
+ * decode_error rather than reading out of bounds or making up a value.
+ */
+
+namespace dojo::serial {
+
+class decode_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+template<typename T>
+struct is_vector : std::false_type {};
+
+template<typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template<typename T>
+struct is_array : std::false_type {};
+
+template<typename T, std::size_t N>
+struct is_array<std::array<T, N>> : std::true_type {};
+
+template<typename T>
+constexpr bool always_false = false;
+
+template<typename Tuple>
+struct all_packed;
+
+template<typename T>
+constexpr bool is_packed();
+
+template<typename... Ts>
+struct all_packed<std::tuple<Ts...>> {
+    static constexpr bool value = (is_packed<Ts>() && ...);
+    static constexpr std::size_t size = (std::size_t{0} + ... + sizeof(Ts));
+};
+
+template<typename T>
+constexpr bool is_packed() {
+    // a bool of any byte but 0 and 1 is undefined, hence checked on read
+    if constexpr (std::is_same_v<T, bool>) {
+        return false;
+    } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return true;
+    } else if constexpr (is_array<T>::value) {
+        using element = typename T::value_type;
+        return is_packed<element>() && sizeof(T) == std::tuple_size_v<T> * sizeof(element);
+    } else if constexpr (std::is_trivially_copyable_v<T> && reflect::is_reflectable_v<T>) {
+        using fields = all_packed<reflect::field_types_t<T>>;
+        // the fields of the packed types take up the whole struct, hence no padding
+        return fields::value && fields::size == sizeof(T);
+    } else {
+        return false;
+    }
+}
+
+template<typename Tuple>
+struct min_encoded_size_of_fields;
+
+/**
+ * The fewest bytes a T is serialized into, against which a forged count of
+ * elements is checked before anything is allocated for them.
+ */
+template<typename T>
+constexpr std::size_t min_encoded_size() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return 1;
+    } else if constexpr (is_packed<T>()) {
+        return sizeof(T);
+    } else if constexpr (std::is_same_v<T, std::string> || is_vector<T>::value) {
+        return sizeof(std::uint64_t);
+    } else if constexpr (is_array<T>::value) {
+        return std::tuple_size_v<T> * min_encoded_size<typename T::value_type>();
+    } else if constexpr (reflect::is_reflectable_v<T>) {
+        return min_encoded_size_of_fields<reflect::field_types_t<T>>::value;
+    } else {
+        return 0;
+    }
+}
+
+template<typename... Ts>
+struct min_encoded_size_of_fields<std::tuple<Ts...>> {
+    static constexpr std::size_t value = (std::size_t{0} + ... + min_encoded_size<Ts>());
+};
+
+template<typename T>
+struct is_packed_vector : std::false_type {};
+
+template<typename T, typename A>
+struct is_packed_vector<std::vector<T, A>> : std::bool_constant<is_packed<T>()> {};
+
+}
+
+/**
+ * Whether a T is its own serialized form.
+ */
+template<typename T>
+constexpr bool is_packed_v = detail::is_packed<T>();
+
+/**
+ * A read-only view of the packed elements in a byte buffer.
+ *
+ * The elements are copied out on access instead of being referenced, since
+ * the buffer is not necessarily aligned for them, and they are not objects
+ * of the buffer anyway. The copy of a small element is a plain, unaligned
+ * load on x86-64 and aarch64.
+ */
+template<typename T>
+class array_view {
+    static_assert(is_packed_v<T>);
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        const_iterator() = default;
+
+        explicit const_iterator(std::byte const *const p) : m_p(p) {}
+
+        T operator*() const { return load(m_p); }
+
+        const_iterator &operator++() {
+            m_p += sizeof(T);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto const old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const_iterator const &other) const { return m_p == other.m_p; }
+
+        bool operator!=(const_iterator const &other) const { return m_p != other.m_p; }
+
+    private:
+        std::byte const *m_p = nullptr;
+    };
+
+    array_view() = default;
+
+    array_view(std::byte const *const data, std::size_t const size) : m_data(data), m_size(size) {}
+
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    [[nodiscard]] std::size_t size_bytes() const { return m_size * sizeof(T); }
+
+    [[nodiscard]] std::byte const *bytes() const { return m_data; }
+
+    T operator[](std::size_t const i) const { return load(m_data + i * sizeof(T)); }
+
+    [[nodiscard]] const_iterator begin() const { return const_iterator(m_data); }
+
+    [[nodiscard]] const_iterator end() const { return const_iterator(m_data + size_bytes()); }
+
+    /**
+     * Copy all the elements at once, which is a single memcpy.
+     */
+    void copy_to(T *const out) const {
+        if (m_size != 0) {
+            std::memcpy(out, m_data, size_bytes());
+        }
+    }
+
+    [[nodiscard]] std::vector<T> to_vector() const {
+        auto v = std::vector<T>(m_size);
+        copy_to(v.data());
+        return v;
+    }
+
+private:
+    static T load(std::byte const *const p) {
+        auto value = T();
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+
+    std::byte const *m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+namespace detail {
+
+template<typename T, typename = void>
+struct view_of;
+
+template<typename Tuple>
+struct views_of_fields;
+
+template<typename... Ts>
+struct views_of_fields<std::tuple<Ts...>> {
+    using type = std::tuple<typename view_of<Ts>::type...>;
+};
+
+template<typename T, typename>
+struct view_of {
+    static_assert(always_false<T>, "neither packed nor a string, a vector, an array or an aggregate");
+};
+
+template<typename T>
+struct view_of<T, std::enable_if_t<is_packed_v<T>>> {
+    using type = T;
+};
+
+template<>
+struct view_of<bool> {
+    using type = bool;
+};
+
+template<>
+struct view_of<std::string> {
+    using type = std::string_view;
+};
+
+template<typename T, typename A>
+struct view_of<std::vector<T, A>> {
+    using type = std::conditional_t<is_packed_v<T>, array_view<T>, std::vector<typename view_of<T>::type>>;
+};
+
+template<typename T, std::size_t N>
+struct view_of<std::array<T, N>, std::enable_if_t<!is_packed_v<std::array<T, N>>>> {
+    using type = std::array<typename view_of<T>::type, N>;
+};
+
+template<typename T>
+struct view_of<T, std::enable_if_t<!is_packed_v<T> && !is_array<T>::value && reflect::is_reflectable_v<T>>> {
+    using type = typename views_of_fields<reflect::field_types_t<T>>::type;
+};
+
+}
+
+/**
+ * What deserialize_view<T> gives.
+ */
+template<typename T>
+using view_t = typename detail::view_of<T>::type;
+
+/**
+ * The size in bytes of the serialized value.
+ */
+template<typename T>
+std::size_t serialized_size(T const &value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return 1;
+    } else if constexpr (is_packed_v<T>) {
+        return sizeof(T);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return sizeof(std::uint64_t) + value.size();
+    } else if constexpr (detail::is_packed_vector<T>::value) {
+        return sizeof(std::uint64_t) + value.size() * sizeof(typename T::value_type);
+    } else if constexpr (detail::is_vector<T>::value || detail::is_array<T>::value) {
+        auto size = detail::is_vector<T>::value ? sizeof(std::uint64_t) : 0;
+        for (auto const &element: value) {
+            size += serialized_size(element);
+        }
+        return size;
+    } else if constexpr (reflect::is_reflectable_v<T>) {
+        return reflect::apply_fields(value, [](auto const &...fields) {
+            return (std::size_t{0} + ... + serialized_size(fields));
+        });
+    } else {
+        static_assert(detail::always_false<T>, "neither packed nor a string, a vector, an array or an aggregate");
+    }
+}
+
+namespace detail {
+
+inline std::byte *write_bytes(std::byte *const out, void const *const data, std::size_t const size) {
+    if (size != 0) {
+        std::memcpy(out, data, size);
+    }
+    return out + size;
+}
+
+inline std::byte *write_size(std::byte *const out, std::size_t const size) {
+    auto const wire = static_cast<std::uint64_t>(size);
+    return write_bytes(out, &wire, sizeof(wire));
+}
+
+}
+
+/**
+ * Serialize the value into `out`, which has room for at least
+ * serialized_size(value) bytes, and return the end of what's written.
+ */
+template<typename T>
+std::byte *serialize_to(T const &value, std::byte *out) {
+    if constexpr (std::is_same_v<T, bool>) {
+        *out = value ? std::byte{1} : std::byte{0};
+        return out + 1;
+    } else if constexpr (is_packed_v<T>) {
+        // a constant size, which compiles to plain moves for the small ones
+        return detail::write_bytes(out, &value, sizeof(T));
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        out = detail::write_size(out, value.size());
+        return detail::write_bytes(out, value.data(), value.size());
+    } else if constexpr (detail::is_packed_vector<T>::value) {
+        out = detail::write_size(out, value.size());
+        return detail::write_bytes(out, value.data(), value.size() * sizeof(typename T::value_type));
+    } else if constexpr (detail::is_vector<T>::value || detail::is_array<T>::value) {
+        if constexpr (detail::is_vector<T>::value) {
+            out = detail::write_size(out, value.size());
+        }
+        for (auto const &element: value) {
+            out = serialize_to(element, out);
+        }
+        return out;
+    } else if constexpr (reflect::is_reflectable_v<T>) {
+        reflect::for_each_field(value, [&out](auto const &field) {
+            out = serialize_to(field, out);
+        });
+        return out;
+    } else {
+        static_assert(detail::always_false<T>, "neither packed nor a string, a vector, an array or an aggregate");
+    }
+}
+
+template<typename T>
+std::vector<std::byte> serialize(T const &value) {
+    auto bytes = std::vector<std::byte>(serialized_size(value));
+    serialize_to(value, bytes.data());
+    return bytes;
+}
+
+/**
+ * A cursor over the input, which never reads past its end.
+ */
+class reader {
+public:
+    reader(std::byte const *const data, std::size_t const size) : m_cur(data), m_end(data + size) {}
+
+    [[nodiscard]] std::size_t remaining() const { return static_cast<std::size_t>(m_end - m_cur); }
+
+    /**
+     * Take the next `count` elements of `element_size` bytes each.
+     */
+    std::byte const *take(std::size_t const count, std::size_t const element_size = 1) {
+        // against a forged size, whose bytes would overflow
+        if (count > remaining() / element_size) {
+            throw decode_error("truncated input");
+        }
+        auto const *const p = m_cur;
+        m_cur += count * element_size;
+        return p;
+    }
+
+    /**
+     * Take the size of a string or a vector of `E`, which is checked against
+     * the bytes its elements take at least.
+     */
+    template<typename E>
+    std::size_t take_size() {
+        auto wire = std::uint64_t();
+        std::memcpy(&wire, take(sizeof(wire)), sizeof(wire));
+        constexpr auto min_size = detail::min_encoded_size<E>();
+        // the elements of no bytes, such as the empty aggregates, take none
+        // of the input, so only more than a vector can hold are refused
+        auto const max_count = min_size == 0
+                               ? static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(E)
+                               : remaining() / min_size;
+        if (wire > max_count) {
+            throw decode_error("truncated input");
+        }
+        return static_cast<std::size_t>(wire);
+    }
+
+    /**
+     * Read a copy of the next T.
+     */
+    template<typename T>
+    T read() {
+        if constexpr (std::is_same_v<T, bool>) {
+            auto const byte = *take(1);
+            if (byte != std::byte{0} && byte != std::byte{1}) {
+                throw decode_error("bool of neither 0 nor 1");
+            }
+            return byte == std::byte{1};
+        } else if constexpr (is_packed_v<T>) {
+            auto value = T();
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            auto const size = take_size<char>();
+            return std::string(reinterpret_cast<char const *>(take(size)), size);
+        } else if constexpr (detail::is_vector<T>::value) {
+            using element = typename T::value_type;
+            auto const size = take_size<element>();
+            auto v = T();
+            if constexpr (is_packed_v<element>) {
+                v.resize(size);
+                std::memcpy(v.data(), take(size, sizeof(element)), size * sizeof(element));
+            } else {
+                v.reserve(size);
+                for (auto i = std::size_t{0}; i < size; ++i) {
+                    v.push_back(read<element>());
+                }
+            }
+            return v;
+        } else if constexpr (detail::is_array<T>::value) {
+            return read_elements<T, typename T::value_type>(std::make_index_sequence<std::tuple_size_v<T>>());
+        } else if constexpr (reflect::is_reflectable_v<T>) {
+            return read_fields<T>(std::make_index_sequence<reflect::field_count_v<T>>());
+        } else {
+            static_assert(detail::always_false<T>, "neither packed nor a string, a vector, an array or an aggregate");
+        }
+    }
+
+    /**
+     * Read a view of the next T, see view_t.
+     */
+    template<typename T>
+    view_t<T> read_view() {
+        if constexpr (std::is_same_v<T, bool> || is_packed_v<T>) {
+            return read<T>();
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            auto const size = take_size<char>();
+            return std::string_view(reinterpret_cast<char const *>(take(size)), size);
+        } else if constexpr (detail::is_vector<T>::value) {
+            using element = typename T::value_type;
+            auto const size = take_size<element>();
+            if constexpr (is_packed_v<element>) {
+                return array_view<element>(take(size, sizeof(element)), size);
+            } else {
+                auto v = view_t<T>();
+                v.reserve(size);
+                for (auto i = std::size_t{0}; i < size; ++i) {
+                    v.push_back(read_view<element>());
+                }
+                return v;
+            }
+        } else if constexpr (detail::is_array<T>::value) {
+            return read_element_views<T, typename T::value_type>(std::make_index_sequence<std::tuple_size_v<T>>());
+        } else {
+            return read_field_views<T>(std::make_index_sequence<reflect::field_count_v<T>>());
+        }
+    }
+
+private:
+    // the initializers of a braced list are evaluated in order, unlike the
+    // arguments of a call
+
+    template<typename T, typename E, std::size_t... I>
+    T read_elements(std::index_sequence<I...>) {
+        return T{(static_cast<void>(I), read<E>())...};
+    }
+
+    template<typename T, std::size_t... I>
+    T read_fields(std::index_sequence<I...>) {
+        return T{read<reflect::field_t<I, T>>()...};
+    }
+
+    template<typename T, typename E, std::size_t... I>
+    view_t<T> read_element_views(std::index_sequence<I...>) {
+        return view_t<T>{(static_cast<void>(I), read_view<E>())...};
+    }
+
+    template<typename T, std::size_t... I>
+    view_t<T> read_field_views(std::index_sequence<I...>) {
+        return view_t<T>{read_view<reflect::field_t<I, T>>()...};
+    }
+
+    std::byte const *m_cur;
+    std::byte const *m_end;
+};
+
+namespace detail {
+
+inline void expect_end(reader const &r) {
+    if (r.remaining() != 0) {
+        throw decode_error("trailing bytes after the value");
+    }
+}
+
+}
+
+template<typename T>
+T deserialize(std::byte const *const data, std::size_t const size) {
+    auto r = reader(data, size);
+    auto value = r.read<T>();
+    detail::expect_end(r);
+    return value;
+}
+
+template<typename T>
+T deserialize(std::vector<std::byte> const &bytes) {
+    return deserialize<T>(bytes.data(), bytes.size());
+}
+
+/**
+ * Read a view of the T, which points into the input.
+ */
+template<typename T>
+view_t<T> deserialize_view(std::byte const *const data, std::size_t const size) {
+    auto r = reader(data, size);
+    auto view = r.read_view<T>();
+    detail::expect_end(r);
+    return view;
+}
+
+template<typename T>
+view_t<T> deserialize_view(std::vector<std::byte> const &bytes) {
+    return deserialize_view<T>(bytes.data(), bytes.size());
+}
+
+// the views would dangle at once
+template<typename T>
+view_t<T> deserialize_view(std::vector<std::byte> &&bytes) = delete;
+
+}
+
+#endif //CPP_XX_DOJO_BINARY_SERIALIZER_H
@@ -0,0 +1,96 @@
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "aggregate_reflection.h"
+
+/**
+ * The fields of an aggregate, counted and visited without naming any of them,
+ * on top of the structured bindings of C++17.
+ *
+ * reference from https://en.cppreference.com/w/cpp/language/structured_binding
+ * reference from https://en.cppreference.com/w/cpp/language/aggregate_initialization
+ */
+
+namespace {
+
+struct empty {
+};
+
+struct point {
+    int x;
+    int y;
+};
+
+struct person {
+    std::string name;
+    std::uint8_t age;
+    std::vector<std::string> emails;
+    point home;
+    std::array<double, 3> scores;
+};
+
+}
+
+TEST(TestAggregateReflection, test_field_count) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    static_assert(dojo::reflect::field_count_v<empty> == 0);
+    static_assert(dojo::reflect::field_count_v<point> == 2);
+
+    // neither the nested aggregate nor the std::array is counted element by
+    // element, as they are initialized by a whole, converted initializer
+    static_assert(dojo::reflect::field_count_v<person> == 5);
+
+    // not an aggregate, for it has a user-provided constructor
+    static_assert(!dojo::reflect::is_reflectable_v<std::string>);
+}
+
+TEST(TestAggregateReflection, test_field_types) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    ASSERT_TRUE((std::is_same_v<dojo::reflect::field_types_t<point>, std::tuple<int, int>>));
+    ASSERT_TRUE((std::is_same_v<dojo::reflect::field_t<2, person>, std::vector<std::string>>));
+    ASSERT_TRUE((std::is_same_v<dojo::reflect::field_t<3, person>, point>));
+}
+
+TEST(TestAggregateReflection, test_visit_fields) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto p = person{"Alice", 30, {"alice@example.com"}, {1, 2}, {0.5, 1.0, 1.5}};
+
+    auto count = 0;
+    dojo::reflect::for_each_field(p, [&count](auto const &) { ++count; });
+    ASSERT_EQ(count, 5);
+
+    // the fields are bound to the aggregate, not copied
+    dojo::reflect::get_field<0>(p) = "Bob";
+    dojo::reflect::get_field<3>(p).x = 7;
+    ASSERT_EQ(p.name, "Bob");
+    ASSERT_EQ(p.home.x, 7);
+
+    auto const sum = dojo::reflect::apply_fields(p.home, [](int const x, int const y) { return x + y; });
+    ASSERT_EQ(sum, 9);
+}
+
+TEST(TestAggregateReflection, test_const_aggregate) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const p = point{3, 4};
+
+    // the fields are as const as the aggregate
+    dojo::reflect::apply_fields(p, [](auto &x, auto &y) {
+        ASSERT_TRUE((std::is_same_v<decltype(x), int const &>));
+        ASSERT_TRUE((std::is_same_v<decltype(y), int const &>));
+    });
+
+    // and usable in constant expressions
+    constexpr auto q = point{5, 6};
+    static_assert(dojo::reflect::apply_fields(q, [](int x, int y) { return x * y; }) == 30);
+}
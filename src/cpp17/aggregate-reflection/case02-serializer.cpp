@@ -0,0 +1,185 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "binary_serializer.h"
+
+/**
+ * A binary serializer driven by the reflected fields, where the packed
+ * values are copied in bulk and the reads can be views into the input.
+ */
+
+namespace {
+
+enum class order_side : std::uint8_t {
+    buy, sell
+};
+
+// 8 + 8 + 4 + 2 + 1 + 1 bytes, no padding
+struct tick {
+    std::uint64_t time;
+    double price;
+    std::int32_t quantity;
+    std::int16_t venue;
+    order_side side;
+    std::uint8_t flags;
+};
+
+// 7 bytes of padding after the flag
+struct padded {
+    bool flag;
+    double value;
+};
+
+struct nothing {
+};
+
+struct heartbeats {
+    std::vector<nothing> beats;
+};
+
+struct order_book {
+    std::string symbol;
+    std::vector<tick> ticks;
+    std::vector<std::string> tags;
+    std::array<padded, 2> limits;
+};
+
+std::vector<tick> make_ticks(std::size_t const n) {
+    auto ticks = std::vector<tick>();
+    for (auto i = std::size_t{0}; i < n; ++i) {
+        ticks.push_back(tick{i, 100.0 + static_cast<double>(i) / 8, static_cast<std::int32_t>(i * 10),
+                             static_cast<std::int16_t>(i % 4), i % 2 ? order_side::sell : order_side::buy, 0});
+    }
+    return ticks;
+}
+
+bool operator==(tick const &a, tick const &b) {
+    return std::memcmp(&a, &b, sizeof(tick)) == 0;
+}
+
+}
+
+TEST(TestBinarySerializer, test_packed) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    static_assert(dojo::serial::is_packed_v<double>);
+    // a bool may only be 0 or 1, which a memcpy doesn't check
+    static_assert(!dojo::serial::is_packed_v<bool>);
+    static_assert(dojo::serial::is_packed_v<order_side>);
+    static_assert(dojo::serial::is_packed_v<tick>);
+    static_assert(dojo::serial::is_packed_v<std::array<tick, 4>>);
+
+    // the padding would leak the uninitialized bytes, and differ from run to run
+    static_assert(!dojo::serial::is_packed_v<padded>);
+    static_assert(!dojo::serial::is_packed_v<order_book>);
+
+    // a packed struct is written as it is in memory
+    auto const t = make_ticks(2)[1];
+    auto const bytes = dojo::serial::serialize(t);
+    ASSERT_EQ(bytes.size(), sizeof(tick));
+    ASSERT_EQ(std::memcmp(bytes.data(), &t, sizeof(tick)), 0);
+
+    // whereas a padded one is written field by field, without the padding
+    ASSERT_EQ(dojo::serial::serialize(padded{true, 1.5}).size(), 1 + sizeof(double));
+}
+
+TEST(TestBinarySerializer, test_round_trip) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const book = order_book{"ACME", make_ticks(100), {"equity", "nasdaq"}, {{{true, 1.0}, {false, -1.0}}}};
+    auto const bytes = dojo::serial::serialize(book);
+    ASSERT_EQ(bytes.size(), dojo::serial::serialized_size(book));
+    ASSERT_EQ(bytes.size(), (8 + 4) + (8 + 100 * sizeof(tick)) + (8 + 8 + 6 + 8 + 6) + 2 * (1 + 8));
+
+    auto const copy = dojo::serial::deserialize<order_book>(bytes);
+    ASSERT_EQ(copy.symbol, book.symbol);
+    ASSERT_EQ(copy.ticks, book.ticks);
+    ASSERT_EQ(copy.tags, book.tags);
+    ASSERT_EQ(copy.limits[0].flag, true);
+    ASSERT_EQ(copy.limits[1].value, -1.0);
+
+    // the empty aggregates take no bytes, however many there are
+    auto const beats = dojo::serial::serialize(heartbeats{std::vector<nothing>(3)});
+    ASSERT_EQ(beats.size(), sizeof(std::uint64_t));
+    ASSERT_EQ(dojo::serial::deserialize<heartbeats>(beats).beats.size(), 3u);
+    ASSERT_EQ(std::get<0>(dojo::serial::deserialize_view<heartbeats>(beats)).size(), 3u);
+}
+
+TEST(TestBinarySerializer, test_view) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const book = order_book{"ACME", make_ticks(100), {"equity", "nasdaq"}, {}};
+    auto const bytes = dojo::serial::serialize(book);
+
+    // an aggregate which is not packed is viewed as a tuple of the views of
+    // its fields
+    auto const [symbol, ticks, tags, limits] = dojo::serial::deserialize_view<order_book>(bytes);
+    ASSERT_TRUE((std::is_same_v<decltype(symbol), std::string_view const>));
+    ASSERT_TRUE((std::is_same_v<decltype(ticks), dojo::serial::array_view<tick> const>));
+    ASSERT_TRUE((std::is_same_v<decltype(tags), std::vector<std::string_view> const>));
+    ASSERT_TRUE((std::is_same_v<decltype(limits), std::array<std::tuple<bool, double>, 2> const>));
+
+    // nothing is copied but the packed values
+    auto const *const begin = bytes.data();
+    auto const *const end = bytes.data() + bytes.size();
+    auto const *const s = reinterpret_cast<std::byte const *>(symbol.data());
+    ASSERT_TRUE(begin <= s && s < end);
+    ASSERT_TRUE(begin <= ticks.bytes() && ticks.bytes() < end);
+
+    ASSERT_EQ(symbol, "ACME");
+    ASSERT_EQ(ticks.size(), 100u);
+    ASSERT_EQ(ticks[42], book.ticks[42]);
+    ASSERT_EQ(ticks.to_vector(), book.ticks);
+    ASSERT_EQ(tags[1], "nasdaq");
+
+    auto quantity = std::int64_t{0};
+    for (auto const t: ticks) {
+        quantity += t.quantity;
+    }
+    ASSERT_EQ(quantity, 10 * 99 * 100 / 2);
+}
+
+TEST(TestBinarySerializer, test_malformed_input) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const book = order_book{"ACME", make_ticks(3), {"equity"}, {}};
+    auto bytes = dojo::serial::serialize(book);
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    ASSERT_THROW(dojo::serial::deserialize<order_book>(truncated), dojo::serial::decode_error);
+    ASSERT_THROW(dojo::serial::deserialize_view<order_book>(truncated), dojo::serial::decode_error);
+
+    auto trailing = bytes;
+    trailing.push_back(std::byte{0});
+    ASSERT_THROW(dojo::serial::deserialize<order_book>(trailing), dojo::serial::decode_error);
+
+    // a forged bool, which must be 0 or 1, at the flag of the first limit
+    auto forged_bool = dojo::serial::serialize(order_book{"ACME", {}, {}, {{{true, 1.0}, {false, -1.0}}}});
+    auto const flag_offset = (8 + 4) + 8 + 8;
+    ASSERT_EQ(forged_bool[flag_offset], std::byte{1});
+    forged_bool[flag_offset] = std::byte{2};
+    ASSERT_THROW(dojo::serial::deserialize<order_book>(forged_bool), dojo::serial::decode_error);
+    ASSERT_THROW(dojo::serial::deserialize_view<order_book>(forged_bool), dojo::serial::decode_error);
+
+    // a forged count of the ticks, more than the bytes left could hold
+    auto forged_count = bytes;
+    auto const too_many = std::uint64_t{(forged_count.size() - (8 + 4 + 8)) / sizeof(tick) + 1};
+    std::memcpy(forged_count.data() + 8 + 4, &too_many, sizeof(too_many));
+    ASSERT_THROW(dojo::serial::deserialize<order_book>(forged_count), dojo::serial::decode_error);
+
+    // a forged size of the symbol, which would overflow a naive bounds check
+    auto const forged = ~std::uint64_t{0};
+    std::memcpy(bytes.data(), &forged, sizeof(forged));
+    ASSERT_THROW(dojo::serial::deserialize<order_book>(bytes), dojo::serial::decode_error);
+}
@@ -0,0 +1,159 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "binary_serializer.h"
+#include "../../../utils.h"
+
+/**
+ * The throughput of the reflected serializer against a hand-written one, the
+ * bulk copy of the packed structs against the copy field by field, and the
+ * views against the copies when reading.
+ *
+ * The ops are bytes, so the Mops/s read as MB/s.
+ */
+
+namespace {
+
+struct tick {
+    std::uint64_t time;
+    double price;
+    std::int32_t quantity;
+    std::int32_t venue;
+};
+
+// the same fields, but not packed, so it's written field by field
+struct padded_tick {
+    std::uint64_t time;
+    double price;
+    std::int32_t quantity;
+    std::int16_t venue;
+};
+
+struct order {
+    std::uint64_t id;
+    std::string symbol;
+    std::string account;
+    double price;
+    std::int64_t quantity;
+    std::vector<std::string> tags;
+};
+
+template<typename Tick>
+std::vector<Tick> make_ticks(std::size_t const n) {
+    auto ticks = std::vector<Tick>(n);
+    for (auto i = std::size_t{0}; i < n; ++i) {
+        ticks[i].time = i;
+        ticks[i].price = 100.0 + static_cast<double>(i % 1000) / 8;
+        ticks[i].quantity = static_cast<std::int32_t>(i % 97);
+        ticks[i].venue = static_cast<decltype(ticks[i].venue)>(i % 4);
+    }
+    return ticks;
+}
+
+std::vector<order> make_orders(std::size_t const n) {
+    auto orders = std::vector<order>(n);
+    for (auto i = std::size_t{0}; i < n; ++i) {
+        orders[i] = order{i, i % 2 ? "ACME" : "INITECH", "account-" + std::to_string(i % 100),
+                          100.0 + static_cast<double>(i % 1000) / 8, static_cast<std::int64_t>(i % 97),
+                          {"equity", i % 3 ? "nasdaq" : "nyse"}};
+    }
+    return orders;
+}
+
+/**
+ * What would otherwise be written for every struct.
+ */
+std::byte *hand_written_serialize_to(std::vector<order> const &orders, std::byte *out) {
+    auto const put = [&out](void const *const data, std::size_t const size) {
+        std::memcpy(out, data, size);
+        out += size;
+    };
+    auto const put_string = [&put](std::string const &s) {
+        auto const size = static_cast<std::uint64_t>(s.size());
+        put(&size, sizeof(size));
+        put(s.data(), s.size());
+    };
+    auto const count = static_cast<std::uint64_t>(orders.size());
+    put(&count, sizeof(count));
+    for (auto const &o: orders) {
+        put(&o.id, sizeof(o.id));
+        put_string(o.symbol);
+        put_string(o.account);
+        put(&o.price, sizeof(o.price));
+        put(&o.quantity, sizeof(o.quantity));
+        auto const tags = static_cast<std::uint64_t>(o.tags.size());
+        put(&tags, sizeof(tags));
+        for (auto const &tag: o.tags) {
+            put_string(tag);
+        }
+    }
+    return out;
+}
+
+}
+
+TEST(TestBinarySerializerBenchmark, test_bulk_copy) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto n = std::size_t{1} << 20;
+    static_assert(dojo::serial::is_packed_v<tick>);
+    static_assert(!dojo::serial::is_packed_v<padded_tick>);
+
+    auto const ticks = make_ticks<tick>(n);
+    auto const padded_ticks = make_ticks<padded_tick>(n);
+    auto buffer = std::vector<std::byte>(dojo::serial::serialized_size(ticks));
+
+    benchmark("serialize packed ticks, bulk memcpy", buffer.size(), [&] {
+        do_not_optimize(dojo::serial::serialize_to(ticks, buffer.data()));
+    });
+    benchmark("serialize padded ticks, field by field", dojo::serial::serialized_size(padded_ticks), [&] {
+        do_not_optimize(dojo::serial::serialize_to(padded_ticks, buffer.data()));
+    });
+
+    auto const bytes = dojo::serial::serialize(ticks);
+    benchmark("deserialize packed ticks, copy", bytes.size(), [&] {
+        do_not_optimize(dojo::serial::deserialize<std::vector<tick>>(bytes).back());
+    });
+    benchmark("deserialize packed ticks, view and sum", bytes.size(), [&] {
+        auto const view = dojo::serial::deserialize_view<std::vector<tick>>(bytes);
+        auto quantity = std::int64_t{0};
+        for (auto const t: view) {
+            quantity += t.quantity;
+        }
+        do_not_optimize(quantity);
+    });
+}
+
+TEST(TestBinarySerializerBenchmark, test_records) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto n = std::size_t{1} << 17;
+    auto const orders = make_orders(n);
+    auto const size = dojo::serial::serialized_size(orders);
+    auto buffer = std::vector<std::byte>(size);
+
+    benchmark("serialize orders, hand-written", size, [&] {
+        do_not_optimize(hand_written_serialize_to(orders, buffer.data()));
+    });
+    benchmark("serialize orders, reflected", size, [&] {
+        do_not_optimize(dojo::serial::serialize_to(orders, buffer.data()));
+    });
+
+    // the same bytes, so that the two are comparable
+    auto expected = std::vector<std::byte>(size);
+    hand_written_serialize_to(orders, expected.data());
+    ASSERT_EQ(buffer, expected);
+
+    benchmark("deserialize orders, copy", size, [&] {
+        do_not_optimize(dojo::serial::deserialize<std::vector<order>>(buffer).back().id);
+    });
+    benchmark("deserialize orders, view", size, [&] {
+        do_not_optimize(std::get<0>(dojo::serial::deserialize_view<std::vector<order>>(buffer).back()));
+    });
+}
@@ -0,0 +1,162 @@
+#include <any>
+#include <array>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../flat-hash-map/flat_hash_map.h"
+#include "../lock-free-queue/spsc_ring_buffer.h"
+#include "../metrics/metrics.h"
+#include "../timer-wheel/timer_wheel.h"
+#include "../../../alloc_tracking.h"
+#include "../../../utils.h"
+
+/**
+ * The heap allocations made by the vocabulary types of the other cases, and
+ * the hot paths of this project locked in as free of allocations.
+ *
+ * Nothing is counted unless built with the cmake option DOJO_ALLOC_TRACKING,
+ * in which case every test also reports its allocations, see README.MD.
+ */
+
+namespace {
+
+template<typename Fn>
+dojo::alloc::counts count(char const *name, Fn &&fn) {
+    auto const scope = dojo::alloc::scope();
+    fn();
+    auto const counted = scope.counted();
+    std::cout << "  " << name << ": " << counted << std::endl;
+    return counted;
+}
+
+int add(int const a, int const b) {
+    return a + b;
+}
+
+}
+
+TEST(TestAllocTracking, test_vocabulary_types) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const small_any = count("std::any of an int", [] {
+        auto const a = std::any(42);
+        do_not_optimize(a);
+    });
+    auto const large_any = count("std::any of 64 bytes", [] {
+        auto const a = std::any(std::array<char, 64>{});
+        do_not_optimize(a);
+    });
+    auto const small_function = count("std::function of a lambda capturing a pointer", [] {
+        auto x = 0;
+        auto const f = std::function<int()>([&x] { return x; });
+        do_not_optimize(f);
+    });
+    auto const large_function = count("std::function of a lambda capturing 64 bytes", [] {
+        auto const bytes = std::array<char, 64>{};
+        auto const f = std::function<int()>([bytes] { return bytes[0]; });
+        do_not_optimize(f);
+    });
+    count("std::function of a std::bind", [] {
+        auto const f = std::function<int(int)>(std::bind(add, 1, std::placeholders::_1));
+        do_not_optimize(f);
+    });
+    auto const packaged_task = count("std::packaged_task, run and got", [] {
+        auto task = std::packaged_task<int()>([] { return 42; });
+        auto future = task.get_future();
+        task();
+        do_not_optimize(future.get());
+    });
+    auto const promise = count("std::promise, set and got", [] {
+        auto p = std::promise<int>();
+        auto future = p.get_future();
+        p.set_value(42);
+        do_not_optimize(future.get());
+    });
+    count("std::ranges::istream_view of 1000 ints", [] {
+        auto ss = std::istringstream();
+        auto text = std::string();
+        for (auto i = 0; i < 1000; ++i) {
+            text += std::to_string(i) + ' ';
+        }
+        ss.str(std::move(text));
+        auto sum = 0;
+        for (auto const i: std::ranges::istream_view<int>(ss)) {
+            sum += i;
+        }
+        do_not_optimize(sum);
+    });
+
+    if (!dojo::alloc::enabled) {
+        GTEST_SKIP() << "nothing is counted without DOJO_ALLOC_TRACKING";
+    }
+    // the small objects fit in the buffer of the object itself
+    ASSERT_EQ(small_any.allocations, 0);
+    ASSERT_EQ(small_function.allocations, 0);
+    ASSERT_GE(large_any.allocations, 1);
+    ASSERT_GE(large_function.allocations, 1);
+    // and the shared state of a future is always on the heap
+    ASSERT_GE(packaged_task.allocations, 1);
+    ASSERT_GE(promise.allocations, 1);
+    ASSERT_EQ(promise.allocations, promise.deallocations);
+}
+
+TEST(TestAllocTracking, test_no_alloc_hot_paths) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the containers allocate up front, then never again
+    auto map = dojo::flat_hash_map<int, int>(1024);
+    EXPECT_NO_ALLOC(for (auto i = 0; i < 512; ++i) { map[i] = i; });
+    EXPECT_NO_ALLOC(do_not_optimize(map.find(100)));
+
+    auto ring = dojo::spsc_ring_buffer<int>(64);
+    EXPECT_NO_ALLOC(for (auto i = 0; i < 1000; ++i) {
+        ring.try_push(i);
+        do_not_optimize(ring.try_pop());
+    });
+
+    // the nodes are recycled once there are enough for the timers at once
+    auto wheel = dojo::timer_wheel<int>();
+    wheel.cancel(wheel.schedule(100, 0));
+    EXPECT_NO_ALLOC(for (auto i = 0; i < 1000; ++i) { wheel.cancel(wheel.schedule(100 + i, i)); });
+
+    // the shard of this thread is taken by the first record
+    auto counter = dojo::metrics::counter();
+    auto histogram = dojo::metrics::histogram();
+    counter.add();
+    histogram.record(1);
+    EXPECT_NO_ALLOC(for (auto i = 0; i < 1000; ++i) {
+        counter.add();
+        histogram.record(i);
+    });
+}
+
+TEST(TestAllocTracking, test_threads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    if (!dojo::alloc::enabled) {
+        GTEST_SKIP() << "nothing is counted without DOJO_ALLOC_TRACKING";
+    }
+
+    // a scope counts its thread only, while the total counts every thread,
+    // even after it has exited
+    auto const scope = dojo::alloc::scope();
+    auto const total = dojo::alloc::total();
+    std::thread([] {
+        auto const v = std::vector<int>(1000);
+        do_not_optimize(v);
+    }).join();
+    auto const counted = dojo::alloc::total() - total;
+    std::cout << "  total: " << counted << ", this thread: " << scope.counted() << std::endl;
+    ASSERT_GE(counted.allocations, 1);
+    ASSERT_GE(counted.bytes, 1000 * sizeof(int));
+    ASSERT_LT(scope.counted().bytes, 1000 * sizeof(int));
+}
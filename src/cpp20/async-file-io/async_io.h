@@ -0,0 +1,527 @@
+#ifndef CPP_XX_DOJO_ASYNC_IO_H
+#define CPP_XX_DOJO_ASYNC_IO_H
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "uring.h"
+
+namespace dojo {
+
+enum class io_backend {
+    // the requests go to the kernel through the rings of io_uring, and a
+    // single thread waits for all the completions
+    io_uring,
+    // blocking pread() and pwrite() on a few threads, where io_uring is not
+    // available; epoll is of no use here, since it reports a regular file as
+    // always ready while reading it still blocks on the disk
+    thread_pool,
+};
+
+inline io_backend default_io_backend() {
+    return uring::supported() ? io_backend::io_uring : io_backend::thread_pool;
+}
+
+struct async_io_options {
+    io_backend backend = default_io_backend();
+    // the entries of the submission queue of io_uring, which bounds a batch
+    unsigned entries = 256;
+    // the threads of the thread_pool backend, i.e. the requests in flight
+    std::size_t threads = 4;
+};
+
+namespace detail {
+
+/**
+ * What a request does, the same for all the backends.
+ */
+struct io_operation {
+    enum class kind : std::uint8_t { read, write, read_fixed, write_fixed };
+
+    kind op;
+    int fd;
+    std::span<std::byte> buffer;
+    std::uint64_t offset;
+    unsigned buffer_index = 0;
+
+    /**
+     * By the blocking system calls, whose result is the same as that of
+     * io_uring.
+     */
+    [[nodiscard]] int run_blocking() const {
+        auto const result = (op == kind::read || op == kind::read_fixed)
+                            ? ::pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(offset))
+                            : ::pwrite(fd, buffer.data(), buffer.size(), static_cast<off_t>(offset));
+        return result < 0 ? -errno : static_cast<int>(result);
+    }
+};
+
+/**
+ * A request in flight, which is told its result by complete(): the count of
+ * the bytes transferred, or -errno.
+ */
+class io_request {
+public:
+    explicit io_request(io_operation const &operation) : operation(operation) {}
+
+    virtual void complete(int result) = 0;
+
+    io_operation operation;
+
+protected:
+    ~io_request() = default;
+};
+
+inline std::size_t io_result(int const result) {
+    if (result < 0) {
+        throw std::system_error(-result, std::system_category(), "async_io");
+    }
+    return static_cast<std::size_t>(result);
+}
+
+/**
+ * A request completing into a std::future, which frees itself on completion.
+ */
+class future_request final : public io_request {
+public:
+    using io_request::io_request;
+
+    void complete(int const result) override {
+        try {
+            m_promise.set_value(io_result(result));
+        } catch (...) {
+            m_promise.set_exception(std::current_exception());
+        }
+        delete this;
+    }
+
+    std::future<std::size_t> get_future() { return m_promise.get_future(); }
+
+private:
+    std::promise<std::size_t> m_promise;
+};
+
+}
+
+class async_io;
+
+/**
+ * The awaitable of a request, which resumes the awaiting coroutine with the
+ * count of the bytes transferred, or throws a std::system_error.
+ *
+ * The coroutine resumes on the thread which completes the request, i.e. the
+ * completion thread of io_uring or a thread of the pool, which should rather
+ * hand heavy work over than hold up the other completions.
+ */
+class io_awaitable final : private detail::io_request {
+public:
+    io_awaitable(async_io &io, detail::io_operation const &operation) : detail::io_request(operation), m_io(io) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    inline void await_suspend(std::coroutine_handle<> handle);
+
+    std::size_t await_resume() const { return detail::io_result(m_result); }
+
+private:
+    void complete(int const result) override {
+        m_result = result;
+        m_handle.resume();
+    }
+
+    async_io &m_io;
+    std::coroutine_handle<> m_handle;
+    int m_result = 0;
+};
+
+/**
+ * @brief Asynchronous reads and writes of files, completing into futures or
+ * coroutines
+ *
+ * With std::async wrapping a blocking read(), every request in flight takes a
+ * thread, which mostly waits. With io_uring, a request is an entry of a ring
+ * shared with the kernel instead, so any count of requests are in flight at
+ * the cost of a single thread waiting for all their completions:
+ *   - a batch fills many entries before a single system call submits them
+ *     all, rather than one call per request;
+ *   - the registered buffers are pinned and mapped into the kernel once for
+ *     all, rather than on every request, and addressed by the fixed requests;
+ *   - the result goes to a std::future, or resumes a coroutine awaiting it.
+ *
+ * Where io_uring is not available, the requests are run by the blocking
+ * system calls on a few threads of its own, with the same interface.
+ *
+ * The buffers must outlive the requests, and the destructor waits for the
+ * requests in flight.
+ *
+ * reference from https://unixism.net/loti/what_is_io_uring.html
+ */
+class async_io {
+public:
+    explicit async_io(async_io_options const &options = {}) : m_backend(options.backend) {
+        if (m_backend == io_backend::io_uring) {
+            m_ring.emplace(options.entries);
+            m_workers.emplace_back([this] { reap(); });
+        } else {
+            for (auto i = std::size_t{0}; i < std::max<std::size_t>(options.threads, 1); ++i) {
+                m_workers.emplace_back([this](std::stop_token const &token) { serve(token); });
+            }
+        }
+    }
+
+    async_io(async_io const &) = delete;
+
+    async_io &operator=(async_io const &) = delete;
+
+    ~async_io() {
+        if (m_ring) {
+            auto const lock = std::lock_guard(m_submit_mutex);
+            m_stopping.store(true, std::memory_order_release);
+            // wakes the completion thread up, which then waits for the rest
+            auto *const sqe = acquire_sqe();
+            sqe->opcode = IORING_OP_NOP;
+            m_ring->submit();
+        }
+        // the pool threads drain the queue before they stop
+        m_workers.clear();
+    }
+
+    [[nodiscard]] io_backend backend() const { return m_backend; }
+
+    /**
+     * Register the buffers for the fixed requests, replacing those registered
+     * before, which must have no requests in flight.
+     */
+    void register_buffers(std::span<std::span<std::byte> const> const buffers) {
+        auto const lock = std::lock_guard(m_submit_mutex);
+        if (m_ring) {
+            if (!m_buffers.empty()) {
+                m_ring->unregister_buffers();
+            }
+            auto iovecs = std::vector<iovec>();
+            for (auto const b: buffers) {
+                iovecs.push_back(iovec{b.data(), b.size()});
+            }
+            m_ring->register_buffers(iovecs);
+        }
+        m_buffers.assign(buffers.begin(), buffers.end());
+    }
+
+    /**
+     * Many requests submitted together, on destruction or by submit(), while
+     * holding the submission queue.
+     */
+    class batch {
+    public:
+        explicit batch(async_io &io) : m_io(io), m_lock(io.m_submit_mutex) {}
+
+        batch(batch const &) = delete;
+
+        batch &operator=(batch const &) = delete;
+
+        ~batch() { submit(); }
+
+        std::future<std::size_t> read(int const fd, std::span<std::byte> const buffer, std::uint64_t const offset) {
+            return add({detail::io_operation::kind::read, fd, buffer, offset});
+        }
+
+        std::future<std::size_t> write(int const fd, std::span<std::byte const> const buffer,
+                                       std::uint64_t const offset) {
+            return add({detail::io_operation::kind::write, fd, as_writable(buffer), offset});
+        }
+
+        /**
+         * Read into `buffer`, which must lie within the registered buffer of
+         * the given index.
+         */
+        std::future<std::size_t> read_fixed(int const fd, unsigned const buffer_index,
+                                            std::span<std::byte> const buffer, std::uint64_t const offset) {
+            return add(m_io.fixed(detail::io_operation::kind::read_fixed, fd, buffer_index, buffer, offset));
+        }
+
+        std::future<std::size_t> write_fixed(int const fd, unsigned const buffer_index,
+                                             std::span<std::byte const> const buffer, std::uint64_t const offset) {
+            return add(m_io.fixed(detail::io_operation::kind::write_fixed, fd, buffer_index, as_writable(buffer),
+                                  offset));
+        }
+
+        /**
+         * Submit the requests added since the last submit, if any.
+         */
+        void submit() {
+            if (m_unsubmitted) {
+                m_io.flush();
+                m_unsubmitted = false;
+            }
+        }
+
+    private:
+        std::future<std::size_t> add(detail::io_operation const &operation) {
+            auto owned = std::make_unique<detail::future_request>(operation);
+            auto future = owned->get_future();
+            m_io.prepare(*owned);
+            owned.release();
+            m_unsubmitted = true;
+            return future;
+        }
+
+        async_io &m_io;
+        std::unique_lock<std::mutex> m_lock;
+        bool m_unsubmitted = false;
+    };
+
+    /**
+     * Only the requests of the batch can be submitted till it is destroyed.
+     */
+    batch start_batch() { return batch(*this); }
+
+    std::future<std::size_t> read(int const fd, std::span<std::byte> const buffer, std::uint64_t const offset) {
+        return batch(*this).read(fd, buffer, offset);
+    }
+
+    std::future<std::size_t> write(int const fd, std::span<std::byte const> const buffer,
+                                   std::uint64_t const offset) {
+        return batch(*this).write(fd, buffer, offset);
+    }
+
+    std::future<std::size_t> read_fixed(int const fd, unsigned const buffer_index,
+                                        std::span<std::byte> const buffer, std::uint64_t const offset) {
+        return batch(*this).read_fixed(fd, buffer_index, buffer, offset);
+    }
+
+    /**
+     * `co_await io.async_read(...)` in a coroutine.
+     */
+    io_awaitable async_read(int const fd, std::span<std::byte> const buffer, std::uint64_t const offset) {
+        return {*this, {detail::io_operation::kind::read, fd, buffer, offset}};
+    }
+
+    io_awaitable async_write(int const fd, std::span<std::byte const> const buffer, std::uint64_t const offset) {
+        return {*this, {detail::io_operation::kind::write, fd, as_writable(buffer), offset}};
+    }
+
+    io_awaitable async_read_fixed(int const fd, unsigned const buffer_index, std::span<std::byte> const buffer,
+                                  std::uint64_t const offset) {
+        return {*this, fixed(detail::io_operation::kind::read_fixed, fd, buffer_index, buffer, offset)};
+    }
+
+private:
+    friend class io_awaitable;
+
+    // the kernel only reads from the buffer of a write
+    static std::span<std::byte> as_writable(std::span<std::byte const> const buffer) {
+        return {const_cast<std::byte *>(buffer.data()), buffer.size()};
+    }
+
+    detail::io_operation fixed(detail::io_operation::kind const op, int const fd, unsigned const buffer_index,
+                             std::span<std::byte> const buffer, std::uint64_t const offset) const {
+        if (buffer_index >= m_buffers.size()) {
+            throw std::out_of_range("async_io: no such registered buffer");
+        }
+        auto const registered = m_buffers[buffer_index];
+        if (buffer.data() < registered.data() ||
+            buffer.data() + buffer.size() > registered.data() + registered.size()) {
+            throw std::out_of_range("async_io: not within the registered buffer");
+        }
+        return {op, fd, buffer, offset, buffer_index};
+    }
+
+    void submit_one(detail::io_request &request) {
+        auto const lock = std::lock_guard(m_submit_mutex);
+        prepare(request);
+        flush();
+    }
+
+    /**
+     * Queue the request up, with the submission queue held.
+     */
+    void prepare(detail::io_request &request) {
+        if (!m_ring) {
+            m_pending.push_back(&request);
+            return;
+        }
+        auto *const sqe = acquire_sqe();
+        auto const &operation = request.operation;
+        using kind = detail::io_operation::kind;
+        switch (operation.op) {
+            case kind::read:
+                sqe->opcode = IORING_OP_READ;
+                break;
+            case kind::write:
+                sqe->opcode = IORING_OP_WRITE;
+                break;
+            case kind::read_fixed:
+                sqe->opcode = IORING_OP_READ_FIXED;
+                break;
+            case kind::write_fixed:
+                sqe->opcode = IORING_OP_WRITE_FIXED;
+                break;
+        }
+        sqe->fd = operation.fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(operation.buffer.data());
+        sqe->len = static_cast<std::uint32_t>(operation.buffer.size());
+        sqe->off = operation.offset;
+        sqe->buf_index = static_cast<std::uint16_t>(operation.buffer_index);
+        sqe->user_data = reinterpret_cast<std::uint64_t>(&request);
+        m_in_flight.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * The next free entry of the submission queue, with it held, which makes
+     * room when full by handing the entries over to the kernel.
+     *
+     * The kernel takes none while the completion queue overflows, which then
+     * is drained here rather than waiting for the completion thread to: that
+     * may be this very thread, preparing the next request of a coroutine it
+     * has resumed, or be waiting for the submission queue held here.
+     */
+    io_uring_sqe *acquire_sqe() {
+        auto *sqe = m_ring->get_sqe();
+        while (sqe == nullptr) {
+            if (m_ring->submit() == 0) {
+                drain_completions();
+                std::this_thread::yield();
+            }
+            sqe = m_ring->get_sqe();
+        }
+        return sqe;
+    }
+
+    /**
+     * Submit the queued requests, with the submission queue held.
+     */
+    void flush() {
+        if (m_ring) {
+            m_ring->submit();
+            return;
+        }
+        if (m_pending.empty()) {
+            return;
+        }
+        {
+            auto const lock = std::lock_guard(m_queue_mutex);
+            m_queue.insert(m_queue.end(), m_pending.begin(), m_pending.end());
+        }
+        if (m_pending.size() == 1) {
+            m_queue_cv.notify_one();
+        } else {
+            m_queue_cv.notify_all();
+        }
+        m_pending.clear();
+    }
+
+    /**
+     * Move the completions out of the completion queue, for the completion
+     * thread to complete, by any thread.
+     */
+    void drain_completions() {
+        auto const lock = std::lock_guard(m_drain_mutex);
+        m_ring->for_each_completion([this](io_uring_cqe const &cqe) {
+            if (cqe.user_data != 0) {
+                m_drained.emplace_back(reinterpret_cast<detail::io_request *>(cqe.user_data), cqe.res);
+            }
+        });
+    }
+
+    /**
+     * The completion thread of io_uring, which stops once stopping with no
+     * requests in flight.
+     *
+     * The completions are drained first and completed after, so that those
+     * resuming coroutines may drain more on the way, see acquire_sqe(). A
+     * thread which drains always submits a request after, whose completion
+     * wakes this thread up for what it has drained.
+     */
+    void reap() {
+        auto ready = std::vector<std::pair<detail::io_request *, int>>();
+        while (true) {
+            drain_completions();
+            {
+                auto const lock = std::lock_guard(m_drain_mutex);
+                ready.swap(m_drained);
+            }
+            if (ready.empty()) {
+                if (m_stopping.load(std::memory_order_acquire) &&
+                    m_in_flight.load(std::memory_order_relaxed) == 0) {
+                    return;
+                }
+                m_ring->wait();
+                continue;
+            }
+            for (auto const &[request, result]: ready) {
+                m_in_flight.fetch_sub(1, std::memory_order_relaxed);
+                request->complete(result);
+            }
+            ready.clear();
+        }
+    }
+
+    /**
+     * A thread of the thread_pool backend, which drains the queue once
+     * stopped.
+     */
+    void serve(std::stop_token const &token) {
+        while (true) {
+            auto *request = static_cast<detail::io_request *>(nullptr);
+            {
+                auto lock = std::unique_lock(m_queue_mutex);
+                m_queue_cv.wait(lock, token, [this] { return !m_queue.empty(); });
+                if (m_queue.empty()) {
+                    return;
+                }
+                request = m_queue.front();
+                m_queue.pop_front();
+            }
+            request->complete(request->operation.run_blocking());
+        }
+    }
+
+    io_backend m_backend;
+    std::optional<uring> m_ring;
+    std::vector<std::span<std::byte>> m_buffers;
+
+    std::mutex m_submit_mutex;
+    // the consumption of the completion queue, and what it has consumed
+    std::mutex m_drain_mutex;
+    std::vector<std::pair<detail::io_request *, int>> m_drained;
+    std::atomic<std::size_t> m_in_flight{0};
+    std::atomic<bool> m_stopping{false};
+
+    // the thread_pool backend
+    std::vector<detail::io_request *> m_pending;
+    std::mutex m_queue_mutex;
+    std::condition_variable_any m_queue_cv;
+    std::deque<detail::io_request *> m_queue;
+
+    std::vector<std::jthread> m_workers;
+};
+
+inline void io_awaitable::await_suspend(std::coroutine_handle<> const handle) {
+    m_handle = handle;
+    // may be resumed by another thread before returning from here
+    m_io.submit_one(*this);
+}
+
+}
+
+#endif //CPP_XX_DOJO_ASYNC_IO_H
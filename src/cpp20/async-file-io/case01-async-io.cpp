@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "async_io.h"
+#include "../coroutines/co_future.h"
+
+/**
+ * Reads and writes of files completing into futures and coroutines, by
+ * io_uring, or by a thread pool where io_uring is not available.
+ *
+ * reference from https://man7.org/linux/man-pages/man2/io_uring_enter.2.html
+ */
+
+namespace {
+
+/**
+ * A temporary file, removed on destruction.
+ */
+class temp_file {
+public:
+    temp_file() {
+        m_fd = ::mkstemp(m_path.data());
+        if (m_fd < 0) {
+            throw std::system_error(errno, std::system_category(), "mkstemp");
+        }
+    }
+
+    temp_file(temp_file const &) = delete;
+
+    temp_file &operator=(temp_file const &) = delete;
+
+    ~temp_file() {
+        ::close(m_fd);
+        ::unlink(m_path.c_str());
+    }
+
+    [[nodiscard]] int fd() const { return m_fd; }
+
+private:
+    std::string m_path = "/tmp/dojo-async-io-XXXXXX";
+    int m_fd = -1;
+};
+
+std::vector<dojo::io_backend> backends() {
+    auto result = std::vector<dojo::io_backend>{dojo::io_backend::thread_pool};
+    if (dojo::uring::supported()) {
+        result.push_back(dojo::io_backend::io_uring);
+    } else {
+        std::cout << "  io_uring is not available, only the thread pool is tested" << std::endl;
+    }
+    return result;
+}
+
+std::vector<std::byte> pattern(std::size_t const size, int const seed) {
+    auto bytes = std::vector<std::byte>(size);
+    for (auto i = std::size_t{0}; i < size; ++i) {
+        bytes[i] = static_cast<std::byte>((i * 31 + seed) & 0xff);
+    }
+    return bytes;
+}
+
+dojo::co_future<std::size_t> read_over(dojo::async_io &io, int const fd, std::span<std::byte> buffer,
+                                       int const times) {
+    auto total = std::size_t{0};
+    for (auto i = 0; i < times; ++i) {
+        total += co_await io.async_read(fd, buffer, 0);
+    }
+    co_return total;
+}
+
+dojo::co_future<std::size_t> copy(dojo::async_io &io, int const from, int const to, std::span<std::byte> buffer) {
+    auto const read = co_await io.async_read(from, buffer, 0);
+    co_return co_await io.async_write(to, buffer.first(read), 0);
+}
+
+}
+
+TEST(TestAsyncIo, test_read_write) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const backend: backends()) {
+        auto io = dojo::async_io({.backend = backend});
+        ASSERT_EQ(io.backend(), backend);
+
+        auto const file = temp_file();
+        auto const data = pattern(10000, 1);
+        ASSERT_EQ(io.write(file.fd(), data, 0).get(), data.size());
+
+        auto read = std::vector<std::byte>(data.size());
+        ASSERT_EQ(io.read(file.fd(), read, 0).get(), data.size());
+        ASSERT_EQ(read, data);
+
+        // a short read at the end of the file
+        ASSERT_EQ(io.read(file.fd(), read, 9000).get(), 1000);
+        ASSERT_EQ(io.read(file.fd(), read, 20000).get(), 0);
+    }
+}
+
+TEST(TestAsyncIo, test_batch) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto blocks = 1000;
+    constexpr auto block_size = std::size_t{512};
+    for (auto const backend: backends()) {
+        // more blocks than entries of the ring, which is flushed when full
+        auto io = dojo::async_io({.backend = backend, .entries = 64});
+        auto const file = temp_file();
+        auto const data = pattern(blocks * block_size, 2);
+        ASSERT_EQ(io.write(file.fd(), data, 0).get(), data.size());
+
+        auto read = std::vector<std::byte>(data.size());
+        auto futures = std::vector<std::future<std::size_t>>();
+        {
+            // in the reverse order, all submitted together
+            auto batch = io.start_batch();
+            for (auto b = blocks - 1; b >= 0; --b) {
+                futures.push_back(batch.read(file.fd(), std::span(read).subspan(b * block_size, block_size),
+                                             b * block_size));
+            }
+        }
+        for (auto &f: futures) {
+            ASSERT_EQ(f.get(), block_size);
+        }
+        ASSERT_EQ(read, data);
+    }
+}
+
+TEST(TestAsyncIo, test_registered_buffers) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const backend: backends()) {
+        auto io = dojo::async_io({.backend = backend});
+        auto const file = temp_file();
+        auto const data = pattern(8192, 3);
+        ASSERT_EQ(io.write(file.fd(), data, 0).get(), data.size());
+
+        auto arena = std::vector<std::byte>(16384);
+        auto const buffers = std::vector<std::span<std::byte>>{std::span(arena).first(8192),
+                                                               std::span(arena).last(8192)};
+        io.register_buffers(buffers);
+
+        // into the halves of the second buffer
+        auto first = io.read_fixed(file.fd(), 1, buffers[1].first(4096), 4096);
+        auto second = io.read_fixed(file.fd(), 1, buffers[1].last(4096), 0);
+        ASSERT_EQ(first.get(), 4096);
+        ASSERT_EQ(second.get(), 4096);
+        ASSERT_TRUE(std::equal(data.begin() + 4096, data.end(), arena.begin() + 8192));
+        ASSERT_TRUE(std::equal(data.begin(), data.begin() + 4096, arena.begin() + 12288));
+
+        ASSERT_THROW(io.read_fixed(file.fd(), 2, buffers[1], 0), std::out_of_range);
+        ASSERT_THROW(io.read_fixed(file.fd(), 0, buffers[1], 0), std::out_of_range);
+    }
+}
+
+TEST(TestAsyncIo, test_coroutine) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const backend: backends()) {
+        auto io = dojo::async_io({.backend = backend});
+        auto const from = temp_file();
+        auto const to = temp_file();
+        auto const data = pattern(3000, 4);
+        ASSERT_EQ(io.write(from.fd(), data, 0).get(), data.size());
+
+        auto buffer = std::vector<std::byte>(4096);
+        ASSERT_EQ(copy(io, from.fd(), to.fd(), buffer).get(), data.size());
+
+        auto copied = std::vector<std::byte>(data.size());
+        ASSERT_EQ(io.read(to.fd(), copied, 0).get(), data.size());
+        ASSERT_EQ(copied, data);
+    }
+}
+
+/**
+ * A ring of two entries, overrun at once by a batch, and by the coroutines
+ * which submit their next reads from the completion thread as it resumes
+ * them, which all complete however full the rings get.
+ */
+TEST(TestAsyncIo, test_full_rings) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto coroutine_count = 32;
+    constexpr auto reads = 50;
+    constexpr auto batched = 500;
+    constexpr auto block_size = std::size_t{512};
+    for (auto const backend: backends()) {
+        auto io = dojo::async_io({.backend = backend, .entries = 2});
+        auto const file = temp_file();
+        auto const data = pattern(block_size, 5);
+        ASSERT_EQ(io.write(file.fd(), data, 0).get(), data.size());
+
+        auto buffers = std::vector<std::vector<std::byte>>(coroutine_count + 1, std::vector<std::byte>(block_size));
+        auto readers = std::vector<dojo::co_future<std::size_t>>();
+        for (auto i = 0; i < coroutine_count; ++i) {
+            readers.push_back(read_over(io, file.fd(), buffers[i], reads));
+        }
+        auto futures = std::vector<std::future<std::size_t>>();
+        {
+            auto batch = io.start_batch();
+            for (auto i = 0; i < batched; ++i) {
+                futures.push_back(batch.read(file.fd(), buffers.back(), 0));
+            }
+            batch.submit();
+        }
+        for (auto &f: futures) {
+            ASSERT_EQ(f.get(), block_size);
+        }
+        for (auto &r: readers) {
+            ASSERT_EQ(r.get(), block_size * reads);
+        }
+        ASSERT_EQ(buffers.front(), data);
+    }
+}
+
+TEST(TestAsyncIo, test_error) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const backend: backends()) {
+        auto io = dojo::async_io({.backend = backend});
+        auto buffer = std::vector<std::byte>(16);
+        auto failed = io.read(-1, buffer, 0);
+        try {
+            failed.get();
+            FAIL() << "no error";
+        } catch (std::system_error const &e) {
+            ASSERT_EQ(e.code().value(), EBADF);
+        }
+
+        auto const file = temp_file();
+        ASSERT_THROW(copy(io, -1, file.fd(), buffer).get(), std::system_error);
+    }
+}
@@ -0,0 +1,184 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "async_io.h"
+#include "../coroutines/co_future.h"
+#include "../../../utils.h"
+
+/**
+ * Reading thousands of small local files at once by async_io, against
+ * std::async with a std::ifstream per file, i.e. a thread per file.
+ *
+ * The files have just been written, so they are read from the page cache:
+ * what is measured is the cost of the requests rather than that of the disk,
+ * which would only widen the gap between a thread per request and a ring of
+ * requests.
+ *
+ * Only printed, not asserted.
+ */
+
+namespace {
+
+constexpr auto file_count = std::size_t{2000};
+constexpr auto file_size = std::size_t{16} << 10;
+
+/**
+ * A directory of files of random bytes, removed on destruction.
+ */
+class file_set {
+public:
+    file_set() {
+        auto dir = std::string("/tmp/dojo-async-io-bench-XXXXXX");
+        if (::mkdtemp(dir.data()) == nullptr) {
+            throw std::system_error(errno, std::system_category(), "mkdtemp");
+        }
+        m_dir = dir;
+        auto const content = std::string(file_size, 'x');
+        for (auto i = std::size_t{0}; i < file_count; ++i) {
+            m_paths.push_back(m_dir / ("file-" + std::to_string(i)));
+            std::ofstream(m_paths.back(), std::ios::binary) << content;
+        }
+    }
+
+    file_set(file_set const &) = delete;
+
+    file_set &operator=(file_set const &) = delete;
+
+    ~file_set() { std::filesystem::remove_all(m_dir); }
+
+    [[nodiscard]] std::vector<std::filesystem::path> const &paths() const { return m_paths; }
+
+private:
+    std::filesystem::path m_dir;
+    std::vector<std::filesystem::path> m_paths;
+};
+
+std::vector<int> open_all(file_set const &files) {
+    auto fds = std::vector<int>();
+    for (auto const &path: files.paths()) {
+        fds.push_back(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    }
+    return fds;
+}
+
+void close_all(std::vector<int> const &fds) {
+    for (auto const fd: fds) {
+        ::close(fd);
+    }
+}
+
+std::size_t read_with_std_async(file_set const &files) {
+    auto futures = std::vector<std::future<std::vector<char>>>();
+    for (auto const &path: files.paths()) {
+        futures.push_back(std::async(std::launch::async, [&path] {
+            auto in = std::ifstream(path, std::ios::binary);
+            auto content = std::vector<char>(file_size);
+            in.read(content.data(), static_cast<std::streamsize>(content.size()));
+            content.resize(static_cast<std::size_t>(in.gcount()));
+            return content;
+        }));
+    }
+    auto total = std::size_t{0};
+    for (auto &f: futures) {
+        total += f.get().size();
+    }
+    return total;
+}
+
+std::size_t read_with_futures(dojo::async_io &io, file_set const &files, std::span<std::byte> const arena,
+                              bool const fixed) {
+    auto const fds = open_all(files);
+    auto futures = std::vector<std::future<std::size_t>>();
+    futures.reserve(fds.size());
+    {
+        auto batch = io.start_batch();
+        for (auto i = std::size_t{0}; i < fds.size(); ++i) {
+            auto const buffer = arena.subspan(i * file_size, file_size);
+            futures.push_back(fixed ? batch.read_fixed(fds[i], 0, buffer, 0) : batch.read(fds[i], buffer, 0));
+        }
+    }
+    auto total = std::size_t{0};
+    for (auto &f: futures) {
+        total += f.get();
+    }
+    close_all(fds);
+    return total;
+}
+
+dojo::co_future<std::size_t> read_file(dojo::async_io &io, int const fd, std::span<std::byte> const buffer) {
+    co_return co_await io.async_read(fd, buffer, 0);
+}
+
+std::size_t read_with_coroutines(dojo::async_io &io, file_set const &files, std::span<std::byte> const arena) {
+    auto const fds = open_all(files);
+    auto reads = std::vector<dojo::co_future<std::size_t>>();
+    reads.reserve(fds.size());
+    for (auto i = std::size_t{0}; i < fds.size(); ++i) {
+        reads.push_back(read_file(io, fds[i], arena.subspan(i * file_size, file_size)));
+    }
+    auto total = std::size_t{0};
+    for (auto &r: reads) {
+        total += r.get();
+    }
+    close_all(fds);
+    return total;
+}
+
+}
+
+TEST(TestAsyncIoBenchmark, test_read_files) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const files = file_set();
+    auto arena = std::vector<std::byte>(file_count * file_size);
+    auto total = std::size_t{0};
+
+    benchmark("std::async + std::ifstream, per file", file_count, [&] {
+        total = read_with_std_async(files);
+    });
+    ASSERT_EQ(total, file_count * file_size);
+
+    {
+        auto io = dojo::async_io({.backend = dojo::io_backend::thread_pool});
+        benchmark("async_io, thread pool, batched futures", file_count, [&] {
+            total = read_with_futures(io, files, arena, false);
+        });
+        ASSERT_EQ(total, file_count * file_size);
+    }
+
+    if (!dojo::uring::supported()) {
+        std::cout << "  io_uring is not available" << std::endl;
+        return;
+    }
+    auto io = dojo::async_io({.backend = dojo::io_backend::io_uring});
+    benchmark("async_io, io_uring, batched futures", file_count, [&] {
+        total = read_with_futures(io, files, arena, false);
+    });
+    ASSERT_EQ(total, file_count * file_size);
+
+    auto const buffers = std::vector<std::span<std::byte>>{arena};
+    io.register_buffers(buffers);
+    benchmark("async_io, io_uring, registered buffer", file_count, [&] {
+        total = read_with_futures(io, files, arena, true);
+    });
+    ASSERT_EQ(total, file_count * file_size);
+
+    benchmark("async_io, io_uring, coroutines", file_count, [&] {
+        total = read_with_coroutines(io, files, arena);
+    });
+    ASSERT_EQ(total, file_count * file_size);
+}
@@ -0,0 +1,293 @@
+#ifndef CPP_XX_DOJO_URING_H
+#define CPP_XX_DOJO_URING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace dojo {
+
+namespace detail {
+
+/**
+ * A file descriptor closed on destruction.
+ */
+class unique_fd {
+public:
+    unique_fd() = default;
+
+    explicit unique_fd(int const fd) : m_fd(fd) {}
+
+    unique_fd(unique_fd &&other) noexcept: m_fd(std::exchange(other.m_fd, -1)) {}
+
+    unique_fd &operator=(unique_fd &&other) noexcept {
+        if (this != &other) {
+            reset(std::exchange(other.m_fd, -1));
+        }
+        return *this;
+    }
+
+    ~unique_fd() { reset(); }
+
+    [[nodiscard]] int get() const { return m_fd; }
+
+    void reset(int const fd = -1) {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        m_fd = fd;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+/**
+ * A shared mapping of a file, unmapped on destruction.
+ */
+class mapping {
+public:
+    mapping() = default;
+
+    mapping(int const fd, std::size_t const size, off_t const offset) :
+            m_addr(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset)),
+            m_size(size) {
+        if (m_addr == MAP_FAILED) {
+            m_addr = nullptr;
+            throw std::system_error(errno, std::system_category(), "mmap");
+        }
+    }
+
+    mapping(mapping &&other) noexcept:
+            m_addr(std::exchange(other.m_addr, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+    mapping &operator=(mapping &&other) noexcept {
+        if (this != &other) {
+            reset();
+            m_addr = std::exchange(other.m_addr, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~mapping() { reset(); }
+
+    template<typename T>
+    T *at(std::uint32_t const offset) const {
+        return reinterpret_cast<T *>(static_cast<std::byte *>(m_addr) + offset);
+    }
+
+private:
+    void reset() {
+        if (m_addr != nullptr) {
+            ::munmap(m_addr, m_size);
+            m_addr = nullptr;
+        }
+    }
+
+    void *m_addr = nullptr;
+    std::size_t m_size = 0;
+};
+
+template<typename T>
+T load_acquire(T const *const p) {
+    return std::atomic_ref<T>(*const_cast<T *>(p)).load(std::memory_order_acquire);
+}
+
+template<typename T>
+void store_release(T *const p, T const value) {
+    std::atomic_ref<T>(*p).store(value, std::memory_order_release);
+}
+
+}
+
+/**
+ * @brief An io_uring instance, by the raw system calls rather than liburing
+ *
+ * The submission queue and the completion queue are rings shared with the
+ * kernel: the entries are filled in place, published by a store-release of
+ * the tail of the submission queue and handed to the kernel by a single
+ * io_uring_enter() however many they are, while the completions are read
+ * from the completion queue without any system call at all.
+ *
+ * Not thread-safe: the submissions must be serialized with each other, and
+ * so must the consumption of the completions, though a thread may submit
+ * while another is waiting for the completions.
+ *
+ * reference from https://kernel.dk/io_uring.pdf
+ * reference from https://man7.org/linux/man-pages/man7/io_uring.7.html
+ */
+class uring {
+public:
+    explicit uring(unsigned const entries) {
+        auto params = io_uring_params{};
+        m_fd = detail::unique_fd(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)));
+        if (m_fd.get() < 0) {
+            throw std::system_error(errno, std::system_category(), "io_uring_setup");
+        }
+
+        auto sq_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+        auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+        m_sq_ring = detail::mapping(m_fd.get(), sq_size, IORING_OFF_SQ_RING);
+        auto const &cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP)
+                              ? m_sq_ring
+                              : (m_cq_ring = detail::mapping(m_fd.get(), cq_size, IORING_OFF_CQ_RING));
+        m_sqe_ring = detail::mapping(m_fd.get(), params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+
+        m_sq_head = m_sq_ring.at<std::uint32_t>(params.sq_off.head);
+        m_sq_tail = m_sq_ring.at<std::uint32_t>(params.sq_off.tail);
+        m_sq_mask = *m_sq_ring.at<std::uint32_t>(params.sq_off.ring_mask);
+        m_sq_entries = params.sq_entries;
+        m_sqes = m_sqe_ring.at<io_uring_sqe>(0);
+        // the slot i of the ring always holds the entry i, so that filling the
+        // entries in order fills the ring in order
+        auto *const array = m_sq_ring.at<std::uint32_t>(params.sq_off.array);
+        for (auto i = std::uint32_t{0}; i < m_sq_entries; ++i) {
+            array[i] = i;
+        }
+        m_tail = *m_sq_tail;
+        m_submitted = m_tail;
+
+        m_cq_head = cq_ring.at<std::uint32_t>(params.cq_off.head);
+        m_cq_tail = cq_ring.at<std::uint32_t>(params.cq_off.tail);
+        m_cq_mask = *cq_ring.at<std::uint32_t>(params.cq_off.ring_mask);
+        m_cqes = cq_ring.at<io_uring_cqe>(params.cq_off.cqes);
+    }
+
+    uring(uring const &) = delete;
+
+    uring &operator=(uring const &) = delete;
+
+    /**
+     * Whether the kernel supports io_uring and allows this process to use it,
+     * which e.g. seccomp filters of containers often don't.
+     */
+    static bool supported() {
+        static auto const result = [] {
+            auto params = io_uring_params{};
+            auto const fd = detail::unique_fd(static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params)));
+            return fd.get() >= 0;
+        }();
+        return result;
+    }
+
+    /**
+     * The next free entry, zeroed, or nullptr if the submission queue is full
+     * until the kernel takes the submitted entries.
+     */
+    io_uring_sqe *get_sqe() {
+        if (m_tail - detail::load_acquire(m_sq_head) >= m_sq_entries) {
+            return nullptr;
+        }
+        auto *const sqe = &m_sqes[m_tail & m_sq_mask];
+        *sqe = io_uring_sqe{};
+        ++m_tail;
+        return sqe;
+    }
+
+    /**
+     * Hand all the entries got since the last call over to the kernel, and
+     * wait until at least `wait_for` completions are there.
+     *
+     * @return the count of the entries taken by the kernel, which takes none
+     * while the completions overflow the completion queue
+     */
+    unsigned submit(unsigned const wait_for = 0) {
+        detail::store_release(m_sq_tail, m_tail);
+        auto const pending = m_tail - m_submitted;
+        auto const taken = enter(pending, wait_for);
+        m_submitted += taken;
+        return taken;
+    }
+
+    /**
+     * Block until a completion is there.
+     */
+    void wait() { enter(0, 1); }
+
+    /**
+     * Consume all the completions there by `fn(cqe)`.
+     *
+     * @return the count of the completions
+     */
+    template<typename Fn>
+    unsigned for_each_completion(Fn &&fn) {
+        auto const head = *m_cq_head;
+        auto const tail = detail::load_acquire(m_cq_tail);
+        for (auto i = head; i != tail; ++i) {
+            fn(m_cqes[i & m_cq_mask]);
+            detail::store_release(m_cq_head, i + 1);
+        }
+        return tail - head;
+    }
+
+    /**
+     * Pin the buffers and map them into the kernel once for all, which the
+     * fixed reads and writes then address by index, rather than mapping the
+     * pages of a buffer on every request.
+     */
+    void register_buffers(std::span<iovec const> const buffers) {
+        if (::syscall(__NR_io_uring_register, m_fd.get(), IORING_REGISTER_BUFFERS,
+                      buffers.data(), static_cast<unsigned>(buffers.size())) < 0) {
+            throw std::system_error(errno, std::system_category(), "io_uring_register");
+        }
+    }
+
+    void unregister_buffers() {
+        ::syscall(__NR_io_uring_register, m_fd.get(), IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    }
+
+private:
+    unsigned enter(unsigned const to_submit, unsigned const wait_for) {
+        while (true) {
+            auto const result = ::syscall(__NR_io_uring_enter, m_fd.get(), to_submit, wait_for,
+                                          wait_for != 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (result >= 0) {
+                return static_cast<unsigned>(result);
+            }
+            if (errno == EBUSY || errno == EAGAIN) {
+                return 0;
+            }
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::system_category(), "io_uring_enter");
+            }
+        }
+    }
+
+    detail::unique_fd m_fd;
+    detail::mapping m_sq_ring;
+    detail::mapping m_cq_ring;
+    detail::mapping m_sqe_ring;
+
+    std::uint32_t *m_sq_head = nullptr;
+    std::uint32_t *m_sq_tail = nullptr;
+    std::uint32_t m_sq_mask = 0;
+    std::uint32_t m_sq_entries = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    // the entries got, and the entries taken by the kernel
+    std::uint32_t m_tail = 0;
+    std::uint32_t m_submitted = 0;
+
+    std::uint32_t *m_cq_head = nullptr;
+    std::uint32_t *m_cq_tail = nullptr;
+    std::uint32_t m_cq_mask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+};
+
+}
+
+#endif //CPP_XX_DOJO_URING_H
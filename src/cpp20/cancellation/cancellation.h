@@ -0,0 +1,329 @@
+#ifndef CPP_XX_DOJO_CANCELLATION_H
+#define CPP_XX_DOJO_CANCELLATION_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "../metrics/metrics.h"
+
+/**
+ * Cooperative cancellation built on std::stop_source/std::stop_token.
+ *
+ * Polling `token.stop_requested()` between sleeps bounds the cancellation
+ * latency by the sleeping interval. Instead, every blocking operation below
+ * registers a std::stop_callback which wakes the blocked thread up as soon as
+ * the stop is requested, so the latency is only the cost of a wake-up.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/stop_callback
+ * reference from https://en.cppreference.com/w/cpp/thread/condition_variable_any/wait
+ */
+
+namespace dojo {
+
+/**
+ * Thrown by cancellable_future::get() if the work was cancelled before it
+ * started, i.e. the work was aborted rather than interrupted.
+ */
+class operation_cancelled : public std::runtime_error {
+public:
+    operation_cancelled() : std::runtime_error("operation cancelled") {}
+};
+
+namespace this_thread {
+
+/**
+ * Block the current thread until `deadline` is reached or a stop is requested.
+ *
+ * @return true if slept until the deadline, false if cancelled
+ */
+template<typename Clock, typename Duration>
+bool sleep_until(std::stop_token const &token, std::chrono::time_point<Clock, Duration> const &deadline) {
+    auto mutex = std::mutex();
+    auto cv = std::condition_variable_any();
+    auto lock = std::unique_lock(mutex);
+    // the predicate never holds, so that only the deadline or the stop ends the waiting
+    cv.wait_until(lock, token, deadline, [] { return false; });
+    return !token.stop_requested();
+}
+
+/**
+ * Block the current thread for `duration` unless a stop is requested.
+ *
+ * @return true if slept for the whole duration, false if cancelled
+ */
+template<typename Rep, typename Period>
+bool sleep_for(std::stop_token const &token, std::chrono::duration<Rep, Period> const &duration) {
+    return sleep_until(token, std::chrono::steady_clock::now() + duration);
+}
+
+}
+
+namespace detail {
+
+/**
+ * Make the stop callback which wakes up the waiter on `cv`.
+ *
+ * The callback locks and unlocks the mutex before notifying, so the waiter is
+ * either still before checking the token (and will see the stop), or already
+ * blocked on `cv` (and will be notified): no wake-up can be lost.
+ *
+ * The callback runs in the constructor of std::stop_callback if the stop has
+ * been requested already, while the waiter is holding the mutex, hence the
+ * waiter itself never locks. Any other thread does, including the one
+ * requesting the stop, which therefore must not hold the mutex then, or it
+ * deadlocks. Notifying without the mutex instead could be lost between the
+ * waiter checking the token and blocking.
+ */
+inline auto wake_up_on_stop(std::condition_variable &cv, std::mutex &mutex) {
+    return [&cv, &mutex, waiter = std::this_thread::get_id()] {
+        if (std::this_thread::get_id() != waiter) {
+            std::lock_guard const guard(mutex);
+        }
+        cv.notify_all();
+    };
+}
+
+}
+
+/**
+ * Wait on a std::condition_variable until `pred` holds or a stop is requested.
+ *
+ * std::condition_variable_any accepts a stop token out of the box since
+ * C++20, but std::condition_variable does not, while it is the cheaper one.
+ *
+ * The stop wakes the waiter up under the mutex of `lock`, so the stop must
+ * not be requested by a thread holding that mutex, e.g. a producer which
+ * gives up while filling the queue waited on; request it after unlocking.
+ *
+ * @return pred() evaluated with the lock held after waking up, i.e. false only
+ *   if woken up by the stop
+ */
+template<typename Predicate>
+bool wait(std::condition_variable &cv, std::unique_lock<std::mutex> &lock,
+          std::stop_token const &token, Predicate pred) {
+    if (!token.stop_possible()) {
+        cv.wait(lock, pred);
+        return true;
+    }
+    {
+        auto const wake_up = std::stop_callback(token, detail::wake_up_on_stop(cv, *lock.mutex()));
+        cv.wait(lock, [&] { return token.stop_requested() || pred(); });
+        // the callback may be blocked on locking the mutex in another thread, and
+        // destroying the callback waits for it to return, hence unlock first
+        lock.unlock();
+    }
+    lock.lock();
+    return pred();
+}
+
+/**
+ * Same as wait(), but gives up at `deadline` as well, with the same
+ * precondition on requesting the stop.
+ */
+template<typename Clock, typename Duration, typename Predicate>
+bool wait_until(std::condition_variable &cv, std::unique_lock<std::mutex> &lock,
+                std::stop_token const &token,
+                std::chrono::time_point<Clock, Duration> const &deadline,
+                Predicate pred) {
+    if (!token.stop_possible()) {
+        return cv.wait_until(lock, deadline, pred);
+    }
+    {
+        auto const wake_up = std::stop_callback(token, detail::wake_up_on_stop(cv, *lock.mutex()));
+        cv.wait_until(lock, deadline, [&] { return token.stop_requested() || pred(); });
+        lock.unlock();
+    }
+    lock.lock();
+    return pred();
+}
+
+/**
+ * Same as wait(), but gives up after `duration` as well, with the same
+ * precondition on requesting the stop.
+ */
+template<typename Rep, typename Period, typename Predicate>
+bool wait_for(std::condition_variable &cv, std::unique_lock<std::mutex> &lock,
+              std::stop_token const &token,
+              std::chrono::duration<Rep, Period> const &duration,
+              Predicate pred) {
+    return wait_until(cv, lock, token, std::chrono::steady_clock::now() + duration, std::move(pred));
+}
+
+/**
+ * A std::stop_source which is stopped as well when its parent token is.
+ */
+class linked_stop_source {
+public:
+    explicit linked_stop_source(std::stop_token const &parent) :
+            m_source(),
+            m_link(parent, [this] { m_source.request_stop(); }) {}
+
+    [[nodiscard]] std::stop_token get_token() const { return m_source.get_token(); }
+
+    bool request_stop() { return m_source.request_stop(); }
+
+    [[nodiscard]] bool stop_requested() const { return m_source.stop_requested(); }
+
+private:
+    std::stop_source m_source;
+    std::stop_callback<std::function<void()>> m_link;
+};
+
+namespace detail {
+
+/**
+ * The metrics of all the cancellable futures, in the global registry.
+ */
+struct future_metrics {
+    // the time get() and wait() block for the value
+    metrics::histogram &wait_time;
+    // the futures destroyed before their value is taken, whose work is
+    // stopped, not counting those given up by discard()
+    metrics::counter &abandoned;
+
+    static future_metrics const &get() {
+        auto &r = metrics::registry::global();
+        static auto const m = future_metrics{
+                r.get_histogram("dojo_future_wait_ns"),
+                r.get_counter("dojo_future_abandoned_total"),
+        };
+        return m;
+    }
+};
+
+}
+
+/**
+ * @brief A future owning the stop source of the work producing its value
+ *
+ * Like std::jthread, a cancellable_future requests stop on destruction, so
+ * the abandoned work gets aborted (if still pending) or interrupted (if
+ * running and cooperative) instead of running to completion for nothing.
+ *
+ * @tparam T the type of the value
+ */
+template<typename T>
+class cancellable_future {
+public:
+    cancellable_future() = default;
+
+    cancellable_future(std::future<T> future, std::stop_source source) :
+            m_future(std::move(future)), m_source(std::move(source)) {}
+
+    cancellable_future(cancellable_future &&) noexcept = default;
+
+    cancellable_future &operator=(cancellable_future &&other) noexcept {
+        if (this != &other) {
+            cancel_if_valid();
+            m_future = std::move(other.m_future);
+            m_source = std::move(other.m_source);
+        }
+        return *this;
+    }
+
+    ~cancellable_future() {
+        cancel_if_valid();
+    }
+
+    bool request_stop() { return m_source.request_stop(); }
+
+    /**
+     * Request stop and give the value up on purpose, e.g. for the helpers of
+     * a parallel loop once it is done, which unlike a future destroyed before
+     * its value is taken isn't counted as abandoned.
+     */
+    void discard() {
+        if (m_future.valid()) {
+            m_source.request_stop();
+            m_future = std::future<T>();
+        }
+    }
+
+    [[nodiscard]] std::stop_token get_stop_token() const { return m_source.get_token(); }
+
+    [[nodiscard]] bool valid() const { return m_future.valid(); }
+
+    /**
+     * @throw operation_cancelled if the work was aborted before it started
+     */
+    T get() {
+        wait();
+        return m_future.get();
+    }
+
+    void wait() const {
+        auto const start = std::chrono::steady_clock::now();
+        m_future.wait();
+        detail::future_metrics::get().wait_time.record(std::chrono::steady_clock::now() - start);
+    }
+
+    template<typename Rep, typename Period>
+    std::future_status wait_for(std::chrono::duration<Rep, Period> const &duration) const {
+        return m_future.wait_for(duration);
+    }
+
+private:
+    void cancel_if_valid() {
+        if (m_future.valid()) {
+            detail::future_metrics::get().abandoned.add();
+            m_source.request_stop();
+        }
+    }
+
+    std::future<T> m_future;
+    std::stop_source m_source{std::nostopstate};
+};
+
+namespace detail {
+
+/**
+ * Invoke `fn` with `token` prepended to the arguments if it accepts a stop
+ * token as its first parameter, in the same way as std::jthread.
+ */
+template<typename Fn, typename... Args>
+decltype(auto) invoke_with_token(Fn &&fn, std::stop_token const &token, Args &&...args) {
+    if constexpr (std::is_invocable_v<Fn, std::stop_token, Args...>) {
+        return std::invoke(std::forward<Fn>(fn), token, std::forward<Args>(args)...);
+    } else {
+        return std::invoke(std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+}
+
+template<typename Fn, typename... Args>
+using invoke_with_token_result_t =
+        decltype(invoke_with_token(std::declval<Fn>(), std::declval<std::stop_token>(), std::declval<Args>()...));
+
+}
+
+/**
+ * Same as std::async(std::launch::async, ...), but `fn` may take a stop token
+ * as its first parameter, which is stopped by the returned future.
+ */
+template<typename Fn, typename... Args>
+auto cancellable_async(Fn &&fn, Args &&...args) {
+    using result_t = detail::invoke_with_token_result_t<std::decay_t<Fn>, std::decay_t<Args>...>;
+
+    auto source = std::stop_source();
+    auto future = std::async(
+            std::launch::async,
+            [token = source.get_token()](auto &&fn, auto &&...args) -> result_t {
+                if (token.stop_requested()) {
+                    throw operation_cancelled();
+                }
+                return detail::invoke_with_token(std::move(fn), token, std::move(args)...);
+            },
+            std::forward<Fn>(fn), std::forward<Args>(args)...);
+    return cancellable_future<result_t>(std::move(future), std::move(source));
+}
+
+}
+
+#endif //CPP_XX_DOJO_CANCELLATION_H
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "cancellation.h"
+
+/**
+ * TestJthread::test_stop_jthread polls `token.stop_requested()` once per
+ * second, hence it takes up to a second to notice the stop. The functions in
+ * cancellation.h register a std::stop_callback instead, which wakes up the
+ * blocked thread as soon as the stop is requested.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/stop_callback
+ */
+
+using namespace std::chrono_literals;
+
+TEST(TestCancellation, test_cancellable_sleep) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // without being stopped, it sleeps for the whole duration
+    auto const start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(dojo::this_thread::sleep_for(std::stop_token(), 10ms));
+    ASSERT_GE(std::chrono::steady_clock::now() - start, 10ms);
+
+    // jthread passes its own stop token to the function automatically,
+    // and the sleep ends as soon as request_stop() is called
+    auto slept_fully = true;
+    auto th = std::jthread([&](std::stop_token const &token) {
+        slept_fully = dojo::this_thread::sleep_for(token, 1h);
+    });
+
+    std::this_thread::sleep_for(10ms);
+    auto const stop = std::chrono::steady_clock::now();
+    th.request_stop();
+    th.join();
+    std::cout << "stopped in " << std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - stop).count() << "us" << std::endl;
+
+    ASSERT_FALSE(slept_fully);
+}
+
+/**
+ * std::condition_variable_any can wait with a stop token since C++20, while
+ * std::condition_variable can not. dojo::wait adds it.
+ */
+TEST(TestCancellation, test_interruptible_condition_variable_wait) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto mutex = std::mutex();
+    auto cv = std::condition_variable();
+    auto ready = false;
+
+    // woken up by the notification: the predicate holds
+    auto notified = std::jthread([&](std::stop_token const &token) {
+        auto lock = std::unique_lock(mutex);
+        ASSERT_TRUE(dojo::wait(cv, lock, token, [&] { return ready; }));
+    });
+    {
+        auto const lock = std::lock_guard(mutex);
+        ready = true;
+    }
+    cv.notify_all();
+    notified.join();
+
+    // woken up by the stop: the predicate doesn't hold
+    ready = false;
+    auto stopped = std::jthread([&](std::stop_token const &token) {
+        auto lock = std::unique_lock(mutex);
+        ASSERT_FALSE(dojo::wait(cv, lock, token, [&] { return ready; }));
+        ASSERT_TRUE(lock.owns_lock());
+    });
+    std::this_thread::sleep_for(10ms);
+    stopped.request_stop();
+    stopped.join();
+
+    // stopped before waiting: returns immediately
+    auto source = std::stop_source();
+    source.request_stop();
+    auto lock = std::unique_lock(mutex);
+    ASSERT_FALSE(dojo::wait(cv, lock, source.get_token(), [&] { return ready; }));
+
+    // timed out
+    ASSERT_FALSE(dojo::wait_for(cv, lock, std::stop_source().get_token(), 10ms, [&] { return ready; }));
+}
+
+TEST(TestCancellation, test_linked_stop_source) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto parent = std::stop_source();
+    auto child = dojo::linked_stop_source(parent.get_token());
+
+    // stopping the child doesn't affect the parent
+    auto sibling = dojo::linked_stop_source(parent.get_token());
+    sibling.request_stop();
+    ASSERT_FALSE(parent.stop_requested());
+    ASSERT_FALSE(child.stop_requested());
+
+    // stopping the parent stops all the children
+    parent.request_stop();
+    ASSERT_TRUE(child.stop_requested());
+    ASSERT_TRUE(child.get_token().stop_requested());
+}
+
+/**
+ * A cancellable_future owns the stop source of the work, like std::jthread:
+ * the work is stopped by request_stop(), or by destroying the future.
+ */
+TEST(TestCancellation, test_cancellable_async) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // a function without stop token works as with std::async
+    auto answer = dojo::cancellable_async([](int a, int b) { return a * b; }, 6, 7);
+    ASSERT_EQ(answer.get(), 42);
+
+    // a function with a stop token can be interrupted
+    auto steps = dojo::cancellable_async([](std::stop_token const &token) {
+        auto step = 0;
+        while (dojo::this_thread::sleep_for(token, 1ms)) {
+            ++step;
+        }
+        return step;
+    });
+    std::this_thread::sleep_for(20ms);
+    steps.request_stop();
+    std::cout << "stopped after " << steps.get() << " steps" << std::endl;
+
+    // the destructor requests stop, and then waits as std::async's future does
+    auto const start = std::chrono::steady_clock::now();
+    {
+        auto abandoned = dojo::cancellable_async([](std::stop_token const &token) {
+            dojo::this_thread::sleep_for(token, 1h);
+        });
+    }
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "thread_pool.h"
+
+/**
+ * A thread pool whose tasks are cancellable through the returned futures, or
+ * all together through the pool.
+ */
+
+using namespace std::chrono_literals;
+
+TEST(TestCancellationThreadPool, test_submit) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto pool = dojo::thread_pool(2);
+
+    auto sum = pool.submit([](int a, int b) { return a + b; }, 1, 2);
+    auto with_token = pool.submit([](std::stop_token const &token, int a) {
+        return token.stop_requested() ? -1 : a;
+    }, 10);
+    auto failed = pool.submit([] { throw std::logic_error("oops"); });
+
+    ASSERT_EQ(sum.get(), 3);
+    ASSERT_EQ(with_token.get(), 10);
+    ASSERT_THROW(failed.get(), std::logic_error);
+}
+
+/**
+ * A task stopped before it starts never runs.
+ */
+TEST(TestCancellationThreadPool, test_abort_pending_task) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto pool = dojo::thread_pool(1);
+
+    // occupy the only worker
+    auto started = std::atomic<bool>(false);
+    auto blocker = pool.submit([&](std::stop_token const &token) {
+        started = true;
+        dojo::this_thread::sleep_for(token, 1h);
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    auto ran = std::atomic<bool>(false);
+    auto pending = pool.submit([&] { ran = true; });
+    pending.request_stop();
+
+    blocker.request_stop();
+    blocker.get();
+
+    ASSERT_THROW(pending.get(), dojo::operation_cancelled);
+    ASSERT_FALSE(ran);
+}
+
+/**
+ * Stopping the pool interrupts the running tasks, and aborts the pending ones,
+ * including the ones submitted afterward.
+ */
+TEST(TestCancellationThreadPool, test_stop_pool) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto pool = dojo::thread_pool(2);
+
+    auto futures = std::vector<dojo::cancellable_future<bool>>();
+    for (auto i = 0; i < 10; ++i) {
+        futures.push_back(pool.submit([](std::stop_token const &token) {
+            return dojo::this_thread::sleep_for(token, 1h);
+        }));
+    }
+
+    std::this_thread::sleep_for(10ms);
+    auto const start = std::chrono::steady_clock::now();
+    pool.request_stop();
+
+    auto interrupted = 0;
+    auto aborted = 0;
+    for (auto &future: futures) {
+        try {
+            ASSERT_FALSE(future.get());
+            ++interrupted;
+        } catch (dojo::operation_cancelled const &) {
+            ++aborted;
+        }
+    }
+    std::cout << interrupted << " interrupted, " << aborted << " aborted in "
+              << std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+              << "us" << std::endl;
+    ASSERT_EQ(interrupted + aborted, 10);
+    ASSERT_LE(interrupted, 2);
+
+    auto late = pool.submit([] { return 0; });
+    ASSERT_THROW(late.get(), dojo::operation_cancelled);
+}
+
+/**
+ * Destroying the pool stops it as well, like std::jthread.
+ */
+TEST(TestCancellationThreadPool, test_stop_on_destruction) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto future = dojo::cancellable_future<bool>();
+    auto started = std::atomic<bool>(false);
+    auto const start = std::chrono::steady_clock::now();
+    {
+        auto pool = dojo::thread_pool(1);
+        future = pool.submit([&](std::stop_token const &token) {
+            started = true;
+            return dojo::this_thread::sleep_for(token, 1h);
+        });
+        while (!started) {
+            std::this_thread::yield();
+        }
+    }
+    ASSERT_FALSE(future.get());
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <latch>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "cancellation.h"
+#include "thread_pool.h"
+#include "../../../utils.h"
+
+/**
+ * Measure how long it takes for a stop request to reach many blocked tasks.
+ *
+ * "propagate" is the cost of request_stop() itself, which runs the stop
+ * callbacks of all the tasks, i.e. wakes all of them up. "observe" is the time
+ * until the tasks have noticed the stop and returned, in percentiles over the
+ * tasks where each is timed on its own.
+ */
+
+using namespace std::chrono_literals;
+
+static constexpr auto task_count = std::size_t{1000};
+
+static void report_total(double const ns_per_op, std::size_t const ops) {
+    std::cout << "    total: " << ns_per_op * static_cast<double>(ops) / 1000.0 << "us" << std::endl;
+}
+
+/**
+ * The baseline: tasks poll the token between sleeps of 100ms, as
+ * TestJthread::test_stop_jthread does, hence observe the stop 50ms late on
+ * average.
+ */
+TEST(TestCancellationBenchmark, test_polling_threads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const count = std::size_t{16};
+    auto source = std::stop_source();
+    auto started = std::latch(static_cast<std::ptrdiff_t>(count));
+    auto threads = std::vector<std::jthread>();
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        threads.emplace_back([&started, token = source.get_token()] {
+            started.count_down();
+            while (!token.stop_requested()) {
+                std::this_thread::sleep_for(100ms);
+            }
+        });
+    }
+    started.wait();
+
+    auto const ns = benchmark("polling: propagate + observe, per task", count, [&] {
+        source.request_stop();
+        threads.clear();
+    });
+    report_total(ns, count);
+}
+
+TEST(TestCancellationBenchmark, test_cancellable_sleeping_threads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto source = std::stop_source();
+    auto started = std::latch(static_cast<std::ptrdiff_t>(task_count));
+    auto stopped = std::latch(static_cast<std::ptrdiff_t>(task_count));
+    // when each task has observed the stop
+    auto woken = std::vector<std::chrono::steady_clock::time_point>(task_count);
+    auto threads = std::vector<std::jthread>();
+    threads.reserve(task_count);
+    for (auto i = std::size_t{0}; i < task_count; ++i) {
+        threads.emplace_back([&started, &stopped, &woken = woken[i], token = source.get_token()] {
+            started.count_down();
+            dojo::this_thread::sleep_for(token, 1h);
+            woken = std::chrono::steady_clock::now();
+            stopped.count_down();
+        });
+    }
+    started.wait();
+    // give the last ones a chance to actually block
+    std::this_thread::sleep_for(50ms);
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const propagate = benchmark("sleep_for: propagate, per task", task_count, [&] {
+        source.request_stop();
+    });
+    report_total(propagate, task_count);
+    stopped.wait();
+
+    // the latency of every task, from requesting the stop to observing it
+    auto latencies = std::vector<double>();
+    latencies.reserve(task_count);
+    for (auto const w: woken) {
+        latencies.push_back(std::chrono::duration<double, std::micro>(w - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto const percentile = [&latencies](double const p) {
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+    std::cout << "  sleep_for: observe, p50 " << percentile(0.5) << "us, p99 " << percentile(0.99)
+              << "us, max " << percentile(1.0) << "us" << std::endl;
+    // waking a task up takes well under a millisecond, while the latency of
+    // the tasks grows with their turns on the cores, which is still less for
+    // most of them than the 50ms the polling ones are late on average
+    ASSERT_LT(propagate, 1'000'000.0);
+    ASSERT_LT(percentile(0.5), 50'000.0);
+}
+
+/**
+ * With a pool, most of the tasks are still pending when the stop is requested,
+ * which aborts them without running them at all.
+ */
+TEST(TestCancellationBenchmark, test_thread_pool) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto pool = dojo::thread_pool(4);
+    auto futures = std::vector<dojo::cancellable_future<bool>>();
+    futures.reserve(task_count);
+    for (auto i = std::size_t{0}; i < task_count; ++i) {
+        futures.push_back(pool.submit([](std::stop_token const &token) {
+            return dojo::this_thread::sleep_for(token, 1h);
+        }));
+    }
+    std::this_thread::sleep_for(50ms);
+
+    auto const ns = benchmark("thread_pool: propagate + observe, per task", task_count, [&] {
+        pool.request_stop();
+        for (auto &future: futures) {
+            future.wait();
+        }
+    });
+    report_total(ns, task_count);
+}
@@ -0,0 +1,276 @@
+#ifndef CPP_XX_DOJO_THREAD_POOL_H
+#define CPP_XX_DOJO_THREAD_POOL_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cancellation.h"
+#include "../metrics/metrics.h"
+
+namespace dojo {
+
+namespace detail {
+
+/**
+ * The metrics of all the thread pools, in the global registry.
+ */
+struct thread_pool_metrics {
+    metrics::counter &submitted;
+    // the tasks which have run, whether they returned or threw
+    metrics::counter &completed;
+    // the tasks stopped before they started
+    metrics::counter &aborted;
+    metrics::gauge &queued;
+    // from the submission to the start
+    metrics::histogram &queue_time;
+    metrics::histogram &run_time;
+
+    static thread_pool_metrics const &get() {
+        auto &r = metrics::registry::global();
+        static auto const m = thread_pool_metrics{
+                r.get_counter("dojo_thread_pool_submitted_total"),
+                r.get_counter("dojo_thread_pool_completed_total"),
+                r.get_counter("dojo_thread_pool_aborted_total"),
+                r.get_gauge("dojo_thread_pool_queued"),
+                r.get_histogram("dojo_thread_pool_queue_ns"),
+                r.get_histogram("dojo_thread_pool_run_ns"),
+        };
+        return m;
+    }
+};
+
+}
+
+/**
+ * @brief A fixed-size thread pool whose tasks can be cancelled
+ *
+ * Every submitted task owns a stop source, which is handed to the caller by
+ * the returned cancellable_future, and which is linked to the stop source of
+ * the pool while the task is running:
+ *   - a task stopped before it starts is aborted: it never runs, and its
+ *     future throws operation_cancelled;
+ *   - a task stopped while running is interrupted: its stop token is stopped,
+ *     which it may observe, e.g. by dojo::this_thread::sleep_for.
+ *
+ * Like std::jthread, the pool requests stop on destruction: the running tasks
+ * are interrupted and the pending tasks are aborted.
+ *
+ * The shared states of the futures, the tasks and the queue are allocated
+ * from the given memory resource, e.g. dojo::pmr::per_thread_pool_resource,
+ * which must be thread-safe and outlive the pool.
+ *
+ * The tasks are counted and timed by the metrics of the global registry,
+ * named dojo_thread_pool_*, summed over all the pools.
+ */
+class thread_pool {
+public:
+    explicit thread_pool(std::size_t const thread_count = default_thread_count(),
+                         std::pmr::memory_resource *const resource = std::pmr::get_default_resource()) :
+            m_tasks(resource) {
+        m_workers.reserve(thread_count);
+        for (auto i = std::size_t{0}; i < thread_count; ++i) {
+            m_workers.emplace_back([this, token = m_source.get_token()] { run(token); });
+        }
+    }
+
+    thread_pool(thread_pool const &) = delete;
+
+    thread_pool &operator=(thread_pool const &) = delete;
+
+    ~thread_pool() {
+        m_source.request_stop();
+        m_workers.clear();  // joins the workers
+        cancel_pending();
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_workers.size(); }
+
+    [[nodiscard]] std::stop_token get_stop_token() const { return m_source.get_token(); }
+
+    [[nodiscard]] std::pmr::memory_resource *resource() const { return m_tasks.get_allocator().resource(); }
+
+    /**
+     * Interrupt all the running tasks and abort all the pending ones. The pool
+     * accepts no more tasks after that: they will be aborted right away.
+     */
+    bool request_stop() { return m_source.request_stop(); }
+
+    /**
+     * Submit `fn(args...)`, or `fn(token, args...)` if `fn` accepts a stop
+     * token as its first parameter, in the same way as std::jthread.
+     */
+    template<typename Fn, typename... Args>
+    auto submit(Fn &&fn, Args &&...args) {
+        using result_t = detail::invoke_with_token_result_t<std::decay_t<Fn>, std::decay_t<Args>...>;
+
+        auto promise = std::promise<result_t>(std::allocator_arg, m_tasks.get_allocator());
+        auto future = promise.get_future();
+        auto source = std::stop_source();
+        detail::thread_pool_metrics::get().submitted.add();
+
+        push(task(resource(), [promise = std::move(promise), source, submitted = std::chrono::steady_clock::now(),
+                   fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)](
+                std::stop_token const &pool_token) mutable {
+            auto const &pool_metrics = detail::thread_pool_metrics::get();
+            if (pool_token.stop_requested() || source.stop_requested()) {
+                pool_metrics.aborted.add();
+                promise.set_exception(std::make_exception_ptr(operation_cancelled()));
+                return;
+            }
+            auto const started = std::chrono::steady_clock::now();
+            pool_metrics.queue_time.record(started - submitted);
+            auto const link = std::stop_callback(pool_token, [&source] { source.request_stop(); });
+            try {
+                if constexpr (std::is_void_v<result_t>) {
+                    detail::invoke_with_token(std::move(fn), source.get_token(), std::move(args)...);
+                    promise.set_value();
+                } else {
+                    promise.set_value(detail::invoke_with_token(std::move(fn), source.get_token(), std::move(args)...));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+            pool_metrics.run_time.record(std::chrono::steady_clock::now() - started);
+            pool_metrics.completed.add();
+        }));
+
+        return cancellable_future<result_t>(std::move(future), std::move(source));
+    }
+
+private:
+    /**
+     * A move-only type-erased `void(std::stop_token const &)` callable, since
+     * std::function requires the callable to be copyable while std::promise
+     * is not. The callable is allocated from the memory resource.
+     */
+    class task {
+    public:
+        task() = default;
+
+        template<typename Fn>
+        task(std::pmr::memory_resource *const resource, Fn &&fn) :
+                m_impl(std::pmr::polymorphic_allocator<>(resource).new_object<impl<std::decay_t<Fn>>>(
+                        std::forward<Fn>(fn))),
+                m_resource(resource) {}
+
+        task(task &&other) noexcept :
+                m_impl(std::exchange(other.m_impl, nullptr)), m_resource(other.m_resource) {}
+
+        task &operator=(task &&other) noexcept {
+            if (this != &other) {
+                reset();
+                m_impl = std::exchange(other.m_impl, nullptr);
+                m_resource = other.m_resource;
+            }
+            return *this;
+        }
+
+        ~task() { reset(); }
+
+        void operator()(std::stop_token const &token) { m_impl->call(token); }
+
+    private:
+        struct base {
+            virtual ~base() = default;
+
+            virtual void call(std::stop_token const &token) = 0;
+
+            // with the concrete type, which tells the size to deallocate
+            virtual void destroy(std::pmr::memory_resource *resource) = 0;
+        };
+
+        template<typename Fn>
+        struct impl final : base {
+            explicit impl(Fn fn) : fn(std::move(fn)) {}
+
+            void call(std::stop_token const &token) override { fn(token); }
+
+            void destroy(std::pmr::memory_resource *const resource) override {
+                std::pmr::polymorphic_allocator<>(resource).delete_object(this);
+            }
+
+            Fn fn;
+        };
+
+        void reset() {
+            if (m_impl != nullptr) {
+                std::exchange(m_impl, nullptr)->destroy(m_resource);
+            }
+        }
+
+        base *m_impl = nullptr;
+        std::pmr::memory_resource *m_resource = nullptr;
+    };
+
+    static std::size_t default_thread_count() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void push(task &&t) {
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            if (!m_source.stop_requested()) {
+                m_tasks.push_back(std::move(t));
+                detail::thread_pool_metrics::get().queued.add(1);
+                m_cv.notify_one();
+                return;
+            }
+        }
+        // the workers are gone or going, abort the task right away
+        t(m_source.get_token());
+    }
+
+    void run(std::stop_token const &token) {
+        while (true) {
+            auto t = task();
+            {
+                auto lock = std::unique_lock(m_mutex);
+                if (!wait(m_cv, lock, token, [this] { return !m_tasks.empty(); })) {
+                    lock.unlock();
+                    cancel_pending();
+                    return;
+                }
+                t = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                detail::thread_pool_metrics::get().queued.sub(1);
+            }
+            t(token);
+        }
+    }
+
+    void cancel_pending() {
+        auto tasks = std::pmr::deque<task>(m_tasks.get_allocator());
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            tasks.swap(m_tasks);
+        }
+        detail::thread_pool_metrics::get().queued.sub(static_cast<std::int64_t>(tasks.size()));
+        for (auto &t: tasks) {
+            t(m_source.get_token());
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::pmr::deque<task> m_tasks;
+    std::stop_source m_source;
+    std::vector<std::jthread> m_workers;
+};
+
+}
+
+#endif //CPP_XX_DOJO_THREAD_POOL_H
@@ -0,0 +1,200 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "channel.h"
+
+/**
+ * Channels of go between threads, where every send and receive blocks the
+ * thread, and a select blocks on several channels at once.
+ */
+
+using namespace std::chrono_literals;
+
+TEST(TestChannel, test_unbuffered) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto ch = dojo::channel<std::string>();
+
+    // no receiver, so nothing can be handed over, and the value stays
+    auto value = std::string("lost?");
+    ASSERT_FALSE(ch.try_send(value));
+    ASSERT_EQ(value, "lost?");
+    ASSERT_EQ(ch.try_receive(), std::nullopt);
+
+    // every send returns only once its value is received
+    auto received = std::atomic<int>(0);
+    auto sender = std::jthread([&] {
+        for (auto i = 0; i < 3; ++i) {
+            ch.send(std::to_string(i));
+            EXPECT_EQ(received.load(), i + 1);
+        }
+    });
+    for (auto i = 0; i < 3; ++i) {
+        std::this_thread::sleep_for(5ms);
+        auto const v = ch.receive();
+        ++received;
+        ASSERT_EQ(v, std::to_string(i));
+    }
+}
+
+TEST(TestChannel, test_buffered) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto ch = dojo::channel<int>(2);
+    auto value = 1;
+    ASSERT_TRUE(ch.try_send(value));
+    value = 2;
+    ASSERT_TRUE(ch.try_send(value));
+    value = 3;
+    ASSERT_FALSE(ch.try_send(value));
+    ASSERT_EQ(ch.size(), 2);
+
+    // a sender blocks on a full buffer, till a receiver makes room
+    auto sent = std::atomic<bool>(false);
+    auto sender = std::jthread([&] {
+        ch.send(3);
+        sent = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    ASSERT_FALSE(sent.load());
+    ASSERT_EQ(ch.receive(), 1);
+    sender.join();
+    ASSERT_TRUE(sent.load());
+    ASSERT_EQ(ch.receive(), 2);
+    ASSERT_EQ(ch.receive(), 3);
+}
+
+TEST(TestChannel, test_close) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the buffer is still drained after the close
+    auto buffered = dojo::channel<int>(4);
+    buffered.send(1);
+    buffered.send(2);
+    ASSERT_TRUE(buffered.close());
+    ASSERT_FALSE(buffered.close());
+    ASSERT_THROW(buffered.send(3), dojo::channel_closed);
+    ASSERT_EQ(buffered.receive(), 1);
+    ASSERT_EQ(buffered.receive(), 2);
+    ASSERT_EQ(buffered.receive(), std::nullopt);
+    ASSERT_TRUE(buffered.closed());
+
+    // the blocked receivers receive nothing, and the blocked senders throw
+    auto ch = dojo::channel<int>();
+    auto nothing = std::atomic<int>(0);
+    auto threw = std::atomic<int>(0);
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < 3; ++i) {
+            threads.emplace_back([&] { nothing += !ch.receive().has_value(); });
+        }
+        auto other = dojo::channel<int>();
+        for (auto i = 0; i < 3; ++i) {
+            threads.emplace_back([&] {
+                try {
+                    other.send(1);
+                } catch (dojo::channel_closed const &) {
+                    ++threw;
+                }
+            });
+        }
+        std::this_thread::sleep_for(20ms);
+        ch.close();
+        other.close();
+    }
+    ASSERT_EQ(nothing.load(), 3);
+    ASSERT_EQ(threw.load(), 3);
+}
+
+TEST(TestChannel, test_select) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto numbers = dojo::channel<int>(1);
+    auto words = dojo::channel<std::string>(1);
+    auto quit = dojo::channel<int>();
+
+    // nothing ready, as the default case of go
+    ASSERT_EQ(dojo::try_select(dojo::on_receive(numbers), dojo::on_receive(words)), std::nullopt);
+
+    words.send("hello");
+    auto word = std::string();
+    auto const fired = dojo::select(
+            dojo::on_receive(numbers, [](std::optional<int>) { FAIL(); }),
+            dojo::on_receive(words, [&](std::optional<std::string> w) { word = *w; }));
+    ASSERT_EQ(fired, 1);
+    ASSERT_EQ(word, "hello");
+
+    // blocked on all three, till another thread sends to one of them
+    auto sender = std::jthread([&] {
+        std::this_thread::sleep_for(10ms);
+        quit.send(0);
+    });
+    auto const index = dojo::select(dojo::on_receive(numbers), dojo::on_receive(words), dojo::on_receive(quit));
+    ASSERT_EQ(index, 2);
+
+    // a send and a receive together, where only the send is ready
+    auto const sent = dojo::select(dojo::on_send(numbers, 42), dojo::on_receive(words));
+    ASSERT_EQ(sent, 0);
+    ASSERT_EQ(numbers.receive(), 42);
+}
+
+TEST(TestChannel, test_select_fairness) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // both always ready, but neither starves
+    auto a = dojo::channel<int>(1);
+    auto b = dojo::channel<int>(1);
+    auto counts = std::array<int, 2>{};
+    for (auto i = 0; i < 1000; ++i) {
+        a.try_send(i);
+        b.try_send(i);
+        ++counts[dojo::select(dojo::on_receive(a), dojo::on_receive(b))];
+    }
+    std::cout << "  picked a " << counts[0] << " times, b " << counts[1] << " times" << std::endl;
+    ASSERT_GT(counts[0], 300);
+    ASSERT_GT(counts[1], 300);
+}
+
+TEST(TestChannel, test_many_to_many) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto ch = dojo::channel<std::uint64_t>(16);
+    auto done = dojo::channel<std::uint64_t>();
+    auto sum = std::uint64_t{0};
+    {
+        auto consumers = std::vector<std::jthread>();
+        for (auto i = 0; i < 4; ++i) {
+            consumers.emplace_back([&] {
+                auto partial = std::uint64_t{0};
+                while (auto const v = ch.receive()) {
+                    partial += *v;
+                }
+                done.send(partial);
+            });
+        }
+        {
+            auto producers = std::vector<std::jthread>();
+            for (auto p = std::uint64_t{0}; p < 4; ++p) {
+                producers.emplace_back([&, p] {
+                    for (auto i = std::uint64_t{0}; i < 10000; ++i) {
+                        ch.send(p * 10000 + i);
+                    }
+                });
+            }
+        }
+        ch.close();
+        for (auto i = 0; i < 4; ++i) {
+            sum += *done.receive();
+        }
+    }
+    ASSERT_EQ(sum, 40000 * 39999 / 2);
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "channel.h"
+#include "../coroutines/co_future.h"
+
+/**
+ * The same channels between coroutines, which suspend rather than block, and
+ * are resumed by whoever completes their sends and receives, be it another
+ * coroutine on the same thread or another thread.
+ */
+
+namespace {
+
+dojo::co_future<int> ping(dojo::channel<int> &to, dojo::channel<int> &from, int const rounds) {
+    auto last = 0;
+    for (auto i = 0; i < rounds; ++i) {
+        co_await to.async_send(last + 1);
+        last = *co_await from.async_receive();
+    }
+    to.close();
+    co_return last;
+}
+
+dojo::co_future<int> pong(dojo::channel<int> &from, dojo::channel<int> &to) {
+    auto count = 0;
+    while (auto const v = co_await from.async_receive()) {
+        ++count;
+        co_await to.async_send(*v + 1);
+    }
+    co_return count;
+}
+
+dojo::co_future<std::thread::id> receive_then_tell(dojo::channel<int> &ch, std::optional<int> &received) {
+    received = co_await ch.async_receive();
+    co_return std::this_thread::get_id();
+}
+
+dojo::co_future<std::vector<std::string>> merge(dojo::channel<int> &numbers, dojo::channel<std::string> &words) {
+    auto merged = std::vector<std::string>();
+    auto open = 2;
+    while (open > 0) {
+        co_await dojo::async_select(
+                dojo::on_receive(numbers, [&](std::optional<int> const n) {
+                    n ? merged.push_back(std::to_string(*n)) : static_cast<void>(--open);
+                }),
+                dojo::on_receive(words, [&](std::optional<std::string> w) {
+                    w ? merged.push_back(std::move(*w)) : static_cast<void>(--open);
+                }));
+    }
+    co_return merged;
+}
+
+dojo::co_future<void> send_to_closed(dojo::channel<int> &ch) {
+    co_await ch.async_send(1);
+}
+
+}
+
+TEST(TestCoChannel, test_ping_pong) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // on this thread only: each coroutine resumes the other as it completes
+    // the other's receive
+    auto to = dojo::channel<int>();
+    auto from = dojo::channel<int>();
+    auto ponged = pong(to, from);
+    auto pinged = ping(to, from, 1000);
+    ASSERT_EQ(pinged.get(), 2000);
+    ASSERT_EQ(ponged.get(), 1000);
+}
+
+TEST(TestCoChannel, test_resumed_by_thread) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto ch = dojo::channel<int>();
+    auto received = std::optional<int>();
+    auto told = receive_then_tell(ch, received);
+
+    auto sender_id = std::thread::id();
+    std::jthread([&] {
+        sender_id = std::this_thread::get_id();
+        ch.send(42);
+    }).join();
+    ASSERT_EQ(told.get(), sender_id);
+    ASSERT_EQ(received, 42);
+}
+
+TEST(TestCoChannel, test_async_select) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto numbers = dojo::channel<int>();
+    auto words = dojo::channel<std::string>();
+    auto merged = merge(numbers, words);
+
+    // a thread blocked and a coroutine suspended on the same channels
+    auto sender = std::jthread([&] {
+        words.send("one");
+        numbers.send(2);
+        words.send("three");
+        words.close();
+    });
+    numbers.send(0);
+    sender.join();
+    numbers.close();
+    auto result = merged.get();
+    // in order per channel, though interleaved in any order
+    ASSERT_LT(std::find(result.begin(), result.end(), "one"), std::find(result.begin(), result.end(), "three"));
+    std::sort(result.begin(), result.end());
+    ASSERT_EQ(result, (std::vector<std::string>{"0", "2", "one", "three"}));
+
+    auto closed = dojo::channel<int>();
+    closed.close();
+    ASSERT_THROW(send_to_closed(closed).get(), dojo::channel_closed);
+}
@@ -0,0 +1,145 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "channel.h"
+#include "../coroutines/co_future.h"
+#include "../metrics/metrics.h"
+#include "../../../utils.h"
+
+/**
+ * A pipeline of a producer, 4 stages and a consumer, linked by channels,
+ * either unbuffered, where every message is handed over from stage to stage,
+ * or buffered, where the stages run ahead of each other till the buffers
+ * fill:
+ *   - on threads, where each stage is a thread blocking on its channels;
+ *   - on coroutines, all on a single thread, where each stage is resumed by
+ *     the stage sending to it, and suspends as it sends on in turn.
+ *
+ * The throughput is the messages through the whole pipeline per second, and
+ * the latency that of a message from the producer to the consumer, recorded
+ * by a dojo::metrics::histogram.
+ *
+ * Only printed, not asserted.
+ */
+
+namespace {
+
+constexpr auto stage_count = std::size_t{4};
+
+using clock = std::chrono::steady_clock;
+
+struct message {
+    std::uint64_t sequence;
+    clock::time_point sent;
+};
+
+void report_latency(dojo::metrics::histogram const &latency) {
+    auto const s = latency.snapshot();
+    std::cout << "    latency: p50 " << s.value_at_quantile(0.5) / 1000.0 << "us, p99 "
+              << s.value_at_quantile(0.99) / 1000.0 << "us, p99.9 " << s.value_at_quantile(0.999) / 1000.0
+              << "us, max " << s.max() / 1000.0 << "us" << std::endl;
+}
+
+void run_threads(std::string const &name, std::size_t const capacity, std::size_t const count) {
+    auto channels = std::vector<std::unique_ptr<dojo::channel<message>>>();
+    for (auto i = std::size_t{0}; i <= stage_count; ++i) {
+        channels.push_back(std::make_unique<dojo::channel<message>>(capacity));
+    }
+    auto latency = dojo::metrics::histogram();
+    auto received = std::uint64_t{0};
+
+    benchmark(name.c_str(), count, [&] {
+        auto threads = std::vector<std::jthread>();
+        threads.emplace_back([&] {
+            for (auto i = std::uint64_t{0}; i < count; ++i) {
+                channels.front()->send(message{i, clock::now()});
+            }
+            channels.front()->close();
+        });
+        for (auto i = std::size_t{0}; i < stage_count; ++i) {
+            threads.emplace_back([&, i] {
+                while (auto m = channels[i]->receive()) {
+                    ++m->sequence;
+                    channels[i + 1]->send(*m);
+                }
+                channels[i + 1]->close();
+            });
+        }
+        while (auto const m = channels.back()->receive()) {
+            latency.record(clock::now() - m->sent);
+            received += m->sequence;
+        }
+    });
+    do_not_optimize(received);
+    report_latency(latency);
+}
+
+dojo::co_future<void> produce(dojo::channel<message> &out, std::size_t const count) {
+    for (auto i = std::uint64_t{0}; i < count; ++i) {
+        co_await out.async_send(message{i, clock::now()});
+    }
+    out.close();
+}
+
+dojo::co_future<void> stage(dojo::channel<message> &in, dojo::channel<message> &out) {
+    while (auto m = co_await in.async_receive()) {
+        ++m->sequence;
+        co_await out.async_send(*m);
+    }
+    out.close();
+}
+
+dojo::co_future<std::uint64_t> consume(dojo::channel<message> &in, dojo::metrics::histogram &latency) {
+    auto received = std::uint64_t{0};
+    while (auto const m = co_await in.async_receive()) {
+        latency.record(clock::now() - m->sent);
+        received += m->sequence;
+    }
+    co_return received;
+}
+
+void run_coroutines(std::string const &name, std::size_t const capacity, std::size_t const count) {
+    auto channels = std::vector<std::unique_ptr<dojo::channel<message>>>();
+    for (auto i = std::size_t{0}; i <= stage_count; ++i) {
+        channels.push_back(std::make_unique<dojo::channel<message>>(capacity));
+    }
+    auto latency = dojo::metrics::histogram();
+    auto received = std::uint64_t{0};
+
+    benchmark(name.c_str(), count, [&] {
+        // from the consumer up, so that each suspends till the one before
+        // sends to it
+        auto consumed = consume(*channels.back(), latency);
+        auto stages = std::vector<dojo::co_future<void>>();
+        for (auto i = stage_count; i > 0; --i) {
+            stages.push_back(stage(*channels[i - 1], *channels[i]));
+        }
+        produce(*channels.front(), count).get();
+        received = consumed.get();
+    });
+    do_not_optimize(received);
+    report_latency(latency);
+}
+
+}
+
+TEST(TestChannelBenchmark, test_thread_pipeline) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    run_threads("threads, unbuffered, 4 stages", 0, 20000);
+    run_threads("threads, buffered of 64, 4 stages", 64, 200000);
+}
+
+TEST(TestChannelBenchmark, test_coroutine_pipeline) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    run_coroutines("coroutines, unbuffered, 4 stages", 0, 200000);
+    run_coroutines("coroutines, buffered of 64, 4 stages", 64, 200000);
+}
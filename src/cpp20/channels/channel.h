@@ -0,0 +1,676 @@
+#ifndef CPP_XX_DOJO_CHANNEL_H
+#define CPP_XX_DOJO_CHANNEL_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace dojo {
+
+/**
+ * Thrown by a send to a closed channel, which is a bug of the program, as in
+ * go, where it panics: only the sending side should close a channel.
+ */
+class channel_closed : public std::logic_error {
+public:
+    channel_closed() : std::logic_error("send on a closed channel") {}
+};
+
+template<typename T>
+class channel;
+
+namespace detail {
+
+/**
+ * The state of a blocked select, or of a blocked send or receive, which is a
+ * select of a single case: the case which has fired, claimed by the first
+ * channel to complete one of its cases, and the party to wake up.
+ */
+class select_state {
+public:
+    static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+    void set_handle(std::coroutine_handle<> const handle) noexcept { m_handle = handle; }
+
+    bool claim(std::size_t const index) noexcept {
+        auto expected = none;
+        return m_fired.compare_exchange_strong(expected, index, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t fired() const noexcept { return m_fired.load(std::memory_order_acquire); }
+
+    /**
+     * Called under the lock of the channel which has claimed the state: a
+     * blocked thread is notified right away, while a coroutine is handed back,
+     * to be resumed once the lock is released.
+     */
+    [[nodiscard]] std::coroutine_handle<> wake() noexcept {
+        if (m_handle) {
+            return m_handle;
+        }
+        m_ready.store(true, std::memory_order_release);
+        m_ready.notify_one();
+        return {};
+    }
+
+    void wait() const noexcept { m_ready.wait(false, std::memory_order_acquire); }
+
+private:
+    std::atomic<std::size_t> m_fired{none};
+    std::atomic<bool> m_ready{false};
+    std::coroutine_handle<> m_handle;
+};
+
+/**
+ * A case of a select blocked on a channel, linked into the senders or the
+ * receivers of the channel.
+ */
+template<typename T>
+struct channel_waiter {
+    select_state *state = nullptr;
+    std::size_t index = 0;
+    // the value to send, or the slot to receive into
+    std::optional<T> *value = nullptr;
+    // a send which failed as the channel was closed
+    bool closed = false;
+    bool linked = false;
+    channel_waiter *prev = nullptr;
+    channel_waiter *next = nullptr;
+};
+
+template<typename T>
+class waiter_queue {
+public:
+    [[nodiscard]] bool empty() const noexcept { return m_head == nullptr; }
+
+    void push_back(channel_waiter<T> *const w) noexcept {
+        w->prev = m_tail;
+        w->next = nullptr;
+        (m_tail != nullptr ? m_tail->next : m_head) = w;
+        m_tail = w;
+        w->linked = true;
+    }
+
+    void remove(channel_waiter<T> *const w) noexcept {
+        (w->prev != nullptr ? w->prev->next : m_head) = w->next;
+        (w->next != nullptr ? w->next->prev : m_tail) = w->prev;
+        w->linked = false;
+    }
+
+    /**
+     * Unlink the waiters one by one till one is claimed for this channel; the
+     * others belong to selects which have fired on another channel already.
+     */
+    channel_waiter<T> *claim_first() noexcept {
+        while (m_head != nullptr) {
+            auto *const w = m_head;
+            remove(w);
+            if (w->state->claim(w->index)) {
+                return w;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    channel_waiter<T> *m_head = nullptr;
+    channel_waiter<T> *m_tail = nullptr;
+};
+
+struct no_callback {
+    template<typename... Args>
+    void operator()(Args &&...) const noexcept {}
+};
+
+}
+
+/**
+ * A case of a select receiving from a channel, which calls `fn(value)` with
+ * the value received, or with nothing if the channel is closed and drained.
+ */
+template<typename T, typename Fn = detail::no_callback>
+class receive_case {
+public:
+    receive_case(channel<T> &ch, Fn fn) : m_channel(&ch), m_fn(std::move(fn)) {}
+
+    [[nodiscard]] std::mutex &mutex() const noexcept { return m_channel->m_mutex; }
+
+    bool try_complete(std::coroutine_handle<> &resume) { return m_channel->receive_locked(m_value, resume); }
+
+    void enqueue(detail::select_state &state, std::size_t const index) noexcept {
+        m_waiter.state = &state;
+        m_waiter.index = index;
+        m_waiter.value = &m_value;
+        m_channel->m_receivers.push_back(&m_waiter);
+    }
+
+    void dequeue() noexcept {
+        if (m_waiter.linked) {
+            m_channel->m_receivers.remove(&m_waiter);
+        }
+    }
+
+    void finish() { std::invoke(m_fn, std::move(m_value)); }
+
+    [[nodiscard]] std::optional<T> &value() noexcept { return m_value; }
+
+private:
+    channel<T> *m_channel;
+    Fn m_fn;
+    std::optional<T> m_value;
+    detail::channel_waiter<T> m_waiter;
+};
+
+/**
+ * A case of a select sending a value to a channel, which calls `fn()` once
+ * sent, or throws channel_closed if the channel is closed.
+ */
+template<typename T, typename Fn = detail::no_callback>
+class send_case {
+public:
+    send_case(channel<T> &ch, T value, Fn fn) : m_channel(&ch), m_fn(std::move(fn)), m_value(std::move(value)) {}
+
+    [[nodiscard]] std::mutex &mutex() const noexcept { return m_channel->m_mutex; }
+
+    bool try_complete(std::coroutine_handle<> &resume) {
+        return m_channel->send_locked(m_value, m_waiter.closed, resume);
+    }
+
+    void enqueue(detail::select_state &state, std::size_t const index) noexcept {
+        m_waiter.state = &state;
+        m_waiter.index = index;
+        m_waiter.value = &m_value;
+        m_channel->m_senders.push_back(&m_waiter);
+    }
+
+    void dequeue() noexcept {
+        if (m_waiter.linked) {
+            m_channel->m_senders.remove(&m_waiter);
+        }
+    }
+
+    void finish() {
+        if (m_waiter.closed) {
+            throw channel_closed();
+        }
+        std::invoke(m_fn);
+    }
+
+    /**
+     * The value, still there if it hasn't been sent.
+     */
+    [[nodiscard]] std::optional<T> &value() noexcept { return m_value; }
+
+private:
+    channel<T> *m_channel;
+    Fn m_fn;
+    std::optional<T> m_value;
+    detail::channel_waiter<T> m_waiter;
+};
+
+template<typename T, typename Fn = detail::no_callback>
+receive_case<T, Fn> on_receive(channel<T> &ch, Fn fn = {}) {
+    return receive_case<T, Fn>(ch, std::move(fn));
+}
+
+template<typename T, typename Fn = detail::no_callback>
+send_case<T, Fn> on_send(channel<T> &ch, std::type_identity_t<T> value, Fn fn = {}) {
+    return send_case<T, Fn>(ch, std::move(value), std::move(fn));
+}
+
+namespace detail {
+
+/**
+ * The first case tried by a select of this thread, which rotates, so that
+ * no case starves while another is always ready; go picks one at random.
+ */
+inline std::size_t next_select_start() noexcept {
+    thread_local auto start = std::size_t{0};
+    return start++;
+}
+
+/**
+ * A select of the cases, with the locks of all their channels held while it
+ * tries the cases, or enqueues them all, and again while it dequeues them
+ * after being woken up, as the select of go does.
+ */
+template<typename... Cases>
+class selector {
+public:
+    static constexpr auto none = select_state::none;
+
+    explicit selector(Cases &&...cases) : m_cases(std::move(cases)...) {
+        // distinct, and always locked in the order of their addresses, so
+        // that two selects over the same channels never deadlock
+        std::apply([this](auto &...c) { m_mutexes = {&c.mutex()...}; }, m_cases);
+        std::sort(m_mutexes.begin(), m_mutexes.end(), std::less<>());
+        m_mutex_count = static_cast<std::size_t>(std::unique(m_mutexes.begin(), m_mutexes.end()) - m_mutexes.begin());
+    }
+
+    selector(selector const &) = delete;
+
+    selector &operator=(selector const &) = delete;
+
+    template<std::size_t I>
+    auto &get() noexcept { return std::get<I>(m_cases); }
+
+    void lock() {
+        for (auto i = std::size_t{0}; i < m_mutex_count; ++i) {
+            m_mutexes[i]->lock();
+        }
+    }
+
+    void unlock() noexcept {
+        for (auto i = m_mutex_count; i > 0; --i) {
+            m_mutexes[i - 1]->unlock();
+        }
+    }
+
+    /**
+     * Complete the first case ready, with the locks held.
+     *
+     * @return the index of the case, or none
+     */
+    std::size_t try_locked(std::coroutine_handle<> &resume) {
+        auto const start = sizeof...(Cases) > 1 ? next_select_start() % sizeof...(Cases) : 0;
+        for (auto i = std::size_t{0}; i < sizeof...(Cases); ++i) {
+            auto const index = (start + i) % sizeof...(Cases);
+            if (try_case(index, resume)) {
+                return index;
+            }
+        }
+        return none;
+    }
+
+    void enqueue_locked(select_state &state) noexcept {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (std::get<I>(m_cases).enqueue(state, I), ...);
+        }(std::index_sequence_for<Cases...>{});
+    }
+
+    void dequeue_locked() noexcept {
+        std::apply([](auto &...c) { (c.dequeue(), ...); }, m_cases);
+    }
+
+    /**
+     * Call the callback of the case completed, without any lock held.
+     */
+    void finish(std::size_t const index) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            static_cast<void>(((I == index ? (std::get<I>(m_cases).finish(), true) : false) || ...));
+        }(std::index_sequence_for<Cases...>{});
+    }
+
+    /**
+     * Complete a case if any is ready, without blocking.
+     */
+    std::size_t try_select() {
+        auto resume = std::coroutine_handle<>();
+        lock();
+        auto const index = try_locked(resume);
+        unlock();
+        if (resume) {
+            resume.resume();
+        }
+        if (index != none) {
+            finish(index);
+        }
+        return index;
+    }
+
+    /**
+     * Block the thread till a case completes.
+     */
+    std::size_t select() {
+        auto resume = std::coroutine_handle<>();
+        lock();
+        auto index = try_locked(resume);
+        if (index != none) {
+            unlock();
+            if (resume) {
+                resume.resume();
+            }
+        } else {
+            auto state = select_state();
+            enqueue_locked(state);
+            unlock();
+            state.wait();
+            // which also waits for the channel waking this thread up to
+            // release its lock, before the state goes
+            lock();
+            dequeue_locked();
+            unlock();
+            index = state.fired();
+        }
+        finish(index);
+        return index;
+    }
+
+private:
+    bool try_case(std::size_t const index, std::coroutine_handle<> &resume) {
+        auto done = false;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            static_cast<void>(((I == index ? (done = std::get<I>(m_cases).try_complete(resume), true) : false) || ...));
+        }(std::index_sequence_for<Cases...>{});
+        return done;
+    }
+
+    std::tuple<Cases...> m_cases;
+    std::array<std::mutex *, sizeof...(Cases)> m_mutexes{};
+    std::size_t m_mutex_count = 0;
+};
+
+}
+
+/**
+ * The awaitable of a select in a coroutine, which resumes with the index of
+ * the case completed, on the thread completing it.
+ */
+template<typename... Cases>
+class select_awaitable {
+public:
+    explicit select_awaitable(Cases &&...cases) : m_selector(std::move(cases)...) {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> const handle) {
+        auto resume = std::coroutine_handle<>();
+        m_selector.lock();
+        m_index = m_selector.try_locked(resume);
+        if (m_index != select_state_none) {
+            m_selector.unlock();
+            if (resume) {
+                resume.resume();
+            }
+            return false;
+        }
+        m_state.set_handle(handle);
+        m_selector.enqueue_locked(m_state);
+        m_selector.unlock();
+        // this coroutine may have been resumed, and this awaitable be gone,
+        // by another thread already
+        return true;
+    }
+
+    std::size_t await_resume() {
+        if (m_index == select_state_none) {
+            m_selector.lock();
+            m_selector.dequeue_locked();
+            m_selector.unlock();
+            m_index = m_state.fired();
+        }
+        m_selector.finish(m_index);
+        return m_index;
+    }
+
+protected:
+    static constexpr auto select_state_none = detail::select_state::none;
+
+    detail::selector<Cases...> m_selector;
+    detail::select_state m_state;
+    std::size_t m_index = select_state_none;
+};
+
+/**
+ * Block till one of the cases completes, calling its callback, as the
+ * select statement of go.
+ *
+ * If several cases are ready, they are tried from a rotating start, so that
+ * none starves.
+ *
+ * @return the index of the case completed
+ * @throw channel_closed if a case sending to a closed channel is completed
+ */
+template<typename... Cases>
+std::size_t select(Cases &&...cases) {
+    auto s = detail::selector<std::decay_t<Cases>...>(std::forward<Cases>(cases)...);
+    return s.select();
+}
+
+/**
+ * Complete one of the cases if any is ready, otherwise return nothing right
+ * away, as a select of go with a default case.
+ */
+template<typename... Cases>
+std::optional<std::size_t> try_select(Cases &&...cases) {
+    auto s = detail::selector<std::decay_t<Cases>...>(std::forward<Cases>(cases)...);
+    auto const index = s.try_select();
+    return index != detail::select_state::none ? std::optional(index) : std::nullopt;
+}
+
+/**
+ * `co_await async_select(cases...)` in a coroutine, the same as select() but
+ * suspending the coroutine rather than blocking the thread.
+ */
+template<typename... Cases>
+select_awaitable<std::decay_t<Cases>...> async_select(Cases &&...cases) {
+    return select_awaitable<std::decay_t<Cases>...>(std::forward<Cases>(cases)...);
+}
+
+/**
+ * @brief A channel of go: a queue of values, passed from the senders to the
+ * receivers in order, with backpressure
+ *
+ *   - an unbuffered channel, of capacity 0, hands every value over from a
+ *     sender to a receiver directly: each blocks till the other comes;
+ *   - a buffered channel lets the senders go on till its buffer is full, and
+ *     the receivers till it's empty;
+ *   - once closed, the senders throw channel_closed, and the receivers drain
+ *     the buffer then receive nothing.
+ *
+ * The blocked senders and receivers queue in the channel in order, and both
+ * threads and coroutines can block: a thread waits on an atomic, while a
+ * coroutine is resumed by whichever thread completes its send or receive,
+ * right there, after the lock of the channel is released. And a select()
+ * blocks on several channels at once.
+ *
+ * A channel is shared by reference, and must outlive whatever is blocked on
+ * it.
+ *
+ * reference from https://go.dev/ref/spec#Channel_types
+ * reference from https://go.dev/src/runtime/chan.go
+ * reference from https://go.dev/src/runtime/select.go
+ */
+template<typename T>
+class channel {
+public:
+    explicit channel(std::size_t const capacity = 0) : m_capacity(capacity) {}
+
+    channel(channel const &) = delete;
+
+    channel &operator=(channel const &) = delete;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+    /**
+     * The values buffered.
+     */
+    [[nodiscard]] std::size_t size() const {
+        auto const lock = std::lock_guard(m_mutex);
+        return m_buffer.size();
+    }
+
+    [[nodiscard]] bool closed() const {
+        auto const lock = std::lock_guard(m_mutex);
+        return m_closed;
+    }
+
+    /**
+     * @throw channel_closed if the channel is closed, or gets closed while
+     * the send is blocked
+     */
+    void send(T value) {
+        auto s = detail::selector<send_case<T>>(send_case<T>(*this, std::move(value), {}));
+        s.select();
+    }
+
+    /**
+     * @return the value received, or nothing if the channel is closed and
+     * drained
+     */
+    std::optional<T> receive() {
+        auto s = detail::selector<receive_case<T>>(receive_case<T>(*this, {}));
+        s.select();
+        return std::move(s.template get<0>().value());
+    }
+
+    /**
+     * Send the value if it can be without blocking, otherwise leave it as it
+     * is.
+     */
+    bool try_send(T &value) {
+        auto s = detail::selector<send_case<T>>(send_case<T>(*this, std::move(value), {}));
+        if (s.try_select() != detail::select_state::none) {
+            return true;
+        }
+        value = std::move(*s.template get<0>().value());
+        return false;
+    }
+
+    /**
+     * @return a value if one can be received without blocking, or nothing,
+     * also if the channel is closed and drained, which closed() tells apart
+     */
+    std::optional<T> try_receive() {
+        auto s = detail::selector<receive_case<T>>(receive_case<T>(*this, {}));
+        s.try_select();
+        return std::move(s.template get<0>().value());
+    }
+
+    /**
+     * `co_await ch.async_send(value)`, the same as send() but suspending.
+     */
+    select_awaitable<send_case<T>> async_send(T value) {
+        return select_awaitable<send_case<T>>(send_case<T>(*this, std::move(value), {}));
+    }
+
+    class receive_awaitable : public select_awaitable<receive_case<T>> {
+    public:
+        using select_awaitable<receive_case<T>>::select_awaitable;
+
+        std::optional<T> await_resume() {
+            select_awaitable<receive_case<T>>::await_resume();
+            return std::move(this->m_selector.template get<0>().value());
+        }
+    };
+
+    /**
+     * `co_await ch.async_receive()`, the same as receive() but suspending.
+     */
+    receive_awaitable async_receive() { return receive_awaitable(receive_case<T>(*this, {})); }
+
+    /**
+     * Close the channel, waking up all the blocked senders, which throw
+     * channel_closed, and the blocked receivers, which receive nothing.
+     *
+     * @return false if already closed
+     */
+    bool close() {
+        auto resumes = std::deque<std::coroutine_handle<>>();
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            if (m_closed) {
+                return false;
+            }
+            m_closed = true;
+            while (auto *const w = m_receivers.claim_first()) {
+                if (auto const h = w->state->wake()) {
+                    resumes.push_back(h);
+                }
+            }
+            while (auto *const w = m_senders.claim_first()) {
+                w->closed = true;
+                if (auto const h = w->state->wake()) {
+                    resumes.push_back(h);
+                }
+            }
+        }
+        for (auto const h: resumes) {
+            h.resume();
+        }
+        return true;
+    }
+
+private:
+    template<typename, typename>
+    friend class receive_case;
+
+    template<typename, typename>
+    friend class send_case;
+
+    /**
+     * Receive into `slot` if a value is buffered or a sender is blocked, or
+     * receive nothing if closed; with the lock held.
+     *
+     * @return false if the receive has to block
+     */
+    bool receive_locked(std::optional<T> &slot, std::coroutine_handle<> &resume) {
+        if (!m_buffer.empty()) {
+            slot.emplace(std::move(m_buffer.front()));
+            m_buffer.pop_front();
+            // a blocked sender takes the room, in order
+            if (auto *const w = m_senders.claim_first()) {
+                m_buffer.push_back(std::move(**w->value));
+                resume = w->state->wake();
+            }
+            return true;
+        }
+        if (auto *const w = m_senders.claim_first()) {
+            slot.emplace(std::move(**w->value));
+            resume = w->state->wake();
+            return true;
+        }
+        if (m_closed) {
+            slot.reset();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Send `*value` to a blocked receiver or into the buffer, or fail as the
+     * channel is closed; with the lock held.
+     *
+     * @return false if the send has to block
+     */
+    bool send_locked(std::optional<T> &value, bool &closed, std::coroutine_handle<> &resume) {
+        if (m_closed) {
+            closed = true;
+            return true;
+        }
+        if (auto *const w = m_receivers.claim_first()) {
+            w->value->emplace(std::move(*value));
+            resume = w->state->wake();
+            return true;
+        }
+        if (m_buffer.size() < m_capacity) {
+            m_buffer.push_back(std::move(*value));
+            return true;
+        }
+        return false;
+    }
+
+    mutable std::mutex m_mutex;
+    std::size_t const m_capacity;
+    std::deque<T> m_buffer;
+    bool m_closed = false;
+    // only either is non-empty at a time, except for the waiters of the
+    // selects which have fired elsewhere and not dequeued yet
+    detail::waiter_queue<T> m_senders;
+    detail::waiter_queue<T> m_receivers;
+};
+
+}
+
+#endif //CPP_XX_DOJO_CHANNEL_H
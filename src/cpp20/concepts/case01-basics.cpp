@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 
+#include "concepts.h"
+
 /**
  * Class templates, function templates,
  * and non-template functions (typically members of class templates)
@@ -25,46 +27,8 @@
 
 using namespace std::literals;
 
-/**
- * First way to define a concept.
- *
- * Define a concept that requires:
- * 1. `T` to be comparable using `==` and `!=`, and
- * 2. the result type being bool.
- */
-template<typename T>
-concept EqComparable = requires(T a, T b) {
-    // The 'requires' clause contains one or more constraints separated by commas.
-    // Each constraint is satisfied by requiring the expression to be valid,
-    // without needing to be true.
-
-    // There are two ways to specify the constraints:
-    // 1. Constraint the expression to be valid.
-    //    This constraint is satisfied if the expression is valid, without needing to be true.
-    a == b;
-    a != b;
-    // 2. Constraint the expression to be valid, and the result type meets a concept.
-    //    This constraint is satisfied if the expression enclosed in '{' and '}' is valid
-    //    and the expression's type must meet the concept specified after '->'.
-    //    The concept should be partially bounded with except one parameter type not specified.
-    { a == b } -> std::same_as<bool>;
-    { a != b } -> std::same_as<bool>;
-};
-
-/**
- * Second way to define a concept.
- *
- * Define a concept by composing other concepts or type traits
- */
-template<typename T>
-concept IntEqComparable =
-    // composed with a concept:
-    EqComparable<T> &&
-    // composed with a constexpr evaluating to true,
-    //   such as a type trait;
-    std::is_integral_v<T> &&
-    //   or as a function call
-    sizeof(T) > 1;
+// See concepts.h for the two ways to define a concept. The concepts live in a
+// header so that other cases (e.g. flat-hash-map) can constrain on them too.
 
 /**
  * First way to require/use a concept.
@@ -122,3 +86,18 @@ TEST(TestConcepts, test_concepts_on_functions) { // NOLINT(cert-err58-cpp)
     // following line won't be compiled since double is not integral
     // fn_int_equality_compare<double>(2, 2);
 }
+
+TEST(TestConcepts, test_concepts_for_hashing) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // int and std::string have both `==`/`!=` and a std::hash specialization
+    EXPECT_TRUE(Hashable<int>);
+    EXPECT_TRUE(Hashable<std::string>);
+
+    // std::vector<int> is comparable, but std::hash is not specialized for it
+    EXPECT_FALSE(Hashable<std::vector<int>>);
+
+    // a concept can constrain more than one type at once
+    EXPECT_TRUE((HashFor<std::hash<std::string_view>, std::string_view>));
+    EXPECT_FALSE((HashFor<std::hash<int>, std::string>));
+}
@@ -0,0 +1,71 @@
+#ifndef CPP_XX_DOJO_CONCEPTS_H
+#define CPP_XX_DOJO_CONCEPTS_H
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+/**
+ * First way to define a concept.
+ *
+ * Define a concept that requires:
+ * 1. `T` to be comparable using `==` and `!=`, and
+ * 2. the result type being bool.
+ */
+template<typename T>
+concept EqComparable = requires(T a, T b) {
+    // The 'requires' clause contains one or more constraints separated by commas.
+    // Each constraint is satisfied by requiring the expression to be valid,
+    // without needing to be true.
+
+    // There are two ways to specify the constraints:
+    // 1. Constraint the expression to be valid.
+    //    This constraint is satisfied if the expression is valid, without needing to be true.
+    a == b;
+    a != b;
+    // 2. Constraint the expression to be valid, and the result type meets a concept.
+    //    This constraint is satisfied if the expression enclosed in '{' and '}' is valid
+    //    and the expression's type must meet the concept specified after '->'.
+    //    The concept should be partially bounded with except one parameter type not specified.
+    { a == b } -> std::same_as<bool>;
+    { a != b } -> std::same_as<bool>;
+};
+
+/**
+ * Second way to define a concept.
+ *
+ * Define a concept by composing other concepts or type traits
+ */
+template<typename T>
+concept IntEqComparable =
+    // composed with a concept:
+    EqComparable<T> &&
+    // composed with a constexpr evaluating to true,
+    //   such as a type trait;
+    std::is_integral_v<T> &&
+    //   or as a function call
+    sizeof(T) > 1;
+
+/**
+ * Define a concept that requires `H` to be a hash function object for `K`:
+ * invoking it on a const key must be valid and yield something convertible to
+ * std::size_t.
+ *
+ * The hash function object and the key type are constrained together since a
+ * transparent hash (such as one hashing both std::string and std::string_view)
+ * can be a hash for more than one key type.
+ */
+template<typename H, typename K>
+concept HashFor = requires(H const &h, K const &k) {
+    { h(k) } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * Define a concept that requires `K` to be usable as a key of a hash container
+ * with `std::hash` as the hash function.
+ */
+template<typename K>
+concept Hashable = EqComparable<K> && HashFor<std::hash<K>, K>;
+
+#endif //CPP_XX_DOJO_CONCEPTS_H
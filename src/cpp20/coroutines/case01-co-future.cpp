@@ -0,0 +1,64 @@
+#include <coroutine>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "co_future.h"
+
+/**
+ * A coroutine returning a co_future runs eagerly, and hands its result or its
+ * exception over to whoever holds the future.
+ */
+
+namespace {
+
+/**
+ * Resume the awaiting coroutine on a thread of its own.
+ */
+struct resume_on_new_thread {
+    std::thread::id *id;
+
+    bool await_ready() { return false; }
+
+    void await_suspend(std::coroutine_handle<> const handle) {
+        std::thread([handle] { handle.resume(); }).detach();
+    }
+
+    void await_resume() { *id = std::this_thread::get_id(); }
+};
+
+dojo::co_future<int> add(int const a, int const b) {
+    co_return a + b;
+}
+
+dojo::co_future<int> add_elsewhere(int const a, int const b, std::thread::id &resumed_on) {
+    co_await resume_on_new_thread{&resumed_on};
+    co_return a + b;
+}
+
+dojo::co_future<void> fail() {
+    throw std::runtime_error("oops");
+    co_return;
+}
+
+}
+
+TEST(TestCoFuture, test_result) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    ASSERT_EQ(add(1, 2).get(), 3);
+
+    auto resumed_on = std::thread::id();
+    auto elsewhere = add_elsewhere(3, 4, resumed_on);
+    ASSERT_EQ(elsewhere.get(), 7);
+    ASSERT_NE(resumed_on, std::this_thread::get_id());
+}
+
+TEST(TestCoFuture, test_exception) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto failed = fail();
+    ASSERT_THROW(failed.get(), std::runtime_error);
+}
@@ -0,0 +1,83 @@
+#ifndef CPP_XX_DOJO_CO_FUTURE_H
+#define CPP_XX_DOJO_CO_FUTURE_H
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <utility>
+
+namespace dojo {
+
+template<typename T>
+class co_future;
+
+namespace detail {
+
+template<typename T>
+class co_promise_base {
+public:
+    template<typename U>
+    void return_value(U &&value) { m_promise.set_value(std::forward<U>(value)); }
+
+protected:
+    std::promise<T> m_promise;
+};
+
+template<>
+class co_promise_base<void> {
+public:
+    void return_void() { m_promise.set_value(); }
+
+protected:
+    std::promise<void> m_promise;
+};
+
+}
+
+/**
+ * @brief The simplest return type of a coroutine: a std::future of its result
+ *
+ * The coroutine starts right away on the calling thread, like a plain call,
+ * and goes on wherever whatever it awaits resumes it, e.g. on the thread
+ * which completes an i/o. Its frame is freed as it finishes, having set the
+ * result, so nobody has to keep or destroy the handle.
+ *
+ * reference from https://en.cppreference.com/w/cpp/language/coroutines
+ */
+template<typename T>
+class co_future {
+public:
+    class promise_type : public detail::co_promise_base<T> {
+    public:
+        co_future get_return_object() { return co_future(this->m_promise.get_future()); }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { this->m_promise.set_exception(std::current_exception()); }
+    };
+
+    co_future() = default;
+
+    [[nodiscard]] bool valid() const { return m_future.valid(); }
+
+    T get() { return m_future.get(); }
+
+    void wait() const { m_future.wait(); }
+
+    template<typename Rep, typename Period>
+    std::future_status wait_for(std::chrono::duration<Rep, Period> const &duration) const {
+        return m_future.wait_for(duration);
+    }
+
+private:
+    explicit co_future(std::future<T> future) : m_future(std::move(future)) {}
+
+    std::future<T> m_future;
+};
+
+}
+
+#endif //CPP_XX_DOJO_CO_FUTURE_H
@@ -0,0 +1,186 @@
+#include <charconv>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include "expected.h"
+
+/**
+ * An expected holds either a value or the error which prevented it, to be
+ * returned rather than thrown, and chained by the monadic operations.
+ */
+
+namespace {
+
+dojo::expected<int, std::errc> parse_int(std::string_view const text) {
+    auto value = 0;
+    auto const [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc()) {
+        return dojo::unexpected(ec);
+    }
+    if (end != text.data() + text.size()) {
+        return dojo::unexpected(std::errc::invalid_argument);
+    }
+    return value;
+}
+
+dojo::expected<int, std::errc> check_port(int const port) {
+    if (port <= 0 || port > 65535) {
+        return dojo::unexpected(std::errc::result_out_of_range);
+    }
+    return port;
+}
+
+/**
+ * Throws when constructed of a negative, or when copied while told to, and
+ * moves without promising not to throw, which leaves expected no way but to
+ * back the old alternative up; counts the live instances.
+ */
+struct fragile {
+    static inline auto live = 0;
+    static inline auto throw_on_copy = false;
+
+    int value;
+
+    fragile(int const v) : value(v) {  // NOLINT(google-explicit-constructor)
+        if (v < 0) {
+            throw std::invalid_argument("negative");
+        }
+        ++live;
+    }
+
+    fragile(fragile const &other) : value(other.value) {
+        if (throw_on_copy) {
+            throw std::runtime_error("copy");
+        }
+        ++live;
+    }
+
+    fragile(fragile &&other) noexcept(false) : value(other.value) { ++live; }
+
+    fragile &operator=(fragile const &) = default;
+
+    fragile &operator=(fragile &&) = default;
+
+    ~fragile() { --live; }
+};
+
+}
+
+TEST(TestExpected, test_value_or_error) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const ok = parse_int("42");
+    ASSERT_TRUE(ok.has_value());
+    ASSERT_EQ(42, *ok);
+    ASSERT_EQ(42, ok.value());
+    ASSERT_EQ(ok, 42);
+
+    auto const bad = parse_int("4x");
+    ASSERT_FALSE(bad);
+    ASSERT_EQ(std::errc::invalid_argument, bad.error());
+    ASSERT_EQ(bad, dojo::unexpected(std::errc::invalid_argument));
+    ASSERT_EQ(7, bad.value_or(7));
+    ASSERT_THROW(static_cast<void>(bad.value()), dojo::bad_expected_access<std::errc>);
+
+    auto copy = bad;
+    ASSERT_EQ(copy, bad);
+    copy = 3;
+    ASSERT_EQ(copy, 3);
+    copy = dojo::unexpected(std::errc::invalid_argument);
+    ASSERT_EQ(copy, bad);
+}
+
+TEST(TestExpected, test_monadic_chaining) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const port = [](std::string_view const text) {
+        return parse_int(text)
+                .and_then(check_port)
+                .transform([](int const p) { return "port " + std::to_string(p); })
+                .transform_error([](std::errc const e) { return std::make_error_code(e).message(); });
+    };
+    ASSERT_EQ("port 8080", port("8080").value());
+    ASSERT_FALSE(port("80800").has_value());
+    ASSERT_FALSE(port("http").has_value());
+
+    // or_else recovers from the error, or passes it on
+    auto const recovered = parse_int("oops").or_else([](std::errc) {
+        return dojo::expected<int, std::errc>(8080);
+    });
+    ASSERT_EQ(8080, *recovered);
+    auto const passed_on = parse_int("-1").and_then(check_port).or_else([](std::errc const e) {
+        return dojo::expected<int, std::errc>(dojo::unexpect, e);
+    });
+    ASSERT_EQ(std::errc::result_out_of_range, passed_on.error());
+}
+
+TEST(TestExpected, test_void_and_owning) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // only may fail
+    auto const done = dojo::expected<void, std::string>();
+    ASSERT_TRUE(done.has_value());
+    auto const failed = dojo::expected<void, std::string>(dojo::unexpect, "disk full");
+    ASSERT_EQ("disk full", failed.error());
+    ASSERT_EQ(2, done.transform([] { return 2; }).value());
+    ASSERT_EQ("disk full!", failed.transform_error([](std::string const &e) { return e + "!"; }).error());
+
+    // move-only values, destroyed exactly once
+    auto const tracker = std::make_shared<int>(0);
+    {
+        auto owning = dojo::expected<std::shared_ptr<int>, std::string>(tracker);
+        ASSERT_EQ(2, tracker.use_count());
+        auto moved = std::move(owning);
+        ASSERT_EQ(2, tracker.use_count());
+        moved = dojo::unexpected(std::string("gone"));
+        ASSERT_EQ(1, tracker.use_count());
+        auto unique = dojo::expected<std::unique_ptr<int>, int>(std::make_unique<int>(5));
+        auto taken = std::move(unique).and_then([](std::unique_ptr<int> p) {
+            return dojo::expected<int, int>(*p);
+        });
+        ASSERT_EQ(5, *taken);
+    }
+    ASSERT_EQ(1, tracker.use_count());
+
+    static_assert(std::is_trivially_copyable_v<dojo::expected<int, std::errc>>);
+    static_assert(!std::is_copy_constructible_v<dojo::expected<std::unique_ptr<int>, int>>);
+}
+
+/**
+ * Switching between a value and an error keeps the old one when constructing
+ * the new one throws, so the expected is still whole and destroyed once.
+ */
+TEST(TestExpected, test_throwing_constructor) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    {
+        auto failed = dojo::expected<fragile, std::string>(dojo::unexpect, "seven");
+        ASSERT_THROW(failed = -1, std::invalid_argument);
+        ASSERT_FALSE(failed.has_value());
+        ASSERT_EQ("seven", failed.error());
+        ASSERT_THROW(failed.emplace(-1), std::invalid_argument);
+        ASSERT_EQ("seven", failed.error());
+
+        auto const source = dojo::expected<fragile, std::string>(fragile(3));
+        fragile::throw_on_copy = true;
+        ASSERT_THROW(failed = source, std::runtime_error);
+        fragile::throw_on_copy = false;
+        ASSERT_EQ("seven", failed.error());
+
+        failed = source;
+        ASSERT_EQ(3, failed->value);
+        ASSERT_EQ(2, fragile::live);
+
+        auto succeeded = dojo::expected<std::string, fragile>("five");
+        ASSERT_THROW(succeeded = dojo::unexpected(-1), std::invalid_argument);
+        ASSERT_TRUE(succeeded.has_value());
+        ASSERT_EQ("five", *succeeded);
+    }
+    ASSERT_EQ(0, fragile::live);
+}
@@ -0,0 +1,69 @@
+#include <future>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "expected_future.h"
+
+/**
+ * An expected_promise hands over a value or an error to its future, which
+ * returns it as an expected rather than throwing.
+ */
+
+TEST(TestExpectedFuture, test_value_and_error) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto promise = dojo::expected_promise<std::string>();
+    auto future = promise.get_future();
+    ASSERT_TRUE(future.valid());
+    ASSERT_FALSE(future.is_ready());
+
+    auto producer = std::jthread([&] { promise.set_value("hello"); });
+    ASSERT_EQ("hello", future.get().value());
+    ASSERT_FALSE(future.valid());
+
+    auto failing = dojo::expected_promise<int>();
+    auto failed = failing.get_future();
+    std::jthread([&] {
+        failing.set_error(std::make_error_code(std::errc::timed_out));
+    }).join();
+    auto const result = failed.get();
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(std::errc::timed_out, result.error());
+}
+
+TEST(TestExpectedFuture, test_misuses) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto promise = dojo::expected_promise<void, std::string>();
+    auto future = promise.get_future();
+    ASSERT_FALSE(promise.get_future().valid());
+
+    ASSERT_TRUE(promise.set_value());
+    ASSERT_FALSE(promise.set_error("too late"));
+    ASSERT_TRUE(future.is_ready());
+    ASSERT_TRUE(future.get().has_value());
+}
+
+TEST(TestExpectedFuture, test_broken_promise) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto future = dojo::expected_future<int>();
+    {
+        auto promise = dojo::expected_promise<int>();
+        future = promise.get_future();
+    }
+    auto const result = future.get();
+    ASSERT_EQ(std::future_errc::broken_promise, result.error());
+
+    // an error type which can't tell
+    auto other = dojo::expected_future<int, int>();
+    {
+        auto promise = dojo::expected_promise<int, int>();
+        other = promise.get_future();
+    }
+    ASSERT_EQ(0, other.get().error());
+}
@@ -0,0 +1,153 @@
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "expected.h"
+#include "expected_future.h"
+#include "../../../utils.h"
+
+/**
+ * The cost of passing an error from a promise to its future:
+ *   - as an exception through std::future, which allocates and throws it,
+ *     captures it in a std::exception_ptr, and rethrows it on get();
+ *   - as an expected through std::future, which still pays for the shared
+ *     state of the standard library, but throws nothing;
+ *   - as an expected through dojo::expected_future.
+ *
+ * The value path is measured as well, as the baseline of the shared state.
+ * The promise and the future are on the same thread, which isolates the cost
+ * of the error channel from the cost of waking up another thread, and then on
+ * several threads at once, since unwinding may take a global lock.
+ */
+
+namespace {
+
+using result_t = dojo::expected<int, std::error_code>;
+
+int via_exception(std::size_t const i, bool const fail) {
+    auto promise = std::promise<int>();
+    auto future = promise.get_future();
+    if (fail) {
+        promise.set_exception(std::make_exception_ptr(std::system_error(std::make_error_code(std::errc::timed_out))));
+    } else {
+        promise.set_value(static_cast<int>(i));
+    }
+    try {
+        return future.get();
+    } catch (std::system_error const &e) {
+        return -e.code().value();
+    }
+}
+
+int via_std_future(std::size_t const i, bool const fail) {
+    auto promise = std::promise<result_t>();
+    auto future = promise.get_future();
+    if (fail) {
+        promise.set_value(dojo::unexpected(std::make_error_code(std::errc::timed_out)));
+    } else {
+        promise.set_value(static_cast<int>(i));
+    }
+    auto const result = future.get();
+    return result ? *result : -result.error().value();
+}
+
+int via_expected_future(std::size_t const i, bool const fail) {
+    auto promise = dojo::expected_promise<int>();
+    auto future = promise.get_future();
+    if (fail) {
+        promise.set_error(std::make_error_code(std::errc::timed_out));
+    } else {
+        promise.set_value(static_cast<int>(i));
+    }
+    auto const result = future.get();
+    return result ? *result : -result.error().value();
+}
+
+template<typename Fn>
+void round_trips(std::string const &name, int const threads, std::size_t const per_thread, bool const fail, Fn fn) {
+    benchmark(name.c_str(), per_thread * threads, [&] {
+        auto workers = std::vector<std::jthread>();
+        for (auto t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                auto sum = 0L;
+                for (auto i = std::size_t{0}; i < per_thread; ++i) {
+                    sum += fn(i, fail);
+                }
+                do_not_optimize(sum);
+            });
+        }
+    });
+}
+
+}
+
+TEST(TestExpectedBenchmark, test_error_path) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto ops = std::size_t{200'000};
+    for (auto const threads: {1, 4}) {
+        auto const per_thread = ops / threads;
+        auto const suffix = " x" + std::to_string(threads) + " threads";
+        for (auto const fail: {false, true}) {
+            auto const path = std::string(fail ? " errors" : " values");
+            round_trips("std::future, exception" + path + suffix, threads, per_thread, fail, via_exception);
+            round_trips("std::future<expected>" + path + suffix, threads, per_thread, fail, via_std_future);
+            round_trips("dojo::expected_future" + path + suffix, threads, per_thread, fail, via_expected_future);
+        }
+    }
+}
+
+/**
+ * Errors handed over to another thread, which consumes them while they are
+ * being produced.
+ */
+TEST(TestExpectedBenchmark, test_cross_thread_errors) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto count = std::size_t{100'000};
+    {
+        auto promises = std::vector<std::promise<int>>(count);
+        auto futures = std::vector<std::future<int>>();
+        for (auto &promise: promises) {
+            futures.push_back(promise.get_future());
+        }
+        benchmark("std::future, exception across threads", count, [&] {
+            auto const producer = std::jthread([&] {
+                for (auto &promise: promises) {
+                    promise.set_exception(std::make_exception_ptr(std::runtime_error("timed out")));
+                }
+            });
+            for (auto &future: futures) {
+                try {
+                    do_not_optimize(future.get());
+                } catch (std::runtime_error const &e) {
+                    do_not_optimize(e.what());
+                }
+            }
+        });
+    }
+    {
+        auto promises = std::vector<dojo::expected_promise<int>>(count);
+        auto futures = std::vector<dojo::expected_future<int>>();
+        for (auto &promise: promises) {
+            futures.push_back(promise.get_future());
+        }
+        benchmark("dojo::expected_future across threads", count, [&] {
+            auto const producer = std::jthread([&] {
+                for (auto &promise: promises) {
+                    promise.set_error(std::make_error_code(std::errc::timed_out));
+                }
+            });
+            for (auto &future: futures) {
+                do_not_optimize(future.get().error().value());
+            }
+        });
+    }
+}
@@ -0,0 +1,685 @@
+#ifndef CPP_XX_DOJO_EXPECTED_H
+#define CPP_XX_DOJO_EXPECTED_H
+
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace dojo {
+
+/**
+ * @brief The error held by an expected, to tell it apart from a value of the
+ * same type
+ */
+template<typename E>
+class unexpected {
+public:
+    template<typename G = E>
+    requires (!std::is_same_v<std::remove_cvref_t<G>, unexpected> && std::is_constructible_v<E, G>)
+    constexpr explicit unexpected(G &&error) : m_error(std::forward<G>(error)) {}
+
+    template<typename... Args>
+    constexpr explicit unexpected(std::in_place_t, Args &&...args) : m_error(std::forward<Args>(args)...) {}
+
+    constexpr E &error() & noexcept { return m_error; }
+
+    constexpr E const &error() const & noexcept { return m_error; }
+
+    constexpr E &&error() && noexcept { return std::move(m_error); }
+
+    template<typename G>
+    friend constexpr bool operator==(unexpected const &lhs, unexpected<G> const &rhs) {
+        return lhs.error() == rhs.error();
+    }
+
+private:
+    E m_error;
+};
+
+template<typename E>
+unexpected(E) -> unexpected<E>;
+
+struct unexpect_t {
+    explicit unexpect_t() = default;
+};
+
+inline constexpr auto unexpect = unexpect_t();
+
+/**
+ * Thrown by expected::value() when there's an error instead, which is the
+ * only exception of an expected, and a bug rather than an error to handle.
+ */
+template<typename E>
+class bad_expected_access : public std::exception {
+public:
+    explicit bad_expected_access(E error) : m_error(std::move(error)) {}
+
+    [[nodiscard]] char const *what() const noexcept override { return "bad access to dojo::expected without value"; }
+
+    [[nodiscard]] E const &error() const noexcept { return m_error; }
+
+private:
+    E m_error;
+};
+
+template<typename T, typename E>
+class expected;
+
+namespace detail {
+
+/**
+ * The trivial special members of an expected need constraints which subsume
+ * those of the non-trivial ones, hence concepts rather than plain traits.
+ */
+template<typename... Ts>
+concept copy_constructible_all = (std::is_copy_constructible_v<Ts> && ...);
+
+template<typename... Ts>
+concept trivially_copy_constructible_all =
+        copy_constructible_all<Ts...> && (std::is_trivially_copy_constructible_v<Ts> && ...);
+
+template<typename... Ts>
+concept move_constructible_all = (std::is_move_constructible_v<Ts> && ...);
+
+template<typename... Ts>
+concept trivially_move_constructible_all =
+        move_constructible_all<Ts...> && (std::is_trivially_move_constructible_v<Ts> && ...);
+
+template<typename... Ts>
+concept copy_assignable_all = ((std::is_copy_constructible_v<Ts> && std::is_copy_assignable_v<Ts>) && ...);
+
+template<typename... Ts>
+concept trivially_copy_assignable_all = copy_assignable_all<Ts...> && (
+        (std::is_trivially_copy_constructible_v<Ts> && std::is_trivially_copy_assignable_v<Ts> &&
+         std::is_trivially_destructible_v<Ts>) && ...);
+
+template<typename... Ts>
+concept move_assignable_all = ((std::is_move_constructible_v<Ts> && std::is_move_assignable_v<Ts>) && ...);
+
+template<typename... Ts>
+concept trivially_move_assignable_all = move_assignable_all<Ts...> && (
+        (std::is_trivially_move_constructible_v<Ts> && std::is_trivially_move_assignable_v<Ts> &&
+         std::is_trivially_destructible_v<Ts>) && ...);
+
+template<typename T>
+struct is_expected : std::false_type {};
+
+template<typename T, typename E>
+struct is_expected<expected<T, E>> : std::true_type {};
+
+template<typename T>
+struct is_unexpected : std::false_type {};
+
+template<typename E>
+struct is_unexpected<unexpected<E>> : std::true_type {};
+
+/**
+ * Replace the alternative `old` by a `New` constructed of `args`, where
+ * `old` may be the very same member, such that `old` is still there if the
+ * constructing throws, as the reinit-expected of std::expected does:
+ *   - constructed right in place when it can't throw;
+ *   - otherwise constructed aside first, then moved in when moving can't
+ *     throw;
+ *   - otherwise with `old` moved aside, and moved back on an exception.
+ */
+template<typename New, typename Old, typename... Args>
+constexpr void reinit(New &new_member, Old &old, Args &&...args) {
+    if constexpr (std::is_nothrow_constructible_v<New, Args...>) {
+        std::destroy_at(std::addressof(old));
+        std::construct_at(std::addressof(new_member), std::forward<Args>(args)...);
+    } else if constexpr (std::is_nothrow_move_constructible_v<New>) {
+        auto constructed = New(std::forward<Args>(args)...);
+        std::destroy_at(std::addressof(old));
+        std::construct_at(std::addressof(new_member), std::move(constructed));
+    } else {
+        static_assert(std::is_nothrow_move_constructible_v<Old>,
+                      "either the value or the error must be nothrow move constructible");
+        auto backup = Old(std::move(old));
+        std::destroy_at(std::addressof(old));
+        try {
+            std::construct_at(std::addressof(new_member), std::forward<Args>(args)...);
+        } catch (...) {
+            std::construct_at(std::addressof(old), std::move(backup));
+            throw;
+        }
+    }
+}
+
+/**
+ * The members shared by expected<T, E> and expected<void, E>, which only
+ * differ in their storage, as a CRTP base.
+ *
+ * The monadic operations forward the expected itself, so each of them is
+ * written once for the lvalues, the const lvalues and the rvalues.
+ */
+template<typename Derived, typename T, typename E>
+class expected_monads {
+public:
+    template<typename Fn>
+    constexpr auto and_then(Fn &&fn) & { return and_then_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto and_then(Fn &&fn) const & { return and_then_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto and_then(Fn &&fn) && { return and_then_impl(std::move(self()), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto or_else(Fn &&fn) & { return or_else_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto or_else(Fn &&fn) const & { return or_else_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto or_else(Fn &&fn) && { return or_else_impl(std::move(self()), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto transform(Fn &&fn) & { return transform_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto transform(Fn &&fn) const & { return transform_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto transform(Fn &&fn) && { return transform_impl(std::move(self()), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto transform_error(Fn &&fn) & { return transform_error_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto transform_error(Fn &&fn) const & { return transform_error_impl(self(), std::forward<Fn>(fn)); }
+
+    template<typename Fn>
+    constexpr auto transform_error(Fn &&fn) && {
+        return transform_error_impl(std::move(self()), std::forward<Fn>(fn));
+    }
+
+private:
+    constexpr Derived &self() { return static_cast<Derived &>(*this); }
+
+    constexpr Derived const &self() const { return static_cast<Derived const &>(*this); }
+
+    // invoke fn with the value of self, or with nothing for a void value
+    template<typename Self, typename Fn>
+    static constexpr decltype(auto) invoke_value(Self &&self, Fn &&fn) {
+        if constexpr (std::is_void_v<T>) {
+            return std::invoke(std::forward<Fn>(fn));
+        } else {
+            return std::invoke(std::forward<Fn>(fn), *std::forward<Self>(self));
+        }
+    }
+
+    template<typename Self, typename Fn>
+    using value_result_t = decltype(invoke_value(std::declval<Self>(), std::declval<Fn>()));
+
+    template<typename Self, typename Fn>
+    static constexpr auto and_then_impl(Self &&self, Fn &&fn) {
+        using result = std::remove_cvref_t<value_result_t<Self, Fn>>;
+        static_assert(is_expected<result>::value, "and_then must return an expected");
+        static_assert(std::is_same_v<typename result::error_type, E>, "and_then must keep the error type");
+        if (self.has_value()) {
+            return invoke_value(std::forward<Self>(self), std::forward<Fn>(fn));
+        }
+        return result(unexpect, std::forward<Self>(self).error());
+    }
+
+    template<typename Self, typename Fn>
+    static constexpr auto or_else_impl(Self &&self, Fn &&fn) {
+        using result = std::remove_cvref_t<std::invoke_result_t<Fn, decltype(std::forward<Self>(self).error())>>;
+        static_assert(is_expected<result>::value, "or_else must return an expected");
+        static_assert(std::is_same_v<typename result::value_type, T>, "or_else must keep the value type");
+        if (self.has_value()) {
+            if constexpr (std::is_void_v<T>) {
+                return result();
+            } else {
+                return result(std::in_place, *std::forward<Self>(self));
+            }
+        }
+        return std::invoke(std::forward<Fn>(fn), std::forward<Self>(self).error());
+    }
+
+    template<typename Self, typename Fn>
+    static constexpr auto transform_impl(Self &&self, Fn &&fn) {
+        using value = std::remove_cv_t<value_result_t<Self, Fn>>;
+        using result = expected<value, E>;
+        if (!self.has_value()) {
+            return result(unexpect, std::forward<Self>(self).error());
+        }
+        if constexpr (std::is_void_v<value>) {
+            invoke_value(std::forward<Self>(self), std::forward<Fn>(fn));
+            return result();
+        } else {
+            return result(std::in_place, invoke_value(std::forward<Self>(self), std::forward<Fn>(fn)));
+        }
+    }
+
+    template<typename Self, typename Fn>
+    static constexpr auto transform_error_impl(Self &&self, Fn &&fn) {
+        using error = std::remove_cv_t<std::invoke_result_t<Fn, decltype(std::forward<Self>(self).error())>>;
+        using result = expected<T, error>;
+        if (!self.has_value()) {
+            return result(unexpect, std::invoke(std::forward<Fn>(fn), std::forward<Self>(self).error()));
+        }
+        if constexpr (std::is_void_v<T>) {
+            return result();
+        } else {
+            return result(std::in_place, *std::forward<Self>(self));
+        }
+    }
+};
+
+}
+
+/**
+ * @brief Either a value or an error, which is returned rather than thrown
+ *
+ * The std::expected of C++23, written for C++20, as much as the cases here
+ * need: the errors are plain values, so passing one back costs no more than
+ * passing back a value, unlike an exception, which is allocated, unwinds the
+ * stack through the tables of every frame, and takes a std::exception_ptr to
+ * cross threads.
+ *
+ * The monadic and_then, or_else, transform and transform_error chain the
+ * steps which may fail, without checking every result by hand:
+ *
+ *     auto port = parse_int(text).and_then(check_range).value_or(8080);
+ *
+ * The assignments between a value and an error, and emplace, keep the old
+ * alternative if constructing the new one throws, which takes either the
+ * value or the error to be nothrow move constructible, as std::expected does.
+ *
+ * reference from https://en.cppreference.com/w/cpp/utility/expected
+ */
+template<typename T, typename E>
+class expected : public detail::expected_monads<expected<T, E>, T, E> {
+public:
+    using value_type = T;
+    using error_type = E;
+    using unexpected_type = unexpected<E>;
+
+    template<typename U>
+    using rebind = expected<U, error_type>;
+
+    constexpr expected() requires std::is_default_constructible_v<T> : m_value(), m_has_value(true) {}
+
+    constexpr expected(expected const &) requires detail::trivially_copy_constructible_all<T, E> = default;
+
+    constexpr expected(expected const &other) requires detail::copy_constructible_all<T, E> :
+            m_has_value(other.m_has_value) {
+        if (m_has_value) {
+            std::construct_at(std::addressof(m_value), other.m_value);
+        } else {
+            std::construct_at(std::addressof(m_error), other.m_error);
+        }
+    }
+
+    constexpr expected(expected &&) requires detail::trivially_move_constructible_all<T, E> = default;
+
+    constexpr expected(expected &&other) noexcept(
+            std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>)
+    requires detail::move_constructible_all<T, E> : m_has_value(other.m_has_value) {
+        if (m_has_value) {
+            std::construct_at(std::addressof(m_value), std::move(other.m_value));
+        } else {
+            std::construct_at(std::addressof(m_error), std::move(other.m_error));
+        }
+    }
+
+    template<typename U = T>
+    requires (!std::is_same_v<std::remove_cvref_t<U>, std::in_place_t> &&
+              !std::is_same_v<std::remove_cvref_t<U>, expected> &&
+              !detail::is_unexpected<std::remove_cvref_t<U>>::value &&
+              std::is_constructible_v<T, U>)
+    constexpr explicit(!std::is_convertible_v<U, T>) expected(U &&value) :
+            m_value(std::forward<U>(value)), m_has_value(true) {}
+
+    template<typename G>
+    requires std::is_constructible_v<E, G const &>
+    constexpr explicit(!std::is_convertible_v<G const &, E>) expected(unexpected<G> const &error) :
+            m_error(error.error()), m_has_value(false) {}
+
+    template<typename G>
+    requires std::is_constructible_v<E, G>
+    constexpr explicit(!std::is_convertible_v<G, E>) expected(unexpected<G> &&error) :
+            m_error(std::move(error).error()), m_has_value(false) {}
+
+    template<typename... Args>
+    requires std::is_constructible_v<T, Args...>
+    constexpr explicit expected(std::in_place_t, Args &&...args) :
+            m_value(std::forward<Args>(args)...), m_has_value(true) {}
+
+    template<typename... Args>
+    requires std::is_constructible_v<E, Args...>
+    constexpr explicit expected(unexpect_t, Args &&...args) :
+            m_error(std::forward<Args>(args)...), m_has_value(false) {}
+
+    constexpr ~expected() requires (std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>) = default;
+
+    constexpr ~expected() { destroy(); }
+
+    constexpr expected &operator=(expected const &) requires detail::trivially_copy_assignable_all<T, E> = default;
+
+    constexpr expected &operator=(expected const &other) requires detail::copy_assignable_all<T, E> {
+        if (this != &other) {
+            assign(other);
+        }
+        return *this;
+    }
+
+    constexpr expected &operator=(expected &&) requires detail::trivially_move_assignable_all<T, E> = default;
+
+    constexpr expected &operator=(expected &&other) noexcept(
+            std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T> &&
+            std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_assignable_v<E>)
+    requires detail::move_assignable_all<T, E> {
+        if (this != &other) {
+            assign(std::move(other));
+        }
+        return *this;
+    }
+
+    template<typename U = T>
+    requires (!std::is_same_v<std::remove_cvref_t<U>, expected> &&
+              !detail::is_unexpected<std::remove_cvref_t<U>>::value &&
+              std::is_constructible_v<T, U> && std::is_assignable_v<T &, U>)
+    constexpr expected &operator=(U &&value) {
+        if (m_has_value) {
+            m_value = std::forward<U>(value);
+        } else {
+            detail::reinit(m_value, m_error, std::forward<U>(value));
+            m_has_value = true;
+        }
+        return *this;
+    }
+
+    template<typename G>
+    constexpr expected &operator=(unexpected<G> error) {
+        if (m_has_value) {
+            detail::reinit(m_error, m_value, std::move(error).error());
+            m_has_value = false;
+        } else {
+            m_error = std::move(error).error();
+        }
+        return *this;
+    }
+
+    template<typename... Args>
+    constexpr T &emplace(Args &&...args) {
+        if (m_has_value) {
+            if constexpr (std::is_nothrow_constructible_v<T, Args...> || std::is_nothrow_move_constructible_v<T>) {
+                detail::reinit(m_value, m_value, std::forward<Args>(args)...);
+            } else {
+                // there's no other alternative to back the value up by
+                m_value = T(std::forward<Args>(args)...);
+            }
+        } else {
+            detail::reinit(m_value, m_error, std::forward<Args>(args)...);
+            m_has_value = true;
+        }
+        return m_value;
+    }
+
+    [[nodiscard]] constexpr bool has_value() const noexcept { return m_has_value; }
+
+    constexpr explicit operator bool() const noexcept { return m_has_value; }
+
+    constexpr T *operator->() noexcept { return std::addressof(m_value); }
+
+    constexpr T const *operator->() const noexcept { return std::addressof(m_value); }
+
+    constexpr T &operator*() & noexcept { return m_value; }
+
+    constexpr T const &operator*() const & noexcept { return m_value; }
+
+    constexpr T &&operator*() && noexcept { return std::move(m_value); }
+
+    constexpr T &value() & {
+        check_value();
+        return m_value;
+    }
+
+    constexpr T const &value() const & {
+        check_value();
+        return m_value;
+    }
+
+    constexpr T &&value() && {
+        check_value();
+        return std::move(m_value);
+    }
+
+    constexpr E &error() & noexcept { return m_error; }
+
+    constexpr E const &error() const & noexcept { return m_error; }
+
+    constexpr E &&error() && noexcept { return std::move(m_error); }
+
+    template<typename U>
+    constexpr T value_or(U &&fallback) const & {
+        return m_has_value ? m_value : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template<typename U>
+    constexpr T value_or(U &&fallback) && {
+        return m_has_value ? std::move(m_value) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template<typename T2, typename E2>
+    requires (!std::is_void_v<T2>)
+    friend constexpr bool operator==(expected const &lhs, expected<T2, E2> const &rhs) {
+        if (lhs.has_value() != rhs.has_value()) {
+            return false;
+        }
+        return lhs.has_value() ? *lhs == *rhs : lhs.error() == rhs.error();
+    }
+
+    template<typename T2>
+    requires (!detail::is_expected<T2>::value && !detail::is_unexpected<T2>::value)
+    friend constexpr bool operator==(expected const &lhs, T2 const &value) {
+        return lhs.has_value() && *lhs == value;
+    }
+
+    template<typename E2>
+    friend constexpr bool operator==(expected const &lhs, unexpected<E2> const &error) {
+        return !lhs.has_value() && lhs.error() == error.error();
+    }
+
+private:
+    constexpr void check_value() const {
+        if (!m_has_value) {
+            throw bad_expected_access<E>(m_error);
+        }
+    }
+
+    constexpr void destroy() {
+        if (m_has_value) {
+            std::destroy_at(std::addressof(m_value));
+        } else {
+            std::destroy_at(std::addressof(m_error));
+        }
+    }
+
+    template<typename Other>
+    constexpr void assign(Other &&other) {
+        if (m_has_value && other.m_has_value) {
+            m_value = std::forward<Other>(other).m_value;
+        } else if (!m_has_value && !other.m_has_value) {
+            m_error = std::forward<Other>(other).m_error;
+        } else if (other.m_has_value) {
+            detail::reinit(m_value, m_error, std::forward<Other>(other).m_value);
+            m_has_value = true;
+        } else {
+            detail::reinit(m_error, m_value, std::forward<Other>(other).m_error);
+            m_has_value = false;
+        }
+    }
+
+    union {
+        T m_value;
+        E m_error;
+    };
+    bool m_has_value;
+};
+
+/**
+ * @brief Either nothing or an error, for the operations which only may fail
+ */
+template<typename E>
+class expected<void, E> : public detail::expected_monads<expected<void, E>, void, E> {
+public:
+    using value_type = void;
+    using error_type = E;
+    using unexpected_type = unexpected<E>;
+
+    template<typename U>
+    using rebind = expected<U, error_type>;
+
+    constexpr expected() noexcept : m_has_value(true) {}
+
+    constexpr expected(expected const &) requires detail::trivially_copy_constructible_all<E> = default;
+
+    constexpr expected(expected const &other) requires detail::copy_constructible_all<E> :
+            m_has_value(other.m_has_value) {
+        if (!m_has_value) {
+            std::construct_at(std::addressof(m_error), other.m_error);
+        }
+    }
+
+    constexpr expected(expected &&) requires detail::trivially_move_constructible_all<E> = default;
+
+    constexpr expected(expected &&other) noexcept(std::is_nothrow_move_constructible_v<E>)
+    requires detail::move_constructible_all<E> : m_has_value(other.m_has_value) {
+        if (!m_has_value) {
+            std::construct_at(std::addressof(m_error), std::move(other.m_error));
+        }
+    }
+
+    template<typename G>
+    requires std::is_constructible_v<E, G const &>
+    constexpr explicit(!std::is_convertible_v<G const &, E>) expected(unexpected<G> const &error) :
+            m_error(error.error()), m_has_value(false) {}
+
+    template<typename G>
+    requires std::is_constructible_v<E, G>
+    constexpr explicit(!std::is_convertible_v<G, E>) expected(unexpected<G> &&error) :
+            m_error(std::move(error).error()), m_has_value(false) {}
+
+    constexpr explicit expected(std::in_place_t) noexcept : m_has_value(true) {}
+
+    template<typename... Args>
+    requires std::is_constructible_v<E, Args...>
+    constexpr explicit expected(unexpect_t, Args &&...args) :
+            m_error(std::forward<Args>(args)...), m_has_value(false) {}
+
+    constexpr ~expected() requires std::is_trivially_destructible_v<E> = default;
+
+    constexpr ~expected() {
+        if (!m_has_value) {
+            std::destroy_at(std::addressof(m_error));
+        }
+    }
+
+    constexpr expected &operator=(expected const &) requires detail::trivially_copy_assignable_all<E> = default;
+
+    constexpr expected &operator=(expected const &other) requires detail::copy_assignable_all<E> {
+        if (this != &other) {
+            assign(other);
+        }
+        return *this;
+    }
+
+    constexpr expected &operator=(expected &&) requires detail::trivially_move_assignable_all<E> = default;
+
+    constexpr expected &operator=(expected &&other) noexcept(
+            std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_assignable_v<E>)
+    requires detail::move_assignable_all<E> {
+        if (this != &other) {
+            assign(std::move(other));
+        }
+        return *this;
+    }
+
+    template<typename G>
+    constexpr expected &operator=(unexpected<G> error) {
+        if (m_has_value) {
+            std::construct_at(std::addressof(m_error), std::move(error).error());
+            m_has_value = false;
+        } else {
+            m_error = std::move(error).error();
+        }
+        return *this;
+    }
+
+    constexpr void emplace() noexcept {
+        if (!m_has_value) {
+            std::destroy_at(std::addressof(m_error));
+            m_has_value = true;
+        }
+    }
+
+    [[nodiscard]] constexpr bool has_value() const noexcept { return m_has_value; }
+
+    constexpr explicit operator bool() const noexcept { return m_has_value; }
+
+    constexpr void operator*() const noexcept {}
+
+    constexpr void value() const & {
+        if (!m_has_value) {
+            throw bad_expected_access<E>(m_error);
+        }
+    }
+
+    constexpr void value() && {
+        if (!m_has_value) {
+            throw bad_expected_access<E>(std::move(m_error));
+        }
+    }
+
+    constexpr E &error() & noexcept { return m_error; }
+
+    constexpr E const &error() const & noexcept { return m_error; }
+
+    constexpr E &&error() && noexcept { return std::move(m_error); }
+
+    template<typename T2, typename E2>
+    requires std::is_void_v<T2>
+    friend constexpr bool operator==(expected const &lhs, expected<T2, E2> const &rhs) {
+        if (lhs.has_value() != rhs.has_value()) {
+            return false;
+        }
+        return lhs.has_value() || lhs.error() == rhs.error();
+    }
+
+    template<typename E2>
+    friend constexpr bool operator==(expected const &lhs, unexpected<E2> const &error) {
+        return !lhs.has_value() && lhs.error() == error.error();
+    }
+
+private:
+    template<typename Other>
+    constexpr void assign(Other &&other) {
+        if (m_has_value && other.m_has_value) {
+            return;
+        }
+        if (!m_has_value && !other.m_has_value) {
+            m_error = std::forward<Other>(other).m_error;
+        } else if (other.m_has_value) {
+            std::destroy_at(std::addressof(m_error));
+            m_has_value = true;
+        } else {
+            std::construct_at(std::addressof(m_error), std::forward<Other>(other).m_error);
+            m_has_value = false;
+        }
+    }
+
+    union {
+        E m_error;
+    };
+    bool m_has_value;
+};
+
+}
+
+#endif //CPP_XX_DOJO_EXPECTED_H
@@ -0,0 +1,213 @@
+#ifndef CPP_XX_DOJO_EXPECTED_FUTURE_H
+#define CPP_XX_DOJO_EXPECTED_FUTURE_H
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+#include "../synchronization/spin_wait.h"
+
+namespace dojo {
+
+namespace detail {
+
+/**
+ * The result, constructed in place once, and published by the status.
+ */
+template<typename T, typename E>
+class expected_shared_state {
+public:
+    expected_shared_state() noexcept {}
+
+    expected_shared_state(expected_shared_state const &) = delete;
+
+    expected_shared_state &operator=(expected_shared_state const &) = delete;
+
+    ~expected_shared_state() {
+        if (m_status.load(std::memory_order_acquire) == ready) {
+            std::destroy_at(std::addressof(m_result));
+        }
+    }
+
+    /**
+     * Only the first of the concurrent calls sets the result.
+     */
+    template<typename... Args>
+    bool set(Args &&...args) {
+        auto status = pending;
+        if (!m_status.compare_exchange_strong(status, writing, std::memory_order_relaxed)) {
+            return false;
+        }
+        try {
+            std::construct_at(std::addressof(m_result), std::forward<Args>(args)...);
+        } catch (...) {
+            m_status.store(pending, std::memory_order_relaxed);
+            throw;
+        }
+        m_status.store(ready, std::memory_order_release);
+        m_status.notify_all();
+        return true;
+    }
+
+    [[nodiscard]] bool is_ready() const noexcept { return m_status.load(std::memory_order_acquire) == ready; }
+
+    void wait() const noexcept {
+        for (auto status = m_status.load(std::memory_order_acquire); status != ready;
+             status = m_status.load(std::memory_order_acquire)) {
+            spin_then_wait(m_status, status);
+        }
+    }
+
+    expected<T, E> &result() noexcept { return m_result; }
+
+private:
+    static constexpr std::uint32_t pending = 0;
+    static constexpr std::uint32_t writing = 1;
+    static constexpr std::uint32_t ready = 2;
+
+    std::atomic<std::uint32_t> m_status{pending};
+    union {
+        expected<T, E> m_result;
+    };
+};
+
+}
+
+template<typename T, typename E>
+class expected_promise;
+
+/**
+ * @brief The future of an expected_promise, whose get() returns the expected
+ * rather than throwing the error
+ */
+template<typename T, typename E = std::error_code>
+class expected_future {
+public:
+    expected_future() noexcept = default;
+
+    expected_future(expected_future const &) = delete;
+
+    expected_future &operator=(expected_future const &) = delete;
+
+    expected_future(expected_future &&) noexcept = default;
+
+    expected_future &operator=(expected_future &&) noexcept = default;
+
+    [[nodiscard]] bool valid() const noexcept { return m_state != nullptr; }
+
+    [[nodiscard]] bool is_ready() const noexcept { return m_state->is_ready(); }
+
+    void wait() const noexcept { m_state->wait(); }
+
+    /**
+     * Wait for the result and take it, after which the future is no longer
+     * valid, the same as std::future::get().
+     */
+    expected<T, E> get() {
+        m_state->wait();
+        auto const state = std::move(m_state);
+        return std::move(state->result());
+    }
+
+private:
+    friend class expected_promise<T, E>;
+
+    explicit expected_future(std::shared_ptr<detail::expected_shared_state<T, E>> state) noexcept :
+            m_state(std::move(state)) {}
+
+    std::shared_ptr<detail::expected_shared_state<T, E>> m_state;
+};
+
+/**
+ * @brief A std::promise whose errors are values of type E rather than
+ * exceptions
+ *
+ * Setting an error costs the same as setting a value: there's no exception
+ * to allocate and throw, no std::exception_ptr to capture, and nothing to
+ * rethrow on the other side, which std::future::get() does every time it's
+ * called on an error. Hence meant for the paths where errors are frequent,
+ * e.g. timeouts or misses, rather than exceptional.
+ *
+ * The misuses are reported without exceptions as well: setting a result
+ * which has already been set returns false, and getting the future twice
+ * returns an invalid one. A promise destroyed without a result breaks it with
+ * std::future_errc::broken_promise, for an E constructible from it such as
+ * std::error_code, otherwise with a value-initialized E.
+ *
+ * The waiting thread spins for a while before parking on the status of the
+ * shared state, like dojo::latch.
+ */
+template<typename T, typename E = std::error_code>
+class expected_promise {
+public:
+    expected_promise() : m_state(std::make_shared<detail::expected_shared_state<T, E>>()) {}
+
+    expected_promise(expected_promise const &) = delete;
+
+    expected_promise &operator=(expected_promise const &) = delete;
+
+    expected_promise(expected_promise &&other) noexcept :
+            m_state(std::move(other.m_state)),
+            m_future_retrieved(other.m_future_retrieved) {}
+
+    expected_promise &operator=(expected_promise &&other) noexcept {
+        if (this != &other) {
+            break_promise();
+            m_state = std::move(other.m_state);
+            m_future_retrieved = other.m_future_retrieved;
+        }
+        return *this;
+    }
+
+    ~expected_promise() {
+        break_promise();
+    }
+
+    [[nodiscard]] expected_future<T, E> get_future() {
+        if (m_state == nullptr || std::exchange(m_future_retrieved, true)) {
+            return {};
+        }
+        return expected_future<T, E>(m_state);
+    }
+
+    template<typename... Args>
+    bool set_value(Args &&...args) {
+        return m_state != nullptr && m_state->set(std::in_place, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    bool set_error(Args &&...args) {
+        return m_state != nullptr && m_state->set(unexpect, std::forward<Args>(args)...);
+    }
+
+    bool set_result(expected<T, E> result) {
+        return m_state != nullptr && m_state->set(std::move(result));
+    }
+
+private:
+    static E broken_promise_error() {
+        if constexpr (std::is_constructible_v<E, std::future_errc>) {
+            return E(std::future_errc::broken_promise);
+        } else {
+            return E();
+        }
+    }
+
+    void break_promise() {
+        if (m_state != nullptr && !m_state->is_ready()) {
+            m_state->set(unexpect, broken_promise_error());
+        }
+    }
+
+    std::shared_ptr<detail::expected_shared_state<T, E>> m_state;
+    bool m_future_retrieved = false;
+};
+
+}
+
+#endif //CPP_XX_DOJO_EXPECTED_FUTURE_H
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flat_hash_map.h"
+
+/**
+ * std::unordered_map is node-based: every element is a separately allocated
+ * node, and every lookup chases at least one pointer into a bucket list. The
+ * flat hash map stores the elements in place, and filters the candidates
+ * with one byte of the hash per slot, 16 slots at a time.
+ *
+ * The key type is constrained by the concepts from the concepts case, i.e.
+ * `EqComparable` plus `HashFor` the given hash function object.
+ *
+ * reference from https://abseil.io/about/design/swisstables
+ */
+
+using namespace std::literals;
+
+TEST(TestFlatHashMap, test_insert_find_erase) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto map = dojo::flat_hash_map<int, std::string>();
+    ASSERT_TRUE(map.empty());
+
+    // insert returns the position and whether it's newly inserted
+    auto [it, inserted] = map.insert({1, "one"});
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(it->second, "one");
+
+    // an existing key is never overwritten by insert or try_emplace
+    ASSERT_FALSE(map.insert({1, "uno"}).second);
+    ASSERT_FALSE(map.try_emplace(1, "eins").second);
+    ASSERT_EQ(map.at(1), "one");
+
+    // but it will be overwritten by insert_or_assign or operator[]
+    map.insert_or_assign(1, "uno");
+    ASSERT_EQ(map[1], "uno");
+    map[2] = "two";
+    ASSERT_EQ(map.size(), 2);
+
+    ASSERT_TRUE(map.contains(2));
+    ASSERT_EQ(map.count(3), 0);
+    ASSERT_EQ(map.find(3), map.end());
+    ASSERT_THROW(map.at(3), std::out_of_range);
+
+    ASSERT_EQ(map.erase(1), 1);
+    ASSERT_EQ(map.erase(1), 0);
+    ASSERT_FALSE(map.contains(1));
+    ASSERT_EQ(map.size(), 1);
+}
+
+/**
+ * Given a transparent hash and a transparent equality, the map can be looked
+ * up with any type comparable with the key, without constructing a key.
+ */
+TEST(TestFlatHashMap, test_heterogeneous_lookup) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto map = dojo::flat_hash_map<std::string, int, dojo::string_hash, std::equal_to<>>{
+            {"hello", 1},
+            {"world", 2},
+    };
+
+    // no std::string is constructed for these lookups
+    ASSERT_TRUE(map.contains("hello"sv));
+    ASSERT_EQ(map.find("world")->second, 2);
+    ASSERT_EQ(map.erase("hello"sv), 1);
+    ASSERT_FALSE(map.contains("hello"));
+
+    // while the default std::hash<std::string> is not transparent,
+    // hence `sv` must be converted to std::string before looking up
+    ASSERT_TRUE((dojo::HeterogeneousKeyFor<dojo::string_hash, std::equal_to<>, std::string, std::string_view>));
+    ASSERT_FALSE((dojo::HeterogeneousKeyFor<std::hash<std::string>, std::equal_to<>, std::string, std::string_view>));
+}
+
+/**
+ * reserve() makes room for the given count of elements in advance, so that no
+ * rehash (which invalidates the references) happens while inserting them.
+ */
+TEST(TestFlatHashMap, test_reserve) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto map = dojo::flat_hash_map<int, int>();
+    map.reserve(1000);
+
+    auto const capacity = map.capacity();
+    ASSERT_GE(capacity, 1000);
+
+    map[0] = 0;
+    auto const *first = &map.find(0)->second;
+    for (auto i = 1; i < 1000; ++i) {
+        map[i] = i;
+    }
+
+    ASSERT_EQ(map.capacity(), capacity);
+    ASSERT_EQ(first, &map.find(0)->second);
+    ASSERT_LE(map.load_factor(), 0.875f);
+}
+
+TEST(TestFlatHashMap, test_iterate_and_erase_while_iterating) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto map = dojo::flat_hash_map<int, int>();
+    for (auto i = 0; i < 100; ++i) {
+        map[i] = i * i;
+    }
+
+    auto sum = 0;
+    for (auto const &[key, value]: map) {
+        ASSERT_EQ(value, key * key);
+        sum += key;
+    }
+    ASSERT_EQ(sum, 4950);
+
+    // erasing never moves the other elements, hence it's safe to go on
+    // iterating with the returned iterator
+    for (auto it = map.begin(); it != map.end();) {
+        it = it->first % 2 ? map.erase(it) : std::next(it);
+    }
+    ASSERT_EQ(map.size(), 50);
+    ASSERT_TRUE(std::ranges::all_of(map, [](auto const &kv) { return kv.first % 2 == 0; }));
+}
+
+/**
+ * Values are moved rather than copied when the table grows, hence move-only
+ * values are supported.
+ */
+TEST(TestFlatHashMap, test_move_only_values) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto map = dojo::flat_hash_map<std::string, std::unique_ptr<int>>();
+    for (auto i = 0; i < 100; ++i) {
+        map.try_emplace(std::to_string(i), std::make_unique<int>(i));
+    }
+    for (auto i = 0; i < 100; ++i) {
+        ASSERT_EQ(*map.at(std::to_string(i)), i);
+    }
+
+    auto moved = std::move(map);
+    ASSERT_EQ(moved.size(), 100);
+    ASSERT_TRUE(map.empty()); // NOLINT(bugprone-use-after-move)
+}
+
+/**
+ * Randomly mix insertions and erasures, which leaves plenty of tombstones
+ * behind, and check the map always agrees with std::unordered_map.
+ */
+TEST(TestFlatHashMap, test_agree_with_unordered_map) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto flat = dojo::flat_hash_map<int, int>();
+    auto node = std::unordered_map<int, int>();
+
+    auto rng = std::mt19937(42);
+    auto key_dist = std::uniform_int_distribution(0, 4096);
+    for (auto i = 0; i < 200'000; ++i) {
+        auto const key = key_dist(rng);
+        if (rng() % 3) {
+            ASSERT_EQ(flat.try_emplace(key, i).second, node.try_emplace(key, i).second);
+        } else {
+            ASSERT_EQ(flat.erase(key), node.erase(key));
+        }
+    }
+
+    ASSERT_EQ(flat.size(), node.size());
+    for (auto const &[key, value]: node) {
+        ASSERT_EQ(flat.at(key), value);
+    }
+
+    auto copied = flat;
+    ASSERT_EQ(copied.size(), node.size());
+    copied.clear();
+    ASSERT_TRUE(copied.empty());
+    ASSERT_EQ(copied.begin(), copied.end());
+    ASSERT_EQ(flat.size(), node.size());
+}
+
+TEST(TestFlatHashMap, test_key_constraints) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // ok: int is EqComparable and std::hash<int> is a hash for it
+    ASSERT_TRUE((EqComparable<int> && HashFor<std::hash<int>, int>));
+
+    // error: std::vector<int> is EqComparable, but there is no std::hash<std::vector<int>>
+    //dojo::flat_hash_map<std::vector<int>, int> map;
+    ASSERT_FALSE((HashFor<std::hash<std::vector<int>>, std::vector<int>>));
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flat_hash_map.h"
+#include "../../../utils.h"
+
+/**
+ * Compare the flat hash map with std::unordered_map on the same operations.
+ *
+ * The keys are shuffled so that neither the insertion order nor the lookup
+ * order is friendly to the cache, and the two orders differ. The timings are
+ * only printed, not asserted, since they depend on the machine.
+ */
+
+static constexpr auto element_count = std::size_t{1} << 20;
+
+static std::vector<int> shuffled_keys(std::size_t const count, int const first, unsigned const seed) {
+    auto keys = std::vector<int>(count);
+    std::iota(keys.begin(), keys.end(), first);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+    return keys;
+}
+
+template<typename Map>
+static void benchmark_int_map(char const *name) {
+    auto const keys = shuffled_keys(element_count, 0, 1);
+    // look up in another order than inserted, otherwise the nodes of
+    // std::unordered_map would be visited in the order they were allocated
+    auto const hits = shuffled_keys(element_count, 0, 2);
+    auto const misses = shuffled_keys(element_count, static_cast<int>(element_count), 3);
+
+    std::cout << name << ":" << std::endl;
+
+    auto map = Map();
+    benchmark("insert", keys.size(), [&] {
+        for (auto const key: keys) {
+            map.try_emplace(key, key);
+        }
+    });
+
+    auto reserved = Map();
+    reserved.reserve(keys.size());
+    benchmark("insert after reserve", keys.size(), [&] {
+        for (auto const key: keys) {
+            reserved.try_emplace(key, key);
+        }
+    });
+
+    benchmark("lookup (hit)", hits.size(), [&] {
+        auto sum = 0L;
+        for (auto const key: hits) {
+            sum += map.find(key)->second;
+        }
+        do_not_optimize(sum);
+    });
+
+    benchmark("lookup (miss)", misses.size(), [&] {
+        auto found = std::size_t{0};
+        for (auto const key: misses) {
+            found += map.count(key);
+        }
+        do_not_optimize(found);
+    });
+
+    benchmark("erase", keys.size(), [&] {
+        for (auto const key: keys) {
+            map.erase(key);
+        }
+    });
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(TestFlatHashMapBenchmark, test_int_keys) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    benchmark_int_map<std::unordered_map<int, int>>("std::unordered_map<int, int>");
+    benchmark_int_map<dojo::flat_hash_map<int, int>>("dojo::flat_hash_map<int, int>");
+}
+
+/**
+ * Besides the cache misses, looking up std::unordered_map<std::string, ...>
+ * with a std::string_view costs an extra std::string construction, which can
+ * be avoided by the heterogeneous lookup.
+ */
+TEST(TestFlatHashMapBenchmark, test_string_keys) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const count = element_count / 4;
+    auto words = std::vector<std::string>();
+    for (auto const key: shuffled_keys(count, 0, 4)) {
+        words.push_back("a long enough key to defeat sso #" + std::to_string(key));
+    }
+    auto views = std::vector<std::string_view>(words.begin(), words.end());
+    std::shuffle(views.begin(), views.end(), std::mt19937(5));
+
+    auto node = std::unordered_map<std::string, int>();
+    auto flat = dojo::flat_hash_map<std::string, int, dojo::string_hash, std::equal_to<>>();
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        node.try_emplace(words[i], static_cast<int>(i));
+        flat.try_emplace(words[i], static_cast<int>(i));
+    }
+
+    benchmark("std::unordered_map<std::string> lookup by string_view", count, [&] {
+        auto sum = 0L;
+        for (auto const view: views) {
+            sum += node.find(std::string(view))->second;
+        }
+        do_not_optimize(sum);
+    });
+
+    benchmark("dojo::flat_hash_map<std::string> lookup by string_view", count, [&] {
+        auto sum = 0L;
+        for (auto const view: views) {
+            sum += flat.find(view)->second;
+        }
+        do_not_optimize(sum);
+    });
+}
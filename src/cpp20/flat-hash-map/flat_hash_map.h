@@ -0,0 +1,709 @@
+#ifndef CPP_XX_DOJO_FLAT_HASH_MAP_H
+#define CPP_XX_DOJO_FLAT_HASH_MAP_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../concepts/concepts.h"
+
+/**
+ * A Swiss-table-style open-addressing hash map.
+ *
+ * All the elements live in one flat array of slots, and each slot has a one
+ * byte control word in a parallel array:
+ *   - empty:   0b10000000, the slot has never been used since the last rehash;
+ *   - deleted: 0b11111110, a tombstone left by erase;
+ *   - full:    0b0xxxxxxx, where xxxxxxx are the lowest 7 bits of the hash (h2).
+ *
+ * The remaining bits of the hash (h1) select where the probing starts. Probing
+ * visits a whole group of 16 control bytes at once: with SSE2 comparing a
+ * group against h2 is a single `pcmpeqb` + `pmovmskb`, so a lookup rarely
+ * touches a slot whose key is not equal, and rarely leaves the first group.
+ *
+ * reference from https://abseil.io/about/design/swisstables
+ */
+
+namespace dojo {
+
+namespace detail {
+
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t ctrl_empty = -128;
+inline constexpr ctrl_t ctrl_deleted = -2;
+
+inline constexpr std::size_t group_width = 16;
+
+/**
+ * Spread the entropy of a weak hash (e.g. std::hash<int> is the identity)
+ * over all the bits, since both the highest bits (h1) and the lowest 7 bits
+ * (h2) are consumed separately.
+ */
+inline std::size_t mix_hash(std::size_t const hash) {
+    auto const product = static_cast<unsigned __int128>(hash) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(product) ^ static_cast<std::size_t>(product >> 64);
+}
+
+/**
+ * A group of 16 consecutive control bytes. Each of the match functions returns
+ * a bitmask whose i-th bit is set if the i-th control byte matches.
+ */
+#if defined(__SSE2__)
+class group {
+public:
+    explicit group(ctrl_t const *pos) :
+            m_ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const *>(pos))) {}
+
+    [[nodiscard]] std::uint32_t match(ctrl_t const h2) const {
+        return static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+    }
+
+    [[nodiscard]] std::uint32_t match_empty() const {
+        return match(ctrl_empty);
+    }
+
+    // empty and deleted are the only control bytes with the sign bit set
+    [[nodiscard]] std::uint32_t match_empty_or_deleted() const {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(m_ctrl));
+    }
+
+private:
+    __m128i m_ctrl;
+};
+#else
+class group {
+public:
+    explicit group(ctrl_t const *pos) {
+        std::memcpy(m_ctrl, pos, group_width);
+    }
+
+    [[nodiscard]] std::uint32_t match(ctrl_t const h2) const {
+        auto mask = std::uint32_t{0};
+        for (auto i = std::size_t{0}; i < group_width; ++i) {
+            mask |= static_cast<std::uint32_t>(m_ctrl[i] == h2) << i;
+        }
+        return mask;
+    }
+
+    [[nodiscard]] std::uint32_t match_empty() const {
+        return match(ctrl_empty);
+    }
+
+    [[nodiscard]] std::uint32_t match_empty_or_deleted() const {
+        auto mask = std::uint32_t{0};
+        for (auto i = std::size_t{0}; i < group_width; ++i) {
+            mask |= static_cast<std::uint32_t>(m_ctrl[i] < 0) << i;
+        }
+        return mask;
+    }
+
+private:
+    ctrl_t m_ctrl[group_width]{};
+};
+#endif
+
+}
+
+/**
+ * @brief A transparent hash for strings, which enables heterogeneous lookup
+ * with std::string_view or char const * without constructing a std::string.
+ *
+ * Use it together with std::equal_to<>, which is transparent as well.
+ */
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view const str) const {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+/**
+ * Specify that `Q` can be used to look up a key of type `K` without being
+ * converted to `K` first, which requires both the hash and the equality to
+ * declare themselves as transparent.
+ */
+template<typename Hash, typename Eq, typename K, typename Q>
+concept HeterogeneousKeyFor =
+    requires {
+        typename Hash::is_transparent;
+        typename Eq::is_transparent;
+    } &&
+    HashFor<Hash, Q> &&
+    requires(Eq const &eq, K const &key, Q const &query) {
+        { eq(key, query) } -> std::convertible_to<bool>;
+    };
+
+/**
+ * @brief A Swiss-table-style flat hash map
+ *
+ * Unlike std::unordered_map, the elements are not stable: both references and
+ * iterators are invalidated by any insertion which causes a rehash.
+ *
+ * @tparam K the key type
+ * @tparam V the mapped type
+ * @tparam Hash the hash function object
+ * @tparam Eq the equality function object
+ */
+template<typename K, typename V,
+        typename Hash = std::hash<K>,
+        typename Eq = std::equal_to<K>>
+requires EqComparable<K> && HashFor<Hash, K>
+class flat_hash_map {
+    using ctrl_t = detail::ctrl_t;
+
+    static constexpr auto npos = static_cast<std::size_t>(-1);
+    static constexpr auto min_capacity = detail::group_width;
+
+    /**
+     * The elements are exposed as `pair<K const, V>`, but have to be moved as
+     * `pair<K, V>` when rehashing. Both pairs have the same layout, which is
+     * the same trick as the one used by absl::flat_hash_map.
+     */
+    union slot_type {
+        slot_type() {}  // NOLINT(modernize-use-equals-default)
+        ~slot_type() {}  // NOLINT(modernize-use-equals-default)
+
+        std::pair<K const, V> value;
+        std::pair<K, V> mutable_value;
+    };
+
+    template<bool Const>
+    class basic_iterator {
+        friend class flat_hash_map;
+
+        template<bool>
+        friend class basic_iterator;
+
+        using slot_pointer = std::conditional_t<Const, slot_type const *, slot_type *>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<K const, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, value_type const &, value_type &>;
+        using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+
+        basic_iterator() = default;
+
+        // allow converting an iterator to a const_iterator
+        template<bool OtherConst>
+        requires (Const && !OtherConst)
+        basic_iterator(basic_iterator<OtherConst> const &other) : // NOLINT(google-explicit-constructor)
+                m_ctrl(other.m_ctrl), m_slot(other.m_slot), m_end(other.m_end) {}
+
+        reference operator*() const { return m_slot->value; }
+
+        pointer operator->() const { return &m_slot->value; }
+
+        basic_iterator &operator++() {
+            ++m_ctrl;
+            ++m_slot;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(basic_iterator const &lhs, basic_iterator const &rhs) {
+            return lhs.m_slot == rhs.m_slot;
+        }
+
+    private:
+        basic_iterator(ctrl_t const *ctrl, slot_pointer slot, ctrl_t const *end) :
+                m_ctrl(ctrl), m_slot(slot), m_end(end) {}
+
+        void skip_empty_or_deleted() {
+            while (m_ctrl != m_end && *m_ctrl < 0) {
+                ++m_ctrl;
+                ++m_slot;
+            }
+        }
+
+        ctrl_t const *m_ctrl{};
+        slot_pointer m_slot{};
+        ctrl_t const *m_end{};
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(size_type const capacity, Hash const &hash = Hash(), Eq const &eq = Eq()) :
+            m_hash(hash), m_eq(eq) {
+        reserve(capacity);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> init) {
+        reserve(init.size());
+        for (auto const &value: init) {
+            insert(value);
+        }
+    }
+
+    flat_hash_map(flat_hash_map const &other) :
+            m_hash(other.m_hash), m_eq(other.m_eq) {
+        reserve(other.size());
+        for (auto const &value: other) {
+            insert(value);
+        }
+    }
+
+    flat_hash_map(flat_hash_map &&other) noexcept:
+            m_ctrl(std::exchange(other.m_ctrl, nullptr)),
+            m_slots(std::exchange(other.m_slots, nullptr)),
+            m_capacity(std::exchange(other.m_capacity, 0)),
+            m_size(std::exchange(other.m_size, 0)),
+            m_growth_left(std::exchange(other.m_growth_left, 0)),
+            m_hash(std::move(other.m_hash)),
+            m_eq(std::move(other.m_eq)) {}
+
+    flat_hash_map &operator=(flat_hash_map other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~flat_hash_map() {
+        destroy_and_deallocate();
+    }
+
+    void swap(flat_hash_map &other) noexcept {
+        using std::swap;
+        swap(m_ctrl, other.m_ctrl);
+        swap(m_slots, other.m_slots);
+        swap(m_capacity, other.m_capacity);
+        swap(m_size, other.m_size);
+        swap(m_growth_left, other.m_growth_left);
+        swap(m_hash, other.m_hash);
+        swap(m_eq, other.m_eq);
+    }
+
+    // iterators
+
+    iterator begin() {
+        auto it = iterator(m_ctrl, m_slots, m_ctrl + m_capacity);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+
+    iterator end() {
+        return iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity);
+    }
+
+    const_iterator begin() const {
+        auto it = const_iterator(m_ctrl, m_slots, m_ctrl + m_capacity);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+
+    const_iterator end() const {
+        return const_iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity);
+    }
+
+    // capacity
+
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    [[nodiscard]] size_type size() const { return m_size; }
+
+    [[nodiscard]] size_type capacity() const { return m_capacity; }
+
+    [[nodiscard]] float load_factor() const {
+        return m_capacity ? static_cast<float>(m_size) / static_cast<float>(m_capacity) : 0.0f;
+    }
+
+    /**
+     * Make room for at least `count` elements without any further rehash.
+     */
+    void reserve(size_type const count) {
+        auto capacity = min_capacity;
+        while (max_load(capacity) < count) {
+            capacity *= 2;
+        }
+        if (capacity > m_capacity) {
+            resize(capacity);
+        }
+    }
+
+    // modifiers
+
+    void clear() {
+        for (auto i = size_type{0}; i < m_capacity; ++i) {
+            if (m_ctrl[i] >= 0) {
+                std::destroy_at(&m_slots[i].value);
+            }
+        }
+        if (m_capacity) {
+            std::memset(m_ctrl, detail::ctrl_empty, m_capacity + detail::group_width - 1);
+        }
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args) {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(value_type const &value) {
+        return try_emplace_impl(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return try_emplace_impl(value.first, std::move(value.second));
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj) {
+        auto result = try_emplace_impl(key, std::forward<M>(obj));
+        if (!result.second) {
+            result.first->second = std::forward<M>(obj);
+        }
+        return result;
+    }
+
+    V &operator[](K const &key) {
+        return try_emplace_impl(key).first->second;
+    }
+
+    V &operator[](K &&key) {
+        return try_emplace_impl(std::move(key)).first->second;
+    }
+
+    size_type erase(K const &key) {
+        return erase_impl(key);
+    }
+
+    template<typename Q>
+    requires HeterogeneousKeyFor<Hash, Eq, K, Q>
+    size_type erase(Q const &key) {
+        return erase_impl(key);
+    }
+
+    /**
+     * Erase the element at `pos`, and return the iterator following it. No
+     * element is moved by erasing, hence only iterators to the erased element
+     * are invalidated.
+     */
+    iterator erase(const_iterator pos) {
+        auto const index = static_cast<size_type>(pos.m_slot - m_slots);
+        erase_at(index);
+        auto it = iterator(m_ctrl + index, m_slots + index, m_ctrl + m_capacity);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator(pos));
+    }
+
+    // lookup
+
+    iterator find(K const &key) {
+        return iterator_at(find_index(key));
+    }
+
+    const_iterator find(K const &key) const {
+        return iterator_at(find_index(key));
+    }
+
+    template<typename Q>
+    requires HeterogeneousKeyFor<Hash, Eq, K, Q>
+    iterator find(Q const &key) {
+        return iterator_at(find_index(key));
+    }
+
+    template<typename Q>
+    requires HeterogeneousKeyFor<Hash, Eq, K, Q>
+    const_iterator find(Q const &key) const {
+        return iterator_at(find_index(key));
+    }
+
+    [[nodiscard]] bool contains(K const &key) const {
+        return find_index(key) != npos;
+    }
+
+    template<typename Q>
+    requires HeterogeneousKeyFor<Hash, Eq, K, Q>
+    [[nodiscard]] bool contains(Q const &key) const {
+        return find_index(key) != npos;
+    }
+
+    [[nodiscard]] size_type count(K const &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    template<typename Q>
+    requires HeterogeneousKeyFor<Hash, Eq, K, Q>
+    [[nodiscard]] size_type count(Q const &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    V &at(K const &key) {
+        auto const index = find_index(key);
+        if (index == npos) {
+            throw std::out_of_range("flat_hash_map::at: key not found");
+        }
+        return m_slots[index].value.second;
+    }
+
+    V const &at(K const &key) const {
+        return const_cast<flat_hash_map *>(this)->at(key);
+    }
+
+    // observers
+
+    hasher hash_function() const { return m_hash; }
+
+    key_equal key_eq() const { return m_eq; }
+
+private:
+    // keep the load factor no higher than 7/8
+    static size_type max_load(size_type const capacity) {
+        return capacity - capacity / 8;
+    }
+
+    [[nodiscard]] size_type mask() const { return m_capacity - 1; }
+
+    template<typename Q>
+    [[nodiscard]] std::size_t hash_of(Q const &key) const {
+        return detail::mix_hash(static_cast<std::size_t>(m_hash(key)));
+    }
+
+    static size_type h1(std::size_t const hash) { return hash >> 7; }
+
+    static ctrl_t h2(std::size_t const hash) { return static_cast<ctrl_t>(hash & 0x7f); }
+
+    iterator iterator_at(size_type const index) {
+        if (index == npos) {
+            return end();
+        }
+        return iterator(m_ctrl + index, m_slots + index, m_ctrl + m_capacity);
+    }
+
+    const_iterator iterator_at(size_type const index) const {
+        if (index == npos) {
+            return end();
+        }
+        return const_iterator(m_ctrl + index, m_slots + index, m_ctrl + m_capacity);
+    }
+
+    /**
+     * Set the control byte of slot `index`. The first `group_width - 1` bytes
+     * are cloned after the end of the control bytes, so that a group can be
+     * loaded from any position without wrapping around.
+     */
+    void set_ctrl(size_type const index, ctrl_t const value) {
+        m_ctrl[index] = value;
+        if (index < detail::group_width - 1) {
+            m_ctrl[m_capacity + index] = value;
+        }
+    }
+
+    /**
+     * Probe groups with a triangular sequence (+1, +2, +3, ... groups), which
+     * visits every group exactly once when the capacity is a power of two.
+     */
+    template<typename Q>
+    [[nodiscard]] size_type find_index(Q const &key) const {
+        if (m_size == 0) {
+            return npos;
+        }
+        auto const hash = hash_of(key);
+        auto pos = h1(hash) & mask();
+        auto step = size_type{0};
+        while (true) {
+            auto const g = detail::group(m_ctrl + pos);
+            for (auto bits = g.match(h2(hash)); bits; bits &= bits - 1) {
+                auto const index = (pos + std::countr_zero(bits)) & mask();
+                if (m_eq(m_slots[index].value.first, key)) {
+                    return index;
+                }
+            }
+            if (g.match_empty()) {
+                return npos;
+            }
+            step += detail::group_width;
+            pos = (pos + step) & mask();
+        }
+    }
+
+    [[nodiscard]] size_type find_first_non_full(std::size_t const hash) const {
+        auto pos = h1(hash) & mask();
+        auto step = size_type{0};
+        while (true) {
+            if (auto const bits = detail::group(m_ctrl + pos).match_empty_or_deleted()) {
+                return (pos + std::countr_zero(bits)) & mask();
+            }
+            step += detail::group_width;
+            pos = (pos + step) & mask();
+        }
+    }
+
+    template<typename Q, typename... Args>
+    std::pair<iterator, bool> try_emplace_impl(Q &&key, Args &&...args) {
+        if (auto const index = find_index(key); index != npos) {
+            return {iterator_at(index), false};
+        }
+
+        auto const hash = hash_of(key);
+        if (m_capacity == 0) {
+            resize(min_capacity);
+        }
+        auto index = find_first_non_full(hash);
+        // reusing a tombstone does not consume the growth budget
+        if (m_growth_left == 0 && m_ctrl[index] != detail::ctrl_deleted) {
+            grow();
+            index = find_first_non_full(hash);
+        }
+
+        std::construct_at(&m_slots[index].value,
+                          std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<Q>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        if (m_ctrl[index] == detail::ctrl_empty) {
+            --m_growth_left;
+        }
+        set_ctrl(index, h2(hash));
+        ++m_size;
+        return {iterator_at(index), true};
+    }
+
+    template<typename Q>
+    size_type erase_impl(Q const &key) {
+        auto const index = find_index(key);
+        if (index == npos) {
+            return 0;
+        }
+        erase_at(index);
+        return 1;
+    }
+
+    /**
+     * A slot can go back to empty instead of becoming a tombstone if every
+     * group covering it contains an empty slot, since no probe could have
+     * passed through it then.
+     */
+    void erase_at(size_type const index) {
+        std::destroy_at(&m_slots[index].value);
+        --m_size;
+
+        auto const index_before = (index - detail::group_width) & mask();
+        auto const empty_before = detail::group(m_ctrl + index_before).match_empty();
+        auto const empty_after = detail::group(m_ctrl + index).match_empty();
+        auto const was_never_full =
+                empty_before && empty_after &&
+                static_cast<std::size_t>(std::countl_zero(empty_before) - 16 + std::countr_zero(empty_after))
+                < detail::group_width;
+
+        if (was_never_full) {
+            set_ctrl(index, detail::ctrl_empty);
+            ++m_growth_left;
+        } else {
+            set_ctrl(index, detail::ctrl_deleted);
+        }
+    }
+
+    /**
+     * Double the capacity, unless most of the used slots are tombstones, in
+     * which case rehashing in place is enough to reclaim them.
+     */
+    void grow() {
+        if (m_size <= max_load(m_capacity) / 2) {
+            resize(m_capacity);
+        } else {
+            resize(m_capacity * 2);
+        }
+    }
+
+    void resize(size_type const new_capacity) {
+        auto *const old_ctrl = m_ctrl;
+        auto *const old_slots = m_slots;
+        auto const old_capacity = m_capacity;
+
+        auto const ctrl_size = new_capacity + detail::group_width - 1;
+        m_ctrl = new ctrl_t[ctrl_size];
+        std::memset(m_ctrl, detail::ctrl_empty, ctrl_size);
+        m_slots = std::allocator<slot_type>().allocate(new_capacity);
+        m_capacity = new_capacity;
+        m_growth_left = max_load(new_capacity) - m_size;
+
+        for (auto i = size_type{0}; i < old_capacity; ++i) {
+            if (old_ctrl[i] < 0) {
+                continue;
+            }
+            auto &old_slot = old_slots[i];
+            auto const hash = hash_of(old_slot.value.first);
+            auto const index = find_first_non_full(hash);
+            std::construct_at(&m_slots[index].mutable_value, std::move(old_slot.mutable_value));
+            std::destroy_at(&old_slot.mutable_value);
+            set_ctrl(index, h2(hash));
+        }
+
+        delete[] old_ctrl;
+        if (old_slots) {
+            std::allocator<slot_type>().deallocate(old_slots, old_capacity);
+        }
+    }
+
+    void destroy_and_deallocate() {
+        if (!m_capacity) {
+            return;
+        }
+        for (auto i = size_type{0}; i < m_capacity; ++i) {
+            if (m_ctrl[i] >= 0) {
+                std::destroy_at(&m_slots[i].value);
+            }
+        }
+        delete[] m_ctrl;
+        std::allocator<slot_type>().deallocate(m_slots, m_capacity);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = m_size = m_growth_left = 0;
+    }
+
+    ctrl_t *m_ctrl = nullptr;
+    slot_type *m_slots = nullptr;
+    size_type m_capacity = 0;
+    size_type m_size = 0;
+    size_type m_growth_left = 0;
+    [[no_unique_address]] Hash m_hash{};
+    [[no_unique_address]] Eq m_eq{};
+};
+
+}
+
+#endif //CPP_XX_DOJO_FLAT_HASH_MAP_H
@@ -30,6 +30,10 @@ TEST(TestJthread, test_jthread) { // NOLINT(cert-err58-cpp)
 
 /**
  * jthread can be cancelled/stopped by calling request_stop
+ *
+ * NOTE: polling the token between sleeps delays noticing the stop by up to
+ * one sleeping interval. See the cancellation case for sleeping and waiting
+ * which are woken up by the stop immediately.
  */
 TEST(TestJthread, test_stop_jthread) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " <<  __PRETTY_FUNCTION__ << " ..." << std::endl;
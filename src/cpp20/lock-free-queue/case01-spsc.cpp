@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "spsc_ring_buffer.h"
+
+/**
+ * A ring buffer for handing elements from exactly one producer thread over to
+ * exactly one consumer thread, e.g. between two stages of a pipeline.
+ *
+ * Compared with passing a std::promise per element, the ring buffer is
+ * reusable, bounded (which gives backpressure), and needs no allocation.
+ */
+
+TEST(TestSpscRingBuffer, test_push_pop) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the capacity is rounded up to a power of two
+    auto ring = dojo::spsc_ring_buffer<std::string>(3);
+    ASSERT_EQ(ring.capacity(), 4);
+
+    ASSERT_FALSE(ring.try_pop());
+
+    for (auto i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_push(std::to_string(i)));
+    }
+    // full
+    ASSERT_FALSE(ring.try_push("4"));
+    ASSERT_EQ(ring.size(), 4);
+
+    // first in first out
+    ASSERT_EQ(ring.try_pop(), "0");
+    ASSERT_TRUE(ring.try_emplace(3, 'x'));
+    ASSERT_EQ(ring.pop(), "1");
+    ASSERT_EQ(ring.pop(), "2");
+    ASSERT_EQ(ring.pop(), "3");
+    ASSERT_EQ(ring.pop(), "xxx");
+    ASSERT_FALSE(ring.try_pop());
+}
+
+TEST(TestSpscRingBuffer, test_destroy_remaining_elements) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const tracker = std::make_shared<int>(0);
+    {
+        auto ring = dojo::spsc_ring_buffer<std::shared_ptr<int>>(8);
+        ring.push(tracker);
+        ring.push(tracker);
+        ASSERT_EQ(tracker.use_count(), 3);
+    }
+    ASSERT_EQ(tracker.use_count(), 1);
+}
+
+/**
+ * The ring is much smaller than the count of elements, hence both sides keep
+ * blocking on each other, which checks that no element is lost, duplicated
+ * or reordered, and that no wake-up is lost.
+ */
+TEST(TestSpscRingBuffer, test_stress) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto count = std::uint64_t{1'000'000};
+    auto ring = dojo::spsc_ring_buffer<std::uint64_t>(16);
+
+    auto producer = std::jthread([&] {
+        for (auto i = std::uint64_t{0}; i < count; ++i) {
+            ring.push(i);
+        }
+    });
+
+    auto sum = std::uint64_t{0};
+    for (auto i = std::uint64_t{0}; i < count; ++i) {
+        auto const value = ring.pop();
+        ASSERT_EQ(value, i);
+        sum += value;
+    }
+    ASSERT_EQ(sum, count * (count - 1) / 2);
+}
@@ -0,0 +1,76 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mpmc_queue.h"
+
+/**
+ * A bounded queue for any count of producer and consumer threads, e.g. the
+ * task queue of a thread pool.
+ */
+
+TEST(TestMpmcQueue, test_push_pop) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto queue = dojo::mpmc_queue<std::unique_ptr<int>>(4);
+    ASSERT_EQ(queue.capacity(), 4);
+    ASSERT_FALSE(queue.try_pop());
+
+    for (auto i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_push(std::make_unique<int>(i)));
+    }
+    // full: the element is not consumed on failure
+    auto rejected = std::make_unique<int>(4);
+    ASSERT_FALSE(queue.try_push(std::move(rejected)));
+    ASSERT_NE(rejected, nullptr); // NOLINT(bugprone-use-after-move)
+
+    // first in first out, also across the laps of the ring
+    for (auto i = 0; i < 8; ++i) {
+        ASSERT_EQ(*queue.pop(), i);
+        queue.push(std::make_unique<int>(i + 4));
+    }
+}
+
+/**
+ * Several producers and consumers hammer a small queue with blocking push and
+ * pop. Every value must be consumed exactly once.
+ */
+TEST(TestMpmcQueue, test_stress) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto producer_count = 4;
+    constexpr auto consumer_count = 4;
+    constexpr auto count_per_producer = std::uint32_t{100'000};
+    constexpr auto total = count_per_producer * producer_count;
+
+    auto queue = dojo::mpmc_queue<std::uint32_t>(8);
+    auto seen = std::vector<std::atomic<int>>(total);
+
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto p = 0; p < producer_count; ++p) {
+            threads.emplace_back([&, p] {
+                for (auto i = std::uint32_t{0}; i < count_per_producer; ++i) {
+                    queue.push(p * count_per_producer + i);
+                }
+            });
+        }
+        for (auto c = 0; c < consumer_count; ++c) {
+            threads.emplace_back([&] {
+                for (auto i = std::uint32_t{0}; i < total / consumer_count; ++i) {
+                    seen[queue.pop()].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+    }
+
+    ASSERT_FALSE(queue.try_pop());
+    for (auto const &times: seen) {
+        ASSERT_EQ(times.load(), 1);
+    }
+}
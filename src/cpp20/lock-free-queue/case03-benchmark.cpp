@@ -0,0 +1,125 @@
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mpmc_queue.h"
+#include "spsc_ring_buffer.h"
+#include "../../../utils.h"
+
+/**
+ * Throughput of handing over integers between 1..N producer/consumer pairs.
+ *
+ * The baseline is the textbook bounded queue made of std::mutex,
+ * std::condition_variable and std::deque.
+ *
+ * With fewer cores than threads, every hand-off costs a context switch either
+ * way, which hides the difference; the numbers are meaningful on a machine
+ * with at least two cores per pair.
+ */
+
+static constexpr auto count_per_pair = std::uint64_t{200'000};
+static constexpr auto queue_capacity = std::size_t{1024};
+static constexpr int pair_counts[] = {1, 2, 4};
+
+template<typename T>
+class locked_queue {
+public:
+    explicit locked_queue(std::size_t const capacity) : m_capacity(capacity) {}
+
+    void push(T value) {
+        auto lock = std::unique_lock(m_mutex);
+        m_not_full.wait(lock, [this] { return m_queue.size() < m_capacity; });
+        m_queue.push_back(std::move(value));
+        m_not_empty.notify_one();
+    }
+
+    T pop() {
+        auto lock = std::unique_lock(m_mutex);
+        m_not_empty.wait(lock, [this] { return !m_queue.empty(); });
+        auto value = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_not_full.notify_one();
+        return value;
+    }
+
+private:
+    std::size_t const m_capacity;
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+    std::deque<T> m_queue;
+};
+
+/**
+ * Run `pairs` producers and `pairs` consumers, where the i-th producer and
+ * the i-th consumer share `queue_of(i)`.
+ */
+template<typename QueueOf>
+static void run_pairs(int const pairs, QueueOf &&queue_of) {
+    auto threads = std::vector<std::jthread>();
+    for (auto i = 0; i < pairs; ++i) {
+        threads.emplace_back([&queue = queue_of(i)] {
+            for (auto n = std::uint64_t{0}; n < count_per_pair; ++n) {
+                queue.push(n);
+            }
+        });
+        threads.emplace_back([&queue = queue_of(i)] {
+            auto sum = std::uint64_t{0};
+            for (auto n = std::uint64_t{0}; n < count_per_pair; ++n) {
+                sum += queue.pop();
+            }
+            do_not_optimize(sum);
+        });
+    }
+}
+
+TEST(TestLockFreeQueueBenchmark, test_spsc_pairs) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const pairs: pair_counts) {
+        auto const ops = count_per_pair * pairs;
+        auto const suffix = " x" + std::to_string(pairs) + " pairs";
+
+        auto locked = std::vector<std::unique_ptr<locked_queue<std::uint64_t>>>();
+        auto rings = std::vector<std::unique_ptr<dojo::spsc_ring_buffer<std::uint64_t>>>();
+        for (auto i = 0; i < pairs; ++i) {
+            locked.push_back(std::make_unique<locked_queue<std::uint64_t>>(queue_capacity));
+            rings.push_back(std::make_unique<dojo::spsc_ring_buffer<std::uint64_t>>(queue_capacity));
+        }
+
+        benchmark(("mutex + condition_variable" + suffix).c_str(), ops, [&] {
+            run_pairs(pairs, [&](int const i) -> auto & { return *locked[i]; });
+        });
+        benchmark(("spsc_ring_buffer" + suffix).c_str(), ops, [&] {
+            run_pairs(pairs, [&](int const i) -> auto & { return *rings[i]; });
+        });
+    }
+}
+
+TEST(TestLockFreeQueueBenchmark, test_mpmc_pairs) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const pairs: pair_counts) {
+        auto const ops = count_per_pair * pairs;
+        auto const suffix = " x" + std::to_string(pairs) + " pairs";
+
+        // all the pairs share the same queue
+        auto locked = locked_queue<std::uint64_t>(queue_capacity);
+        auto queue = dojo::mpmc_queue<std::uint64_t>(queue_capacity);
+
+        benchmark(("mutex + condition_variable" + suffix).c_str(), ops, [&] {
+            run_pairs(pairs, [&](int) -> auto & { return locked; });
+        });
+        benchmark(("mpmc_queue" + suffix).c_str(), ops, [&] {
+            run_pairs(pairs, [&](int) -> auto & { return queue; });
+        });
+    }
+}
@@ -0,0 +1,184 @@
+#ifndef CPP_XX_DOJO_MPMC_QUEUE_H
+#define CPP_XX_DOJO_MPMC_QUEUE_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "../../../utils.h"
+
+namespace dojo {
+
+/**
+ * @brief A bounded lock-free multi-producer multi-consumer queue
+ *
+ * Dmitry Vyukov's design: every cell carries a sequence number telling which
+ * lap of the ring it's ready for.
+ *   - a producer claims position `pos` by CAS on the enqueue position, once
+ *     the sequence of the cell equals `pos`; it publishes the element by
+ *     storing `pos + 1` to the sequence;
+ *   - a consumer claims position `pos` by CAS on the dequeue position, once
+ *     the sequence of the cell equals `pos + 1`; it releases the cell for the
+ *     next lap by storing `pos + capacity` to the sequence.
+ *
+ * Producers and consumers only contend on their own position counter, and
+ * hand over each element through the cell itself.
+ *
+ * reference from https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * @tparam T the type of the elements
+ */
+template<typename T>
+class mpmc_queue {
+public:
+    /**
+     * @param capacity rounded up to a power of two
+     */
+    explicit mpmc_queue(std::size_t const capacity) :
+            m_capacity(static_cast<sequence_t>(std::bit_ceil(capacity < 2 ? 2 : capacity))),
+            m_cells(std::make_unique<cell[]>(m_capacity)) {
+        for (auto i = sequence_t{0}; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(mpmc_queue const &) = delete;
+
+    mpmc_queue &operator=(mpmc_queue const &) = delete;
+
+    ~mpmc_queue() {
+        while (try_pop()) {
+        }
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+
+    template<typename... Args>
+    bool try_emplace(Args &&...args) {
+        auto pos = m_enqueue_pos.value.load(std::memory_order_relaxed);
+        while (true) {
+            auto &c = cell_at(pos);
+            auto const seq = c.sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::int32_t>(seq - pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::construct_at(c.element(), std::forward<Args>(args)...);
+                    c.sequence.store(static_cast<sequence_t>(pos + 1), std::memory_order_release);
+                    c.sequence.notify_all();
+                    return true;
+                }
+            } else if (diff < 0) {
+                // the cell still holds the element of the previous lap: full
+                return false;
+            } else {
+                // another producer has claimed this position
+                pos = m_enqueue_pos.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_push(T const &value) { return try_emplace(value); }
+
+    bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+    std::optional<T> try_pop() {
+        auto pos = m_dequeue_pos.value.load(std::memory_order_relaxed);
+        while (true) {
+            auto &c = cell_at(pos);
+            auto const seq = c.sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::int32_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (m_dequeue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    auto value = std::optional<T>(std::move(*c.element()));
+                    std::destroy_at(c.element());
+                    c.sequence.store(static_cast<sequence_t>(pos + m_capacity), std::memory_order_release);
+                    c.sequence.notify_all();
+                    return value;
+                }
+            } else if (diff < 0) {
+                // the cell is not filled for this lap yet: empty
+                return std::nullopt;
+            } else {
+                // another consumer has claimed this position
+                pos = m_dequeue_pos.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Block until there's room for the element, by spinning for a while first,
+     * and then parking on the sequence of the next cell with atomic::wait,
+     * which changes once the consumer of the previous lap releases it.
+     */
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        for (auto spin = 0; !try_emplace(std::forward<Args>(args)...); ++spin) {
+            if (spin >= max_spin) {
+                auto const pos = m_enqueue_pos.value.load(std::memory_order_relaxed);
+                auto &c = cell_at(pos);
+                // full if the cell is still one lap behind
+                c.sequence.wait(static_cast<sequence_t>(pos - m_capacity + 1), std::memory_order_acquire);
+            }
+        }
+    }
+
+    void push(T const &value) { emplace(value); }
+
+    void push(T &&value) { emplace(std::move(value)); }
+
+    /**
+     * Block until there's an element, by spinning for a while first, and then
+     * parking on the sequence of the next cell with atomic::wait, which
+     * changes once the producer fills it.
+     */
+    T pop() {
+        for (auto spin = 0;; ++spin) {
+            if (auto value = try_pop()) {
+                return std::move(*value);
+            }
+            if (spin >= max_spin) {
+                auto const pos = m_dequeue_pos.value.load(std::memory_order_relaxed);
+                auto &c = cell_at(pos);
+                // empty if the cell is still waiting for this lap's element
+                c.sequence.wait(pos, std::memory_order_acquire);
+            }
+        }
+    }
+
+private:
+    /**
+     * The positions and the sequences keep increasing and wrap around, which
+     * is fine as long as the capacity is a power of two and far below 2^31.
+     * They are 32 bits since that's what a futex waits on, hence
+     * atomic::wait/notify on them need no proxy in libstdc++.
+     */
+    using sequence_t = std::uint32_t;
+
+    // spinning only makes sense if the other side can run meanwhile
+    static inline auto const max_spin = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+
+    struct cell {
+        std::atomic<sequence_t> sequence;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T *element() { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    cell &cell_at(sequence_t const pos) { return m_cells[pos & (m_capacity - 1)]; }
+
+    sequence_t const m_capacity;
+    std::unique_ptr<cell[]> const m_cells;
+
+    cache_line_padded<std::atomic<sequence_t>> m_enqueue_pos{0};
+    cache_line_padded<std::atomic<sequence_t>> m_dequeue_pos{0};
+};
+
+}
+
+#endif //CPP_XX_DOJO_MPMC_QUEUE_H
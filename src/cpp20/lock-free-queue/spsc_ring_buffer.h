@@ -0,0 +1,170 @@
+#ifndef CPP_XX_DOJO_SPSC_RING_BUFFER_H
+#define CPP_XX_DOJO_SPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "../../../utils.h"
+
+namespace dojo {
+
+/**
+ * @brief A bounded lock-free single-producer single-consumer ring buffer
+ *
+ * The producer only writes the tail and the consumer only writes the head,
+ * so each side publishes its progress with a single release store, and no
+ * read-modify-write is needed at all. Both indices live on their own cache
+ * line, together with a private copy of the other side's index, which is only
+ * refreshed when the ring looks full (for the producer) or empty (for the
+ * consumer). That saves most of the cache line transfers between the cores.
+ *
+ * reference from https://rigtorp.se/ringbuffer/
+ *
+ * @tparam T the type of the elements
+ */
+template<typename T>
+class spsc_ring_buffer {
+public:
+    /**
+     * @param capacity rounded up to a power of two
+     */
+    explicit spsc_ring_buffer(std::size_t const capacity) :
+            m_capacity(static_cast<index_t>(std::bit_ceil(capacity < 2 ? 2 : capacity))),
+            m_slots(std::make_unique<slot[]>(m_capacity)) {}
+
+    spsc_ring_buffer(spsc_ring_buffer const &) = delete;
+
+    spsc_ring_buffer &operator=(spsc_ring_buffer const &) = delete;
+
+    ~spsc_ring_buffer() {
+        auto const tail = m_tail.value.load(std::memory_order_relaxed);
+        for (auto head = m_head.value.load(std::memory_order_relaxed); head != tail; ++head) {
+            std::destroy_at(element_at(head));
+        }
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+
+    /**
+     * Only a snapshot, which may be stale as soon as it's returned.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return static_cast<index_t>(
+                m_tail.value.load(std::memory_order_acquire) - m_head.value.load(std::memory_order_acquire));
+    }
+
+    // producer side
+
+    template<typename... Args>
+    bool try_emplace(Args &&...args) {
+        auto const tail = m_tail.value.load(std::memory_order_relaxed);
+        if (static_cast<index_t>(tail - m_producer_cache.value) == m_capacity) {
+            m_producer_cache.value = m_head.value.load(std::memory_order_acquire);
+            if (static_cast<index_t>(tail - m_producer_cache.value) == m_capacity) {
+                return false;
+            }
+        }
+        std::construct_at(element_at(tail), std::forward<Args>(args)...);
+        m_tail.value.store(tail + 1, std::memory_order_release);
+        m_tail.value.notify_one();
+        return true;
+    }
+
+    bool try_push(T const &value) { return try_emplace(value); }
+
+    bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+    /**
+     * Block until there's room for the element, by spinning for a while first,
+     * and then parking on the head index with C++20 atomic::wait.
+     */
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        for (auto spin = 0; !try_emplace(std::forward<Args>(args)...); ++spin) {
+            if (spin >= max_spin) {
+                // full: the head equals tail - capacity until the consumer moves on
+                auto const tail = m_tail.value.load(std::memory_order_relaxed);
+                m_head.value.wait(static_cast<index_t>(tail - m_capacity), std::memory_order_acquire);
+            }
+        }
+    }
+
+    void push(T const &value) { emplace(value); }
+
+    void push(T &&value) { emplace(std::move(value)); }
+
+    // consumer side
+
+    std::optional<T> try_pop() {
+        auto const head = m_head.value.load(std::memory_order_relaxed);
+        if (head == m_consumer_cache.value) {
+            m_consumer_cache.value = m_tail.value.load(std::memory_order_acquire);
+            if (head == m_consumer_cache.value) {
+                return std::nullopt;
+            }
+        }
+        auto *const element = element_at(head);
+        auto value = std::optional<T>(std::move(*element));
+        std::destroy_at(element);
+        m_head.value.store(head + 1, std::memory_order_release);
+        m_head.value.notify_one();
+        return value;
+    }
+
+    /**
+     * Block until there's an element, by spinning for a while first, and then
+     * parking on the tail index with C++20 atomic::wait.
+     */
+    T pop() {
+        for (auto spin = 0;; ++spin) {
+            if (auto value = try_pop()) {
+                return std::move(*value);
+            }
+            if (spin >= max_spin) {
+                // empty: the tail equals the head until the producer moves on
+                m_tail.value.wait(m_head.value.load(std::memory_order_relaxed), std::memory_order_acquire);
+            }
+        }
+    }
+
+private:
+    /**
+     * The indices keep increasing and wrap around, which is fine as long as the
+     * capacity is a power of two. They are 32 bits since that's what a futex
+     * waits on, hence atomic::wait/notify on them need no proxy in libstdc++.
+     */
+    using index_t = std::uint32_t;
+
+    // spinning only makes sense if the other side can run meanwhile
+    static inline auto const max_spin = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+
+    struct slot {
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    T *element_at(index_t const index) {
+        return std::launder(reinterpret_cast<T *>(m_slots[index & (m_capacity - 1)].storage));
+    }
+
+    index_t const m_capacity;
+    std::unique_ptr<slot[]> const m_slots;
+
+    // written by the consumer only
+    cache_line_padded<std::atomic<index_t>> m_head{0};
+    cache_line_padded<index_t> m_consumer_cache{0};
+
+    // written by the producer only
+    cache_line_padded<std::atomic<index_t>> m_tail{0};
+    cache_line_padded<index_t> m_producer_cache{0};
+};
+
+}
+
+#endif //CPP_XX_DOJO_SPSC_RING_BUFFER_H
@@ -0,0 +1,127 @@
+#ifndef CPP_XX_DOJO_ADAPTIVE_MUTEX_H
+#define CPP_XX_DOJO_ADAPTIVE_MUTEX_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "contention_stats.h"
+#include "../synchronization/spin_wait.h"
+
+namespace dojo {
+
+/**
+ * @brief A mutex which spins for about as long as it has recently taken to
+ * get it, before parking
+ *
+ * The state is a 32-bit word: unlocked, locked, or locked with parked
+ * waiters, which is what the waiters park on with atomic::wait. Unlocking
+ * only issues a system call in the last state.
+ *
+ * The spinning adapts like glibc's PTHREAD_MUTEX_ADAPTIVE_NP: it's bounded by
+ * twice the moving average of the spins which did get the lock, except that
+ * every spinning which doesn't get it decays the average rather than counts
+ * as the most spins, so a mutex held for long quickly stops wasting cpu on
+ * spinning, while one held for a few instructions is mostly taken without
+ * ever parking. The bound is capped
+ * by dojo::spin_limit, which is 0 on a single core.
+ *
+ * reference from https://akkadia.org/drepper/futex.pdf
+ *
+ * @tparam Stats contention_stats to count, or no_contention_stats not to
+ */
+template<typename Stats = no_contention_stats>
+class adaptive_mutex {
+public:
+    adaptive_mutex() = default;
+
+    adaptive_mutex(adaptive_mutex const &) = delete;
+
+    adaptive_mutex &operator=(adaptive_mutex const &) = delete;
+
+    [[nodiscard]] bool try_lock() noexcept {
+        auto expected = unlocked;
+        if (m_state.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+            on_acquired(0, false);
+            return true;
+        }
+        return false;
+    }
+
+    void lock() noexcept {
+        auto expected = unlocked;
+        if (m_state.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+            on_acquired(0, false);
+            return;
+        }
+
+        auto const estimate = m_spin_estimate.load(std::memory_order_relaxed);
+        auto const max_spins = std::min(static_cast<std::uint32_t>(spin_limit.load(std::memory_order_relaxed)),
+                                        estimate * 2 + 10);
+        for (auto spins = std::uint32_t{1}; spins <= max_spins; ++spins) {
+            detail::cpu_relax();
+            expected = unlocked;
+            if (m_state.load(std::memory_order_relaxed) == unlocked &&
+                m_state.compare_exchange_weak(expected, locked, std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                adapt(estimate, spins);
+                on_acquired(spins, false);
+                return;
+            }
+        }
+        if (max_spins != 0) {
+            // held for longer than worth spinning, which glibc would count as
+            // max_spins, ratcheting the estimate up to the cap
+            adapt(estimate, 0);
+        }
+
+        // announce a waiter, which the unlock has to wake up
+        auto parked = false;
+        while (m_state.exchange(contended, std::memory_order_acquire) != unlocked) {
+            parked = true;
+            m_state.wait(contended, std::memory_order_relaxed);
+        }
+        on_acquired(max_spins, parked);
+    }
+
+    void unlock() noexcept {
+        if constexpr (Stats::enabled) {
+            m_stats.on_release(m_acquired_at);
+        }
+        if (m_state.exchange(unlocked, std::memory_order_release) == contended) {
+            m_state.notify_one();
+        }
+    }
+
+    [[nodiscard]] contention_snapshot stats() const noexcept { return m_stats.snapshot(); }
+
+private:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t contended = 2;
+
+    void adapt(std::uint32_t const estimate, std::uint32_t const spins) noexcept {
+        // a racy moving average is good enough
+        auto const delta = (static_cast<std::int64_t>(spins) - static_cast<std::int64_t>(estimate)) / 8;
+        m_spin_estimate.store(static_cast<std::uint32_t>(estimate + delta), std::memory_order_relaxed);
+    }
+
+    void on_acquired(std::uint32_t const spins, bool const parked) noexcept {
+        if constexpr (Stats::enabled) {
+            m_stats.on_acquire(spins, parked);
+            m_acquired_at = Stats::clock::now();
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{unlocked};
+    std::atomic<std::uint32_t> m_spin_estimate{0};
+    [[no_unique_address]] Stats m_stats;
+    // only written and read by the owner
+    [[no_unique_address]] std::conditional_t<Stats::enabled, typename Stats::clock::time_point, no_contention_stats>
+            m_acquired_at{};
+};
+
+}
+
+#endif //CPP_XX_DOJO_ADAPTIVE_MUTEX_H
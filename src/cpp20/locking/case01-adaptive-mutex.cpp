@@ -0,0 +1,113 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "adaptive_mutex.h"
+
+/**
+ * An adaptive mutex spins for about as long as the lock has recently been
+ * held, then parks in the kernel. With contention stats, it tells how often
+ * it was contended and how long it was held.
+ */
+
+TEST(TestAdaptiveMutex, test_mutual_exclusion) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto thread_count = 8;
+    constexpr auto rounds = 20'000;
+    auto mutex = dojo::adaptive_mutex<>();
+    auto counter = 0;  // not atomic: only ever touched under the lock
+
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&] {
+                for (auto round = 0; round < rounds; ++round) {
+                    auto const lock = std::lock_guard(mutex);
+                    ++counter;
+                }
+            });
+        }
+    }
+    ASSERT_EQ(thread_count * rounds, counter);
+}
+
+TEST(TestAdaptiveMutex, test_try_lock) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto mutex = dojo::adaptive_mutex<>();
+    ASSERT_TRUE(mutex.try_lock());
+    std::jthread([&] { ASSERT_FALSE(mutex.try_lock()); }).join();
+    mutex.unlock();
+    std::jthread([&] {
+        ASSERT_TRUE(mutex.try_lock());
+        mutex.unlock();
+    }).join();
+}
+
+/**
+ * A mutex always held for longer than worth spinning for spins less and less,
+ * down to the least bound, rather than ever more.
+ */
+TEST(TestAdaptiveMutex, test_spinning_decays) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // spin even on a single core, which is all this is about
+    auto const limit = dojo::spin_limit.exchange(128);
+    auto mutex = dojo::adaptive_mutex<dojo::contention_stats>();
+    auto const hold_while_waiting = [&mutex](int const rounds) {
+        for (auto i = 0; i < rounds; ++i) {
+            mutex.lock();
+            auto waiter = std::jthread([&] {
+                mutex.lock();
+                mutex.unlock();
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            mutex.unlock();
+        }
+    };
+
+    hold_while_waiting(40);
+    auto const spun = mutex.stats().spins;
+    hold_while_waiting(10);
+    auto const spins_per_round = (mutex.stats().spins - spun) / 10;
+    dojo::spin_limit = limit;
+
+    std::cout << "  " << spins_per_round << " spins per round at last" << std::endl;
+    ASSERT_LE(spins_per_round, 10u);
+}
+
+TEST(TestAdaptiveMutex, test_contention_stats) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto mutex = dojo::adaptive_mutex<dojo::contention_stats>();
+    auto locked = std::atomic<bool>(false);
+
+    mutex.lock();
+    auto waiter = std::jthread([&] {
+        mutex.lock();
+        locked = true;
+        mutex.unlock();
+    });
+    // long enough for the waiter to give up spinning
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(locked);
+    mutex.unlock();
+    waiter.join();
+    ASSERT_TRUE(locked);
+
+    auto const stats = mutex.stats();
+    std::cout << "  " << stats << std::endl;
+    ASSERT_EQ(2u, stats.acquisitions);
+    ASSERT_EQ(1u, stats.contended);
+    ASSERT_EQ(1u, stats.parks);
+    ASSERT_GE(stats.hold_time, std::chrono::milliseconds(20));
+
+    // none of them without the stats
+    ASSERT_EQ(0u, dojo::adaptive_mutex<>().stats().acquisitions);
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "per_core_shared_mutex.h"
+
+/**
+ * A per-core reader-writer lock counts its readers on a cache line per cpu,
+ * so the readers don't contend with each other, while a writer waits for all
+ * of them to leave.
+ */
+
+TEST(TestPerCoreSharedMutex, test_readers_share) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto mutex = dojo::per_core_shared_mutex<>();
+    auto const reading = std::shared_lock(mutex);
+    std::jthread([&] {
+        ASSERT_TRUE(mutex.try_lock_shared());
+        mutex.unlock_shared();
+        ASSERT_FALSE(mutex.try_lock());
+    }).join();
+}
+
+TEST(TestPerCoreSharedMutex, test_writer_excludes) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto mutex = dojo::per_core_shared_mutex<dojo::contention_stats>();
+    auto read = std::atomic<bool>(false);
+
+    mutex.lock();
+    auto reader = std::jthread([&] {
+        ASSERT_FALSE(mutex.try_lock_shared());
+        auto const lock = std::shared_lock(mutex);
+        read = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(read);
+    mutex.unlock();
+    reader.join();
+    ASSERT_TRUE(read);
+
+    std::cout << "  writers: " << mutex.stats() << std::endl;
+    std::cout << "  readers: " << mutex.shared_stats() << std::endl;
+    ASSERT_EQ(1u, mutex.stats().acquisitions);
+    ASSERT_EQ(1u, mutex.shared_stats().acquisitions);
+    ASSERT_EQ(1u, mutex.shared_stats().contended);
+}
+
+TEST(TestPerCoreSharedMutex, test_consistent_reads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the writers keep both halves equal, which the readers must always see
+    auto mutex = dojo::per_core_shared_mutex<>();
+    auto a = 0, b = 0;
+    auto torn = std::atomic<int>(0);
+
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < 2; ++i) {
+            threads.emplace_back([&] {
+                for (auto round = 0; round < 5'000; ++round) {
+                    auto const lock = std::lock_guard(mutex);
+                    ++a;
+                    std::this_thread::yield();
+                    ++b;
+                }
+            });
+        }
+        for (auto i = 0; i < 6; ++i) {
+            threads.emplace_back([&] {
+                for (auto round = 0; round < 20'000; ++round) {
+                    auto const lock = std::shared_lock(mutex);
+                    torn += a != b;
+                }
+            });
+        }
+    }
+    ASSERT_EQ(0, torn);
+    ASSERT_EQ(10'000, a);
+    ASSERT_EQ(10'000, b);
+}
@@ -0,0 +1,85 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "seqlock.h"
+
+/**
+ * A seqlock lets the readers copy a small value without writing to shared
+ * memory at all, retrying whenever a writer got in the way.
+ */
+
+namespace {
+
+struct sample {
+    std::uint64_t sequence;
+    double value;
+    std::uint32_t checksum;  // makes the size no multiple of the words
+};
+
+sample make_sample(std::uint64_t const sequence) {
+    return {sequence, static_cast<double>(sequence) * 0.5, static_cast<std::uint32_t>(sequence * 31)};
+}
+
+}
+
+TEST(TestSeqlock, test_load_store) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto lock = dojo::seqlock<sample>(make_sample(1));
+    ASSERT_EQ(1u, lock.load().sequence);
+
+    lock.store(make_sample(7));
+    auto const loaded = lock.load();
+    ASSERT_EQ(7u, loaded.sequence);
+    ASSERT_EQ(3.5, loaded.value);
+    ASSERT_EQ(7u * 31, loaded.checksum);
+
+    lock.update([](sample const &s) { return make_sample(s.sequence + 1); });
+    ASSERT_EQ(8u, lock.load().sequence);
+}
+
+TEST(TestSeqlock, test_no_torn_reads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto updates = std::uint64_t{20'000};
+    auto lock = dojo::seqlock<sample, dojo::contention_stats>(make_sample(0));
+    auto torn = std::atomic<int>(0);
+    auto done = std::atomic<bool>(false);
+
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                auto last = std::uint64_t{0};
+                while (!done.load(std::memory_order_relaxed)) {
+                    auto const s = lock.load();
+                    auto const expected = make_sample(s.sequence);
+                    torn += s.value != expected.value || s.checksum != expected.checksum || s.sequence < last;
+                    last = s.sequence;
+                }
+            });
+        }
+        for (auto i = 0; i < 2; ++i) {
+            threads.emplace_back([&] {
+                for (auto round = std::uint64_t{0}; round < updates / 2; ++round) {
+                    lock.update([](sample const &s) { return make_sample(s.sequence + 1); });
+                }
+            });
+        }
+        while (lock.load().sequence != updates) {
+            std::this_thread::yield();
+        }
+        done = true;
+    }
+    ASSERT_EQ(0, torn);
+
+    std::cout << "  writers: " << lock.writer_stats() << std::endl;
+    std::cout << "  readers: " << lock.reader_stats() << std::endl;
+    ASSERT_EQ(updates, lock.writer_stats().acquisitions);
+    ASSERT_GT(lock.reader_stats().acquisitions, 0u);
+}
@@ -0,0 +1,176 @@
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "adaptive_mutex.h"
+#include "per_core_shared_mutex.h"
+#include "seqlock.h"
+#include "../../../utils.h"
+
+/**
+ * How the locks scale with the count of threads, against those of the
+ * standard library, with the contention stats of the dojo ones.
+ *
+ * With fewer cores than threads, the threads mostly take turns on the cpu
+ * rather than contend, so the scaling only shows on multi-core machines.
+ */
+
+static constexpr int thread_counts[] = {1, 2, 4, 8, 16};
+
+/**
+ * Run `ops_per_thread` calls of `fn` on each of `threads` threads, as a
+ * single benchmark of all the calls.
+ */
+template<typename Fn>
+static void run_threads(std::string const &name, int const threads, std::size_t const ops_per_thread, Fn &&fn) {
+    benchmark(name.c_str(), ops_per_thread * threads, [&] {
+        auto workers = std::vector<std::jthread>();
+        for (auto t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (auto i = std::size_t{0}; i < ops_per_thread; ++i) {
+                    fn(t, i);
+                }
+            });
+        }
+    });
+}
+
+static std::string with_threads(char const *name, int const threads) {
+    return std::string(name) + " x" + std::to_string(threads) + " threads";
+}
+
+/**
+ * A short critical section: the mutex is the bottleneck.
+ */
+TEST(TestLockingBenchmark, test_mutex_scaling) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto ops = std::size_t{200'000};
+    for (auto const threads: thread_counts) {
+        auto const per_thread = ops / threads;
+
+        auto std_mutex = std::mutex();
+        auto std_counter = std::uint64_t{0};
+        run_threads(with_threads("std::mutex", threads), threads, per_thread, [&](int, std::size_t) {
+            auto const lock = std::lock_guard(std_mutex);
+            ++std_counter;
+        });
+
+        auto adaptive = dojo::adaptive_mutex<>();
+        auto adaptive_counter = std::uint64_t{0};
+        run_threads(with_threads("dojo::adaptive_mutex", threads), threads, per_thread, [&](int, std::size_t) {
+            auto const lock = std::lock_guard(adaptive);
+            ++adaptive_counter;
+        });
+
+        auto counted = dojo::adaptive_mutex<dojo::contention_stats>();
+        auto counted_counter = std::uint64_t{0};
+        run_threads(with_threads("dojo::adaptive_mutex with stats", threads), threads, per_thread,
+                    [&](int, std::size_t) {
+                        auto const lock = std::lock_guard(counted);
+                        ++counted_counter;
+                    });
+        std::cout << "    " << counted.stats() << std::endl;
+
+        do_not_optimize(std_counter + adaptive_counter + counted_counter);
+    }
+}
+
+/**
+ * A read-mostly lookup table, with a write every 1024 operations.
+ */
+template<typename Mutex, template<typename> typename ReadLock>
+static void read_mostly(char const *name, int const threads, std::size_t const per_thread) {
+    constexpr auto keys = 1024u;
+    auto table = std::unordered_map<std::uint32_t, std::uint64_t>();
+    for (auto k = 0u; k < keys; ++k) {
+        table[k] = k;
+    }
+    auto mutex = Mutex();
+    run_threads(with_threads(name, threads), threads, per_thread, [&](int const t, std::size_t const i) {
+        auto const key = static_cast<std::uint32_t>((i * 7 + static_cast<std::size_t>(t) * 131) % keys);
+        if (i % 1024 == 1023) {
+            auto const lock = std::lock_guard(mutex);
+            ++table[key];
+        } else {
+            auto const lock = ReadLock<Mutex>(mutex);
+            do_not_optimize(table.find(key)->second);
+        }
+    });
+}
+
+TEST(TestLockingBenchmark, test_read_mostly_scaling) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto ops = std::size_t{400'000};
+    for (auto const threads: thread_counts) {
+        auto const per_thread = ops / threads;
+        read_mostly<std::mutex, std::lock_guard>("std::mutex lookups", threads, per_thread);
+        read_mostly<std::shared_mutex, std::shared_lock>("std::shared_mutex lookups", threads, per_thread);
+        read_mostly<dojo::per_core_shared_mutex<>, std::shared_lock>(
+                "dojo::per_core_shared_mutex lookups", threads, per_thread);
+    }
+}
+
+/**
+ * A small struct read by every thread, and rewritten by one of them every
+ * 256 operations.
+ */
+struct quote {
+    std::uint64_t bid;
+    std::uint64_t ask;
+    std::uint64_t time;
+};
+
+TEST(TestLockingBenchmark, test_small_value_scaling) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto ops = std::size_t{1'000'000};
+    for (auto const threads: thread_counts) {
+        auto const per_thread = ops / threads;
+
+        auto mutex = std::shared_mutex();
+        auto guarded = quote{};
+        run_threads(with_threads("std::shared_mutex quote", threads), threads, per_thread,
+                    [&](int const t, std::size_t const i) {
+                        if (t == 0 && i % 256 == 0) {
+                            auto const lock = std::lock_guard(mutex);
+                            guarded = quote{i, i + 1, i};
+                        } else {
+                            auto const lock = std::shared_lock(mutex);
+                            do_not_optimize(guarded.ask - guarded.bid);
+                        }
+                    });
+
+        auto lock = dojo::seqlock<quote>();
+        run_threads(with_threads("dojo::seqlock quote", threads), threads, per_thread,
+                    [&](int const t, std::size_t const i) {
+                        if (t == 0 && i % 256 == 0) {
+                            lock.store(quote{i, i + 1, i});
+                        } else {
+                            auto const q = lock.load();
+                            do_not_optimize(q.ask - q.bid);
+                        }
+                    });
+
+        // the readers share the counters, so they do write after all
+        auto counted = dojo::seqlock<quote, dojo::contention_stats>();
+        run_threads(with_threads("dojo::seqlock quote with stats", threads), threads, per_thread,
+                    [&](int const t, std::size_t const i) {
+                        if (t == 0 && i % 256 == 0) {
+                            counted.store(quote{i, i + 1, i});
+                        } else {
+                            auto const q = counted.load();
+                            do_not_optimize(q.ask - q.bid);
+                        }
+                    });
+        std::cout << "    readers: " << counted.reader_stats() << std::endl;
+    }
+}
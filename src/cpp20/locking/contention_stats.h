@@ -0,0 +1,97 @@
+#ifndef CPP_XX_DOJO_CONTENTION_STATS_H
+#define CPP_XX_DOJO_CONTENTION_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace dojo {
+
+struct contention_snapshot {
+    // the times the lock was taken
+    std::uint64_t acquisitions = 0;
+    // the times it was not free at the first try
+    std::uint64_t contended = 0;
+    // the polls while waiting for it, or the retries of a seqlock reader
+    std::uint64_t spins = 0;
+    // the times a thread parked in the kernel waiting for it
+    std::uint64_t parks = 0;
+    // the total time it was held exclusively
+    std::chrono::nanoseconds hold_time{0};
+
+    friend std::ostream &operator<<(std::ostream &os, contention_snapshot const &s) {
+        return os << "acquisitions=" << s.acquisitions << " contended=" << s.contended
+                  << " spins=" << s.spins << " parks=" << s.parks
+                  << " hold_time=" << std::chrono::duration<double, std::milli>(s.hold_time).count() << "ms";
+    }
+};
+
+/**
+ * @brief The contention counters of a lock, to be given as its Stats
+ * parameter
+ *
+ * The counters are relaxed atomics, which are still shared among all the
+ * threads taking the lock, and the hold time reads the clock twice per
+ * acquisition, hence only meant for diagnosing. The default
+ * no_contention_stats compiles all of them away.
+ */
+class contention_stats {
+public:
+    static constexpr bool enabled = true;
+
+    using clock = std::chrono::steady_clock;
+
+    void on_acquire(std::uint64_t const spins, bool const parked) noexcept {
+        m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (spins != 0 || parked) {
+            m_contended.fetch_add(1, std::memory_order_relaxed);
+            m_spins.fetch_add(spins, std::memory_order_relaxed);
+        }
+        if (parked) {
+            m_parks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void on_release(clock::time_point const acquired_at) noexcept {
+        auto const held = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - acquired_at);
+        m_hold_ns.fetch_add(static_cast<std::uint64_t>(held.count()), std::memory_order_relaxed);
+    }
+
+    /**
+     * The counters are read one by one, hence not necessarily consistent with
+     * each other while the lock is in use.
+     */
+    [[nodiscard]] contention_snapshot snapshot() const noexcept {
+        return {
+                m_acquisitions.load(std::memory_order_relaxed),
+                m_contended.load(std::memory_order_relaxed),
+                m_spins.load(std::memory_order_relaxed),
+                m_parks.load(std::memory_order_relaxed),
+                std::chrono::nanoseconds(m_hold_ns.load(std::memory_order_relaxed)),
+        };
+    }
+
+private:
+    std::atomic<std::uint64_t> m_acquisitions{0};
+    std::atomic<std::uint64_t> m_contended{0};
+    std::atomic<std::uint64_t> m_spins{0};
+    std::atomic<std::uint64_t> m_parks{0};
+    std::atomic<std::uint64_t> m_hold_ns{0};
+};
+
+struct no_contention_stats {
+    static constexpr bool enabled = false;
+
+    using clock = std::chrono::steady_clock;
+
+    void on_acquire(std::uint64_t, bool) noexcept {}
+
+    void on_release(clock::time_point) noexcept {}
+
+    [[nodiscard]] contention_snapshot snapshot() const noexcept { return {}; }
+};
+
+}
+
+#endif //CPP_XX_DOJO_CONTENTION_STATS_H
@@ -0,0 +1,199 @@
+#ifndef CPP_XX_DOJO_PER_CORE_SHARED_MUTEX_H
+#define CPP_XX_DOJO_PER_CORE_SHARED_MUTEX_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include "adaptive_mutex.h"
+#include "contention_stats.h"
+#include "../synchronization/spin_wait.h"
+#include "../../../utils.h"
+
+namespace dojo {
+
+namespace detail {
+
+/**
+ * The reader slot of the current thread, handed out round-robin on first use
+ * and never changed afterwards, so that unlocking finds the same slot as
+ * locking even if the thread has migrated to another cpu in between.
+ */
+inline std::size_t local_reader_slot() {
+    static auto next = std::atomic<std::size_t>(0);
+    thread_local auto const slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+}
+
+/**
+ * @brief A reader-writer lock for read-mostly data, where the readers never
+ * write to a cache line shared with the readers of the other cores
+ *
+ * std::shared_mutex keeps a single reader count, so every lock_shared and
+ * unlock_shared of every core bounces the same cache line, and the readers
+ * stop scaling long before they contend on anything real. Here the readers
+ * are counted in slots of their own cache lines, one per cpu (rounded up to a
+ * power of two), which makes reading cheap at the expense of writing: a
+ * writer announces itself, then waits for the count of every slot to drain.
+ *
+ *   - a reader increments its slot, then checks for a writer; a writer sets
+ *     its flag, then checks every slot. Both are sequentially consistent, so
+ *     at least one of them sees the other, like Dekker's algorithm;
+ *   - a reader which sees a writer backs off, and parks on the flag until the
+ *     writer is gone, hence writers are preferred and never starve;
+ *   - the writers are serialized by an adaptive_mutex.
+ *
+ * Meets the SharedMutex requirements, i.e. works with std::shared_lock.
+ *
+ * reference from https://www.usenix.org/legacy/events/usenix03/tech/freenix03/full_papers/mckenney/mckenney_html/
+ *
+ * @tparam Stats contention_stats to count, or no_contention_stats not to
+ */
+template<typename Stats = no_contention_stats>
+class per_core_shared_mutex {
+public:
+    per_core_shared_mutex() :
+            m_slot_count(std::bit_ceil(std::max(std::thread::hardware_concurrency(), 1u))),
+            m_slots(std::make_unique<slot[]>(m_slot_count)) {}
+
+    per_core_shared_mutex(per_core_shared_mutex const &) = delete;
+
+    per_core_shared_mutex &operator=(per_core_shared_mutex const &) = delete;
+
+    void lock() noexcept {
+        m_writers.lock();
+        m_writer.store(1, std::memory_order_seq_cst);
+        auto spins = std::uint64_t{0};
+        auto parked = false;
+        for (auto i = std::size_t{0}; i < m_slot_count; ++i) {
+            auto const &readers = m_slots[i].value;
+            for (auto count = readers.load(std::memory_order_seq_cst); count != 0;
+                 count = readers.load(std::memory_order_seq_cst)) {
+                auto const waited = detail::spin_then_wait(readers, count, std::memory_order_seq_cst);
+                spins += waited.spins;
+                parked |= waited.parked;
+            }
+        }
+        on_acquired(spins, parked);
+    }
+
+    [[nodiscard]] bool try_lock() noexcept {
+        if (!m_writers.try_lock()) {
+            return false;
+        }
+        m_writer.store(1, std::memory_order_seq_cst);
+        for (auto i = std::size_t{0}; i < m_slot_count; ++i) {
+            if (m_slots[i].value.load(std::memory_order_seq_cst) != 0) {
+                release_writer();
+                return false;
+            }
+        }
+        on_acquired(0, false);
+        return true;
+    }
+
+    void unlock() noexcept {
+        if constexpr (Stats::enabled) {
+            m_stats.on_release(m_acquired_at);
+        }
+        release_writer();
+    }
+
+    void lock_shared() noexcept {
+        auto &readers = local_slot();
+        auto spins = std::uint64_t{0};
+        auto parked = false;
+        while (true) {
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (m_writer.load(std::memory_order_seq_cst) == 0) {
+                break;
+            }
+            back_off(readers);
+            while (m_writer.load(std::memory_order_acquire) != 0) {
+                auto const waited = detail::spin_then_wait(m_writer, 1);
+                spins += waited.spins;
+                parked |= waited.parked;
+            }
+        }
+        if constexpr (Stats::enabled) {
+            m_shared_stats.on_acquire(spins, parked);
+        }
+    }
+
+    [[nodiscard]] bool try_lock_shared() noexcept {
+        auto &readers = local_slot();
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        if (m_writer.load(std::memory_order_seq_cst) != 0) {
+            back_off(readers);
+            return false;
+        }
+        if constexpr (Stats::enabled) {
+            m_shared_stats.on_acquire(0, false);
+        }
+        return true;
+    }
+
+    void unlock_shared() noexcept {
+        back_off(local_slot());
+    }
+
+    /**
+     * The contention of the writers, with their hold time.
+     */
+    [[nodiscard]] contention_snapshot stats() const noexcept { return m_stats.snapshot(); }
+
+    /**
+     * The contention of the readers, which share these counters, so counting
+     * them brings back the very cache line bouncing the slots avoid.
+     */
+    [[nodiscard]] contention_snapshot shared_stats() const noexcept { return m_shared_stats.snapshot(); }
+
+private:
+    using slot = cache_line_padded<std::atomic<std::uint32_t>>;
+
+    std::atomic<std::uint32_t> &local_slot() noexcept {
+        return m_slots[detail::local_reader_slot() & (m_slot_count - 1)].value;
+    }
+
+    void back_off(std::atomic<std::uint32_t> &readers) noexcept {
+        // the writer only parks on a slot which it has seen non-zero
+        if (readers.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+            m_writer.load(std::memory_order_seq_cst) != 0) {
+            readers.notify_all();
+        }
+    }
+
+    void release_writer() noexcept {
+        m_writer.store(0, std::memory_order_release);
+        m_writer.notify_all();
+        m_writers.unlock();
+    }
+
+    void on_acquired(std::uint64_t const spins, bool const parked) noexcept {
+        if constexpr (Stats::enabled) {
+            m_stats.on_acquire(spins, parked);
+            m_acquired_at = Stats::clock::now();
+        }
+    }
+
+    std::size_t const m_slot_count;
+    std::unique_ptr<slot[]> const m_slots;
+    // read by every reader, hence away from the lines the writers write to
+    alignas(cache_line_size) std::atomic<std::uint32_t> m_writer{0};
+    alignas(cache_line_size) adaptive_mutex<> m_writers;
+    [[no_unique_address]] Stats m_stats;
+    [[no_unique_address]] Stats m_shared_stats;
+    [[no_unique_address]] std::conditional_t<Stats::enabled, typename Stats::clock::time_point, no_contention_stats>
+            m_acquired_at{};
+};
+
+}
+
+#endif //CPP_XX_DOJO_PER_CORE_SHARED_MUTEX_H
@@ -0,0 +1,134 @@
+#ifndef CPP_XX_DOJO_SEQLOCK_H
+#define CPP_XX_DOJO_SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "adaptive_mutex.h"
+#include "contention_stats.h"
+#include "../synchronization/spin_wait.h"
+
+namespace dojo {
+
+/**
+ * @brief A value which is read without ever writing to shared memory, by
+ * retrying the read whenever a write has overlapped it
+ *
+ * A writer makes the sequence number odd, writes the value, then makes the
+ * sequence number even again. A reader copies the value between two loads of
+ * the sequence number, and keeps the copy only if both are the same even
+ * number. The readers never block the writers, and never slow each other
+ * down, which suits small and frequently read values like timestamps or
+ * statistics; whereas a busy writer may keep the readers retrying.
+ *
+ * The value is kept in relaxed atomic words, since a copy overlapping a write
+ * is a data race otherwise, even though the torn copy is thrown away. The
+ * fences order them against the sequence number.
+ *
+ * reference from https://www.hpl.hp.com/techreports/2012/HPL-2012-68.pdf
+ *
+ * @tparam T a trivially copyable value
+ * @tparam Stats contention_stats to count, or no_contention_stats not to
+ */
+template<typename T, typename Stats = no_contention_stats>
+requires std::is_trivially_copyable_v<T> && std::default_initializable<T>
+class seqlock {
+public:
+    seqlock() : seqlock(T{}) {}
+
+    explicit seqlock(T const &value) noexcept { write_words(value); }
+
+    seqlock(seqlock const &) = delete;
+
+    seqlock &operator=(seqlock const &) = delete;
+
+    [[nodiscard]] T load() const noexcept {
+        for (auto retries = std::uint64_t{0};; ++retries) {
+            auto const before = m_sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                auto const value = read_words();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_sequence.load(std::memory_order_relaxed) == before) {
+                    if constexpr (Stats::enabled) {
+                        m_reader_stats.on_acquire(retries, false);
+                    }
+                    return value;
+                }
+            }
+            // the writer may have been preempted in the middle
+            if (retries < static_cast<std::uint64_t>(spin_limit.load(std::memory_order_relaxed))) {
+                detail::cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void store(T const &value) noexcept {
+        auto const lock = std::lock_guard(m_writer);
+        write(value);
+    }
+
+    /**
+     * Replace the value with `fn(value)`, atomically with regard to the other
+     * writers.
+     */
+    template<typename Fn>
+    requires std::is_invocable_r_v<T, Fn &, T const &>
+    void update(Fn &&fn) {
+        auto const lock = std::lock_guard(m_writer);
+        // no other writer, so the words can't change under the copy
+        write(fn(read_words()));
+    }
+
+    [[nodiscard]] contention_snapshot writer_stats() const noexcept { return m_writer.stats(); }
+
+    /**
+     * The loads as acquisitions, and their retries as spins.
+     */
+    [[nodiscard]] contention_snapshot reader_stats() const noexcept { return m_reader_stats.snapshot(); }
+
+private:
+    static constexpr auto word_count = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    T read_words() const noexcept {
+        auto words = std::array<std::uint64_t, word_count>();
+        for (auto i = std::size_t{0}; i < word_count; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        auto value = T();
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+    void write_words(T const &value) noexcept {
+        auto words = std::array<std::uint64_t, word_count>();
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (auto i = std::size_t{0}; i < word_count; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    void write(T const &value) noexcept {
+        auto const sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        write_words(value);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    std::atomic<std::uint64_t> m_sequence{0};
+    std::array<std::atomic<std::uint64_t>, word_count> m_words{};
+    adaptive_mutex<Stats> m_writer;
+    [[no_unique_address]] mutable Stats m_reader_stats;
+};
+
+}
+
+#endif //CPP_XX_DOJO_SEQLOCK_H
@@ -0,0 +1,44 @@
+#ifndef CPP_XX_DOJO_ARENA_H
+#define CPP_XX_DOJO_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace dojo::pmr {
+
+/**
+ * @brief A monotonic arena for a burst of allocations of the same scope, e.g.
+ * of a request
+ *
+ * Allocating only bumps a pointer, and deallocating does nothing at all: the
+ * memory is freed as a whole once the arena goes out of scope. It starts with
+ * an inline buffer, typically on the stack, and only turns to the upstream
+ * when the buffer runs out, with geometrically growing blocks.
+ *
+ * Not thread-safe, the same as std::pmr::monotonic_buffer_resource which it
+ * is, since it's meant to live and die with a single request.
+ *
+ * reference from https://en.cppreference.com/w/cpp/memory/monotonic_buffer_resource
+ *
+ * @tparam InlineSize the size of the inline buffer in bytes
+ */
+template<std::size_t InlineSize>
+class arena : private std::array<std::byte, InlineSize>, public std::pmr::monotonic_buffer_resource {
+public:
+    explicit arena(std::pmr::memory_resource *const upstream = std::pmr::get_default_resource()) :
+            std::array<std::byte, InlineSize>(),
+            std::pmr::monotonic_buffer_resource(this->data(), InlineSize, upstream) {}
+
+    /**
+     * The inline buffer is a base class rather than a member, as a base class
+     * is constructed before the resource which uses it.
+     */
+    [[nodiscard]] bool owns_inline(void const *const p) const {
+        return this->data() <= p && p < this->data() + InlineSize;
+    }
+};
+
+}
+
+#endif //CPP_XX_DOJO_ARENA_H
@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "arena.h"
+#include "counting_resource.h"
+#include "per_thread_pool_resource.h"
+#include "../lock-free-queue/mpmc_queue.h"
+
+/**
+ * A std::pmr::memory_resource decides where the memory of the std::pmr
+ * containers, and of anything taking a std::pmr::polymorphic_allocator, comes
+ * from, at runtime rather than by the type of the container.
+ *
+ * reference from https://en.cppreference.com/w/cpp/memory/memory_resource
+ */
+
+TEST(TestMemoryResource, test_per_thread_pool_resource) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto upstream = dojo::pmr::counting_resource();
+    {
+        auto resource = dojo::pmr::per_thread_pool_resource(&upstream);
+
+        // a freed block is handed out again by the next allocation of its size
+        auto *const p = resource.allocate(24);
+        resource.deallocate(p, 24);
+        ASSERT_EQ(resource.allocate(30), p);
+        resource.deallocate(p, 30);
+        ASSERT_EQ(upstream.allocations(), 1);  // a single chunk so far
+
+        auto numbers = std::pmr::vector<int>(&resource);
+        for (auto i = 0; i < 1000; ++i) {
+            numbers.push_back(i);
+        }
+        ASSERT_EQ(numbers.back(), 999);
+
+        // too large or over-aligned for the pools
+        auto const before = upstream.allocations();
+        auto *const large = resource.allocate(dojo::pmr::per_thread_pool_resource::max_block_size + 1);
+        auto *const aligned = resource.allocate(64, 64);
+        ASSERT_EQ(upstream.allocations(), before + 2);
+        resource.deallocate(large, dojo::pmr::per_thread_pool_resource::max_block_size + 1);
+        resource.deallocate(aligned, 64, 64);
+    }
+    // all the chunks go back on destruction
+    ASSERT_EQ(upstream.bytes_in_use(), 0);
+}
+
+/**
+ * Blocks allocated on one thread and freed on another go back to the heap of
+ * the allocating thread, so that a producer/consumer pipeline keeps recycling
+ * the same few chunks instead of draining the upstream.
+ */
+TEST(TestMemoryResource, test_per_thread_pool_resource_cross_thread) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto count = 100'000;
+    constexpr auto block_size = std::size_t{64};
+
+    auto upstream = dojo::pmr::counting_resource();
+    auto resource = dojo::pmr::per_thread_pool_resource(&upstream);
+    auto queue = dojo::mpmc_queue<std::uint64_t *>(1024);
+    {
+        auto producer = std::jthread([&] {
+            for (auto i = 0; i < count; ++i) {
+                auto *const p = static_cast<std::uint64_t *>(resource.allocate(block_size));
+                *p = i;
+                queue.push(p);
+            }
+        });
+        auto consumer = std::jthread([&] {
+            for (auto i = 0; i < count; ++i) {
+                auto *const p = queue.pop();
+                ASSERT_EQ(*p, i);
+                resource.deallocate(p, block_size);
+            }
+        });
+    }
+
+    // far less than the count * block_size / chunk_size = 98 chunks without
+    // recycling
+    std::cout << "chunks allocated: " << upstream.allocations() << std::endl;
+    ASSERT_LT(upstream.allocations(), 10);
+}
+
+/**
+ * The heap of a thread which has exited is taken over by the next thread,
+ * along with its chunks, instead of a heap per thread ever started.
+ */
+TEST(TestMemoryResource, test_per_thread_pool_resource_exited_threads) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto block_size = std::size_t{64};
+
+    auto upstream = dojo::pmr::counting_resource();
+    auto resource = dojo::pmr::per_thread_pool_resource(&upstream);
+    // a block of each thread outlives it, freed by the next thread
+    auto *left = static_cast<void *>(nullptr);
+    for (auto i = 0; i < 10; ++i) {
+        std::jthread([&] {
+            auto *const p = resource.allocate(block_size);
+            if (left != nullptr) {
+                resource.deallocate(left, block_size);
+            }
+            left = p;
+        }).join();
+    }
+    resource.deallocate(left, block_size);
+    ASSERT_EQ(upstream.allocations(), 1);
+
+    // and the entries of a destroyed resource don't stand in the way of one
+    // taking its place
+    {
+        auto other = dojo::pmr::per_thread_pool_resource(&upstream);
+        other.deallocate(other.allocate(block_size), block_size);
+    }
+    auto another = dojo::pmr::per_thread_pool_resource(&upstream);
+    another.deallocate(another.allocate(block_size), block_size);
+}
+
+/**
+ * The arena serves the allocations from its inline buffer for as long as it
+ * can, and deallocating is a no-op: everything is freed with the arena.
+ */
+TEST(TestMemoryResource, test_arena) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto upstream = dojo::pmr::counting_resource();
+    {
+        auto arena = dojo::pmr::arena<1024>(&upstream);
+
+        auto small = std::pmr::vector<int>(&arena);
+        small.reserve(100);
+        ASSERT_TRUE(arena.owns_inline(small.data()));
+        ASSERT_EQ(upstream.allocations(), 0);
+
+        auto words = std::pmr::vector<std::pmr::string>(&arena);
+        for (auto i = 0; i < 100; ++i) {
+            // the strings share the arena of the vector
+            words.emplace_back("a string too long for the small string optimization");
+        }
+        ASSERT_FALSE(arena.owns_inline(words.data()));
+        ASSERT_GT(upstream.allocations(), 0);
+    }
+    ASSERT_EQ(upstream.bytes_in_use(), 0);
+}
@@ -0,0 +1,103 @@
+#include <future>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "counting_resource.h"
+#include "packaged_task.h"
+#include "per_thread_pool_resource.h"
+#include "../cancellation/thread_pool.h"
+
+/**
+ * Every std::promise, std::packaged_task or std::async allocates a shared
+ * state for its future, and std::packaged_task also allocates its callable
+ * if it's too large to be stored inline. By default, they all go to the
+ * global allocator.
+ */
+
+/**
+ * std::promise takes an allocator for its shared state, which can be a
+ * std::pmr::polymorphic_allocator pointing to any memory resource.
+ */
+TEST(TestPmrSharedState, test_promise_with_allocator) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto resource = dojo::pmr::counting_resource();
+    {
+        auto promise = std::promise<int>(std::allocator_arg, std::pmr::polymorphic_allocator<>(&resource));
+        auto future = promise.get_future();
+        // the shared state, and with libstdc++ the storage of the result
+        ASSERT_GT(resource.allocations(), 0);
+
+        auto th = std::jthread([&promise] { promise.set_value(42); });
+        ASSERT_EQ(future.get(), 42);
+    }
+    ASSERT_EQ(resource.bytes_in_use(), 0);
+}
+
+TEST(TestPmrSharedState, test_packaged_task) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto resource = dojo::pmr::counting_resource();
+    {
+        auto const big = std::vector<int>(100, 1);
+        auto task = dojo::pmr::packaged_task<int(int)>(std::allocator_arg, &resource, [big](int const times) {
+            return static_cast<int>(big.size()) * times;
+        });
+        auto future = task.get_future();
+        // the shared state and the callable
+        ASSERT_GT(resource.allocations(), 1);
+
+        auto th = std::jthread(std::move(task), 3);
+        ASSERT_EQ(future.get(), 300);
+    }
+    ASSERT_EQ(resource.bytes_in_use(), 0);
+
+    // the same errors as std::packaged_task
+    auto task = dojo::pmr::packaged_task<void()>([] { throw std::runtime_error("oops"); });
+    auto future = task.get_future();
+    task();
+    ASSERT_THROW(future.get(), std::runtime_error);
+    ASSERT_THROW(task(), std::future_error);
+
+    auto never_called = std::make_unique<dojo::pmr::packaged_task<void()>>([] {});
+    auto broken = never_called->get_future();
+    never_called.reset();
+    ASSERT_THROW(broken.get(), std::future_error);
+
+    // no shared state at all, rather than one from the global heap
+    auto empty = dojo::pmr::packaged_task<void()>();
+    ASSERT_FALSE(empty.valid());
+    ASSERT_THROW(empty.get_future(), std::future_error);
+    ASSERT_THROW(empty(), std::future_error);
+    empty = std::move(task);
+    ASSERT_TRUE(empty.valid());
+}
+
+/**
+ * The thread pool allocates the shared states, the tasks and its queue from
+ * its resource, here one where each submitting thread has its own pools.
+ */
+TEST(TestPmrSharedState, test_thread_pool_with_resource) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto upstream = dojo::pmr::counting_resource();
+    auto resource = dojo::pmr::per_thread_pool_resource(&upstream);
+    {
+        auto pool = dojo::thread_pool(2, &resource);
+        ASSERT_EQ(pool.resource(), &resource);
+
+        auto futures = std::vector<dojo::cancellable_future<int>>();
+        for (auto i = 0; i < 100; ++i) {
+            futures.push_back(pool.submit([](int const x) { return x * x; }, i));
+        }
+        for (auto i = 0; i < 100; ++i) {
+            ASSERT_EQ(futures[i].get(), i * i);
+        }
+    }
+    ASSERT_GT(upstream.allocations(), 0);
+}
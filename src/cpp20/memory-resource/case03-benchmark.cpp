@@ -0,0 +1,110 @@
+#include <array>
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "per_thread_pool_resource.h"
+#include "../../../utils.h"
+
+/**
+ * Allocator contention: every thread allocates and frees small blocks as
+ * fast as it can, through each of
+ *   - the global allocator, by std::pmr::new_delete_resource;
+ *   - std::pmr::synchronized_pool_resource, which is guarded by a mutex;
+ *   - dojo::pmr::per_thread_pool_resource, where the threads share nothing.
+ *
+ * The work per thread is fixed, hence ns/op stays flat with the thread count
+ * as long as the threads don't contend, and there are enough cores.
+ */
+
+static constexpr int thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+static constexpr auto rounds_per_thread = 4'000;
+static constexpr std::array<std::size_t, 8> block_sizes = {16, 24, 32, 48, 64, 96, 128, 256};
+
+template<typename Fn>
+static void run_threads(int const threads, Fn const &fn) {
+    auto start = std::latch(1);
+    auto workers = std::vector<std::jthread>();
+    for (auto i = 0; i < threads; ++i) {
+        workers.emplace_back([&] {
+            start.wait();
+            fn();
+        });
+    }
+    start.count_down();
+}
+
+static void allocate_and_free(std::pmr::memory_resource &resource) {
+    auto blocks = std::array<void *, block_sizes.size()>();
+    for (auto round = 0; round < rounds_per_thread; ++round) {
+        for (auto i = std::size_t{0}; i < block_sizes.size(); ++i) {
+            blocks[i] = resource.allocate(block_sizes[i]);
+        }
+        do_not_optimize(blocks);
+        for (auto i = std::size_t{0}; i < block_sizes.size(); ++i) {
+            resource.deallocate(blocks[i], block_sizes[i]);
+        }
+    }
+}
+
+TEST(TestMemoryResourceBenchmark, test_allocation_contention) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const threads: thread_counts) {
+        auto const ops = std::size_t{rounds_per_thread} * block_sizes.size() * threads;
+        auto const suffix = " x" + std::to_string(threads) + " threads";
+
+        auto synchronized = std::pmr::synchronized_pool_resource();
+        auto per_thread = dojo::pmr::per_thread_pool_resource();
+
+        benchmark(("new_delete_resource" + suffix).c_str(), ops, [&] {
+            run_threads(threads, [] { allocate_and_free(*std::pmr::new_delete_resource()); });
+        });
+        benchmark(("synchronized_pool_resource" + suffix).c_str(), ops, [&] {
+            run_threads(threads, [&] { allocate_and_free(synchronized); });
+        });
+        benchmark(("per_thread_pool_resource" + suffix).c_str(), ops, [&] {
+            run_threads(threads, [&] { allocate_and_free(per_thread); });
+        });
+    }
+}
+
+/**
+ * The same for the shared states of promises and futures, which allocate on
+ * every round trip.
+ */
+TEST(TestMemoryResourceBenchmark, test_promise_contention) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const round_trips = [](std::pmr::memory_resource *const resource) {
+        auto sum = 0;
+        for (auto round = 0; round < rounds_per_thread; ++round) {
+            auto promise = std::promise<int>(std::allocator_arg, std::pmr::polymorphic_allocator<>(resource));
+            promise.set_value(round);
+            sum += promise.get_future().get();
+        }
+        do_not_optimize(sum);
+    };
+
+    for (auto const threads: thread_counts) {
+        auto const ops = std::size_t{rounds_per_thread} * threads;
+        auto const suffix = " x" + std::to_string(threads) + " threads";
+
+        auto per_thread = dojo::pmr::per_thread_pool_resource();
+
+        benchmark(("std::promise, new_delete_resource" + suffix).c_str(), ops, [&] {
+            run_threads(threads, [&] { round_trips(std::pmr::new_delete_resource()); });
+        });
+        benchmark(("std::promise, per_thread_pool_resource" + suffix).c_str(), ops, [&] {
+            run_threads(threads, [&] { round_trips(&per_thread); });
+        });
+    }
+}
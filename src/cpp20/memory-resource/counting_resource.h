@@ -0,0 +1,54 @@
+#ifndef CPP_XX_DOJO_COUNTING_RESOURCE_H
+#define CPP_XX_DOJO_COUNTING_RESOURCE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace dojo::pmr {
+
+/**
+ * @brief A memory resource counting what goes through it to the upstream
+ *
+ * Handy as the upstream of another resource, to see how often that one
+ * falls back to it.
+ */
+class counting_resource : public std::pmr::memory_resource {
+public:
+    explicit counting_resource(std::pmr::memory_resource *const upstream = std::pmr::new_delete_resource()) :
+            m_upstream(upstream) {}
+
+    [[nodiscard]] std::size_t allocations() const { return m_allocations.load(); }
+
+    [[nodiscard]] std::size_t deallocations() const { return m_deallocations.load(); }
+
+    [[nodiscard]] std::size_t bytes_in_use() const { return m_bytes_in_use.load(); }
+
+protected:
+    void *do_allocate(std::size_t const bytes, std::size_t const alignment) override {
+        auto *const p = m_upstream->allocate(bytes, alignment);
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytes_in_use.fetch_add(bytes, std::memory_order_relaxed);
+        return p;
+    }
+
+    void do_deallocate(void *const p, std::size_t const bytes, std::size_t const alignment) override {
+        m_upstream->deallocate(p, bytes, alignment);
+        m_deallocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    std::pmr::memory_resource *const m_upstream;
+    std::atomic<std::size_t> m_allocations{0};
+    std::atomic<std::size_t> m_deallocations{0};
+    std::atomic<std::size_t> m_bytes_in_use{0};
+};
+
+}
+
+#endif //CPP_XX_DOJO_COUNTING_RESOURCE_H
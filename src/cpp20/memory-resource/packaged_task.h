@@ -0,0 +1,152 @@
+#ifndef CPP_XX_DOJO_PMR_PACKAGED_TASK_H
+#define CPP_XX_DOJO_PMR_PACKAGED_TASK_H
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace dojo::pmr {
+
+/**
+ * @brief A std::packaged_task whose callable and shared state are allocated
+ * from a memory resource
+ *
+ * std::packaged_task used to take an allocator, but that constructor was
+ * removed in C++17 since no implementation had ever supported it. Whereas
+ * std::promise still takes one, so the shared state comes from the resource
+ * through the promise, and the callable is type-erased into a block of the
+ * resource as well. Then neither of them touches the global allocator, nor
+ * does a default-constructed task, which has no shared state at all.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/promise/promise
+ *
+ * @tparam Signature R(Args...)
+ */
+template<typename Signature>
+class packaged_task;
+
+template<typename R, typename... Args>
+class packaged_task<R(Args...)> {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    packaged_task() noexcept = default;
+
+    template<typename Fn>
+    requires (!std::is_same_v<std::remove_cvref_t<Fn>, packaged_task> && std::is_invocable_r_v<R, Fn &, Args...>)
+    explicit packaged_task(Fn &&fn) :
+            packaged_task(std::allocator_arg, allocator_type(), std::forward<Fn>(fn)) {}
+
+    template<typename Fn>
+    requires std::is_invocable_r_v<R, Fn &, Args...>
+    packaged_task(std::allocator_arg_t, allocator_type alloc, Fn &&fn) :
+            m_promise(std::in_place, std::allocator_arg, alloc),
+            m_callable(alloc.new_object<callable<std::decay_t<Fn>>>(std::forward<Fn>(fn))),
+            m_resource(alloc.resource()) {}
+
+    packaged_task(packaged_task const &) = delete;
+
+    packaged_task &operator=(packaged_task const &) = delete;
+
+    packaged_task(packaged_task &&other) noexcept :
+            m_promise(std::move(other.m_promise)),
+            m_callable(std::exchange(other.m_callable, nullptr)),
+            m_resource(other.m_resource),
+            m_called(other.m_called) {}
+
+    packaged_task &operator=(packaged_task &&other) noexcept {
+        if (this != &other) {
+            reset_callable();
+            m_promise = std::move(other.m_promise);
+            m_callable = std::exchange(other.m_callable, nullptr);
+            m_resource = other.m_resource;
+            m_called = other.m_called;
+        }
+        return *this;
+    }
+
+    ~packaged_task() {
+        // the promise reports std::future_errc::broken_promise if never called
+        reset_callable();
+    }
+
+    [[nodiscard]] bool valid() const noexcept { return m_callable != nullptr; }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return allocator_type(m_resource); }
+
+    std::future<R> get_future() {
+        if (!m_promise) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return m_promise->get_future();
+    }
+
+    void operator()(Args... args) {
+        if (!valid()) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (std::exchange(m_called, true)) {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+        try {
+            if constexpr (std::is_void_v<R>) {
+                m_callable->call(std::forward<Args>(args)...);
+                m_promise->set_value();
+            } else {
+                m_promise->set_value(m_callable->call(std::forward<Args>(args)...));
+            }
+        } catch (...) {
+            m_promise->set_exception(std::current_exception());
+        }
+    }
+
+private:
+    struct callable_base {
+        virtual ~callable_base() = default;
+
+        virtual R call(Args &&...args) = 0;
+
+        // with the concrete type, which tells the size to deallocate
+        virtual void destroy(allocator_type alloc) = 0;
+    };
+
+    template<typename Fn>
+    struct callable final : callable_base {
+        explicit callable(Fn fn) : fn(std::move(fn)) {}
+
+        R call(Args &&...args) override {
+            if constexpr (std::is_void_v<R>) {
+                std::invoke(fn, std::forward<Args>(args)...);
+            } else {
+                return std::invoke(fn, std::forward<Args>(args)...);
+            }
+        }
+
+        void destroy(allocator_type alloc) override { alloc.delete_object(this); }
+
+        Fn fn;
+    };
+
+    void reset_callable() {
+        if (m_callable != nullptr) {
+            std::exchange(m_callable, nullptr)->destroy(allocator_type(m_resource));
+        }
+    }
+
+    // empty when default-constructed, since a std::promise allocates its
+    // shared state from the global heap as it's constructed
+    std::optional<std::promise<R>> m_promise;
+    callable_base *m_callable = nullptr;
+    // rather than the allocator, which is not assignable
+    std::pmr::memory_resource *m_resource = std::pmr::get_default_resource();
+    bool m_called = false;
+};
+
+}
+
+#endif //CPP_XX_DOJO_PMR_PACKAGED_TASK_H
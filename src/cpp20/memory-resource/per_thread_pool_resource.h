@@ -0,0 +1,295 @@
+#ifndef CPP_XX_DOJO_PER_THREAD_POOL_RESOURCE_H
+#define CPP_XX_DOJO_PER_THREAD_POOL_RESOURCE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace dojo::pmr {
+
+/**
+ * @brief A thread-safe pool resource where every thread allocates from its
+ * own pools, without any lock or read-modify-write in the common case
+ *
+ * std::pmr::synchronized_pool_resource serializes all the threads on a mutex,
+ * and the global allocator, although usually smarter, still shares its state
+ * among the threads. Here every thread owns a heap, which holds a free list
+ * for each size class (16 bytes, 32 bytes, ..., 4 KiB):
+ *   - allocating pops the free list of the heap of the current thread;
+ *   - deallocating on the owning thread pushes back to that free list;
+ *   - deallocating on another thread pushes to a lock-free list of remote
+ *     frees of the owning heap, which the owner takes over as a whole once its
+ *     own free list runs out. Only the owner ever takes from that list, so
+ *     there's no ABA problem.
+ *
+ * The blocks are carved from chunks aligned to their own size, whose header
+ * tells the owning heap, hence no per-block header is needed. Larger or
+ * over-aligned requests go to the upstream resource directly.
+ *
+ * Like the pool resources of the standard, the memory is only returned to the
+ * upstream on destruction. The heap of a thread which exits is handed back to
+ * the resource, along with its chunks and free lists, and taken over by the
+ * next thread which needs one, so the heaps only grow with the threads using
+ * the resource at once, not with all the threads ever started.
+ *
+ * reference from https://www.microsoft.com/en-us/research/publication/mimalloc-free-list-sharding-in-action/
+ */
+class per_thread_pool_resource : public std::pmr::memory_resource {
+public:
+    static constexpr auto min_block_size = std::size_t{16};
+    static constexpr auto max_block_size = std::size_t{4096};
+    static constexpr auto chunk_size = std::size_t{64} << 10;
+
+    explicit per_thread_pool_resource(
+            std::pmr::memory_resource *const upstream = std::pmr::get_default_resource()) :
+            m_upstream(upstream), m_id(next_id()) {
+        auto &live = live_resources();
+        auto const lock = std::lock_guard(live.mutex);
+        live.resources.push_back({m_id, this});
+    }
+
+    per_thread_pool_resource(per_thread_pool_resource const &) = delete;
+
+    per_thread_pool_resource &operator=(per_thread_pool_resource const &) = delete;
+
+    ~per_thread_pool_resource() override {
+        {
+            // no thread exiting from now on hands its heap back
+            auto &live = live_resources();
+            auto const lock = std::lock_guard(live.mutex);
+            std::erase_if(live.resources, [this](live_resource const &r) { return r.id == m_id; });
+        }
+        // the entries of the other threads are left behind, never to match,
+        // until they take another heap
+        std::erase_if(local_entries(), [this](local_entry const &entry) { return entry.id == m_id; });
+        for (auto const &h: m_heaps) {
+            for (auto *c = h->chunks; c != nullptr;) {
+                auto *const next = c->next;
+                m_upstream->deallocate(c, chunk_size, chunk_size);
+                c = next;
+            }
+        }
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *upstream_resource() const { return m_upstream; }
+
+protected:
+    void *do_allocate(std::size_t const bytes, std::size_t const alignment) override {
+        if (!is_pooled(bytes, alignment)) {
+            return m_upstream->allocate(bytes, alignment);
+        }
+        auto &h = local_heap();
+        auto const cls = size_class(bytes);
+        if (h.free[cls] == nullptr) {
+            // take over what the other threads have given back
+            h.free[cls] = h.remote_free[cls].exchange(nullptr, std::memory_order_acquire);
+            if (h.free[cls] == nullptr) {
+                refill(h, cls);
+            }
+        }
+        auto *const b = h.free[cls];
+        h.free[cls] = b->next;
+        return b;
+    }
+
+    void do_deallocate(void *const p, std::size_t const bytes, std::size_t const alignment) override {
+        if (!is_pooled(bytes, alignment)) {
+            m_upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        auto *const b = static_cast<block *>(p);
+        auto const cls = size_class(bytes);
+        auto &owner = *chunk_of(p)->owner;
+        if (&owner == find_local_heap()) {
+            b->next = owner.free[cls];
+            owner.free[cls] = b;
+            return;
+        }
+        auto &list = owner.remote_free[cls];
+        b->next = list.load(std::memory_order_relaxed);
+        while (!list.compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr auto class_count = std::size_t{std::countr_zero(max_block_size / min_block_size) + 1};
+
+    struct block {
+        block *next;
+    };
+
+    struct heap;
+
+    struct chunk {
+        heap *owner;
+        chunk *next;
+    };
+
+    // blocks start after the header, keeping the alignment of max_align_t
+    static constexpr auto chunk_header_size = std::size_t{64};
+    static_assert(sizeof(chunk) <= chunk_header_size);
+
+    struct heap {
+        std::array<block *, class_count> free{};
+        // written by the other threads, hence on its own cache lines
+        alignas(64) std::array<std::atomic<block *>, class_count> remote_free{};
+        chunk *chunks = nullptr;
+    };
+
+    static bool is_pooled(std::size_t const bytes, std::size_t const alignment) {
+        return bytes <= max_block_size && alignment <= alignof(std::max_align_t);
+    }
+
+    static std::size_t size_class(std::size_t const bytes) {
+        auto const size = std::bit_ceil(bytes < min_block_size ? min_block_size : bytes);
+        return std::countr_zero(size / min_block_size);
+    }
+
+    static chunk *chunk_of(void *const p) {
+        return reinterpret_cast<chunk *>(reinterpret_cast<std::uintptr_t>(p) & ~(chunk_size - 1));
+    }
+
+    static std::uint64_t next_id() {
+        static auto counter = std::atomic<std::uint64_t>(0);
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void refill(heap &h, std::size_t const cls) {
+        // the upstream is thread-safe, e.g. the global allocator
+        auto *const c = static_cast<chunk *>(m_upstream->allocate(chunk_size, chunk_size));
+        c->owner = &h;
+        c->next = h.chunks;
+        h.chunks = c;
+
+        auto const block_size = min_block_size << cls;
+        auto *const first = reinterpret_cast<std::byte *>(c) + chunk_header_size;
+        auto const count = (chunk_size - chunk_header_size) / block_size;
+        for (auto i = count; i-- > 0;) {
+            auto *const b = reinterpret_cast<block *>(first + i * block_size);
+            b->next = h.free[cls];
+            h.free[cls] = b;
+        }
+    }
+
+    /**
+     * The heaps of the current thread, keyed by the id of the resource rather
+     * than its address, which may be reused by another resource once this one
+     * is destroyed.
+     */
+    struct local_entry {
+        std::uint64_t id;
+        heap *h;
+    };
+
+    /**
+     * The resources not destroyed yet, which the exiting threads hand their
+     * heaps back to.
+     */
+    struct live_resource {
+        std::uint64_t id;
+        per_thread_pool_resource *resource;
+    };
+
+    struct live_registry {
+        std::mutex mutex;
+        std::vector<live_resource> resources;
+    };
+
+    static live_registry &live_resources() {
+        static auto *const live = new live_registry();  // never destroyed, threads may exit after main
+        return *live;
+    }
+
+    struct local_heaps {
+        std::vector<local_entry> entries;
+
+        ~local_heaps() {
+            auto &live = live_resources();
+            auto const lock = std::lock_guard(live.mutex);
+            for (auto const &entry: entries) {
+                for (auto const &r: live.resources) {
+                    if (r.id == entry.id) {
+                        r.resource->abandon(entry.h);
+                    }
+                }
+            }
+        }
+    };
+
+    static std::vector<local_entry> &local_entries() {
+        thread_local auto heaps = local_heaps();
+        return heaps.entries;
+    }
+
+    heap *find_local_heap() const {
+        for (auto const &entry: local_entries()) {
+            if (entry.id == m_id) {
+                return entry.h;
+            }
+        }
+        return nullptr;
+    }
+
+    heap &local_heap() {
+        if (auto *const h = find_local_heap()) {
+            return *h;
+        }
+        // only once per thread, which drops the entries of the resources
+        // destroyed meanwhile as well
+        auto &entries = local_entries();
+        {
+            auto &live = live_resources();
+            auto const lock = std::lock_guard(live.mutex);
+            std::erase_if(entries, [&live](local_entry const &entry) {
+                return std::none_of(live.resources.begin(), live.resources.end(),
+                                    [&entry](live_resource const &r) { return r.id == entry.id; });
+            });
+        }
+        entries.reserve(entries.size() + 1);
+
+        auto const lock = std::lock_guard(m_mutex);
+        auto *h = static_cast<heap *>(nullptr);
+        if (!m_abandoned.empty()) {
+            h = m_abandoned.back();
+            m_abandoned.pop_back();
+        } else {
+            h = m_heaps.emplace_back(std::make_unique<heap>()).get();
+            // so that handing a heap back as a thread exits never allocates
+            m_abandoned.reserve(m_heaps.size());
+        }
+        entries.push_back({m_id, h});
+        return *h;
+    }
+
+    /**
+     * Take back the heap of an exiting thread, whose blocks still in use are
+     * freed to it as remote ones, until the next owner takes them over.
+     */
+    void abandon(heap *const h) noexcept {
+        auto const lock = std::lock_guard(m_mutex);
+        m_abandoned.push_back(h);
+    }
+
+    std::pmr::memory_resource *const m_upstream;
+    std::uint64_t const m_id;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<heap>> m_heaps;
+    // the heaps of the exited threads, for the next threads to take over
+    std::vector<heap *> m_abandoned;
+};
+
+}
+
+#endif //CPP_XX_DOJO_PER_THREAD_POOL_RESOURCE_H
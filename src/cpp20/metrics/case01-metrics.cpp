@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <latch>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "metrics.h"
+#include "../cancellation/thread_pool.h"
+
+/**
+ * Counters, gauges and histograms whose recording is sharded per thread and
+ * summed only on read, and the metrics of the thread pool recorded by them.
+ */
+
+TEST(TestMetrics, test_counter_and_gauge) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto c = dojo::metrics::counter();
+    auto g = dojo::metrics::gauge();
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < 8; ++i) {
+            threads.emplace_back([&, i] {
+                for (auto j = 0; j < 100000; ++j) {
+                    c.add();
+                    g.add(2);
+                    g.sub(i % 2 == 0 ? 3 : 1);
+                }
+            });
+        }
+    }
+    ASSERT_EQ(c.value(), 800000);
+    ASSERT_EQ(g.value(), 0);
+
+    g.sub(5);
+    ASSERT_EQ(g.value(), -5);
+}
+
+TEST(TestMetrics, test_more_threads_than_shards) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // all alive at once, so the threads beyond the shards share the overflow
+    auto const count = dojo::metrics::detail::max_shards + 44;
+    auto c = dojo::metrics::counter();
+    auto h = dojo::metrics::histogram();
+    auto started = std::latch(static_cast<std::ptrdiff_t>(count));
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = std::size_t{0}; i < count; ++i) {
+            threads.emplace_back([&, i] {
+                started.arrive_and_wait();
+                for (auto j = 0; j < 100; ++j) {
+                    c.add();
+                    h.record(i);
+                }
+            });
+        }
+    }
+    ASSERT_EQ(c.value(), count * 100);
+    ASSERT_EQ(h.snapshot().count(), count * 100);
+    ASSERT_EQ(h.snapshot().sum(), count * (count - 1) / 2 * 100);
+}
+
+TEST(TestMetrics, test_histogram_buckets) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    using dojo::metrics::histogram;
+
+    // the buckets cover all the values, without a gap or an overlap
+    ASSERT_EQ(histogram::lowest_of(0), 0);
+    for (auto b = std::size_t{0}; b < histogram::bucket_count; ++b) {
+        ASSERT_EQ(histogram::bucket_of(histogram::lowest_of(b)), b);
+        ASSERT_EQ(histogram::bucket_of(histogram::highest_of(b)), b);
+        if (b + 1 < histogram::bucket_count) {
+            ASSERT_EQ(histogram::highest_of(b) + 1, histogram::lowest_of(b + 1));
+        }
+        // no wider than 1/32 of the values in it
+        auto const width = histogram::highest_of(b) - histogram::lowest_of(b) + 1;
+        ASSERT_LE(width, std::max<std::uint64_t>(1, histogram::lowest_of(b) / histogram::sub_buckets));
+    }
+    ASSERT_EQ(histogram::highest_of(histogram::bucket_count - 1), UINT64_MAX);
+}
+
+TEST(TestMetrics, test_histogram_quantiles) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // latencies of a long tail, from 100ns to about 10ms
+    auto rng = std::mt19937_64(42);
+    auto dist = std::lognormal_distribution<double>(8.0, 1.5);
+    auto values = std::vector<std::uint64_t>();
+    auto h = dojo::metrics::histogram();
+    for (auto i = 0; i < 100000; ++i) {
+        auto const v = static_cast<std::uint64_t>(std::clamp(dist(rng), 100.0, 1e7));
+        values.push_back(v);
+        h.record(v);
+    }
+    std::sort(values.begin(), values.end());
+
+    auto const s = h.snapshot();
+    ASSERT_EQ(s.count(), values.size());
+    for (auto const q: {0.0, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+        auto const rank = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(q * values.size())));
+        auto const exact = values[rank - 1];
+        auto const approx = s.value_at_quantile(q);
+        ASSERT_GE(approx, exact) << q;
+        ASSERT_LE(static_cast<double>(approx - exact), exact / 32.0) << q;
+    }
+    ASSERT_LE(s.min(), values.front());
+    ASSERT_GE(s.max(), values.back());
+
+    auto const sum = std::accumulate(values.begin(), values.end(), std::uint64_t{0});
+    ASSERT_EQ(s.sum(), sum);
+    ASSERT_DOUBLE_EQ(s.mean(), static_cast<double>(sum) / static_cast<double>(values.size()));
+}
+
+TEST(TestMetrics, test_registry) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto r = dojo::metrics::registry();
+    auto &requests = r.get_counter("requests_total");
+    ASSERT_EQ(&requests, &r.get_counter("requests_total"));
+    requests.add(3);
+    r.get_gauge("connections").add(2);
+    for (auto v = std::uint64_t{1}; v <= 100; ++v) {
+        r.get_histogram("latency_ns").record(v);
+    }
+
+    auto os = std::ostringstream();
+    r.write_text(os);
+    auto const text = os.str();
+    std::cout << text;
+    ASSERT_NE(text.find("# TYPE requests_total counter\nrequests_total 3\n"), std::string::npos);
+    ASSERT_NE(text.find("connections 2\n"), std::string::npos);
+    ASSERT_NE(text.find("latency_ns{quantile=\"0.5\"} 50\n"), std::string::npos);
+    ASSERT_NE(text.find("latency_ns_count 100\n"), std::string::npos);
+}
+
+TEST(TestMetrics, test_thread_pool) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // global, so only the deltas are checked
+    auto &r = dojo::metrics::registry::global();
+    auto const submitted = r.get_counter("dojo_thread_pool_submitted_total").value();
+    auto const completed = r.get_counter("dojo_thread_pool_completed_total").value();
+    auto const aborted = r.get_counter("dojo_thread_pool_aborted_total").value();
+    auto const abandoned = r.get_counter("dojo_future_abandoned_total").value();
+    auto const waits = r.get_histogram("dojo_future_wait_ns").snapshot().count();
+
+    {
+        auto pool = dojo::thread_pool(1);
+        auto futures = std::vector<dojo::cancellable_future<int>>();
+        for (auto i = 0; i < 100; ++i) {
+            futures.push_back(pool.submit([i] { return i; }));
+        }
+        for (auto &f: futures) {
+            f.get();
+        }
+
+        // stopped before it starts, as the only worker is busy, and dropped
+        // without taking its value
+        auto gate = std::latch(1);
+        auto busy = pool.submit([&gate] { gate.wait(); });
+        auto dropped = pool.submit([] { return 0; });
+        dropped.request_stop();
+        // and given up on purpose, which isn't abandoned
+        auto discarded = pool.submit([] { return 0; });
+        discarded.discard();
+        gate.count_down();
+        busy.get();
+        dropped.wait();
+    }
+
+    ASSERT_EQ(r.get_counter("dojo_thread_pool_submitted_total").value() - submitted, 103);
+    ASSERT_EQ(r.get_counter("dojo_thread_pool_completed_total").value() - completed, 101);
+    ASSERT_EQ(r.get_counter("dojo_thread_pool_aborted_total").value() - aborted, 2);
+    ASSERT_EQ(r.get_counter("dojo_future_abandoned_total").value() - abandoned, 1);
+    ASSERT_EQ(r.get_histogram("dojo_future_wait_ns").snapshot().count() - waits, 102);
+    ASSERT_GE(r.get_histogram("dojo_thread_pool_run_ns").snapshot().count(), 101);
+
+    r.write_text(std::cout);
+}
@@ -0,0 +1,86 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "metrics.h"
+#include "../../../utils.h"
+
+/**
+ * 64 threads counting at once, into a counter sharded per thread against a
+ * single atomic, whose cache line every increment takes exclusive on its
+ * core, and a mutex. The cost per increment is the wall time over all the
+ * increments of all the threads, i.e. what an increment takes out of the
+ * throughput of the machine.
+ *
+ * The sharded counter is meant to cost less than 5ns per increment, as it
+ * takes neither a lock prefix nor a cache line of another core.
+ *
+ * Only printed, not asserted.
+ */
+
+namespace {
+
+constexpr auto thread_count = std::size_t{64};
+constexpr auto per_thread = std::size_t{1} << 20;
+
+template<typename Fn>
+void run_threads(char const *name, Fn &&increment) {
+    auto started = std::latch(thread_count + 1);
+    auto threads = std::vector<std::jthread>();
+    for (auto i = std::size_t{0}; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+            started.arrive_and_wait();
+            for (auto j = std::size_t{0}; j < per_thread; ++j) {
+                increment(i + j);
+            }
+        });
+    }
+    benchmark(name, thread_count * per_thread, [&] {
+        started.arrive_and_wait();
+        threads.clear();  // joins the threads
+    });
+}
+
+}
+
+TEST(TestMetricsBenchmark, test_increments) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    {
+        auto c = dojo::metrics::counter();
+        run_threads("metrics::counter, 64 threads", [&](std::size_t) { c.add(); });
+        ASSERT_EQ(c.value(), thread_count * per_thread);
+    }
+    {
+        auto c = std::atomic<std::uint64_t>(0);
+        run_threads("std::atomic fetch_add, 64 threads", [&](std::size_t) {
+            c.fetch_add(1, std::memory_order_relaxed);
+        });
+        ASSERT_EQ(c.load(), thread_count * per_thread);
+    }
+    {
+        auto mutex = std::mutex();
+        auto c = std::uint64_t{0};
+        run_threads("std::mutex, 64 threads", [&](std::size_t) {
+            auto const lock = std::lock_guard(mutex);
+            ++c;
+        });
+        ASSERT_EQ(c, thread_count * per_thread);
+    }
+}
+
+TEST(TestMetricsBenchmark, test_records) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto h = dojo::metrics::histogram();
+    run_threads("metrics::histogram, 64 threads", [&](std::size_t const i) { h.record(i & 0xffff); });
+    ASSERT_EQ(h.snapshot().count(), thread_count * per_thread);
+
+    benchmark("metrics::histogram, snapshot", 1, [&] { do_not_optimize(h.snapshot().count()); });
+}
@@ -0,0 +1,455 @@
+#ifndef CPP_XX_DOJO_METRICS_H
+#define CPP_XX_DOJO_METRICS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../../utils.h"
+
+namespace dojo::metrics {
+
+namespace detail {
+
+/**
+ * The threads which get a shard of their own in every metric; the threads
+ * beyond share an overflow shard, which is updated by atomic read-modify-write
+ * instructions, hence still correct, only slower.
+ */
+inline constexpr std::size_t max_shards = 256;
+
+struct shard_allocator {
+    std::mutex mutex;
+    std::vector<std::uint32_t> free;
+    std::uint32_t next = 0;
+};
+
+inline shard_allocator &get_shard_allocator() {
+    static auto *const a = [] {
+        auto *const allocator = new shard_allocator();  // never destroyed, threads may exit after main
+        // so that handing a shard back as a thread exits never allocates
+        allocator->free.reserve(max_shards);
+        return allocator;
+    }();
+    return *a;
+}
+
+// initialized with a constant, which saves the guard on every access
+inline thread_local std::uint32_t t_shard = max_shards + 1;
+
+/**
+ * Hands the shard back as the thread exits, to the next thread started. The
+ * mutex orders the writes of the exiting thread before those of the next
+ * one, so the shard still has a single writer at a time.
+ */
+struct shard_releaser {
+    std::uint32_t shard;
+
+    ~shard_releaser() {
+        auto &a = get_shard_allocator();
+        auto const lock = std::lock_guard(a.mutex);
+        a.free.push_back(shard);
+        // whatever the destructors of the thread still record overflows
+        t_shard = max_shards;
+    }
+};
+
+[[gnu::noinline]] inline std::uint32_t acquire_shard() {
+    auto &a = get_shard_allocator();
+    auto shard = static_cast<std::uint32_t>(max_shards);
+    {
+        auto const lock = std::lock_guard(a.mutex);
+        if (!a.free.empty()) {
+            shard = a.free.back();
+            a.free.pop_back();
+        } else if (a.next < max_shards) {
+            shard = a.next++;
+        }
+    }
+    t_shard = shard;
+    if (shard != max_shards) {
+        thread_local auto const releaser = shard_releaser{shard};
+    }
+    return shard;
+}
+
+/**
+ * The shard owned by the current thread, or max_shards for the overflow one.
+ */
+inline std::uint32_t local_shard() noexcept {
+    auto const shard = t_shard;
+    if (shard <= max_shards) [[likely]] {
+        return shard;
+    }
+    return acquire_shard();
+}
+
+/**
+ * Add to a value only ever written by the current thread: a plain load and
+ * store, since no other thread can interleave, which is what saves the lock
+ * prefix of a fetch_add. Relaxed atomics all the same, for the readers.
+ */
+inline void add_owned(std::atomic<std::uint64_t> &value, std::uint64_t const n) noexcept {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/**
+ * A sum of a shard per thread, each on a cache line of its own.
+ */
+class sharded_sum {
+public:
+    sharded_sum() : m_shards(std::make_unique<shard[]>(max_shards + 1)) {}
+
+    void add(std::uint64_t const n) noexcept {
+        auto const index = local_shard();
+        auto &value = m_shards[index].value;
+        if (index != max_shards) [[likely]] {
+            add_owned(value, n);
+        } else {
+            value.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] std::uint64_t load() const noexcept {
+        auto sum = std::uint64_t{0};
+        for (auto i = std::size_t{0}; i <= max_shards; ++i) {
+            sum += m_shards[i].value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    using shard = cache_line_padded<std::atomic<std::uint64_t>>;
+
+    std::unique_ptr<shard[]> m_shards;
+};
+
+}
+
+/**
+ * @brief A monotonic count, e.g. of the tasks run, cheap enough to be left on
+ *
+ * Every thread counts in a shard of its own, on a cache line of its own, so
+ * counting neither bounces a cache line between the cores nor takes a lock
+ * prefix; the shards are only summed on read, which is O(shards) and sees
+ * the counts of the other threads eventually rather than at once.
+ *
+ * The shards are handed out per thread rather than per cpu: a thread may
+ * migrate between reading its cpu and writing the shard, which takes an
+ * atomic read-modify-write to be safe, or a restartable sequence of linux.
+ * So a counter takes 256 cache lines, 16 KiB, and is meant to be created once
+ * rather than per object.
+ */
+class counter {
+public:
+    void add(std::uint64_t const n = 1) noexcept { m_sum.add(n); }
+
+    [[nodiscard]] std::uint64_t value() const noexcept { return m_sum.load(); }
+
+private:
+    detail::sharded_sum m_sum;
+};
+
+/**
+ * @brief A value going up and down, e.g. the tasks queued, sharded in the
+ * same way as the counter
+ *
+ * Only the deltas are sharded, hence there is no set(): the value is the sum
+ * of the deltas of all the threads, in the modular arithmetic of the shards.
+ */
+class gauge {
+public:
+    void add(std::int64_t const delta) noexcept { m_sum.add(static_cast<std::uint64_t>(delta)); }
+
+    void sub(std::int64_t const delta) noexcept { add(-delta); }
+
+    [[nodiscard]] std::int64_t value() const noexcept { return static_cast<std::int64_t>(m_sum.load()); }
+
+private:
+    detail::sharded_sum m_sum;
+};
+
+/**
+ * The counts of the buckets of a histogram, summed over its shards.
+ */
+class histogram_snapshot {
+public:
+    explicit histogram_snapshot(std::vector<std::uint64_t> counts, std::uint64_t const sum) :
+            m_counts(std::move(counts)), m_sum(sum) {
+        for (auto const c: m_counts) {
+            m_count += c;
+        }
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return m_count; }
+
+    [[nodiscard]] std::uint64_t sum() const noexcept { return m_sum; }
+
+    [[nodiscard]] double mean() const noexcept {
+        return m_count == 0 ? 0.0 : static_cast<double>(m_sum) / static_cast<double>(m_count);
+    }
+
+    [[nodiscard]] std::uint64_t min() const noexcept;
+
+    [[nodiscard]] std::uint64_t max() const noexcept;
+
+    /**
+     * The value which `q` of the values recorded are at or below, e.g. 0.99
+     * for the 99th percentile, as the highest value of its bucket, so never
+     * below the exact one and above it by less than the relative error.
+     */
+    [[nodiscard]] std::uint64_t value_at_quantile(double q) const noexcept;
+
+    [[nodiscard]] std::uint64_t count_at(std::size_t const bucket) const noexcept { return m_counts[bucket]; }
+
+private:
+    std::vector<std::uint64_t> m_counts;
+    std::uint64_t m_sum = 0;
+    std::uint64_t m_count = 0;
+};
+
+/**
+ * @brief A log-linear histogram of 64-bit values, e.g. latencies in
+ * nanoseconds, in the way of the HdrHistogram
+ *
+ * Every power of two is split into 32 buckets of the same width, i.e. the
+ * values below 32 are counted exactly, and any other value is counted in a
+ * bucket no wider than 1/32 of it: the quantiles are within 3.2% of the exact
+ * ones, whatever the range of the values. The bucket of a value is computed
+ * from its highest bit by a shift, with no search at all.
+ *
+ * Recording is sharded per thread as in the counter, and the buckets of a
+ * thread, 15 KiB, are allocated as it first records, so only the threads
+ * which record take memory. Recording never throws: a thread whose buckets
+ * can't be allocated records in the shared overflow shard instead.
+ *
+ * reference from https://github.com/HdrHistogram/HdrHistogram
+ */
+class histogram {
+public:
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr std::size_t sub_buckets = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    static constexpr std::size_t bucket_of(std::uint64_t const value) noexcept {
+        if (value < sub_buckets) {
+            return static_cast<std::size_t>(value);
+        }
+        auto const shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bucket_bits;
+        return (shift + 1) * sub_buckets + static_cast<std::size_t>((value >> shift) - sub_buckets);
+    }
+
+    static constexpr std::uint64_t lowest_of(std::size_t const bucket) noexcept {
+        if (bucket < sub_buckets) {
+            return bucket;
+        }
+        auto const shift = bucket / sub_buckets - 1;
+        return std::uint64_t{sub_buckets + bucket % sub_buckets} << shift;
+    }
+
+    static constexpr std::uint64_t highest_of(std::size_t const bucket) noexcept {
+        // wraps to the maximum for the last bucket
+        return lowest_of(bucket + 1) - 1;
+    }
+
+    histogram() : m_shards(std::make_unique<std::atomic<shard *>[]>(detail::max_shards)) {}
+
+    histogram(histogram const &) = delete;
+
+    histogram &operator=(histogram const &) = delete;
+
+    ~histogram() {
+        for (auto i = std::size_t{0}; i < detail::max_shards; ++i) {
+            delete m_shards[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void record(std::uint64_t const value) noexcept {
+        auto const index = detail::local_shard();
+        if (index != detail::max_shards) [[likely]] {
+            auto *s = m_shards[index].load(std::memory_order_relaxed);
+            if (s == nullptr) [[unlikely]] {
+                s = add_shard(index);
+            }
+            if (s != nullptr) [[likely]] {
+                detail::add_owned(s->buckets[bucket_of(value)], 1);
+                detail::add_owned(s->sum, value);
+                return;
+            }
+        }
+        m_overflow.buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        m_overflow.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Record a duration in nanoseconds, or 0 if negative.
+     */
+    template<typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> const duration) noexcept {
+        auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        record(static_cast<std::uint64_t>(std::max<decltype(ns)>(ns, 0)));
+    }
+
+    [[nodiscard]] histogram_snapshot snapshot() const {
+        auto counts = std::vector<std::uint64_t>(bucket_count);
+        auto sum = std::uint64_t{0};
+        auto const add = [&](shard const &s) {
+            for (auto b = std::size_t{0}; b < bucket_count; ++b) {
+                counts[b] += s.buckets[b].load(std::memory_order_relaxed);
+            }
+            sum += s.sum.load(std::memory_order_relaxed);
+        };
+        for (auto i = std::size_t{0}; i < detail::max_shards; ++i) {
+            if (auto const *const s = m_shards[i].load(std::memory_order_acquire); s != nullptr) {
+                add(*s);
+            }
+        }
+        add(m_overflow);
+        return histogram_snapshot(std::move(counts), sum);
+    }
+
+private:
+    struct alignas(cache_line_size) shard {
+        std::array<std::atomic<std::uint64_t>, bucket_count> buckets{};
+        std::atomic<std::uint64_t> sum{0};
+    };
+
+    /**
+     * Allocate the shard of the current thread, or return nullptr if out of
+     * memory, in which case the thread records in the overflow shard until an
+     * allocation succeeds, rather than throwing out of a noexcept record().
+     */
+    [[gnu::noinline]] shard *add_shard(std::uint32_t const index) noexcept {
+        auto *const s = new(std::nothrow) shard();
+        if (s != nullptr) {
+            m_shards[index].store(s, std::memory_order_release);
+        }
+        return s;
+    }
+
+    // kept when the thread exits, for the next thread taking its shard
+    std::unique_ptr<std::atomic<shard *>[]> m_shards;
+    shard m_overflow;
+};
+
+inline std::uint64_t histogram_snapshot::min() const noexcept {
+    for (auto b = std::size_t{0}; b < m_counts.size(); ++b) {
+        if (m_counts[b] != 0) {
+            return histogram::lowest_of(b);
+        }
+    }
+    return 0;
+}
+
+inline std::uint64_t histogram_snapshot::max() const noexcept {
+    for (auto b = m_counts.size(); b > 0; --b) {
+        if (m_counts[b - 1] != 0) {
+            return histogram::highest_of(b - 1);
+        }
+    }
+    return 0;
+}
+
+inline std::uint64_t histogram_snapshot::value_at_quantile(double const q) const noexcept {
+    if (m_count == 0) {
+        return 0;
+    }
+    auto const rank = std::max(std::uint64_t{1}, static_cast<std::uint64_t>(
+            std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(m_count))));
+    auto seen = std::uint64_t{0};
+    for (auto b = std::size_t{0}; b < m_counts.size(); ++b) {
+        seen += m_counts[b];
+        if (seen >= rank) {
+            return histogram::highest_of(b);
+        }
+    }
+    return max();
+}
+
+/**
+ * @brief The metrics by their names, created on first use and never
+ * destroyed, so that a reference to one stays valid for good
+ *
+ * Looking a metric up takes a lock, so the instrumented code looks its
+ * metrics up once, e.g. into a function-local static, and only records on the
+ * hot path.
+ */
+class registry {
+public:
+    /**
+     * The registry of the process, which the instrumented code of this
+     * project records into.
+     */
+    static registry &global() {
+        static auto *const r = new registry();  // never destroyed, threads may record after main
+        return *r;
+    }
+
+    counter &get_counter(std::string_view const name) { return get(m_counters, name); }
+
+    gauge &get_gauge(std::string_view const name) { return get(m_gauges, name); }
+
+    histogram &get_histogram(std::string_view const name) { return get(m_histograms, name); }
+
+    /**
+     * Write every metric in the text format of prometheus: a line per counter
+     * and gauge, and a summary per histogram, of its count, sum and
+     * quantiles.
+     *
+     * reference from https://prometheus.io/docs/instrumenting/exposition_formats/
+     */
+    void write_text(std::ostream &os) const {
+        auto const lock = std::lock_guard(m_mutex);
+        for (auto const &[name, c]: m_counters) {
+            os << "# TYPE " << name << " counter\n" << name << ' ' << c->value() << '\n';
+        }
+        for (auto const &[name, g]: m_gauges) {
+            os << "# TYPE " << name << " gauge\n" << name << ' ' << g->value() << '\n';
+        }
+        for (auto const &[name, h]: m_histograms) {
+            auto const s = h->snapshot();
+            os << "# TYPE " << name << " summary\n";
+            for (auto const q: {0.5, 0.9, 0.99, 0.999}) {
+                os << name << "{quantile=\"" << q << "\"} " << s.value_at_quantile(q) << '\n';
+            }
+            os << name << "_sum " << s.sum() << '\n' << name << "_count " << s.count() << '\n';
+        }
+    }
+
+private:
+    template<typename T>
+    using metric_map = std::map<std::string, std::unique_ptr<T>, std::less<>>;
+
+    template<typename T>
+    T &get(metric_map<T> &metrics, std::string_view const name) {
+        auto const lock = std::lock_guard(m_mutex);
+        auto it = metrics.find(name);
+        if (it == metrics.end()) {
+            it = metrics.emplace(std::string(name), std::make_unique<T>()).first;
+        }
+        return *it->second;
+    }
+
+    mutable std::mutex m_mutex;
+    metric_map<counter> m_counters;
+    metric_map<gauge> m_gauges;
+    metric_map<histogram> m_histograms;
+};
+
+}
+
+#endif //CPP_XX_DOJO_METRICS_H
@@ -1,15 +1,17 @@
-import module_a;
-
 #include <iostream>
 
 #include <gtest/gtest.h>
 
+// the imports come after the includes, since gcc 12 fails on the standard
+// headers included after a module has been imported
+import module_a;
+
 
 TEST(TestModule, test_call_function_of_module) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
 
     // ok: use of visible functions from module_a
-    std::cout << hello_from_hidden_inner() << std::endl;
+    std::cout << hello_from_module_a() << std::endl;
     std::cout << add(0, 0) << std::endl;
     std::cout << minus(0, 0) << std::endl;
     std::cout << hi::english() << std::endl;
@@ -1,7 +1,7 @@
 export module module_a;
 
 // Exported definition
-export [[maybe_unused]] char const *hello_from_hidden_inner() {
+export [[maybe_unused]] char const *hello_from_module_a() {
     return "Hello";
 }
 
@@ -0,0 +1,179 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+/**
+ * The build time of the same small library and its users, once as a header
+ * included by every user, once as a module imported by every user, compiled
+ * by the compiler of the project:
+ *   - clean: the library, then all the users;
+ *   - a user edited: that user alone;
+ *   - a definition of the library edited: the source of the library alone
+ *     for the header, whereas the interface of the module is recompiled, so
+ *     all the users have to follow, unless the build system compares the
+ *     compiled interfaces.
+ *
+ * Only the compilation is timed, not the link: gcc 12 compiles such a module
+ * but fails to link some of its users, e.g. by mangling the names of the
+ * functions returning a std::string differently in the module and in its
+ * users. And only non-template functions are exported, since gcc 12 fails to
+ * instantiate the templates of the standard library of a module in its users.
+ *
+ * reference from https://gcc.gnu.org/onlinedocs/gcc/C_002b_002b-Modules.html
+ */
+
+namespace {
+
+constexpr auto user_count = 8;
+
+char const *const includes = R"(#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+)";
+
+char const *const declarations = R"(namespace lib {
+using strings = std::vector<std::string>;
+strings split(std::string const &text);
+strings sorted(strings words);
+std::string join(strings const &words, std::string const &separator);
+std::size_t distinct(strings const &words);
+}
+)";
+
+char const *const definitions = R"(namespace lib {
+strings split(std::string const &text) {
+    auto words = strings();
+    for (auto first = std::size_t{0}; first < text.size();) {
+        auto const last = std::min(text.find(' ', first), text.size());
+        if (last != first) {
+            words.push_back(text.substr(first, last - first));
+        }
+        first = last + 1;
+    }
+    return words;
+}
+strings sorted(strings words) {
+    std::sort(words.begin(), words.end());
+    return words;
+}
+std::string join(strings const &words, std::string const &separator) {
+    auto joined = std::string();
+    for (auto const &word: words) {
+        joined += joined.empty() ? word : separator + word;
+    }
+    return joined;
+}
+std::size_t distinct(strings const &words) {
+    auto seen = std::unordered_map<std::string, int>();
+    for (auto const &word: words) {
+        seen.emplace(word, 0);
+    }
+    return seen.size();
+}
+}
+)";
+
+std::string user_source(int const k) {
+    return "int user_" + std::to_string(k) + R"(() {
+    auto const words = lib::sorted(lib::split("b a c a"));
+    return static_cast<int>(lib::distinct(words) + lib::join(words, ",").size() + words[0].size());
+}
+)";
+}
+
+void write_file(std::filesystem::path const &path, std::string const &content) {
+    auto file = std::ofstream(path);
+    file << content;
+}
+
+class build {
+public:
+    build(std::filesystem::path dir, std::string flags) : m_dir(std::move(dir)), m_flags(std::move(flags)) {}
+
+    /**
+     * Compile `source` into an object in the directory, where gcc writes the
+     * compiled modules as well, and return how long it took in milliseconds.
+     */
+    double compile(std::string const &source, std::string const &language = "") const {
+        auto const command = "cd '" + m_dir.string() + "' && " DOJO_CXX_COMPILER " -std=c++20 " + m_flags + " " +
+                             language + " -c " + source + " -o " + source + ".o 2>>errors.log";
+        auto const start = std::chrono::steady_clock::now();
+        auto const status = std::system(command.c_str());
+        auto const stop = std::chrono::steady_clock::now();
+        EXPECT_EQ(0, status) << "see " << (m_dir / "errors.log");
+        return std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+    double compile_users() const {
+        auto ms = 0.0;
+        for (auto k = 0; k < user_count; ++k) {
+            ms += compile("user_" + std::to_string(k) + ".cpp");
+        }
+        return ms;
+    }
+
+private:
+    std::filesystem::path m_dir;
+    std::string m_flags;
+};
+
+void print(char const *const name, double const ms) {
+    auto const flags = std::cout.flags();
+    auto const precision = std::cout.precision();
+    std::cout << "  " << std::left << std::setw(56) << name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(12) << ms << " ms" << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+}
+
+TEST(TestModulesBenchmark, test_build_time) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    if (std::string(DOJO_CXX_COMPILER_ID) != "GNU") {
+        GTEST_SKIP() << "only the module flags of gcc are known";
+    }
+
+    auto const root = std::filesystem::temp_directory_path() / ("dojo-modules-" + std::to_string(getpid()));
+    auto const header_dir = root / "header";
+    auto const module_dir = root / "module";
+    std::filesystem::create_directories(header_dir);
+    std::filesystem::create_directories(module_dir);
+
+    write_file(header_dir / "lib.h", std::string("#pragma once\n") + includes + declarations);
+    write_file(header_dir / "lib.cpp", std::string("#include \"lib.h\"\n") + definitions);
+    write_file(module_dir / "lib.cppm", std::string("module;\n") + includes + "export module lib;\nexport " +
+                                        declarations + definitions);
+    for (auto k = 0; k < user_count; ++k) {
+        auto const name = "user_" + std::to_string(k) + ".cpp";
+        write_file(header_dir / name, "#include \"lib.h\"\n" + user_source(k));
+        write_file(module_dir / name, "import lib;\n" + user_source(k));
+    }
+
+    auto const header = build(header_dir, "");
+    auto const module = build(module_dir, "-fmodules-ts");
+    auto const compile_library = [&] { return module.compile("lib.cppm", "-x c++"); };
+
+    std::cout << "  " << user_count << " users of a library" << std::endl;
+    print("clean, header", header.compile("lib.cpp") + header.compile_users());
+    print("clean, module", compile_library() + module.compile_users());
+    print("a user edited, header", header.compile("user_0.cpp"));
+    print("a user edited, module", module.compile("user_0.cpp"));
+    print("a definition edited, header", header.compile("lib.cpp"));
+    print("a definition edited, module", compile_library() + module.compile_users());
+
+    auto ec = std::error_code();
+    std::filesystem::remove_all(root, ec);
+}
@@ -20,6 +20,8 @@ module;
 #define _POSIX_C_SOURCE 200809L // NOLINT(*-reserved-identifier)
 
 #include <cstdlib>
+// rather than `import <ctime>;`, since cmake doesn't support header units
+#include <ctime>
 
 /////////////////////////////////////////////
 // end of the global module fragment
@@ -28,10 +30,8 @@ module;
 // here is the normal module unit
 export module module_with_global_fragment;
 
-import <ctime>;
-
 // Only for demonstration (bad source of randomness).
-// Use C++ <random> instead.
+// Use C++ <random>, or the engines of the module dojo.random, instead.
 export [[maybe_unused]] double weak_random() {
     std::timespec ts{};
     std::timespec_get(&ts, TIME_UTC);
@@ -1,9 +1,9 @@
-import module_outer;
-
-import <iostream>;
+#include <iostream>
 
 #include <gtest/gtest.h>
 
+import module_outer;
+
 
 TEST(TestModule, test_call_function_of_nest_imported_module) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
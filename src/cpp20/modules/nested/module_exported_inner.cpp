@@ -1,8 +1,10 @@
-export module module_exported_inner;
+module;
+
+#include <cstdio>
 
-import <iostream>;
+export module module_exported_inner;
 
 // Exported definition
 export [[maybe_unused]] void hello_from_exported_inner() {
-    std::cout << "Hello from exported inner" << std::endl;
+    std::puts("Hello from exported inner");
 }
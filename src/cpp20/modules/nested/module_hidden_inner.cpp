@@ -1,8 +1,11 @@
-export module module_inner;
+module;
+
+// rather than `import <cstdio>;`, since cmake doesn't support header units
+#include <cstdio>
 
-import <iostream>;
+export module module_inner;
 
 // Exported definition
 export [[maybe_unused]] void hello_from_hidden_inner() {
-    std::cout << "Hello from hidden module inner" << std::endl;
+    std::puts("Hello from hidden module inner");
 }
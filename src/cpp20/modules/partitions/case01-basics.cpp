@@ -1,9 +1,9 @@
-import A;
-
 #include <iostream>
 
 #include <gtest/gtest.h>
 
+import A;
+
 
 TEST(TestModule, test_call_function_of_module_with_partitions) { // NOLINT(cert-err58-cpp)
     std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
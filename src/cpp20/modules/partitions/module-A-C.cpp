@@ -1,6 +1,6 @@
 module A:C;
 
-export [[maybe_unused]] char const *hello_from_A_C() {
+[[maybe_unused]] char const *hello_from_A_C() {
     return "Hello from A:C!";
 }
 // ... // more declarations and definitions
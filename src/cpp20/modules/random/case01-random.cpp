@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <set>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+import dojo.random;
+
+/**
+ * The engines of the module dojo.random, checked against the outputs of
+ * their reference implementations.
+ */
+
+TEST(TestRandomModule, test_xoshiro256pp) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the same as xoshiro256plusplus.c with the state {1, 2, 3, 4}
+    auto engine = dojo::random::xoshiro256pp(1, 2, 3, 4);
+    ASSERT_EQ(engine(), 41943041ull);
+    ASSERT_EQ(engine(), 58720359ull);
+    ASSERT_EQ(engine(), 3588806011781223ull);
+    ASSERT_EQ(engine(), 3591011842654386ull);
+
+    auto jumped = dojo::random::xoshiro256pp(1, 2, 3, 4);
+    jumped.jump();
+    ASSERT_EQ(jumped(), 17043750140134683703ull);
+}
+
+TEST(TestRandomModule, test_pcg32) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the same as pcg32-global-demo of the reference with the seed 42 and
+    // the stream 54
+    auto engine = dojo::random::pcg32(42, 54);
+    for (auto const expected: {0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu}) {
+        ASSERT_EQ(engine(), expected);
+    }
+
+    // advancing is the same as stepping, only in O(log(n))
+    auto stepped = dojo::random::pcg32(7);
+    auto advanced = stepped;
+    for (auto i = 0; i < 12345; ++i) {
+        stepped();
+    }
+    advanced.advance(12345);
+    ASSERT_EQ(advanced, stepped);
+
+    // the streams of the same seed differ
+    ASSERT_NE(dojo::random::pcg32(7, 1)(), dojo::random::pcg32(7, 2)());
+}
+
+TEST(TestRandomModule, test_fill) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto numbers = std::vector<double>(1 << 16);
+    auto engine = dojo::random::xoshiro256pp(42);
+    engine.fill(numbers);
+    auto sum = 0.0;
+    for (auto const x: numbers) {
+        ASSERT_TRUE(0.0 <= x && x < 1.0);
+        sum += x;
+    }
+    ASSERT_NEAR(sum / static_cast<double>(numbers.size()), 0.5, 0.01);
+
+    // the lane k of the batch engine is the engine jumped k times, and the
+    // numbers come out lane by lane
+    auto batch = dojo::random::xoshiro256pp_x4(42);
+    auto words = std::vector<std::uint64_t>(11);
+    batch.fill(words);
+    for (auto lane = 0u; lane < 4; ++lane) {
+        auto stream = dojo::random::xoshiro256pp(42).jumped(lane);
+        for (auto i = lane; i < words.size(); i += 4) {
+            ASSERT_EQ(words[i], stream());
+        }
+    }
+}
+
+TEST(TestRandomModule, test_distributions) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // a UniformRandomBitGenerator, as the engines of <random>
+    auto engine = dojo::random::xoshiro256pp(1);
+    auto dice = std::uniform_int_distribution<int>(1, 6);
+    auto faces = std::set<int>();
+    for (auto i = 0; i < 1000; ++i) {
+        faces.insert(dice(engine));
+    }
+    ASSERT_EQ(faces, (std::set<int>{1, 2, 3, 4, 5, 6}));
+}
+
+TEST(TestRandomModule, test_thread_streams) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // unlike weak_random(), neither a shared state nor a reseed per call
+    auto firsts = std::vector<double>(4);
+    auto threads = std::vector<std::thread>();
+    for (auto i = 0u; i < firsts.size(); ++i) {
+        threads.emplace_back([&firsts, i] {
+            firsts[i] = dojo::random::uniform();
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    ASSERT_EQ(std::set<double>(firsts.begin(), firsts.end()).size(), firsts.size());
+}
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../../utils.h"
+
+import dojo.random;
+
+/**
+ * The doubles in [0, 1) per second of the engines of dojo.random, against
+ * drand48 reseeded on every call as weak_random() does, drand48 seeded once,
+ * and std::mt19937_64.
+ *
+ * A batch of 16K doubles is filled again and again, which stays in the cache
+ * as the batches of a simulation would, so that the engines are measured
+ * rather than the bandwidth of the memory.
+ */
+
+TEST(TestRandomModuleBenchmark, test_fill_doubles) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto batch_size = std::size_t{1} << 14;
+    constexpr auto rounds = std::size_t{256};
+    constexpr auto n = batch_size * rounds;
+    auto out = std::vector<double>(batch_size);
+
+    benchmark("drand48, reseeded per call", batch_size, [&] {
+        for (auto i = std::size_t{0}; i < batch_size; ++i) {
+            auto ts = std::timespec();
+            std::timespec_get(&ts, TIME_UTC);
+            srand48(ts.tv_nsec);
+            out[i] = drand48();
+        }
+    });
+    do_not_optimize(out);
+
+    srand48(42);
+    benchmark("drand48", n, [&] {
+        for (auto r = std::size_t{0}; r < rounds; ++r) {
+            for (auto &x: out) {
+                x = drand48();
+            }
+        }
+    });
+    do_not_optimize(out);
+
+    auto mt = std::mt19937_64(42);
+    auto canonical = std::uniform_real_distribution<double>(0.0, 1.0);
+    benchmark("std::mt19937_64", n, [&] {
+        for (auto r = std::size_t{0}; r < rounds; ++r) {
+            for (auto &x: out) {
+                x = canonical(mt);
+            }
+        }
+    });
+    do_not_optimize(out);
+
+    auto pcg = dojo::random::pcg32(42);
+    benchmark("dojo::random::pcg32", n, [&] {
+        for (auto r = std::size_t{0}; r < rounds; ++r) {
+            for (auto &x: out) {
+                x = pcg.next_double();
+            }
+        }
+    });
+    do_not_optimize(out);
+
+    auto xoshiro = dojo::random::xoshiro256pp(42);
+    benchmark("dojo::random::xoshiro256pp::fill", n, [&] {
+        for (auto r = std::size_t{0}; r < rounds; ++r) {
+            xoshiro.fill(out);
+        }
+    });
+    do_not_optimize(out);
+
+    auto batch = dojo::random::xoshiro256pp_x4(42);
+    benchmark("dojo::random::xoshiro256pp_x4::fill", n, [&] {
+        for (auto r = std::size_t{0}; r < rounds; ++r) {
+            batch.fill(out);
+        }
+    });
+    do_not_optimize(out);
+
+    benchmark("dojo::random::uniform, per thread", n, [&] {
+        for (auto r = std::size_t{0}; r < rounds; ++r) {
+            for (auto &x: out) {
+                x = dojo::random::uniform();
+            }
+        }
+    });
+    do_not_optimize(out);
+}
@@ -0,0 +1,327 @@
+/**
+ * A module of fast random engines for the simulations, in place of
+ * weak_random() of module_with_global_fragment, which reseeds the global
+ * state of drand48 on every call: slow, and racy across the threads.
+ *
+ *   - xoshiro256pp, xoshiro256++ of 256 bits of state, the general purpose
+ *     engine, whose jump() advances it by 2^128 steps at the cost of 256
+ *     steps, hence splits it into non-overlapping streams, one per thread;
+ *   - pcg32, a 64-bit lcg with a permuted 32-bit output, which has 2^63
+ *     selectable streams and advances by any distance in O(log(n)) steps;
+ *   - xoshiro256pp_x4, four xoshiro256++ streams interleaved lane by lane,
+ *     whose fill() steps all the lanes at once with vector instructions.
+ * The engines are UniformRandomBitGenerators, so they work with the
+ * distributions of <random> as well.
+ *
+ * The member functions of a class attached to a named module are not
+ * implicitly inline, unlike in a header, so the hot ones are marked inline
+ * to let the importers inline them.
+ *
+ * Reference:
+ * [1] https://prng.di.unimi.it/
+ * [2] https://www.pcg-random.org/
+ */
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+export module dojo.random;
+
+namespace dojo::random::detail {
+
+inline std::uint64_t rotl(std::uint64_t const x, int const k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * The 53 high bits as a double in [0, 1), which is every double of the form
+ * k / 2^53 with the same probability.
+ */
+inline double to_unit_double(std::uint64_t const x) {
+    return static_cast<double>(x >> 11) * 0x1.0p-53;
+}
+
+}
+
+export namespace dojo::random {
+
+/**
+ * The mixer of splitmix64, which turns a counter into well-distributed
+ * words, e.g. for expanding a 64-bit seed into a larger state.
+ */
+inline std::uint64_t splitmix64(std::uint64_t &state) {
+    auto z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+class xoshiro256pp_x4;
+
+class xoshiro256pp {
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return ~result_type{0}; }
+
+    explicit xoshiro256pp(std::uint64_t seed = 0x853c49e6748fea9bull) {
+        for (auto &word: m_s) {
+            word = splitmix64(seed);
+        }
+    }
+
+    /**
+     * From the state itself, which must not be all zeros.
+     */
+    xoshiro256pp(std::uint64_t const s0, std::uint64_t const s1, std::uint64_t const s2, std::uint64_t const s3) :
+            m_s{s0, s1, s2, s3} {}
+
+    inline result_type operator()() {
+        auto const result = detail::rotl(m_s[0] + m_s[3], 23) + m_s[0];
+        auto const t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = detail::rotl(m_s[3], 45);
+        return result;
+    }
+
+    /**
+     * A double in [0, 1).
+     */
+    inline double next_double() { return detail::to_unit_double((*this)()); }
+
+    inline void fill(std::span<double> const out) {
+        for (auto &x: out) {
+            x = next_double();
+        }
+    }
+
+    inline void fill(std::span<std::uint64_t> const out) {
+        for (auto &x: out) {
+            x = (*this)();
+        }
+    }
+
+    /**
+     * Advance by 2^128 steps, which leaves 2^128 non-overlapping streams of
+     * 2^128 numbers each.
+     */
+    void jump() {
+        static constexpr std::uint64_t polynomial[] = {
+                0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull,
+        };
+        apply(polynomial);
+    }
+
+    /**
+     * Advance by 2^192 steps, e.g. once per machine before jump() once per
+     * thread.
+     */
+    void long_jump() {
+        static constexpr std::uint64_t polynomial[] = {
+                0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull,
+        };
+        apply(polynomial);
+    }
+
+    /**
+     * A copy advanced by n jumps, i.e. the n-th stream from this one.
+     */
+    [[nodiscard]] xoshiro256pp jumped(std::uint64_t n) const {
+        auto copy = *this;
+        for (; n != 0; --n) {
+            copy.jump();
+        }
+        return copy;
+    }
+
+    friend bool operator==(xoshiro256pp const &, xoshiro256pp const &) = default;
+
+private:
+    friend class xoshiro256pp_x4;
+
+    void apply(std::uint64_t const (&polynomial)[4]) {
+        std::uint64_t s[4] = {};
+        for (auto const word: polynomial) {
+            for (auto b = 0; b < 64; ++b) {
+                if (word & (std::uint64_t{1} << b)) {
+                    for (auto i = 0; i < 4; ++i) {
+                        s[i] ^= m_s[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (auto i = 0; i < 4; ++i) {
+            m_s[i] = s[i];
+        }
+    }
+
+    std::uint64_t m_s[4];
+};
+
+class pcg32 {
+public:
+    using result_type = std::uint32_t;
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return ~result_type{0}; }
+
+    /**
+     * The same as pcg32_srandom_r(seed, stream) of the reference, where the
+     * engines of different streams never share their sequences.
+     */
+    explicit pcg32(std::uint64_t const seed = 0x853c49e6748fea9bull,
+                   std::uint64_t const stream = 0xda3e39cb94b95bdbull) :
+            m_inc((stream << 1) | 1) {
+        (*this)();
+        m_state += seed;
+        (*this)();
+    }
+
+    inline result_type operator()() {
+        auto const old = m_state;
+        m_state = old * multiplier + m_inc;
+        auto const xorshifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        auto const rot = static_cast<std::uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+
+    /**
+     * A double in [0, 1), from two outputs.
+     */
+    inline double next_double() {
+        auto const high = std::uint64_t{(*this)()};
+        return detail::to_unit_double((high << 32) | (*this)());
+    }
+
+    /**
+     * Advance by `delta` steps in O(log(delta)), by squaring the affine map
+     * of one step, i.e. x -> a * x + c, as many times as delta has bits.
+     */
+    void advance(std::uint64_t delta) {
+        auto acc_mult = std::uint64_t{1}, acc_plus = std::uint64_t{0};
+        auto cur_mult = multiplier, cur_plus = m_inc;
+        for (; delta != 0; delta >>= 1) {
+            if (delta & 1) {
+                acc_mult *= cur_mult;
+                acc_plus = acc_plus * cur_mult + cur_plus;
+            }
+            cur_plus = (cur_mult + 1) * cur_plus;
+            cur_mult *= cur_mult;
+        }
+        m_state = acc_mult * m_state + acc_plus;
+    }
+
+    friend bool operator==(pcg32 const &, pcg32 const &) = default;
+
+private:
+    static constexpr std::uint64_t multiplier = 6364136223846793005ull;
+
+    std::uint64_t m_state = 0;
+    std::uint64_t m_inc;
+};
+
+/**
+ * Four streams of xoshiro256++ stepped together, for filling large buffers.
+ *
+ * The state is kept in four vectors of the gcc vector extensions, one per
+ * word of the state, holding that word of all the lanes, so that every step
+ * is a few vector instructions: two of sse2 each, or one of avx2 with
+ * -mavx2. The numbers come out interleaved, the i-th from the lane i % 4,
+ * where the lane k is the engine jumped k times.
+ *
+ * The doubles take 52 random bits rather than 53, as the mantissa of a
+ * double in [1, 2) minus 1, since the vector units of x86-64 can't convert a
+ * 64-bit integer to a double before avx-512.
+ *
+ * The vectors are only passed by reference, whose layout doesn't depend on
+ * whether avx is enabled, unlike passing them by value.
+ */
+class xoshiro256pp_x4 {
+public:
+    static constexpr std::size_t lanes = 4;
+
+    explicit xoshiro256pp_x4(std::uint64_t const seed = 0x853c49e6748fea9bull) :
+            xoshiro256pp_x4(xoshiro256pp(seed)) {}
+
+    explicit xoshiro256pp_x4(xoshiro256pp engine) {
+        for (auto lane = std::size_t{0}; lane < lanes; ++lane) {
+            for (auto word = 0; word < 4; ++word) {
+                m_s[word][lane] = engine.m_s[word];
+            }
+            engine.jump();
+        }
+    }
+
+    inline void fill(std::span<std::uint64_t> const out) { fill_lanes(out); }
+
+    inline void fill(std::span<double> const out) { fill_lanes(out); }
+
+private:
+    using words = std::uint64_t __attribute__((vector_size(32)));
+    using doubles = double __attribute__((vector_size(32)));
+
+    template<typename T>
+    inline void fill_lanes(std::span<T> const out) {
+        // in registers, rather than stored back on every step
+        auto s0 = m_s[0], s1 = m_s[1], s2 = m_s[2], s3 = m_s[3];
+        auto next = [&](auto &result) {
+            auto const sum = s0 + s3;
+            auto const word = ((sum << 23) | (sum >> 41)) + s0;
+            auto const t = s1 << 17;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = (s3 << 45) | (s3 >> 19);
+            if constexpr (std::is_same_v<T, double>) {
+                result = reinterpret_cast<doubles>((word >> 12) | 0x3ff0000000000000ull) - 1.0;
+            } else {
+                result = word;
+            }
+        };
+
+        auto result = std::conditional_t<std::is_same_v<T, double>, doubles, words>();
+        auto i = std::size_t{0};
+        for (; i + lanes <= out.size(); i += lanes) {
+            next(result);
+            std::memcpy(out.data() + i, &result, sizeof(result));
+        }
+        if (i != out.size()) {
+            next(result);
+            std::memcpy(out.data() + i, &result, (out.size() - i) * sizeof(T));
+        }
+        m_s[0] = s0;
+        m_s[1] = s1;
+        m_s[2] = s2;
+        m_s[3] = s3;
+    }
+
+    words m_s[4];
+};
+
+/**
+ * The engine of the calling thread, on a stream of its own, see
+ * random_impl.cpp.
+ */
+xoshiro256pp &thread_engine();
+
+/**
+ * A double in [0, 1) from the engine of the calling thread, the thread-safe
+ * replacement of weak_random().
+ */
+double uniform();
+
+}
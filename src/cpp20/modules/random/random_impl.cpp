@@ -0,0 +1,38 @@
+/**
+ * The implementation unit of dojo.random, whose includes stay out of the
+ * interface, hence out of every importer.
+ */
+module;
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+module dojo.random;
+
+namespace dojo::random {
+
+/**
+ * Every thread takes the next jump of an engine seeded once by
+ * std::random_device, so no two threads ever share a stream.
+ */
+xoshiro256pp &thread_engine() {
+    thread_local auto engine = [] {
+        static auto mutex = std::mutex();
+        static auto next = [] {
+            auto device = std::random_device();
+            return xoshiro256pp((std::uint64_t{device()} << 32) | device());
+        }();
+        auto const lock = std::lock_guard(mutex);
+        auto const engine = next;
+        next.jump();
+        return engine;
+    }();
+    return engine;
+}
+
+double uniform() {
+    return thread_engine().next_double();
+}
+
+}
@@ -0,0 +1,224 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "parallel_for.h"
+
+/**
+ * A parallel loop over a range of integers, in the way of `#pragma omp
+ * parallel for`, on the threads of a dojo::thread_pool plus the calling one.
+ *
+ * reference from https://www.openmp.org/spec-html/5.0/openmpsu41.html
+ */
+
+namespace {
+
+auto const schedules = {
+        dojo::schedule_kind::static_chunks,
+        dojo::schedule_kind::dynamic,
+        dojo::schedule_kind::guided,
+};
+
+/**
+ * A memory resource which throws std::bad_alloc once it has allocated as
+ * many times as told.
+ */
+class limited_resource : public std::pmr::memory_resource {
+public:
+    std::atomic<int> budget{std::numeric_limits<int>::max()};
+    std::atomic<int> allocations{0};
+
+protected:
+    void *do_allocate(std::size_t const bytes, std::size_t const alignment) override {
+        if (budget.fetch_sub(1) <= 0) {
+            throw std::bad_alloc();
+        }
+        allocations.fetch_add(1);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *const p, std::size_t const bytes, std::size_t const alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
+
+TEST(TestParallelFor, test_every_index_once) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto pool = dojo::thread_pool(3);
+    for (auto const schedule: schedules) {
+        for (auto const chunk: {0u, 1u, 7u, 1000u}) {
+            auto hits = std::vector<std::atomic<int>>(1000);
+            dojo::parallel_for(std::views::iota(-500, 500), [&](int const i) {
+                hits[i + 500].fetch_add(1, std::memory_order_relaxed);
+            }, {.schedule = schedule, .chunk = chunk, .threads = 4, .pool = &pool});
+
+            for (auto const &hit: hits) {
+                ASSERT_EQ(1, hit.load());
+            }
+        }
+    }
+
+    // empty, and fewer indices than threads
+    auto calls = std::atomic<int>(0);
+    dojo::parallel_for(std::views::iota(7, 7), [&](int) { ++calls; });
+    ASSERT_EQ(0, calls.load());
+    dojo::parallel_for(std::views::iota(std::uint64_t{0}, std::uint64_t{2}), [&](std::uint64_t) { ++calls; },
+                       {.schedule = dojo::schedule_kind::dynamic, .threads = 8, .pool = &pool});
+    ASSERT_EQ(2, calls.load());
+}
+
+TEST(TestParallelFor, test_static_chunks) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the chunks are dealt round-robin: whichever thread runs the slot s runs
+    // the chunks s, s + 3, s + 6, ..., so every chunk is run by a single
+    // thread in ascending order
+    auto pool = dojo::thread_pool(2);
+    auto owner = std::vector<std::thread::id>(90);
+    dojo::parallel_for(std::views::iota(0, 90), [&](int const i) {
+        owner[i] = std::this_thread::get_id();
+    }, {.chunk = 10, .threads = 3, .pool = &pool});
+
+    for (auto i = 0; i < 90; i += 10) {
+        for (auto j = i; j < i + 10; ++j) {
+            ASSERT_EQ(owner[i], owner[j]);
+        }
+    }
+}
+
+TEST(TestParallelFor, test_nested) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the outer loop keeps all the workers busy, so the inner loops mostly
+    // run on their callers alone, rather than waiting for a worker forever
+    auto pool = dojo::thread_pool(2);
+    auto sums = std::vector<std::atomic<long>>(16);
+    dojo::parallel_for(std::views::iota(0, 16), [&](int const i) {
+        dojo::parallel_for(std::views::iota(0, 1000), [&](int const j) {
+            sums[i].fetch_add(j, std::memory_order_relaxed);
+        }, {.schedule = dojo::schedule_kind::dynamic, .chunk = 16, .pool = &pool});
+    }, {.schedule = dojo::schedule_kind::dynamic, .threads = 3, .pool = &pool});
+
+    for (auto const &sum: sums) {
+        ASSERT_EQ(999 * 1000 / 2, sum.load());
+    }
+}
+
+TEST(TestParallelFor, test_reduce) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto pool = dojo::thread_pool(3);
+    for (auto const schedule: schedules) {
+        auto const sum = dojo::parallel_reduce(
+                std::views::iota(std::int64_t{1}, std::int64_t{100'001}), std::int64_t{0},
+                [](std::int64_t &acc, std::int64_t const i) { acc += i; }, std::plus<>(),
+                {.schedule = schedule, .chunk = 64, .threads = 4, .pool = &pool});
+        ASSERT_EQ(std::int64_t{100'000} * 100'001 / 2, sum);
+    }
+
+    // any type and any combination, e.g. the distinct remainders
+    auto const remainders = dojo::parallel_reduce(
+            std::views::iota(0, 1000), std::set<int>(),
+            [](std::set<int> &acc, int const i) { acc.insert(i % 7); },
+            [](std::set<int> a, std::set<int> const &b) {
+                a.insert(b.begin(), b.end());
+                return a;
+            }, {.threads = 4, .pool = &pool});
+    ASSERT_EQ((std::set<int>{0, 1, 2, 3, 4, 5, 6}), remainders);
+
+    // the static schedule combines in the same order every time, hence the
+    // same rounding of a floating-point sum
+    auto const harmonic = [&] {
+        return dojo::parallel_reduce(std::views::iota(1, 1'000'000), 0.0,
+                                     [](double &acc, int const i) { acc += 1.0 / i; }, std::plus<>(),
+                                     {.threads = 4, .pool = &pool});
+    };
+    auto const expected = harmonic();
+    for (auto i = 0; i < 5; ++i) {
+        ASSERT_EQ(expected, harmonic());
+    }
+}
+
+TEST(TestParallelFor, test_exception) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto &abandoned = dojo::metrics::registry::global().get_counter("dojo_future_abandoned_total");
+    auto const abandoned_before = abandoned.value();
+    auto pool = dojo::thread_pool(3);
+    for (auto const schedule: schedules) {
+        auto calls = std::atomic<int>(0);
+        ASSERT_THROW(dojo::parallel_for(std::views::iota(0, 100'000), [&](int const i) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            if (i == 10) {
+                throw std::runtime_error("boom");
+            }
+        }, {.schedule = schedule, .chunk = 16, .threads = 4, .pool = &pool}), std::runtime_error);
+
+        // the chunks not started yet are skipped
+        ASSERT_LT(calls.load(), 100'000);
+    }
+
+    // the pool is still usable
+    auto calls = std::atomic<int>(0);
+    dojo::parallel_for(std::views::iota(0, 100), [&](int) { ++calls; }, {.threads = 4, .pool = &pool});
+    ASSERT_EQ(100, calls.load());
+
+    // the futures of the helpers are given up on purpose, thrown or not
+    ASSERT_EQ(abandoned.value(), abandoned_before);
+}
+
+/**
+ * A helper failing to be submitted after another has joined: the loop runs to
+ * its end before the error is thrown, since the helper which has joined runs
+ * the body on the frames of the caller.
+ */
+TEST(TestParallelFor, test_submit_failure) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto resource = limited_resource();
+    auto pool = dojo::thread_pool(2, &resource);
+    // the allocations of submitting a single task, once the queue has grown
+    for (auto i = 0; i < 2; ++i) {
+        pool.submit([] {}).get();
+    }
+    auto const before = resource.allocations.load();
+    pool.submit([] {}).get();
+    auto const per_task = resource.allocations.load() - before;
+
+    for (auto const schedule: schedules) {
+        auto calls = std::vector<std::atomic<int>>(10'000);
+        resource.budget = per_task;
+        ASSERT_THROW(dojo::parallel_for(std::views::iota(0, 10'000), [&](int const i) {
+            calls[i].fetch_add(1, std::memory_order_relaxed);
+            // so that a helper which has joined is still running as the
+            // next one fails to be submitted
+            if (i % 1000 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }, {.schedule = schedule, .chunk = 16, .threads = 3, .pool = &pool}), std::bad_alloc);
+        resource.budget = std::numeric_limits<int>::max();
+
+        for (auto const &c: calls) {
+            ASSERT_EQ(c.load(), 1);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "parallel_for.h"
+#include "../../../utils.h"
+
+/**
+ * The scaling of parallel_for with the thread count, the schedules under a
+ * skewed load, and the padding of the accumulators of a reduction.
+ *
+ * Only printed, not asserted, since the numbers depend on the cores at hand:
+ * with a single core, the threads only add the cost of switching among them.
+ */
+
+namespace {
+
+std::vector<std::size_t> thread_counts() {
+    auto const hardware = std::size_t{std::max(std::thread::hardware_concurrency(), 1u)};
+    auto counts = std::vector<std::size_t>{1, 2, 4, 8};
+    if (hardware > 8) {
+        counts.push_back(hardware);
+    }
+    return counts;
+}
+
+/**
+ * Some arithmetic which costs about `n` multiplications, not memory bound.
+ */
+double work(int const i, int const n) {
+    auto x = 1.0 + i * 1e-9;
+    for (auto k = 0; k < n; ++k) {
+        x = x * 1.0000001 + 1e-9;
+    }
+    return x;
+}
+
+}
+
+TEST(TestParallelForBenchmark, test_scaling) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto n = 1 << 16;
+    auto out = std::vector<double>(n);
+    for (auto const threads: thread_counts()) {
+        auto pool = dojo::thread_pool(threads - 1);
+        auto const name = "uniform load, " + std::to_string(threads) + " threads";
+        benchmark(name.c_str(), n, [&] {
+            dojo::parallel_for(std::views::iota(0, n), [&](int const i) {
+                out[i] = work(i, 64);
+            }, {.threads = threads, .pool = &pool});
+        });
+        do_not_optimize(out);
+    }
+}
+
+TEST(TestParallelForBenchmark, test_load_imbalance) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the cost grows with the index, so that one block each leaves the
+    // thread of the last block with as much work as all the others together
+    constexpr auto n = 1 << 12;
+    auto out = std::vector<double>(n);
+    auto const threads = std::size_t{4};
+    auto pool = dojo::thread_pool(threads - 1);
+
+    struct variant {
+        char const *name;
+        dojo::parallel_options options;
+    };
+    auto const variants = {
+            variant{"static, one block each", {.schedule = dojo::schedule_kind::static_chunks}},
+            variant{"static, chunks of 16", {.schedule = dojo::schedule_kind::static_chunks, .chunk = 16}},
+            variant{"dynamic, chunks of 1", {.schedule = dojo::schedule_kind::dynamic}},
+            variant{"dynamic, chunks of 16", {.schedule = dojo::schedule_kind::dynamic, .chunk = 16}},
+            variant{"guided, down to 1", {.schedule = dojo::schedule_kind::guided}},
+            variant{"guided, down to 16", {.schedule = dojo::schedule_kind::guided, .chunk = 16}},
+    };
+    for (auto v: variants) {
+        v.options.threads = threads;
+        v.options.pool = &pool;
+        benchmark(v.name, n, [&] {
+            dojo::parallel_for(std::views::iota(0, n), [&](int const i) {
+                out[i] = work(i, i / 4);
+            }, v.options);
+        });
+        do_not_optimize(out);
+    }
+}
+
+TEST(TestParallelForBenchmark, test_reduce_padding) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // every iteration writes its accumulator in memory, as a loop body which
+    // doesn't keep it in a register would
+    constexpr auto n = 1 << 22;
+    auto const threads = std::size_t{4};
+    auto pool = dojo::thread_pool(threads - 1);
+    // one index per thread
+    auto const options = dojo::parallel_options{.threads = threads, .pool = &pool};
+
+    auto unpadded = std::vector<std::uint64_t>(threads);
+    benchmark("adjacent accumulators", n, [&] {
+        auto next = std::atomic<std::size_t>(0);
+        dojo::parallel_for(std::views::iota(std::size_t{0}, threads), [&](std::size_t) {
+            auto &acc = unpadded[next.fetch_add(1)];
+            for (auto i = 0; i < n / static_cast<int>(threads); ++i) {
+                acc += i;
+                do_not_optimize(acc);
+            }
+        }, options);
+    });
+
+    auto padded = std::vector<cache_line_padded<std::uint64_t>>(threads);
+    benchmark("accumulators padded to cache lines", n, [&] {
+        auto next = std::atomic<std::size_t>(0);
+        dojo::parallel_for(std::views::iota(std::size_t{0}, threads), [&](std::size_t) {
+            auto &acc = padded[next.fetch_add(1)].value;
+            for (auto i = 0; i < n / static_cast<int>(threads); ++i) {
+                acc += i;
+                do_not_optimize(acc);
+            }
+        }, options);
+    });
+
+    auto sum = std::uint64_t{0};
+    benchmark("parallel_reduce", n, [&] {
+        sum = dojo::parallel_reduce(std::views::iota(0, n), std::uint64_t{0},
+                                    [](std::uint64_t &acc, int const i) { acc += i; }, std::plus<>(),
+                                    {.chunk = 1024, .threads = threads, .pool = &pool});
+    });
+    do_not_optimize(sum);
+}
@@ -0,0 +1,320 @@
+#ifndef CPP_XX_DOJO_PARALLEL_FOR_H
+#define CPP_XX_DOJO_PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../cancellation/thread_pool.h"
+#include "../synchronization/spin_wait.h"
+#include "../../../utils.h"
+
+namespace dojo {
+
+/**
+ * How the iterations are split among the threads, the same as the schedule
+ * clause of OpenMP.
+ */
+enum class schedule_kind {
+    // every thread takes its fixed share, in chunks handed out round-robin,
+    // or one contiguous block each by default: no coordination at all, but a
+    // thread with the costly iterations holds up the others
+    static_chunks,
+    // every thread takes the next chunk once done with the previous one, from
+    // a shared atomic counter: balances any load, at the cost of a contended
+    // read-modify-write per chunk, one iteration each by default
+    dynamic,
+    // like dynamic, with chunks proportional to the iterations left, down to
+    // the given chunk size: large chunks first, then smaller ones to balance
+    // the end
+    guided,
+};
+
+struct parallel_options {
+    schedule_kind schedule = schedule_kind::static_chunks;
+    // the iterations of a chunk, or the default of the schedule if 0
+    std::size_t chunk = 0;
+    // the threads taking part, including the calling one, or as many as the
+    // cpus if 0
+    std::size_t threads = 0;
+    // where the helper threads come from, or a pool shared by all the loops
+    thread_pool *pool = nullptr;
+};
+
+namespace detail {
+
+inline thread_pool &default_parallel_pool() {
+    static auto pool = thread_pool();
+    return pool;
+}
+
+/**
+ * The iterations [0, size) of a loop, shared by the caller and its helpers,
+ * which are tasks of a thread pool.
+ *
+ * A helper only takes part if it starts before the caller has run out of
+ * iterations, so the caller never waits for a task which hasn't started:
+ * e.g. with the workers of the pool all busy running the outer loops, a
+ * nested loop is simply run by its caller alone, rather than deadlocking.
+ */
+class loop_team {
+public:
+    using body_fn = void (*)(void *body, std::size_t slot, std::size_t first, std::size_t last);
+
+    loop_team(std::size_t const size, std::size_t const slots, parallel_options const &options,
+              void *const body, body_fn const call) :
+            m_size(size), m_slots(slots), m_schedule(options.schedule),
+            m_chunk(chunk_of(size, slots, options)), m_body(body), m_call(call) {}
+
+    /**
+     * Run by a helper: take part unless the loop is over already.
+     */
+    void help() {
+        if (m_members.fetch_add(1, std::memory_order_acquire) & closed) {
+            leave();
+            return;
+        }
+        work();
+        leave();
+    }
+
+    /**
+     * Run by the caller: take part, then wait for the helpers which did.
+     */
+    void run_and_wait() {
+        work();
+        auto members = m_members.fetch_or(closed, std::memory_order_acq_rel) | closed;
+        while (members != closed) {
+            spin_then_wait(m_members, members);
+            members = m_members.load(std::memory_order_acquire);
+        }
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+private:
+    static constexpr std::uint32_t closed = 1u << 31;
+
+    static std::size_t chunk_of(std::size_t const size, std::size_t const slots, parallel_options const &options) {
+        if (options.chunk != 0) {
+            return options.chunk;
+        }
+        return options.schedule == schedule_kind::static_chunks ? (size + slots - 1) / slots : 1;
+    }
+
+    void leave() {
+        if (m_members.fetch_sub(1, std::memory_order_release) == (closed | 1)) {
+            m_members.notify_all();
+        }
+    }
+
+    void work() {
+        try {
+            // a slot of the accumulators of a reduction, besides the static
+            // share of the iterations
+            for (auto slot = m_next_slot.fetch_add(1, std::memory_order_relaxed); slot < m_slots;
+                 slot = m_next_slot.fetch_add(1, std::memory_order_relaxed)) {
+                switch (m_schedule) {
+                    case schedule_kind::static_chunks:
+                        run_static(slot);
+                        // and the shares of the helpers which haven't come
+                        continue;
+                    case schedule_kind::dynamic:
+                        run_dynamic(slot);
+                        return;
+                    case schedule_kind::guided:
+                        run_guided(slot);
+                        return;
+                }
+            }
+        } catch (...) {
+            auto const lock = std::lock_guard(m_error_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+            m_failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void run_static(std::size_t const slot) {
+        for (auto first = slot * m_chunk; first < m_size && !failed(); first += m_slots * m_chunk) {
+            m_call(m_body, slot, first, std::min(m_size, first + m_chunk));
+        }
+    }
+
+    void run_dynamic(std::size_t const slot) {
+        for (auto first = m_next.fetch_add(m_chunk, std::memory_order_relaxed); first < m_size && !failed();
+             first = m_next.fetch_add(m_chunk, std::memory_order_relaxed)) {
+            m_call(m_body, slot, first, std::min(m_size, first + m_chunk));
+        }
+    }
+
+    void run_guided(std::size_t const slot) {
+        auto first = m_next.load(std::memory_order_relaxed);
+        while (first < m_size && !failed()) {
+            auto const chunk = std::max(m_chunk, (m_size - first) / (2 * m_slots));
+            auto const last = std::min(m_size, first + chunk);
+            if (m_next.compare_exchange_weak(first, last, std::memory_order_relaxed)) {
+                m_call(m_body, slot, first, last);
+                first = m_next.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] bool failed() const noexcept { return m_failed.load(std::memory_order_relaxed); }
+
+    std::size_t const m_size;
+    std::size_t const m_slots;
+    schedule_kind const m_schedule;
+    std::size_t const m_chunk;
+    void *const m_body;
+    body_fn const m_call;
+
+    // the helpers which have taken part and not left yet, and whether the
+    // caller is done, on a 32-bit word to be waited on
+    alignas(cache_line_size) std::atomic<std::uint32_t> m_members{0};
+    alignas(cache_line_size) std::atomic<std::size_t> m_next_slot{0};
+    // the next iteration of the dynamic and guided schedules
+    alignas(cache_line_size) std::atomic<std::size_t> m_next{0};
+    std::atomic<bool> m_failed{false};
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+};
+
+/**
+ * Run `body(slot, first, last)` over the chunks of [0, size), on `slots`
+ * threads at most, where `slot` tells which of them is running.
+ */
+template<typename Body>
+void run_loop(std::size_t const size, parallel_options const &options, std::size_t slots, Body &&body) {
+    auto &pool = options.pool != nullptr ? *options.pool : default_parallel_pool();
+    if (slots <= 1 || pool.size() == 0) {
+        body(std::size_t{0}, std::size_t{0}, size);
+        return;
+    }
+
+    auto const team = std::make_shared<loop_team>(
+            size, slots, options, std::addressof(body),
+            [](void *const b, std::size_t const slot, std::size_t const first, std::size_t const last) {
+                (*static_cast<std::remove_reference_t<Body> *>(b))(slot, first, last);
+            });
+    // the helpers which haven't started by the end are aborted as their
+    // futures are discarded, and the started ones are done with the body
+    auto helpers = std::vector<cancellable_future<void>>();
+    helpers.reserve(slots - 1);
+    auto const discard_helpers = [&helpers] {
+        for (auto &helper: helpers) {
+            helper.discard();
+        }
+    };
+    try {
+        for (auto i = std::size_t{1}; i < slots; ++i) {
+            helpers.push_back(pool.submit([team] { team->help(); }));
+        }
+    } catch (...) {
+        // the helpers which have joined are running the body, on the frames
+        // of the caller, hence the caller runs the loop to its end with them
+        // before unwinding, and throws the error of submitting after all
+        try {
+            team->run_and_wait();
+        } catch (...) {
+        }
+        discard_helpers();
+        throw;
+    }
+    try {
+        team->run_and_wait();
+    } catch (...) {
+        discard_helpers();
+        throw;
+    }
+    discard_helpers();
+}
+
+template<std::integral I, typename S>
+requires std::ranges::sized_range<std::ranges::iota_view<I, S>>
+std::pair<I, std::size_t> iota_bounds(std::ranges::iota_view<I, S> const &range) {
+    return {*range.begin(), static_cast<std::size_t>(range.size())};
+}
+
+inline std::size_t slots_of(std::size_t const size, parallel_options const &options) {
+    auto const threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    // no more threads than chunks
+    auto const chunk = std::max(options.chunk, std::size_t{1});
+    return std::max(std::size_t{1}, std::min(threads, (size + chunk - 1) / chunk));
+}
+
+}
+
+/**
+ * Call `fn(i)` for every integer of `range`, e.g. std::views::iota(0, n), on
+ * several threads, split as told by the options. Returns once all the calls
+ * have returned, and rethrows the first exception thrown by any of them, in
+ * which case the chunks not started yet are skipped.
+ *
+ * The calling thread takes part, and the others come from a thread pool. A
+ * parallel_for may be nested in another, in which case the inner loop gets
+ * the threads of the pool left idle by the outer one, if any.
+ */
+template<std::integral I, typename S, typename Fn>
+requires std::ranges::sized_range<std::ranges::iota_view<I, S>> && std::invocable<Fn &, I>
+void parallel_for(std::ranges::iota_view<I, S> const range, Fn &&fn, parallel_options const &options = {}) {
+    auto const [first, size] = detail::iota_bounds(range);
+    detail::run_loop(size, options, detail::slots_of(size, options),
+                     [&](std::size_t, std::size_t const begin, std::size_t const end) {
+                         for (auto i = begin; i != end; ++i) {
+                             std::invoke(fn, static_cast<I>(first + static_cast<I>(i)));
+                         }
+                     });
+}
+
+/**
+ * Fold `fn(accumulator, i)` over every integer of `range` on several
+ * threads, where every thread folds into an accumulator of its own, starting
+ * from `identity`, then combine the accumulators with `combine`.
+ *
+ * The accumulators are padded to cache lines of their own, or else the
+ * threads writing to neighbouring accumulators would keep invalidating each
+ * other's cache lines, i.e. false sharing. With the static schedule, the
+ * accumulators are combined in the same order whatever the timing, so the
+ * result of a floating-point sum is reproducible for a given thread count.
+ */
+template<std::integral I, typename S, typename T, typename Fn, typename Combine = std::plus<>>
+requires std::ranges::sized_range<std::ranges::iota_view<I, S>> && std::invocable<Fn &, T &, I> &&
+         std::is_invocable_r_v<T, Combine &, T, T>
+T parallel_reduce(std::ranges::iota_view<I, S> const range, T identity, Fn &&fn, Combine combine = {},
+                  parallel_options const &options = {}) {
+    auto const [first, size] = detail::iota_bounds(range);
+    auto const slots = detail::slots_of(size, options);
+    auto accumulators = std::vector<cache_line_padded<T>>(slots, cache_line_padded<T>{identity});
+    detail::run_loop(size, options, slots, [&](std::size_t const slot, std::size_t const begin, std::size_t const end) {
+        // in a register rather than in memory for the whole chunk
+        auto accumulator = std::move(accumulators[slot].value);
+        for (auto i = begin; i != end; ++i) {
+            std::invoke(fn, accumulator, static_cast<I>(first + static_cast<I>(i)));
+        }
+        accumulators[slot].value = std::move(accumulator);
+    });
+
+    auto result = std::move(identity);
+    for (auto &accumulator: accumulators) {
+        result = std::invoke(combine, std::move(result), std::move(accumulator.value));
+    }
+    return result;
+}
+
+}
+
+#endif //CPP_XX_DOJO_PARALLEL_FOR_H
@@ -0,0 +1,456 @@
+#ifndef CPP_XX_DOJO_ANY_VIEW_H
+#define CPP_XX_DOJO_ANY_VIEW_H
+
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace dojo {
+
+namespace detail {
+
+/**
+ * An object of a type known only to its owner, stored in place if it's small
+ * enough and nothrow movable, or allocated otherwise.
+ */
+template<std::size_t Size>
+class small_buffer {
+public:
+    template<typename U>
+    static constexpr bool fits = sizeof(U) <= Size && alignof(U) <= alignof(std::max_align_t) &&
+                                 std::is_nothrow_move_constructible_v<U>;
+
+    small_buffer() noexcept = default;
+
+    // the owner moves, copies and destroys the object, knowing its type
+    small_buffer(small_buffer const &) = delete;
+
+    small_buffer &operator=(small_buffer const &) = delete;
+
+    template<typename U, typename... Args>
+    U *emplace(Args &&...args) {
+        if constexpr (fits<U>) {
+            m_object = ::new(static_cast<void *>(m_inline)) U(std::forward<Args>(args)...);
+        } else {
+            m_object = new U(std::forward<Args>(args)...);
+        }
+        return static_cast<U *>(m_object);
+    }
+
+    template<typename U>
+    void destroy() noexcept {
+        if constexpr (fits<U>) {
+            std::destroy_at(get<U>());
+        } else {
+            delete get<U>();
+        }
+        m_object = nullptr;
+    }
+
+    /**
+     * Move the object of `other` into this empty buffer, leaving `other` empty.
+     */
+    template<typename U>
+    void relocate_from(small_buffer &other) noexcept {
+        if constexpr (fits<U>) {
+            emplace<U>(std::move(*other.get<U>()));
+            other.destroy<U>();
+        } else {
+            m_object = std::exchange(other.m_object, nullptr);
+        }
+    }
+
+    template<typename U>
+    U *get() const noexcept { return static_cast<U *>(m_object); }
+
+    [[nodiscard]] bool is_inline() const noexcept { return m_object == static_cast<void const *>(m_inline); }
+
+private:
+    alignas(std::max_align_t) std::byte m_inline[Size];
+    void *m_object = nullptr;
+};
+
+template<typename R, typename Category>
+concept range_of_category =
+        (std::derived_from<Category, std::input_iterator_tag> && std::ranges::input_range<R>) &&
+        (!std::derived_from<Category, std::forward_iterator_tag> || std::ranges::forward_range<R>) &&
+        (!std::derived_from<Category, std::bidirectional_iterator_tag> || std::ranges::bidirectional_range<R>) &&
+        (!std::derived_from<Category, std::random_access_iterator_tag> ||
+         (std::ranges::random_access_range<R> && std::sized_sentinel_for<
+                 std::ranges::sentinel_t<R>, std::ranges::iterator_t<R>>));
+
+}
+
+/**
+ * @brief An owning, move-only view of any type whose elements are `T`, to
+ * store pipelines of views somewhere and run them later
+ *
+ * Every pipeline of views has a type of its own, e.g. a filter_view of a
+ * transform_view of a ref_view of a vector, with lambdas in between, so the
+ * pipelines can't be kept together in a container, nor be passed across a
+ * non-template interface, without erasing their types. The usual erasure is
+ * a virtual base class, which allocates both the view and every iterator on
+ * the heap. Here neither the view nor its iterators allocate if they fit in
+ * their small buffers, which is the case for the usual chains of two or
+ * three adaptors, and their functions are called through tables of function
+ * pointers, so there's no virtual pointer to keep inline either.
+ *
+ * The iterator still costs an indirect call for each of the dereference, the
+ * increment and the comparison with the end, which keeps the compiler from
+ * inlining the pipeline into the loop. for_each() runs the loop inside the
+ * erased type instead, with a single indirect call per element.
+ *
+ * @tparam T the reference type of the view, e.g. `int` for the results of a
+ * transform, or `int &` for the elements of a container
+ * @tparam Category the iterator category the view provides, which the
+ * erased view must provide as well, from std::input_iterator_tag to
+ * std::random_access_iterator_tag. A random-access view is sized as well.
+ */
+template<typename T, typename Category = std::input_iterator_tag>
+class any_view : public std::ranges::view_interface<any_view<T, Category>> {
+    static constexpr bool is_forward = std::derived_from<Category, std::forward_iterator_tag>;
+    static constexpr bool is_bidirectional = std::derived_from<Category, std::bidirectional_iterator_tag>;
+    static constexpr bool is_random_access = std::derived_from<Category, std::random_access_iterator_tag>;
+
+public:
+    static constexpr std::size_t view_buffer_size = 64;
+    static constexpr std::size_t iterator_buffer_size = 48;
+
+    class iterator;
+
+    any_view() = default;
+
+    template<std::ranges::viewable_range R>
+    requires (!std::is_same_v<std::remove_cvref_t<R>, any_view> &&
+              detail::range_of_category<std::views::all_t<R>, Category> &&
+              std::convertible_to<std::ranges::range_reference_t<std::views::all_t<R>>, T>)
+    explicit(false) any_view(R &&r) : m_vtable(&view_vtable_for<std::views::all_t<R>>) {
+        m_view.template emplace<std::views::all_t<R>>(std::views::all(std::forward<R>(r)));
+    }
+
+    any_view(any_view &&other) noexcept : m_vtable(std::exchange(other.m_vtable, nullptr)) {
+        if (m_vtable != nullptr) {
+            m_vtable->relocate(m_view, other.m_view);
+        }
+    }
+
+    any_view &operator=(any_view &&other) noexcept {
+        if (this != &other) {
+            reset();
+            if ((m_vtable = std::exchange(other.m_vtable, nullptr)) != nullptr) {
+                m_vtable->relocate(m_view, other.m_view);
+            }
+        }
+        return *this;
+    }
+
+    ~any_view() { reset(); }
+
+    iterator begin() {
+        auto it = iterator();
+        it.m_vtable = m_vtable->begin(m_view, it.m_state);
+        return it;
+    }
+
+    std::default_sentinel_t end() noexcept { return {}; }
+
+    [[nodiscard]] std::size_t size() requires is_random_access {
+        return static_cast<std::size_t>(std::default_sentinel - begin());
+    }
+
+    /**
+     * Call `fn` with every element, by iterating the erased view directly.
+     */
+    template<typename Fn>
+    requires std::invocable<Fn &, T>
+    void for_each(Fn &&fn) {
+        m_vtable->for_each(m_view, std::addressof(fn), [](void *const f, T element) {
+            (*static_cast<std::remove_reference_t<Fn> *>(f))(static_cast<T>(element));
+        });
+    }
+
+    /**
+     * Whether the erased view is stored in place, rather than allocated.
+     */
+    [[nodiscard]] bool is_inline() const noexcept { return m_vtable == nullptr || m_view.is_inline(); }
+
+private:
+    using view_buffer = detail::small_buffer<view_buffer_size>;
+    using iterator_buffer = detail::small_buffer<iterator_buffer_size>;
+    using difference_type = std::ptrdiff_t;
+
+    struct iterator_vtable {
+        void (*copy)(iterator_buffer &to, iterator_buffer const &from);
+        void (*relocate)(iterator_buffer &to, iterator_buffer &from) noexcept;
+        void (*destroy)(iterator_buffer &state) noexcept;
+        T (*dereference)(iterator_buffer const &state);
+        void (*increment)(iterator_buffer &state);
+        void (*decrement)(iterator_buffer &state);
+        void (*advance)(iterator_buffer &state, difference_type n);
+        bool (*at_end)(iterator_buffer const &state);
+        bool (*equal)(iterator_buffer const &lhs, iterator_buffer const &rhs);
+        difference_type (*distance)(iterator_buffer const &lhs, iterator_buffer const &rhs);
+        difference_type (*distance_to_end)(iterator_buffer const &state);
+    };
+
+    struct view_vtable {
+        void (*relocate)(view_buffer &to, view_buffer &from) noexcept;
+        void (*destroy)(view_buffer &view) noexcept;
+        iterator_vtable const *(*begin)(view_buffer &view, iterator_buffer &state);
+        void (*for_each)(view_buffer &view, void *fn, void (*call)(void *fn, T element));
+    };
+
+    /**
+     * The iterator and the sentinel of a view, which the iterator compares
+     * with on its own, so that the end is a sentinel of a single type.
+     */
+    template<typename V>
+    struct iterator_state {
+        std::ranges::iterator_t<V> it;
+        std::ranges::sentinel_t<V> end;
+    };
+
+    // the operations each category needs, all of them defined for V of the
+    // category of the view, whose constructor checks
+    template<typename V>
+    struct ops {
+        using state = iterator_state<V>;
+
+        static void copy(iterator_buffer &to, iterator_buffer const &from) {
+            if constexpr (std::copy_constructible<state>) {
+                to.template emplace<state>(*from.template get<state>());
+            }
+        }
+
+        static void relocate(iterator_buffer &to, iterator_buffer &from) noexcept {
+            to.template relocate_from<state>(from);
+        }
+
+        static void destroy(iterator_buffer &s) noexcept { s.template destroy<state>(); }
+
+        static T dereference(iterator_buffer const &s) { return *s.template get<state>()->it; }
+
+        static void increment(iterator_buffer &s) { ++s.template get<state>()->it; }
+
+        static void decrement(iterator_buffer &s) {
+            if constexpr (std::ranges::bidirectional_range<V>) {
+                --s.template get<state>()->it;
+            }
+        }
+
+        static void advance(iterator_buffer &s, difference_type const n) {
+            if constexpr (std::ranges::random_access_range<V>) {
+                s.template get<state>()->it += static_cast<std::ranges::range_difference_t<V>>(n);
+            }
+        }
+
+        static bool at_end(iterator_buffer const &s) {
+            auto const *const st = s.template get<state>();
+            return st->it == st->end;
+        }
+
+        static bool equal(iterator_buffer const &lhs, iterator_buffer const &rhs) {
+            if constexpr (std::equality_comparable<std::ranges::iterator_t<V>>) {
+                return lhs.template get<state>()->it == rhs.template get<state>()->it;
+            } else {
+                return false;
+            }
+        }
+
+        static difference_type distance(iterator_buffer const &lhs, iterator_buffer const &rhs) {
+            if constexpr (std::ranges::random_access_range<V>) {
+                return static_cast<difference_type>(lhs.template get<state>()->it - rhs.template get<state>()->it);
+            } else {
+                return 0;
+            }
+        }
+
+        static difference_type distance_to_end(iterator_buffer const &s) {
+            if constexpr (std::sized_sentinel_for<std::ranges::sentinel_t<V>, std::ranges::iterator_t<V>>) {
+                auto const *const st = s.template get<state>();
+                return static_cast<difference_type>(st->end - st->it);
+            } else {
+                return 0;
+            }
+        }
+
+        static void relocate_view(view_buffer &to, view_buffer &from) noexcept {
+            to.template relocate_from<V>(from);
+        }
+
+        static void destroy_view(view_buffer &view) noexcept { view.template destroy<V>(); }
+
+        static iterator_vtable const *begin(view_buffer &view, iterator_buffer &s) {
+            auto &v = *view.template get<V>();
+            s.template emplace<state>(std::ranges::begin(v), std::ranges::end(v));
+            return &iterator_vtable_for<V>;
+        }
+
+        static void for_each(view_buffer &view, void *const fn, void (*const call)(void *, T)) {
+            for (auto &&element: *view.template get<V>()) {
+                call(fn, static_cast<T>(std::forward<decltype(element)>(element)));
+            }
+        }
+    };
+
+    template<typename V>
+    static constexpr iterator_vtable iterator_vtable_for = {
+            &ops<V>::copy, &ops<V>::relocate, &ops<V>::destroy, &ops<V>::dereference, &ops<V>::increment,
+            &ops<V>::decrement, &ops<V>::advance, &ops<V>::at_end, &ops<V>::equal, &ops<V>::distance,
+            &ops<V>::distance_to_end,
+    };
+
+    template<typename V>
+    static constexpr view_vtable view_vtable_for = {
+            &ops<V>::relocate_view, &ops<V>::destroy_view, &ops<V>::begin, &ops<V>::for_each,
+    };
+
+    void reset() noexcept {
+        if (m_vtable != nullptr) {
+            std::exchange(m_vtable, nullptr)->destroy(m_view);
+        }
+    }
+
+    view_vtable const *m_vtable = nullptr;
+    view_buffer m_view;
+};
+
+template<typename T, typename Category>
+class any_view<T, Category>::iterator {
+public:
+    using iterator_concept = Category;
+    // the algorithms from before C++20 require a reference to the elements
+    using iterator_category = std::conditional_t<std::is_reference_v<T>, Category, std::input_iterator_tag>;
+    using value_type = std::remove_cvref_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = T;
+
+    iterator() = default;
+
+    iterator(iterator const &other) requires is_forward : m_vtable(other.m_vtable) {
+        if (m_vtable != nullptr) {
+            m_vtable->copy(m_state, other.m_state);
+        }
+    }
+
+    iterator(iterator &&other) noexcept : m_vtable(std::exchange(other.m_vtable, nullptr)) {
+        if (m_vtable != nullptr) {
+            m_vtable->relocate(m_state, other.m_state);
+        }
+    }
+
+    iterator &operator=(iterator const &other) requires is_forward {
+        if (this != &other) {
+            reset();
+            if (other.m_vtable != nullptr) {
+                other.m_vtable->copy(m_state, other.m_state);
+                m_vtable = other.m_vtable;
+            }
+        }
+        return *this;
+    }
+
+    iterator &operator=(iterator &&other) noexcept {
+        if (this != &other) {
+            reset();
+            if ((m_vtable = std::exchange(other.m_vtable, nullptr)) != nullptr) {
+                m_vtable->relocate(m_state, other.m_state);
+            }
+        }
+        return *this;
+    }
+
+    ~iterator() { reset(); }
+
+    T operator*() const { return m_vtable->dereference(m_state); }
+
+    iterator &operator++() {
+        m_vtable->increment(m_state);
+        return *this;
+    }
+
+    void operator++(int) requires (!is_forward) { ++*this; }
+
+    iterator operator++(int) requires is_forward {
+        auto old = *this;
+        ++*this;
+        return old;
+    }
+
+    iterator &operator--() requires is_bidirectional {
+        m_vtable->decrement(m_state);
+        return *this;
+    }
+
+    iterator operator--(int) requires is_bidirectional {
+        auto old = *this;
+        --*this;
+        return old;
+    }
+
+    iterator &operator+=(difference_type const n) requires is_random_access {
+        m_vtable->advance(m_state, n);
+        return *this;
+    }
+
+    iterator &operator-=(difference_type const n) requires is_random_access { return *this += -n; }
+
+    T operator[](difference_type const n) const requires is_random_access { return *(*this + n); }
+
+    friend iterator operator+(iterator it, difference_type const n) requires is_random_access { return it += n; }
+
+    friend iterator operator+(difference_type const n, iterator it) requires is_random_access { return it += n; }
+
+    friend iterator operator-(iterator it, difference_type const n) requires is_random_access { return it -= n; }
+
+    friend difference_type operator-(iterator const &lhs, iterator const &rhs) requires is_random_access {
+        return lhs.m_vtable->distance(lhs.m_state, rhs.m_state);
+    }
+
+    friend difference_type operator-(std::default_sentinel_t, iterator const &it) requires is_random_access {
+        return it.m_vtable->distance_to_end(it.m_state);
+    }
+
+    friend difference_type operator-(iterator const &it, std::default_sentinel_t) requires is_random_access {
+        return -it.m_vtable->distance_to_end(it.m_state);
+    }
+
+    friend bool operator==(iterator const &it, std::default_sentinel_t) { return it.m_vtable->at_end(it.m_state); }
+
+    friend bool operator==(iterator const &lhs, iterator const &rhs) requires is_forward {
+        if (lhs.m_vtable == nullptr || rhs.m_vtable == nullptr) {
+            return lhs.m_vtable == rhs.m_vtable;
+        }
+        return lhs.m_vtable->equal(lhs.m_state, rhs.m_state);
+    }
+
+    friend std::strong_ordering operator<=>(iterator const &lhs, iterator const &rhs) requires is_random_access {
+        return lhs - rhs <=> 0;
+    }
+
+    /**
+     * Whether the erased iterator is stored in place, rather than allocated.
+     */
+    [[nodiscard]] bool is_inline() const noexcept { return m_vtable == nullptr || m_state.is_inline(); }
+
+private:
+    friend class any_view;
+
+    void reset() noexcept {
+        if (m_vtable != nullptr) {
+            std::exchange(m_vtable, nullptr)->destroy(m_state);
+        }
+    }
+
+    iterator_vtable const *m_vtable = nullptr;
+    iterator_buffer m_state;
+};
+
+}
+
+#endif //CPP_XX_DOJO_ANY_VIEW_H
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flatten_view.h"
+#include "utils.h"
+
+/**
+ * A flatten view joins the inner ranges like views::join, but knows where
+ * every inner range starts, so it's sized and random-access, and can be split
+ * among threads.
+ */
+
+TEST(TestRangesFlatten, test_flatten) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const nested = std::vector<std::vector<int>>{{}, {0}, {1, 2, 3}, {}, {}, {4, 5}, {}};
+    auto const flat = nested | dojo::views::flatten;
+
+    print_range(flat);
+
+    // output: 0 1 2 3 4 5
+
+    static_assert(std::ranges::random_access_range<decltype(flat)>);
+    static_assert(std::ranges::sized_range<decltype(flat)>);
+    static_assert(std::ranges::view<std::remove_const_t<decltype(flat)>>);
+    ASSERT_EQ(6u, flat.size());
+    ASSERT_TRUE(std::ranges::equal(flat, nested | std::views::join));
+
+    // random access, by a binary search of the offsets
+    ASSERT_EQ(3, flat[3]);
+    ASSERT_EQ(5, *(flat.begin() + 5));
+    ASSERT_EQ(4, *(flat.end() - 2));
+    ASSERT_EQ(2u, (flat.begin() + 4).outer_index() - 3);
+    ASSERT_EQ(1u, (flat.begin() + 2).inner_index());
+    ASSERT_EQ(6, flat.end() - flat.begin());
+
+    // backwards, across the empty inner ranges
+    auto reversed = std::vector<int>();
+    std::ranges::copy(flat | std::views::reverse, std::back_inserter(reversed));
+    ASSERT_EQ((std::vector<int>{5, 4, 3, 2, 1, 0}), reversed);
+
+    // the algorithms which need random access
+    auto const found = std::ranges::lower_bound(flat, 4);
+    ASSERT_EQ(4, found - flat.begin());
+}
+
+TEST(TestRangesFlatten, test_edge_cases) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const none = std::vector<std::vector<int>>();
+    ASSERT_TRUE((none | dojo::views::flatten).empty());
+
+    auto const all_empty = std::vector<std::vector<int>>(5);
+    auto const flat = dojo::flatten_view(all_empty);
+    ASSERT_EQ(0u, flat.size());
+    ASSERT_TRUE(flat.begin() == flat.end());
+
+    // the elements can be written through the view, and the strings are the
+    // inner ranges of a temporary vector, which the view owns
+    auto words = std::vector<std::string>{"ab", "", "cde"};
+    auto letters = words | dojo::views::flatten;
+    std::ranges::transform(letters, letters.begin(), [](char const c) { return static_cast<char>(c - 'a' + 'A'); });
+    ASSERT_EQ("AB", words[0]);
+    ASSERT_EQ("CDE", words[2]);
+
+    auto owned = std::vector<std::vector<int>>{{1, 2}, {3}} | dojo::views::flatten;
+    ASSERT_EQ(6, std::accumulate(owned.begin(), owned.end(), 0));
+}
+
+TEST(TestRangesFlatten, test_parallel_compact) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // ragged enough to cross the shares of the threads in the middle of inner
+    // ranges, and large enough to use the threads at all
+    auto nested = std::vector<std::vector<int>>();
+    auto next = 0;
+    for (auto i = 0; i < 100'000; ++i) {
+        auto &inner = nested.emplace_back(static_cast<std::size_t>(i * 7 % 13));
+        std::iota(inner.begin(), inner.end(), next);
+        next += static_cast<int>(inner.size());
+    }
+    auto const flat = nested | dojo::views::flatten;
+
+    for (auto const threads: {1u, 2u, 3u, 8u}) {
+        auto const compact = dojo::parallel_compact(flat, threads);
+        ASSERT_EQ(flat.size(), compact.size());
+        for (auto i = std::size_t{0}; i < compact.size(); ++i) {
+            ASSERT_EQ(static_cast<int>(i), compact[i]);
+        }
+    }
+}
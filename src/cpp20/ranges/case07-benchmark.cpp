@@ -0,0 +1,266 @@
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "any_view.h"
+#include "flatten_view.h"
+#include "sized_common.h"
+#include "../../../utils.h"
+
+/**
+ * Walking, indexing and compacting ragged nested vectors, with millions of
+ * inner ranges of 0 to 8 elements: flatten_view against views::join and the
+ * hand-written nested loops.
+ *
+ * The threads only pay off with more cores than one, since walking and
+ * copying are bound by the memory bandwidth of a core otherwise.
+ */
+
+namespace {
+
+std::vector<std::vector<std::int64_t>> make_ragged(std::size_t const inner_count) {
+    auto rng = std::mt19937_64(1);  // NOLINT(cert-msc51-cpp)
+    auto size = std::uniform_int_distribution<std::size_t>(0, 8);
+    auto nested = std::vector<std::vector<std::int64_t>>(inner_count);
+    auto next = std::int64_t{0};
+    for (auto &inner: nested) {
+        inner.resize(size(rng));
+        for (auto &e: inner) {
+            e = next++;
+        }
+    }
+    return nested;
+}
+
+std::vector<unsigned> thread_counts() {
+    auto const hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    return hardware == 1 ? std::vector<unsigned>{1, 4} : std::vector<unsigned>{1, hardware};
+}
+
+}
+
+TEST(TestRangesBenchmark, test_flatten_ragged) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto inner_count = std::size_t{2'000'000};
+    auto const nested = make_ragged(inner_count);
+
+    benchmark("flatten_view construction, per inner range", inner_count, [&] {
+        do_not_optimize((nested | dojo::views::flatten).size());
+    });
+    auto const flat = nested | dojo::views::flatten;
+    auto const size = flat.size();
+    std::cout << "  " << inner_count << " inner ranges, " << size << " elements" << std::endl;
+
+    benchmark("nested loops sum", size, [&] {
+        auto sum = std::int64_t{0};
+        for (auto const &inner: nested) {
+            for (auto const e: inner) {
+                sum += e;
+            }
+        }
+        do_not_optimize(sum);
+    });
+    benchmark("views::join sum", size, [&] {
+        auto sum = std::int64_t{0};
+        for (auto const e: nested | std::views::join) {
+            sum += e;
+        }
+        do_not_optimize(sum);
+    });
+    benchmark("flatten_view sum", size, [&] {
+        auto sum = std::int64_t{0};
+        for (auto const e: flat) {
+            sum += e;
+        }
+        do_not_optimize(sum);
+    });
+
+    // views::join would walk there from the beginning every time
+    constexpr auto lookups = std::size_t{1'000'000};
+    auto rng = std::mt19937_64(2);  // NOLINT(cert-msc51-cpp)
+    auto indexes = std::vector<std::size_t>(lookups);
+    for (auto &i: indexes) {
+        i = std::uniform_int_distribution<std::size_t>(0, size - 1)(rng);
+    }
+    benchmark("flatten_view random access", lookups, [&] {
+        auto sum = std::int64_t{0};
+        auto const begin = flat.begin();
+        for (auto const i: indexes) {
+            sum += begin[static_cast<std::ptrdiff_t>(i)];
+        }
+        do_not_optimize(sum);
+    });
+
+    for (auto const threads: thread_counts()) {
+        auto const suffix = " x" + std::to_string(threads) + " threads";
+        benchmark(("flatten_view split sum" + suffix).c_str(), size, [&] {
+            auto sums = std::vector<cache_line_padded<std::int64_t>>(threads);
+            {
+                auto workers = std::vector<std::jthread>();
+                for (auto t = 0u; t < threads; ++t) {
+                    workers.emplace_back([&, t] {
+                        auto const first = flat.begin() + static_cast<std::ptrdiff_t>(size * t / threads);
+                        auto const last = flat.begin() + static_cast<std::ptrdiff_t>(size * (t + 1) / threads);
+                        auto sum = std::int64_t{0};
+                        for (auto it = first; it != last; ++it) {
+                            sum += *it;
+                        }
+                        sums[t].value = sum;
+                    });
+                }
+            }
+            auto sum = std::int64_t{0};
+            for (auto const &s: sums) {
+                sum += s.value;
+            }
+            do_not_optimize(sum);
+        });
+    }
+}
+
+TEST(TestRangesBenchmark, test_compact_ragged) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto inner_count = std::size_t{2'000'000};
+    auto const nested = make_ragged(inner_count);
+    auto const flat = nested | dojo::views::flatten;
+    auto const size = flat.size();
+
+    benchmark("views::join into a vector", size, [&] {
+        auto compact = std::vector<std::int64_t>();
+        for (auto const e: nested | std::views::join) {
+            compact.push_back(e);
+        }
+        do_not_optimize(compact.data());
+    });
+    benchmark("nested loops into a reserved vector", size, [&] {
+        auto compact = std::vector<std::int64_t>();
+        compact.reserve(size);
+        for (auto const &inner: nested) {
+            compact.insert(compact.end(), inner.begin(), inner.end());
+        }
+        do_not_optimize(compact.data());
+    });
+    for (auto const threads: thread_counts()) {
+        auto const name = "dojo::parallel_compact x" + std::to_string(threads) + " threads";
+        benchmark(name.c_str(), size, [&] {
+            auto const compact = dojo::parallel_compact(flat, threads);
+            do_not_optimize(compact.data());
+        });
+    }
+    // without zeroing the new vector first
+    auto buffer = std::vector<std::int64_t>(size);
+    for (auto const threads: thread_counts()) {
+        auto const name = "dojo::parallel_compact to a buffer x" + std::to_string(threads) + " threads";
+        benchmark(name.c_str(), size, [&] {
+            dojo::parallel_compact(flat, buffer.begin(), threads);
+            do_not_optimize(buffer.data());
+        });
+    }
+}
+
+/**
+ * Summing a counted range with the algorithms from before C++20, which need
+ * a common range: through std::ranges::common_view, whose iterators still
+ * count, against dojo::views::sized_common, which hands them plain pointers.
+ * The parallel policies run on the threads of TBB when it's linked.
+ */
+TEST(TestRangesBenchmark, test_parallel_reduce) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto size = std::size_t{1} << 24;
+    auto const values = std::vector<std::int64_t>(size, 3);
+    auto const counted = std::ranges::subrange{
+            std::counted_iterator{values.begin(), static_cast<std::ptrdiff_t>(size)}, std::default_sentinel};
+
+    auto const common = std::ranges::common_view{counted};
+    benchmark("std::accumulate, common_view", size, [&] {
+        do_not_optimize(std::accumulate(common.begin(), common.end(), std::int64_t{0}));
+    });
+    benchmark("std::reduce seq, common_view", size, [&] {
+        do_not_optimize(std::reduce(std::execution::seq, common.begin(), common.end(), std::int64_t{0}));
+    });
+    benchmark("std::reduce par, common_view", size, [&] {
+        do_not_optimize(std::reduce(std::execution::par, common.begin(), common.end(), std::int64_t{0}));
+    });
+    benchmark("std::reduce par_unseq, common_view", size, [&] {
+        do_not_optimize(std::reduce(std::execution::par_unseq, common.begin(), common.end(), std::int64_t{0}));
+    });
+
+    auto const plain = counted | dojo::views::sized_common;
+    benchmark("std::accumulate, sized_common", size, [&] {
+        do_not_optimize(std::accumulate(plain.begin(), plain.end(), std::int64_t{0}));
+    });
+    benchmark("std::reduce seq, sized_common", size, [&] {
+        do_not_optimize(std::reduce(std::execution::seq, plain.begin(), plain.end(), std::int64_t{0}));
+    });
+    benchmark("std::reduce par, sized_common", size, [&] {
+        do_not_optimize(std::reduce(std::execution::par, plain.begin(), plain.end(), std::int64_t{0}));
+    });
+    benchmark("std::reduce par_unseq, sized_common", size, [&] {
+        do_not_optimize(std::reduce(std::execution::par_unseq, plain.begin(), plain.end(), std::int64_t{0}));
+    });
+}
+
+/**
+ * The cost per element of walking a pipeline through dojo::any_view, against
+ * its concrete type, which the compiler inlines into the loop, and the cost
+ * of erasing a pipeline, in place or on the heap.
+ */
+TEST(TestRangesBenchmark, test_any_view_overhead) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto size = std::size_t{1} << 22;
+    auto values = std::vector<std::int64_t>(size);
+    std::iota(values.begin(), values.end(), 0);
+    auto const odd = [](std::int64_t const i) { return i % 2 != 0; };
+    auto const square = [](std::int64_t const i) { return i * i; };
+    auto const pipeline = [&] { return values | std::views::filter(odd) | std::views::transform(square); };
+
+    benchmark("concrete pipeline, per element", size, [&] {
+        auto sum = std::int64_t{0};
+        for (auto const e: pipeline()) {
+            sum += e;
+        }
+        do_not_optimize(sum);
+    });
+    auto erased = dojo::any_view<std::int64_t, std::forward_iterator_tag>(pipeline());
+    benchmark("dojo::any_view iterators, per element", size, [&] {
+        auto sum = std::int64_t{0};
+        for (auto const e: erased) {
+            sum += e;
+        }
+        do_not_optimize(sum);
+    });
+    benchmark("dojo::any_view::for_each, per element", size, [&] {
+        auto sum = std::int64_t{0};
+        erased.for_each([&](std::int64_t const e) { sum += e; });
+        do_not_optimize(sum);
+    });
+
+    constexpr auto erasures = std::size_t{1'000'000};
+    benchmark("dojo::any_view erasure, in place", erasures, [&] {
+        for (auto i = std::size_t{0}; i < erasures; ++i) {
+            auto view = dojo::any_view<std::int64_t>(pipeline());
+            do_not_optimize(view.is_inline());
+        }
+    });
+    auto const padded = [padding = std::array<char, 128>()](std::int64_t const i) { return i + padding[0]; };
+    benchmark("dojo::any_view erasure, on the heap", erasures, [&] {
+        for (auto i = std::size_t{0}; i < erasures; ++i) {
+            auto view = dojo::any_view<std::int64_t>(values | std::views::transform(padded));
+            do_not_optimize(view.is_inline());
+        }
+    });
+}
@@ -0,0 +1,63 @@
+#include <deque>
+#include <execution>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sized_common.h"
+
+/**
+ * The algorithms from before C++20 need a common range, whose end is an
+ * iterator as well. sized_common makes one out of a counted range without
+ * wrapping the iterators, so the algorithms take their fast paths.
+ */
+
+TEST(TestRangesSizedCommon, test_counted) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto nums = {0, 1, 2, 3, 4, 5};
+    auto const range = std::ranges::subrange{std::counted_iterator{nums.begin(), std::ssize(nums)},
+                                             std::default_sentinel};
+
+    // a range of counted_iterator, whatever the view
+    auto common_range = std::ranges::common_view{range};
+    static_assert(std::is_same_v<std::counted_iterator<int const *>, decltype(common_range.begin())>);
+
+    // a pair of pointers, as contiguous, sized and common as it gets
+    auto const plain = range | dojo::views::sized_common;
+    static_assert(std::is_same_v<std::span<int const>, std::remove_const_t<decltype(plain)>>);
+    ASSERT_EQ(6u, plain.size());
+    ASSERT_EQ(15, std::accumulate(plain.begin(), plain.end(), 0));
+    ASSERT_EQ(15, std::reduce(std::execution::par, plain.begin(), plain.end(), 0));
+
+    // a part of a deque is random-access but not contiguous, so it becomes a
+    // subrange of the iterators of the deque, which don't count anymore
+    auto const numbers = std::deque<int>{1, 2, 3, 4};
+    auto const head = std::ranges::subrange{std::counted_iterator{numbers.begin(), 3}, std::default_sentinel}
+                      | dojo::views::sized_common;
+    static_assert(std::is_same_v<std::deque<int>::const_iterator, decltype(head.begin())>);
+    static_assert(std::ranges::sized_range<decltype(head)>);
+    ASSERT_EQ(6, std::reduce(std::execution::par_unseq, head.begin(), head.end()));
+}
+
+TEST(TestRangesSizedCommon, test_fallbacks) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // not random-access: the iterators have to count
+    auto const list = std::list<int>{1, 2, 3, 4};
+    auto const counted = std::ranges::subrange{std::counted_iterator{list.begin(), 3}, std::default_sentinel};
+    auto const common = counted | dojo::views::sized_common;
+    static_assert(std::ranges::common_range<decltype(common)>);
+    ASSERT_EQ(6, std::accumulate(common.begin(), common.end(), 0));
+
+    // not borrowed: the elements are owned by the view
+    auto owned = std::vector<int>{1, 2, 3} | dojo::views::sized_common;
+    static_assert(std::ranges::sized_range<decltype(owned)>);
+    ASSERT_EQ(6, std::accumulate(owned.begin(), owned.end(), 0));
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "any_view.h"
+#include "utils.h"
+
+/**
+ * An any_view owns a pipeline of views of any type, so that pipelines of
+ * different types can be stored together, e.g. in the descriptors of jobs to
+ * run later.
+ */
+
+namespace {
+
+struct job {
+    std::string name;
+    dojo::any_view<int> pipeline;
+};
+
+}
+
+TEST(TestRangesAnyView, test_store_pipelines) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const nums = std::vector<int>{0, 1, 2, 3, 4, 5};
+    auto even = [](int i) { return 0 == i % 2; };
+    auto square = [](int i) { return i * i; };
+
+    auto jobs = std::vector<job>();
+    jobs.push_back({"squares of evens", nums | std::views::filter(even) | std::views::transform(square)});
+    jobs.push_back({"countdown", std::views::iota(0, 4) | std::views::reverse});
+    jobs.push_back({"owned", std::vector<int>{7, 8}});
+
+    for (auto &j: jobs) {
+        std::cout << j.name << ": ";
+        print_range(j.pipeline);
+        ASSERT_TRUE(j.pipeline.is_inline());
+        ASSERT_TRUE(j.pipeline.begin().is_inline());
+    }
+
+    // output: squares of evens: 0 4 16
+    //         countdown: 3 2 1 0
+    //         owned: 7 8
+
+    auto sum = 0;
+    jobs[0].pipeline.for_each([&](int const i) { sum += i; });
+    ASSERT_EQ(20, sum);
+}
+
+TEST(TestRangesAnyView, test_categories) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    static_assert(std::ranges::input_range<dojo::any_view<int>>);
+    static_assert(!std::ranges::forward_range<dojo::any_view<int>>);
+    static_assert(std::ranges::view<dojo::any_view<int>>);
+
+    using random_access = dojo::any_view<int &, std::random_access_iterator_tag>;
+    static_assert(std::ranges::random_access_range<random_access>);
+    static_assert(std::ranges::sized_range<random_access>);
+
+    auto nums = std::vector<int>{5, 3, 4, 1, 2};
+    auto view = random_access(nums | std::views::take(4));
+    ASSERT_EQ(4u, view.size());
+    ASSERT_EQ(4, view.begin()[2]);
+    std::ranges::sort(view.begin(), view.begin() + 4);
+    ASSERT_EQ((std::vector<int>{1, 3, 4, 5, 2}), nums);
+
+    auto bidirectional = dojo::any_view<int, std::bidirectional_iterator_tag>(
+            nums | std::views::transform(std::negate<>()));
+    auto last = bidirectional.begin();
+    std::ranges::advance(last, 4);
+    ASSERT_EQ(-2, *last);
+    ASSERT_EQ(-5, *--last);
+
+    // a pipeline too large for the buffer still works, from the heap
+    auto const big = std::vector<int>(1, 1);
+    auto padded = [padding = std::array<char, 128>()](int i) { return i + padding[0]; };
+    auto allocated = dojo::any_view<int>(big | std::views::transform(padded));
+    ASSERT_FALSE(allocated.is_inline());
+    ASSERT_EQ(1, *allocated.begin());
+
+    // moved around with the jobs
+    auto moved = std::move(allocated);
+    ASSERT_EQ(1, *moved.begin());
+}
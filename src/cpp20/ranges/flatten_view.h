@@ -0,0 +1,328 @@
+#ifndef CPP_XX_DOJO_FLATTEN_VIEW_H
+#define CPP_XX_DOJO_FLATTEN_VIEW_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dojo {
+
+namespace detail {
+
+template<typename R>
+concept flattenable_range =
+        std::ranges::random_access_range<R> && std::ranges::sized_range<R> &&
+        // indexed in place, hence not a temporary
+        std::is_reference_v<std::ranges::range_reference_t<R>> &&
+        std::ranges::random_access_range<std::ranges::range_reference_t<R>> &&
+        std::ranges::sized_range<std::ranges::range_reference_t<R>>;
+
+}
+
+/**
+ * @brief A random-access and sized view of the elements of the inner ranges,
+ * one after another
+ *
+ * std::views::join is only bidirectional at best, and unsized, since the
+ * position of an element is only known by walking there: it can't be split
+ * among threads, nor handed to the algorithms which need the distance. Here
+ * the offset of every inner range is computed once, as the prefix sum of
+ * their sizes, so that:
+ *   - the size of the view is the last offset;
+ *   - the element at a flat index is in the inner range found by a binary
+ *     search of the offsets;
+ *   - incrementing only compares with the offset of the next inner range.
+ *
+ * The offsets are shared by the copies of the view, so it's still cheap to
+ * copy, but they're computed on construction, which walks the outer range
+ * once. Like the views of the standard library, it must not outlive the
+ * range it views, whose sizes must not change meanwhile.
+ *
+ * reference from https://en.cppreference.com/w/cpp/ranges/join_view
+ */
+template<std::ranges::view V>
+requires detail::flattenable_range<V>
+class flatten_view : public std::ranges::view_interface<flatten_view<V>> {
+    template<bool Const>
+    class iterator;
+
+public:
+    flatten_view() requires std::default_initializable<V> = default;
+
+    explicit flatten_view(V base) :
+            m_base(std::move(base)), m_offsets(std::make_shared<std::vector<std::size_t>>()) {
+        auto &offsets = *m_offsets;
+        offsets.reserve(std::ranges::size(m_base) + 1);
+        offsets.push_back(0);
+        for (auto const &inner: m_base) {
+            offsets.push_back(offsets.back() + static_cast<std::size_t>(std::ranges::size(inner)));
+        }
+    }
+
+    [[nodiscard]] V base() const & requires std::copy_constructible<V> { return m_base; }
+
+    [[nodiscard]] V base() && { return std::move(m_base); }
+
+    [[nodiscard]] auto begin() { return iterator<false>(this, 0); }
+
+    [[nodiscard]] auto begin() const requires detail::flattenable_range<V const> { return iterator<true>(this, 0); }
+
+    [[nodiscard]] auto end() { return iterator<false>(this, size()); }
+
+    [[nodiscard]] auto end() const requires detail::flattenable_range<V const> { return iterator<true>(this, size()); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_offsets->back(); }
+
+    /**
+     * The prefix sum of the sizes of the inner ranges, starting with 0, and
+     * ending with the size of the view.
+     */
+    [[nodiscard]] std::vector<std::size_t> const &offsets() const noexcept { return *m_offsets; }
+
+    /**
+     * The inner range at an index of the outer range.
+     */
+    [[nodiscard]] decltype(auto) inner(std::size_t const outer_index) const
+    requires detail::flattenable_range<V const> {
+        return std::ranges::begin(m_base)[static_cast<std::ptrdiff_t>(outer_index)];
+    }
+
+    /**
+     * The inner range of the element at a flat index, or the count of the
+     * inner ranges for the size of the view.
+     */
+    [[nodiscard]] std::size_t outer_index(std::size_t const index) const noexcept {
+        auto const &offsets = *m_offsets;
+        // the last inner range starting at or before the index, i.e. skipping
+        // the empty ones
+        return static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin()) - 1;
+    }
+
+private:
+    V m_base = V();
+    std::shared_ptr<std::vector<std::size_t>> m_offsets = std::make_shared<std::vector<std::size_t>>(1, 0);
+};
+
+template<typename R>
+flatten_view(R &&) -> flatten_view<std::views::all_t<R>>;
+
+template<std::ranges::view V>
+requires detail::flattenable_range<V>
+template<bool Const>
+class flatten_view<V>::iterator {
+    using parent_t = std::conditional_t<Const, flatten_view const, flatten_view>;
+    using base_t = std::conditional_t<Const, V const, V>;
+    using inner_t = std::ranges::range_reference_t<base_t>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::ranges::range_value_t<inner_t>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::ranges::range_reference_t<inner_t>;
+
+    iterator() = default;
+
+    iterator(parent_t *const parent, std::size_t const index) :
+            m_outer(std::ranges::begin(parent->m_base)),
+            m_offsets(parent->m_offsets->data()),
+            m_outer_count(parent->m_offsets->size() - 1),
+            m_index(index) {
+        locate(parent->outer_index(index));
+    }
+
+    // from the mutable iterator to the const one
+    explicit(false) iterator(iterator<!Const> const &other) requires Const && std::convertible_to<
+            std::ranges::iterator_t<V>, std::ranges::iterator_t<V const>> :
+            m_outer(other.m_outer), m_inner(other.m_inner), m_offsets(other.m_offsets),
+            m_outer_count(other.m_outer_count), m_outer_index(other.m_outer_index),
+            m_index(other.m_index), m_next_offset(other.m_next_offset) {}
+
+    reference operator*() const {
+        return m_inner[static_cast<difference_type>(m_index - m_offsets[m_outer_index])];
+    }
+
+    reference operator[](difference_type const n) const { return *(*this + n); }
+
+    iterator &operator++() {
+        // the only branch per element in the common case
+        if (++m_index == m_next_offset) {
+            auto outer_index = m_outer_index + 1;
+            // skip the empty inner ranges
+            while (outer_index < m_outer_count && m_offsets[outer_index + 1] == m_index) {
+                ++outer_index;
+            }
+            locate(outer_index);
+        }
+        return *this;
+    }
+
+    iterator operator++(int) {
+        auto const old = *this;
+        ++*this;
+        return old;
+    }
+
+    iterator &operator--() {
+        if (m_index-- == m_offsets[m_outer_index]) {
+            auto outer_index = m_outer_index - 1;
+            while (m_offsets[outer_index] > m_index) {
+                --outer_index;
+            }
+            locate(outer_index);
+        }
+        return *this;
+    }
+
+    iterator operator--(int) {
+        auto const old = *this;
+        --*this;
+        return old;
+    }
+
+    iterator &operator+=(difference_type const n) {
+        m_index = static_cast<std::size_t>(static_cast<difference_type>(m_index) + n);
+        if (m_index < m_offsets[m_outer_index] || m_index >= m_next_offset) {
+            // where the outer_index of the view would land
+            auto const *const found = std::upper_bound(m_offsets, m_offsets + m_outer_count + 1, m_index);
+            locate(static_cast<std::size_t>(found - m_offsets) - 1);
+        }
+        return *this;
+    }
+
+    iterator &operator-=(difference_type const n) { return *this += -n; }
+
+    friend iterator operator+(iterator it, difference_type const n) { return it += n; }
+
+    friend iterator operator+(difference_type const n, iterator it) { return it += n; }
+
+    friend iterator operator-(iterator it, difference_type const n) { return it -= n; }
+
+    friend difference_type operator-(iterator const &lhs, iterator const &rhs) {
+        return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(iterator const &lhs, iterator const &rhs) { return lhs.m_index == rhs.m_index; }
+
+    friend auto operator<=>(iterator const &lhs, iterator const &rhs) { return lhs.m_index <=> rhs.m_index; }
+
+    /**
+     * The inner range it's in, and its index there.
+     */
+    [[nodiscard]] std::size_t outer_index() const noexcept { return m_outer_index; }
+
+    [[nodiscard]] std::size_t inner_index() const noexcept { return m_index - m_offsets[m_outer_index]; }
+
+private:
+    friend class iterator<!Const>;
+
+    void locate(std::size_t const outer_index) {
+        m_outer_index = outer_index;
+        if (outer_index < m_outer_count) {
+            m_inner = std::ranges::begin(m_outer[static_cast<difference_type>(outer_index)]);
+            m_next_offset = m_offsets[outer_index + 1];
+        } else {
+            // the end, which is never incremented
+            m_inner = {};
+            m_next_offset = static_cast<std::size_t>(-1);
+        }
+    }
+
+    std::ranges::iterator_t<base_t> m_outer{};
+    // the begin of the current inner range
+    std::ranges::iterator_t<inner_t> m_inner{};
+    std::size_t const *m_offsets = nullptr;
+    std::size_t m_outer_count = 0;
+    std::size_t m_outer_index = 0;
+    std::size_t m_index = 0;
+    // the end of the current inner range, as a flat index
+    std::size_t m_next_offset = 0;
+};
+
+namespace views {
+
+/**
+ * The adaptor of flatten_view, which takes the pipe syntax of the views of
+ * the standard library, e.g. `nested | dojo::views::flatten`.
+ */
+struct flatten_fn {
+    template<std::ranges::viewable_range R>
+    requires detail::flattenable_range<std::views::all_t<R>>
+    auto operator()(R &&r) const {
+        return flatten_view<std::views::all_t<R>>(std::views::all(std::forward<R>(r)));
+    }
+
+    template<std::ranges::viewable_range R>
+    requires detail::flattenable_range<std::views::all_t<R>>
+    friend auto operator|(R &&r, flatten_fn const &self) { return self(std::forward<R>(r)); }
+};
+
+inline constexpr auto flatten = flatten_fn();
+
+}
+
+/**
+ * Copy the elements of a flatten_view into a contiguous buffer of the same
+ * size, split evenly among the threads by the flat index, however ragged the
+ * inner ranges are. Every thread copies the inner ranges, or the parts of
+ * them, which fall into its share, with a std::copy each, which is a memmove
+ * for the contiguous ranges of trivially copyable elements.
+ *
+ * Small inputs are copied by the calling thread alone, since starting the
+ * threads costs more than copying them.
+ */
+template<std::ranges::view V, std::random_access_iterator O>
+requires detail::flattenable_range<V const> && std::indirectly_copyable<
+        std::ranges::iterator_t<std::ranges::range_reference_t<V const>>, O>
+void parallel_compact(flatten_view<V> const &flat, O const out,
+                      std::size_t thread_count = std::thread::hardware_concurrency()) {
+    constexpr auto min_share = std::size_t{1} << 16;
+    auto const size = flat.size();
+    thread_count = std::clamp(size / min_share, std::size_t{1}, std::max(thread_count, std::size_t{1}));
+
+    auto const copy_share = [&](std::size_t const first, std::size_t const last) {
+        auto const &offsets = flat.offsets();
+        for (auto i = flat.outer_index(first); i < offsets.size() - 1 && offsets[i] < last; ++i) {
+            auto const from = std::max(first, offsets[i]);
+            auto const to = std::min(last, offsets[i + 1]);
+            auto const inner = std::ranges::begin(flat.inner(i));
+            std::copy(inner + static_cast<std::ptrdiff_t>(from - offsets[i]),
+                      inner + static_cast<std::ptrdiff_t>(to - offsets[i]),
+                      out + static_cast<std::ptrdiff_t>(from));
+        }
+    };
+    if (thread_count == 1) {
+        copy_share(0, size);
+        return;
+    }
+
+    auto threads = std::vector<std::jthread>();
+    threads.reserve(thread_count - 1);
+    for (auto t = std::size_t{1}; t < thread_count; ++t) {
+        threads.emplace_back(copy_share, size * t / thread_count, size * (t + 1) / thread_count);
+    }
+    copy_share(0, size / thread_count);
+}
+
+/**
+ * The elements of a flatten_view in a new vector, by parallel_compact.
+ */
+template<std::ranges::view V>
+requires detail::flattenable_range<V const>
+auto parallel_compact(flatten_view<V> const &flat, std::size_t const thread_count = std::thread::hardware_concurrency()) {
+    using value_t = std::ranges::range_value_t<std::ranges::range_reference_t<V const>>;
+    auto result = std::vector<value_t>(flat.size());
+    parallel_compact(flat, result.begin(), thread_count);
+    return result;
+}
+
+}
+
+#endif //CPP_XX_DOJO_FLATTEN_VIEW_H
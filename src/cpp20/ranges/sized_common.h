@@ -0,0 +1,70 @@
+#ifndef CPP_XX_DOJO_SIZED_COMMON_H
+#define CPP_XX_DOJO_SIZED_COMMON_H
+
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace dojo::views {
+
+namespace detail {
+
+template<typename I>
+struct is_counted_iterator : std::false_type {};
+
+template<typename I>
+struct is_counted_iterator<std::counted_iterator<I>> : std::true_type {};
+
+}
+
+/**
+ * @brief Make a range common, i.e. whose end is an iterator as well, for the
+ * algorithms from before C++20, while keeping it sized and random-access,
+ * and with the plainest iterators possible
+ *
+ * std::views::common wraps the iterators into common_iterator, or, for a
+ * sized and random-access range, keeps the iterators as they are. Either way,
+ * a range of counted_iterator stays a range of counted_iterator, which
+ * decrements its count along with every increment, and which none of the
+ * fast paths of the standard library recognizes, e.g. the memmove of
+ * std::copy, or the vectorized loops of the parallel algorithms. Here:
+ *   - a sized contiguous range becomes a std::span, i.e. a pair of pointers;
+ *   - a sized random-access range becomes a subrange of its iterators, where
+ *     a counted_iterator is replaced by the iterator it counts;
+ *   - any other range goes to std::views::common.
+ *
+ * Only a borrowed range is unwrapped, since the result refers to its
+ * elements, which an owning view would otherwise take away.
+ */
+struct sized_common_fn {
+    template<std::ranges::viewable_range R>
+    auto operator()(R &&r) const {
+        if constexpr (!std::ranges::borrowed_range<R> || !std::ranges::sized_range<R>) {
+            return std::views::common(std::forward<R>(r));
+        } else if constexpr (std::ranges::contiguous_range<R>) {
+            return std::span(std::to_address(std::ranges::begin(r)), std::ranges::size(r));
+        } else if constexpr (std::ranges::random_access_range<R>) {
+            auto const size = static_cast<std::ranges::range_difference_t<R>>(std::ranges::size(r));
+            auto first = std::ranges::begin(r);
+            if constexpr (detail::is_counted_iterator<decltype(first)>::value) {
+                return std::ranges::subrange(first.base(), first.base() + size);
+            } else {
+                return std::ranges::subrange(first, first + size);
+            }
+        } else {
+            return std::views::common(std::forward<R>(r));
+        }
+    }
+
+    template<std::ranges::viewable_range R>
+    friend auto operator|(R &&r, sized_common_fn const &self) { return self(std::forward<R>(r)); }
+};
+
+inline constexpr auto sized_common = sized_common_fn();
+
+}
+
+#endif //CPP_XX_DOJO_SIZED_COMMON_H
@@ -0,0 +1,102 @@
+#ifndef CPP_XX_DOJO_BARRIER_H
+#define CPP_XX_DOJO_BARRIER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "spin_wait.h"
+
+namespace dojo {
+
+namespace detail {
+
+struct noop_completion {
+    void operator()() const noexcept {}
+};
+
+}
+
+/**
+ * @brief A reusable thread barrier, the same as std::barrier, whose waiters
+ * spin for a while before parking
+ *
+ * The threads arrive by counting down the arrivals still expected in the
+ * phase. The one which counts down to 0 is the last, and it alone runs the
+ * completion, takes off the threads which have dropped, resets the count,
+ * and flips the phase, which is the 32-bit word all the waiters park on. A
+ * waiter holds the phase it arrived in as its arrival token, and waits until
+ * the phase is no longer that.
+ *
+ * It's a central counter, so every arrival bounces the same cache line.
+ * Which is cheap enough for a few dozens of threads, beyond that a
+ * tree barrier scales better.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/barrier
+ *
+ * @tparam CompletionFn invoked once per phase by the last arriving thread
+ */
+template<typename CompletionFn = detail::noop_completion>
+class barrier {
+public:
+    using arrival_token = std::uint32_t;
+
+    explicit barrier(std::ptrdiff_t const expected, CompletionFn completion = CompletionFn()) :
+            m_expected(static_cast<std::uint32_t>(expected)), m_completion(std::move(completion)),
+            m_remaining(static_cast<std::uint32_t>(expected)) {}
+
+    barrier(barrier const &) = delete;
+
+    barrier &operator=(barrier const &) = delete;
+
+    [[nodiscard]] arrival_token arrive(std::ptrdiff_t const n = 1) {
+        auto const n32 = static_cast<std::uint32_t>(n);
+        auto const phase = m_phase.load(std::memory_order_relaxed);
+        if (m_remaining.fetch_sub(n32, std::memory_order_acq_rel) == n32) {
+            complete_phase();
+        }
+        return phase;
+    }
+
+    void wait(arrival_token const token) const {
+        while (m_phase.load(std::memory_order_acquire) == token) {
+            detail::spin_then_wait(m_phase, token);
+        }
+    }
+
+    void arrive_and_wait() {
+        wait(arrive());
+    }
+
+    /**
+     * Arrive in the current phase, and leave the barrier for the later ones,
+     * which expect one thread less from the next phase on.
+     */
+    void arrive_and_drop() {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        static_cast<void>(arrive());
+    }
+
+private:
+    void complete_phase() {
+        m_completion();
+        // every other thread of the phase has arrived, and none of the next
+        // can before the phase flips, so the count is this thread's alone
+        m_expected -= m_dropped.exchange(0, std::memory_order_relaxed);
+        m_remaining.store(m_expected, std::memory_order_release);
+        m_phase.fetch_add(1, std::memory_order_release);
+        m_phase.notify_all();
+    }
+
+    // only read and written by the last thread to arrive in each phase
+    std::uint32_t m_expected;
+    [[no_unique_address]] CompletionFn m_completion;
+    std::atomic<std::uint32_t> m_remaining;
+    std::atomic<std::uint32_t> m_dropped{0};
+    std::atomic<std::uint32_t> m_phase{0};
+};
+
+}
+
+#endif //CPP_XX_DOJO_BARRIER_H
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "barrier.h"
+#include "latch.h"
+
+/**
+ * Phase synchronization without a mutex: a latch is a one-shot rendezvous,
+ * and a barrier a reusable one, with a completion step between the phases.
+ */
+
+TEST(TestLatch, test_latch) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto thread_count = 8;
+    auto ready = dojo::latch(thread_count);
+    auto done = dojo::latch(thread_count);
+    auto results = std::vector<int>(thread_count);
+
+    auto threads = std::vector<std::jthread>();
+    for (auto i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+            // all the threads start working together
+            ready.arrive_and_wait();
+            results[i] = i * i;
+            done.count_down();
+        });
+    }
+
+    done.wait();
+    ASSERT_TRUE(done.try_wait());
+    for (auto i = 0; i < thread_count; ++i) {
+        ASSERT_EQ(results[i], i * i);
+    }
+}
+
+/**
+ * Every phase sees all the writes of the previous phase, and the completion
+ * runs exactly once per phase, before any thread moves on.
+ */
+TEST(TestBarrier, test_phases) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto thread_count = 4;
+    constexpr auto phase_count = 1000;
+
+    auto slots = std::vector<int>(thread_count);
+    auto completions = 0;
+    auto sync = dojo::barrier(thread_count, [&]() noexcept { ++completions; });
+
+    auto threads = std::vector<std::jthread>();
+    for (auto i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+            for (auto phase = 0; phase < phase_count; ++phase) {
+                slots[i] = phase;
+                sync.arrive_and_wait();
+                for (auto const slot: slots) {
+                    ASSERT_EQ(slot, phase);
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    threads.clear();
+    ASSERT_EQ(completions, phase_count * 2);
+}
+
+TEST(TestBarrier, test_arrive_and_drop) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto phases = 0;
+    auto sync = dojo::barrier(3, [&]() noexcept { ++phases; });
+    {
+        auto quitter = std::jthread([&] { sync.arrive_and_drop(); });
+        auto stayer = std::jthread([&] {
+            sync.arrive_and_wait();
+            sync.arrive_and_wait();
+        });
+        sync.arrive_and_wait();
+        // only 2 threads are expected from now on
+        sync.arrive_and_wait();
+    }
+    ASSERT_EQ(phases, 2);
+}
+
+/**
+ * The threads drop out one by one at different phases, while the others keep
+ * arriving in the same phases, and each phase completes once, when all the
+ * threads still in it have arrived, no sooner and no later.
+ */
+TEST(TestBarrier, test_drop_while_arriving) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto thread_count = 8;
+    constexpr auto round_count = 1000;
+
+    for (auto round = 0; round < round_count; ++round) {
+        // the phase in which each thread drops, after waiting in all before
+        auto drop_phases = std::vector<int>(thread_count);
+        for (auto i = 0; i < thread_count; ++i) {
+            drop_phases[i] = (i * 7 + round) % 5;
+        }
+
+        auto arrived = std::atomic<int>(0);
+        auto phase = 0;
+        auto mismatches = 0;
+        auto sync = dojo::barrier(thread_count, [&]() noexcept {
+            auto const expected = std::count_if(drop_phases.begin(), drop_phases.end(),
+                                                [&](int const drop) { return drop >= phase; });
+            mismatches += arrived.exchange(0) != expected;
+            ++phase;
+        });
+
+        {
+            auto threads = std::vector<std::jthread>();
+            for (auto i = 0; i < thread_count; ++i) {
+                threads.emplace_back([&, i] {
+                    for (auto p = 0; p < drop_phases[i]; ++p) {
+                        ++arrived;
+                        sync.arrive_and_wait();
+                    }
+                    ++arrived;
+                    sync.arrive_and_drop();
+                });
+            }
+        }
+        ASSERT_EQ(mismatches, 0);
+        ASSERT_EQ(phase, *std::max_element(drop_phases.begin(), drop_phases.end()) + 1);
+    }
+}
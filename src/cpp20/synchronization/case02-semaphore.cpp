@@ -0,0 +1,87 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "counting_semaphore.h"
+
+/**
+ * A counting semaphore limits the count of threads in a section, or hands
+ * over tokens from producers to consumers.
+ */
+
+TEST(TestCountingSemaphore, test_limit_concurrency) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto limit = 3;
+    auto slots = dojo::counting_semaphore<limit>(limit);
+    auto inside = std::atomic<int>(0);
+    auto max_inside = std::atomic<int>(0);
+
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < 16; ++i) {
+            threads.emplace_back([&] {
+                for (auto round = 0; round < 100; ++round) {
+                    slots.acquire();
+                    auto const now = inside.fetch_add(1) + 1;
+                    auto max = max_inside.load();
+                    while (now > max && !max_inside.compare_exchange_weak(max, now)) {
+                    }
+                    std::this_thread::yield();
+                    inside.fetch_sub(1);
+                    slots.release();
+                }
+            });
+        }
+    }
+    ASSERT_LE(max_inside.load(), limit);
+    ASSERT_EQ(inside.load(), 0);
+}
+
+TEST(TestCountingSemaphore, test_try_acquire) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto signal = dojo::binary_semaphore(0);
+    ASSERT_FALSE(signal.try_acquire());
+    ASSERT_FALSE(signal.try_acquire_for(std::chrono::milliseconds(10)));
+
+    signal.release();
+    ASSERT_TRUE(signal.try_acquire());
+    ASSERT_FALSE(signal.try_acquire());
+
+    auto releaser = std::jthread([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        signal.release();
+    });
+    signal.acquire();
+}
+
+/**
+ * Producers release as many tokens as the consumers acquire, all of which
+ * must get through without any lost wake-up.
+ */
+TEST(TestCountingSemaphore, test_producers_consumers) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto count_per_thread = 50'000;
+    auto tokens = dojo::counting_semaphore<>(0);
+    auto threads = std::vector<std::jthread>();
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (auto n = 0; n < count_per_thread; ++n) {
+                tokens.acquire();
+            }
+        });
+        threads.emplace_back([&] {
+            for (auto n = 0; n < count_per_thread; ++n) {
+                tokens.release();
+            }
+        });
+    }
+    threads.clear();
+    ASSERT_FALSE(tokens.try_acquire());
+}
@@ -0,0 +1,57 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "event_count.h"
+#include "../lock-free-queue/mpmc_queue.h"
+
+/**
+ * An event count makes the consumers of a non-blocking queue park while it's
+ * empty, without putting a mutex on the hot path of the producers.
+ */
+TEST(TestEventCount, test_blocking_pop_on_lock_free_queue) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto count = std::uint32_t{100'000};
+    auto queue = dojo::mpmc_queue<std::uint32_t>(1 << 17);
+    auto events = dojo::event_count();
+    auto sum = std::atomic<std::uint64_t>(0);
+
+    {
+        auto consumers = std::vector<std::jthread>();
+        for (auto c = 0; c < 2; ++c) {
+            consumers.emplace_back([&] {
+                for (auto i = std::uint32_t{0}; i < count / 2; ++i) {
+                    auto item = std::optional<std::uint32_t>();
+                    events.await([&] { return (item = queue.try_pop()).has_value(); });
+                    sum.fetch_add(*item, std::memory_order_relaxed);
+                }
+            });
+        }
+        auto producer = std::jthread([&] {
+            for (auto i = std::uint32_t{0}; i < count; ++i) {
+                ASSERT_TRUE(queue.try_push(i));
+                events.notify_one();
+            }
+        });
+    }
+    ASSERT_EQ(sum.load(), std::uint64_t{count} * (count - 1) / 2);
+}
+
+/**
+ * A notification between prepare_wait and wait is not lost: the wait returns
+ * at once.
+ */
+TEST(TestEventCount, test_notify_before_wait) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto events = dojo::event_count();
+    auto const key = events.prepare_wait();
+    events.notify_all();
+    events.wait(key);
+}
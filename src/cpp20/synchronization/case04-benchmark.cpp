@@ -0,0 +1,167 @@
+#include <barrier>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "barrier.h"
+#include "counting_semaphore.h"
+#include "spin_wait.h"
+#include "../../../utils.h"
+
+/**
+ * The futex-based primitives against the textbook ones made of std::mutex
+ * and std::condition_variable, and against those of the standard library.
+ *
+ * With a single core, nothing spins, and every wake-up is a context switch
+ * whatever the primitive, so the differences mostly show on multi-core
+ * machines.
+ */
+
+class locked_semaphore {
+public:
+    explicit locked_semaphore(std::ptrdiff_t const desired) : m_count(desired) {}
+
+    void release() {
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            ++m_count;
+        }
+        m_cv.notify_one();
+    }
+
+    void acquire() {
+        auto lock = std::unique_lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_count > 0; });
+        --m_count;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::ptrdiff_t m_count;
+};
+
+class locked_barrier {
+public:
+    explicit locked_barrier(std::ptrdiff_t const expected) : m_expected(expected) {}
+
+    void arrive_and_wait() {
+        auto lock = std::unique_lock(m_mutex);
+        auto const generation = m_generation;
+        if (++m_arrived == m_expected) {
+            m_arrived = 0;
+            ++m_generation;
+            m_cv.notify_all();
+            return;
+        }
+        m_cv.wait(lock, [&] { return m_generation != generation; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::ptrdiff_t const m_expected;
+    std::ptrdiff_t m_arrived = 0;
+    std::size_t m_generation = 0;
+};
+
+/**
+ * Wake-up latency: two threads hand a turn back and forth through a pair of
+ * semaphores, so every round trip is two wake-ups.
+ */
+template<typename Semaphore>
+static void ping_pong(char const *name, std::size_t const round_trips) {
+    auto ping = Semaphore(0);
+    auto pong = Semaphore(0);
+    benchmark(name, round_trips, [&] {
+        auto other = std::jthread([&] {
+            for (auto i = std::size_t{0}; i < round_trips; ++i) {
+                ping.acquire();
+                pong.release();
+            }
+        });
+        for (auto i = std::size_t{0}; i < round_trips; ++i) {
+            ping.release();
+            pong.acquire();
+        }
+    });
+}
+
+TEST(TestSynchronizationBenchmark, test_wake_up_latency) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto round_trips = std::size_t{20'000};
+    ping_pong<locked_semaphore>("mutex + condition_variable ping-pong", round_trips);
+    ping_pong<std::binary_semaphore>("std::binary_semaphore ping-pong", round_trips);
+    ping_pong<dojo::binary_semaphore>("dojo::binary_semaphore ping-pong", round_trips);
+
+    auto const spin_limit = dojo::spin_limit.exchange(0);
+    ping_pong<dojo::binary_semaphore>("dojo::binary_semaphore ping-pong, no spin", round_trips);
+    dojo::spin_limit = spin_limit;
+}
+
+/**
+ * Throughput: tokens handed over from a producer to a consumer as fast as
+ * they go.
+ */
+template<typename Semaphore>
+static void hand_over(char const *name, std::size_t const tokens) {
+    auto semaphore = Semaphore(0);
+    benchmark(name, tokens, [&] {
+        auto consumer = std::jthread([&] {
+            for (auto i = std::size_t{0}; i < tokens; ++i) {
+                semaphore.acquire();
+            }
+        });
+        for (auto i = std::size_t{0}; i < tokens; ++i) {
+            semaphore.release();
+        }
+    });
+}
+
+TEST(TestSynchronizationBenchmark, test_semaphore_throughput) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto tokens = std::size_t{500'000};
+    hand_over<locked_semaphore>("mutex + condition_variable tokens", tokens);
+    hand_over<std::counting_semaphore<>>("std::counting_semaphore tokens", tokens);
+    hand_over<dojo::counting_semaphore<>>("dojo::counting_semaphore tokens", tokens);
+}
+
+/**
+ * Phase synchronization: every thread arrives and waits at the barrier, over
+ * and over again.
+ */
+template<typename Barrier>
+static void phases(std::string const &name, int const threads, std::size_t const phase_count) {
+    auto sync = Barrier(threads);
+    benchmark(name.c_str(), phase_count, [&] {
+        auto workers = std::vector<std::jthread>();
+        for (auto i = 0; i < threads; ++i) {
+            workers.emplace_back([&] {
+                for (auto phase = std::size_t{0}; phase < phase_count; ++phase) {
+                    sync.arrive_and_wait();
+                }
+            });
+        }
+    });
+}
+
+TEST(TestSynchronizationBenchmark, test_barrier_phases) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    constexpr auto phase_count = std::size_t{5'000};
+    for (auto const threads: {2, 4, 8}) {
+        auto const suffix = " x" + std::to_string(threads) + " threads";
+        phases<locked_barrier>("mutex + condition_variable barrier" + suffix, threads, phase_count);
+        phases<std::barrier<>>("std::barrier" + suffix, threads, phase_count);
+        phases<dojo::barrier<>>("dojo::barrier" + suffix, threads, phase_count);
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef CPP_XX_DOJO_COUNTING_SEMAPHORE_H
+#define CPP_XX_DOJO_COUNTING_SEMAPHORE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+#include "spin_wait.h"
+
+namespace dojo {
+
+/**
+ * @brief A counting semaphore, the same as std::counting_semaphore, whose
+ * acquirers spin for a while before parking
+ *
+ * The count is a 32-bit word, which is what the acquirers park on once it's
+ * zero. Acquiring is a compare-and-swap, and releasing a fetch-add. Only the
+ * release which makes the count positive wakes up a parked acquirer, which in
+ * turn wakes up the next one if there are tokens left, so that a burst of
+ * releases costs a single system call rather than one each.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/counting_semaphore
+ *
+ * @tparam LeastMaxValue the least maximum count to support
+ */
+template<std::ptrdiff_t LeastMaxValue = std::numeric_limits<std::int32_t>::max()>
+class counting_semaphore {
+    static_assert(LeastMaxValue >= 0 && LeastMaxValue <= std::numeric_limits<std::int32_t>::max());
+
+public:
+    static constexpr std::ptrdiff_t max() noexcept { return LeastMaxValue; }
+
+    explicit counting_semaphore(std::ptrdiff_t const desired) : m_count(static_cast<std::uint32_t>(desired)) {}
+
+    counting_semaphore(counting_semaphore const &) = delete;
+
+    counting_semaphore &operator=(counting_semaphore const &) = delete;
+
+    void release(std::ptrdiff_t const update = 1) {
+        if (m_count.fetch_add(static_cast<std::uint32_t>(update), std::memory_order_release) != 0) {
+            // nobody parks on a positive count
+            return;
+        }
+        if (update == 1) {
+            m_count.notify_one();
+        } else {
+            m_count.notify_all();
+        }
+    }
+
+    [[nodiscard]] bool try_acquire() noexcept {
+        auto count = m_count.load(std::memory_order_relaxed);
+        while (count != 0) {
+            if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void acquire() {
+        auto count = m_count.load(std::memory_order_relaxed);
+        while (true) {
+            if (count == 0) {
+                detail::spin_then_wait(m_count, 0, std::memory_order_relaxed);
+                count = m_count.load(std::memory_order_relaxed);
+            } else if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire,
+                                                     std::memory_order_relaxed)) {
+                if (count > 1) {
+                    // pass the baton, a no-op unless someone is parked
+                    m_count.notify_one();
+                }
+                return;
+            }
+        }
+    }
+
+    /**
+     * Only polls until the deadline, as atomic::wait takes no timeout.
+     */
+    template<typename Clock, typename Duration>
+    [[nodiscard]] bool try_acquire_until(std::chrono::time_point<Clock, Duration> const &deadline) {
+        while (!try_acquire()) {
+            if (Clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool try_acquire_for(std::chrono::duration<Rep, Period> const &timeout) {
+        return try_acquire_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+private:
+    std::atomic<std::uint32_t> m_count;
+};
+
+using binary_semaphore = counting_semaphore<1>;
+
+}
+
+#endif //CPP_XX_DOJO_COUNTING_SEMAPHORE_H
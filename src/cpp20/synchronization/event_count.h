@@ -0,0 +1,103 @@
+#ifndef CPP_XX_DOJO_EVENT_COUNT_H
+#define CPP_XX_DOJO_EVENT_COUNT_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "spin_wait.h"
+
+namespace dojo {
+
+/**
+ * @brief An event count, which turns any non-blocking condition into a
+ * blocking wait without a mutex
+ *
+ * The waiter announces itself and takes a key before checking its condition
+ * once more, and parks with the key only if the condition still doesn't hold:
+ *
+ *     while (!(item = queue.try_pop())) {
+ *         auto const key = events.prepare_wait();
+ *         if ((item = queue.try_pop())) {
+ *             events.cancel_wait();
+ *             break;
+ *         }
+ *         events.wait(key);
+ *     }
+ *
+ * and the notifier makes the condition hold before notifying:
+ *
+ *     queue.try_push(item);
+ *     events.notify_one();
+ *
+ * A notification after prepare_wait changes the epoch, hence the wait with
+ * the key returns at once, and no wake-up is ever lost. Meanwhile notifying
+ * costs only a fence and a load while nobody is waiting.
+ *
+ * reference from https://github.com/facebook/folly/blob/main/folly/experimental/EventCount.h
+ */
+class event_count {
+public:
+    using key = std::uint32_t;
+
+    event_count() = default;
+
+    event_count(event_count const &) = delete;
+
+    event_count &operator=(event_count const &) = delete;
+
+    [[nodiscard]] key prepare_wait() {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    void cancel_wait() {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wait(key const k) {
+        detail::spin_then_wait(m_epoch, k);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() { notify(false); }
+
+    void notify_all() { notify(true); }
+
+    /**
+     * Block until `pred()` holds, which is checked by the caller thread only.
+     */
+    template<typename Pred>
+    void await(Pred pred) {
+        while (!pred()) {
+            auto const k = prepare_wait();
+            if (pred()) {
+                cancel_wait();
+                return;
+            }
+            wait(k);
+        }
+    }
+
+private:
+    void notify(bool const all) {
+        // order the store making the condition hold before the load of the
+        // waiters, pairing with the fetch_add in prepare_wait
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        m_epoch.fetch_add(1, std::memory_order_release);
+        if (all) {
+            m_epoch.notify_all();
+        } else {
+            m_epoch.notify_one();
+        }
+    }
+
+    std::atomic<std::uint32_t> m_epoch{0};
+    std::atomic<std::uint32_t> m_waiters{0};
+};
+
+}
+
+#endif //CPP_XX_DOJO_EVENT_COUNT_H
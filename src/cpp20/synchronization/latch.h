@@ -0,0 +1,59 @@
+#ifndef CPP_XX_DOJO_LATCH_H
+#define CPP_XX_DOJO_LATCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "spin_wait.h"
+
+namespace dojo {
+
+/**
+ * @brief A single-use downward counter, the same as std::latch, whose
+ * waiters spin for a while before parking
+ *
+ * The whole state is one 32-bit counter, which is also what the waiters
+ * park on, so counting down never takes a lock, and only issues a system
+ * call if the counter reaches zero while someone is parked.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/latch
+ */
+class latch {
+public:
+    explicit latch(std::ptrdiff_t const expected) : m_counter(static_cast<std::uint32_t>(expected)) {}
+
+    latch(latch const &) = delete;
+
+    latch &operator=(latch const &) = delete;
+
+    void count_down(std::ptrdiff_t const n = 1) {
+        auto const n32 = static_cast<std::uint32_t>(n);
+        if (m_counter.fetch_sub(n32, std::memory_order_release) == n32) {
+            m_counter.notify_all();
+        }
+    }
+
+    [[nodiscard]] bool try_wait() const noexcept {
+        return m_counter.load(std::memory_order_acquire) == 0;
+    }
+
+    void wait() const {
+        for (auto counter = m_counter.load(std::memory_order_acquire); counter != 0;
+             counter = m_counter.load(std::memory_order_acquire)) {
+            detail::spin_then_wait(m_counter, counter);
+        }
+    }
+
+    void arrive_and_wait(std::ptrdiff_t const n = 1) {
+        count_down(n);
+        wait();
+    }
+
+private:
+    std::atomic<std::uint32_t> m_counter;
+};
+
+}
+
+#endif //CPP_XX_DOJO_LATCH_H
@@ -0,0 +1,66 @@
+#ifndef CPP_XX_DOJO_SPIN_WAIT_H
+#define CPP_XX_DOJO_SPIN_WAIT_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace dojo {
+
+/**
+ * How many times a waiting thread polls before it parks in the kernel.
+ *
+ * Spinning saves the two system calls and the context switches of parking
+ * and waking up, when the wait is shorter than them, but burns the cpu
+ * meanwhile. It only pays off if the thread to wait for is running on another
+ * core, hence no spinning at all on a single core by default.
+ *
+ * Tunable at runtime, e.g. 0 for the threads which should never spin.
+ */
+inline std::atomic<int> spin_limit = std::thread::hardware_concurrency() > 1 ? 128 : 0;
+
+namespace detail {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+struct spin_wait_result {
+    // the polls before the value changed or the thread parked
+    std::uint32_t spins;
+    bool parked;
+};
+
+/**
+ * Wait until `value` is no longer `old`, by polling for a while first, and
+ * then parking on it with C++20 atomic::wait, which is a futex on linux for
+ * a 32-bit integer.
+ *
+ * It may return spuriously, hence is meant to be called in a loop.
+ */
+inline spin_wait_result spin_then_wait(std::atomic<std::uint32_t> const &value, std::uint32_t const old,
+                                       std::memory_order const order = std::memory_order_acquire) {
+    auto const limit = static_cast<std::uint32_t>(spin_limit.load(std::memory_order_relaxed));
+    for (auto spin = std::uint32_t{0}; spin < limit; ++spin) {
+        if (value.load(order) != old) {
+            return {spin, false};
+        }
+        cpu_relax();
+    }
+    value.wait(old, order);
+    return {limit, true};
+}
+
+}
+
+}
+
+#endif //CPP_XX_DOJO_SPIN_WAIT_H
@@ -0,0 +1,158 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "task_graph.h"
+
+/**
+ * A DAG of tasks run on a dojo::thread_pool, where every task starts as soon
+ * as the tasks it depends on have finished.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/packaged_task
+ */
+
+TEST(TestTaskGraph, test_dependencies_first) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // a diamond: the sources are parsed, compiled apart, then linked
+    auto mutex = std::mutex();
+    auto done = std::vector<std::string>();
+    auto step = [&](std::string name) {
+        return [&, name] {
+            auto const lock = std::lock_guard(mutex);
+            done.push_back(name);
+        };
+    };
+
+    auto graph = dojo::task_graph();
+    auto const parse = graph.add("parse", step("parse"));
+    auto const compile_a = graph.add("compile a", step("compile a"));
+    auto const compile_b = graph.add("compile b", step("compile b"));
+    auto const link = graph.add("link", step("link"));
+    graph.precede(parse, compile_a);
+    graph.precede(parse, compile_b);
+    graph.precede(compile_a, link);
+    graph.precede(compile_b, link);
+
+    auto pool = dojo::thread_pool(3);
+    for (auto round = 0; round < 100; ++round) {
+        done.clear();
+        auto const report = graph.run(pool);
+        ASSERT_EQ(done.size(), 4);
+        ASSERT_EQ(done.front(), "parse");
+        ASSERT_EQ(done.back(), "link");
+        ASSERT_EQ(report.nodes.size(), 4);
+        for (auto const &node: report.nodes) {
+            ASSERT_TRUE(node.ran);
+        }
+        ASSERT_LE(report.nodes[parse].finish, report.nodes[compile_a].start);
+        ASSERT_LE(report.nodes[compile_b].finish, report.nodes[link].start);
+    }
+
+    // the same on the calling thread alone
+    done.clear();
+    graph.run();
+    ASSERT_EQ(done, (std::vector<std::string>{"parse", "compile a", "compile b", "link"}));
+}
+
+TEST(TestTaskGraph, test_every_node_once) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // layers of nodes, each depending on two of the layer before
+    constexpr auto layers = 50;
+    constexpr auto width = 8;
+    auto runs = std::vector<std::atomic<int>>(layers * width);
+    auto graph = dojo::task_graph();
+    for (auto layer = 0; layer < layers; ++layer) {
+        for (auto i = 0; i < width; ++i) {
+            auto const id = graph.add("node", [&runs, n = layer * width + i] {
+                runs[n].fetch_add(1, std::memory_order_relaxed);
+            });
+            if (layer != 0) {
+                graph.precede(id - width, id);
+                graph.precede(id - width - i + (i + 1) % width, id);
+            }
+        }
+    }
+
+    auto pool = dojo::thread_pool(4);
+    graph.run(pool);
+    graph.run(pool);
+    for (auto const &r: runs) {
+        ASSERT_EQ(r.load(), 2);
+    }
+}
+
+TEST(TestTaskGraph, test_critical_path) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    using namespace std::chrono_literals;
+    auto const sleep = [](auto const duration) {
+        return [duration] { std::this_thread::sleep_for(duration); };
+    };
+
+    // fetch -> build -> test is longer than fetch -> lint -> test
+    auto graph = dojo::task_graph();
+    auto const fetch = graph.add("fetch", sleep(1ms));
+    auto const lint = graph.add("lint", sleep(1ms));
+    auto const build = graph.add("build", sleep(20ms));
+    auto const test = graph.add("test", sleep(1ms));
+    graph.precede(fetch, lint);
+    graph.precede(fetch, build);
+    graph.precede(lint, test);
+    graph.precede(build, test);
+
+    auto pool = dojo::thread_pool(2);
+    auto const report = graph.run(pool);
+    std::cout << report;
+    ASSERT_EQ(report.critical_path, (std::vector<std::size_t>{fetch, build, test}));
+    ASSERT_GE(report.span, 22ms);
+    ASSERT_GE(report.work, report.span);
+    ASSERT_GE(report.wall, report.span);
+    ASSERT_GE(report.nodes[build].duration(), 20ms);
+}
+
+TEST(TestTaskGraph, test_exception) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto graph = dojo::task_graph();
+    auto ran_after = false;
+    auto const first = graph.add("first", [] {});
+    auto const failing = graph.add("failing", [] { throw std::runtime_error("oops"); });
+    auto const after = graph.add("after", [&] { ran_after = true; });
+    graph.precede(first, failing);
+    graph.precede(failing, after);
+
+    auto pool = dojo::thread_pool(2);
+    ASSERT_THROW(graph.run(pool), std::runtime_error);
+    ASSERT_FALSE(ran_after);
+    ASSERT_THROW(graph.run(), std::runtime_error);
+    ASSERT_FALSE(ran_after);
+}
+
+TEST(TestTaskGraph, test_cycle) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto graph = dojo::task_graph();
+    auto ran = false;
+    auto const a = graph.add("a", [&] { ran = true; });
+    auto const b = graph.add("b", [&] { ran = true; });
+    graph.precede(a, b);
+    graph.precede(b, a);
+
+    auto pool = dojo::thread_pool(1);
+    ASSERT_THROW(graph.run(pool), dojo::cycle_error);
+    ASSERT_FALSE(ran);
+    ASSERT_THROW(graph.precede(a, 2), std::out_of_range);
+
+    // an empty graph is done right away
+    auto empty = dojo::task_graph();
+    ASSERT_TRUE(empty.run(pool).critical_path.empty());
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "task_graph.h"
+#include "../../../utils.h"
+
+/**
+ * A task_graph on synthetic graphs against what it replaces: the same nodes
+ * submitted to the pool in a topological order, waiting with future.get() for
+ * each before submitting the next, which keeps a single thread busy at a time.
+ *
+ *   - wide: a source, many independent nodes, then a sink, where the whole
+ *     graph could run at once but for the source and the sink;
+ *   - deep: a single chain, where nothing could run at once, which tells the
+ *     cost of handing a node over to the next;
+ *   - layered: layers of nodes, each depending on two of the layer before,
+ *     like the targets of a build.
+ *
+ * Only printed, not asserted, since the numbers depend on the cores at hand:
+ * with a single core, the wide graph can't run any faster than the chain.
+ */
+
+namespace {
+
+/**
+ * Some arithmetic which costs about `n` multiplications, not memory bound.
+ */
+double work(std::size_t const i, int const n) {
+    auto x = 1.0 + static_cast<double>(i) * 1e-9;
+    for (auto k = 0; k < n; ++k) {
+        x = x * 1.0000001 + 1e-9;
+    }
+    return x;
+}
+
+struct synthetic_graph {
+    dojo::task_graph graph;
+    std::vector<double> out;
+};
+
+void add_node(synthetic_graph &g, int const cost) {
+    auto const id = g.graph.size();
+    g.graph.add("node " + std::to_string(id), [&out = g.out, id, cost] { out[id] = work(id, cost); });
+}
+
+void make_wide(synthetic_graph &g, std::size_t const width, int const cost) {
+    g.out.resize(width + 2);
+    add_node(g, cost);
+    for (auto i = std::size_t{1}; i <= width; ++i) {
+        add_node(g, cost);
+        g.graph.precede(0, i);
+    }
+    add_node(g, cost);
+    for (auto i = std::size_t{1}; i <= width; ++i) {
+        g.graph.precede(i, width + 1);
+    }
+}
+
+void make_deep(synthetic_graph &g, std::size_t const depth, int const cost) {
+    g.out.resize(depth);
+    for (auto i = std::size_t{0}; i < depth; ++i) {
+        add_node(g, cost);
+        if (i != 0) {
+            g.graph.precede(i - 1, i);
+        }
+    }
+}
+
+void make_layered(synthetic_graph &g, std::size_t const layers, std::size_t const width, int const cost) {
+    g.out.resize(layers * width);
+    for (auto layer = std::size_t{0}; layer < layers; ++layer) {
+        for (auto i = std::size_t{0}; i < width; ++i) {
+            add_node(g, cost);
+            if (layer != 0) {
+                auto const id = layer * width + i;
+                g.graph.precede(id - width, id);
+                g.graph.precede(id - width - i + (i + 1) % width, id);
+            }
+        }
+    }
+}
+
+/**
+ * The chain of future.get() over the nodes in the order of their ids, which
+ * is a topological order of the synthetic graphs.
+ */
+void run_chained(synthetic_graph &g, dojo::thread_pool &pool, int const cost) {
+    for (auto id = std::size_t{0}; id < g.out.size(); ++id) {
+        pool.submit([&g, id, cost] { g.out[id] = work(id, cost); }).get();
+    }
+}
+
+void compare(char const *shape, synthetic_graph &g, int const cost) {
+    auto const threads = std::size_t{std::max(std::thread::hardware_concurrency(), 1u)};
+    auto pool = dojo::thread_pool(threads);
+    auto const nodes = g.out.size();
+
+    auto name = std::string(shape) + ", future.get() chain";
+    benchmark(name.c_str(), nodes, [&] { run_chained(g, pool, cost); });
+    name = std::string(shape) + ", task_graph, serial";
+    benchmark(name.c_str(), nodes, [&] { g.graph.run(); });
+    name = std::string(shape) + ", task_graph, " + std::to_string(threads) + " threads";
+    auto report = dojo::task_graph_report();
+    benchmark(name.c_str(), nodes, [&] { report = g.graph.run(pool); });
+    do_not_optimize(g.out);
+
+    std::cout << "    work " << report.work.count() / 1000 << " us, span " << report.span.count() / 1000
+              << " us, wall " << report.wall.count() / 1000 << " us, parallelism " << report.parallelism()
+              << ", critical path of " << report.critical_path.size() << " nodes" << std::endl;
+}
+
+}
+
+TEST(TestTaskGraphBenchmark, test_wide) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const cost: {0, 10000}) {
+        auto g = synthetic_graph();
+        make_wide(g, 4096, cost);
+        std::cout << "  4096 nodes of " << cost << " multiplications:" << std::endl;
+        compare("wide", g, cost);
+    }
+}
+
+TEST(TestTaskGraphBenchmark, test_deep) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    for (auto const cost: {0, 10000}) {
+        auto g = synthetic_graph();
+        make_deep(g, 4096, cost);
+        std::cout << "  4096 nodes of " << cost << " multiplications:" << std::endl;
+        compare("deep", g, cost);
+    }
+}
+
+TEST(TestTaskGraphBenchmark, test_layered) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto g = synthetic_graph();
+    make_layered(g, 256, 16, 10000);
+    std::cout << "  256 layers of 16 nodes of 10000 multiplications:" << std::endl;
+    compare("layered", g, 10000);
+}
@@ -0,0 +1,368 @@
+#ifndef CPP_XX_DOJO_TASK_GRAPH_H
+#define CPP_XX_DOJO_TASK_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../cancellation/thread_pool.h"
+
+namespace dojo {
+
+/**
+ * Thrown by task_graph::run() if the edges make a cycle, which no order of
+ * the nodes can satisfy.
+ */
+class cycle_error : public std::logic_error {
+public:
+    cycle_error() : std::logic_error("task_graph: the edges make a cycle") {}
+};
+
+/**
+ * When a node of a run started and finished, since the run started.
+ */
+struct task_timing {
+    std::string name;
+    std::chrono::nanoseconds start{0};
+    std::chrono::nanoseconds finish{0};
+    std::thread::id thread;
+    // false if skipped, since another node threw before this one started
+    bool ran = false;
+
+    [[nodiscard]] std::chrono::nanoseconds duration() const { return finish - start; }
+};
+
+/**
+ * What a run of a task_graph took: the timing of every node, by node id, and
+ * the critical path, i.e. the chain of dependent nodes of the longest total
+ * duration, which bounds the run from below however many threads there are.
+ */
+struct task_graph_report {
+    std::vector<task_timing> nodes;
+    std::vector<std::size_t> critical_path;
+    // from the start of the first node to the finish of the last one
+    std::chrono::nanoseconds wall{0};
+    // the durations of all the nodes summed up
+    std::chrono::nanoseconds work{0};
+    // the durations of the nodes of the critical path summed up
+    std::chrono::nanoseconds span{0};
+
+    /**
+     * The average count of the nodes which could have run at once, i.e. the
+     * most a run could speed up with enough threads.
+     */
+    [[nodiscard]] double parallelism() const {
+        return span.count() == 0 ? 1.0 : static_cast<double>(work.count()) / static_cast<double>(span.count());
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, task_graph_report const &report) {
+        auto const us = [](std::chrono::nanoseconds const ns) { return static_cast<double>(ns.count()) / 1000; };
+        auto const flags = os.flags();
+        auto const precision = os.precision();
+        os << std::fixed << std::setprecision(1)
+           << "wall " << us(report.wall) << " us, work " << us(report.work) << " us, span " << us(report.span)
+           << " us, parallelism " << std::setprecision(2) << report.parallelism() << std::setprecision(1) << '\n';
+        for (auto const &node: report.nodes) {
+            os << "  " << std::left << std::setw(24) << node.name << std::right;
+            if (node.ran) {
+                os << std::setw(12) << us(node.start) << std::setw(12) << us(node.finish) << " us\n";
+            } else {
+                os << std::setw(12) << "skipped" << '\n';
+            }
+        }
+        os << "  critical path:";
+        for (auto const id: report.critical_path) {
+            os << ' ' << report.nodes[id].name;
+        }
+        os << '\n';
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+};
+
+/**
+ * A DAG of tasks, where a task starts as soon as all the tasks it depends on
+ * have finished, rather than in an order fixed upfront as a chain of
+ * future.get() does, which leaves the threads idle whenever the next task in
+ * the chain is not ready while others are.
+ *
+ * Every node is a std::packaged_task, which keeps the callable across the runs
+ * by reset() and catches its exception in the shared state. A run counts down
+ * an atomic of every node by its predecessors, and whoever finishes the last
+ * predecessor of a node releases it: the thread goes on with one of the nodes
+ * it released and submits the others to the pool, so a chain runs on a single
+ * thread without going through the queue of the pool.
+ *
+ * Once a node throws, the nodes which haven't started yet are skipped, and the
+ * run rethrows the exception of the failed node first added.
+ *
+ * The graph must not be changed while running, and the pool must not be
+ * stopped in the middle of a run, whose aborted tasks would never finish.
+ *
+ * reference from https://en.cppreference.com/w/cpp/thread/packaged_task
+ * reference from https://taskflow.github.io/taskflow/index.html
+ */
+class task_graph {
+public:
+    using node_id = std::size_t;
+
+    /**
+     * Add a node running `fn()`, which returns nothing: the results are passed
+     * on by the captures of the callables.
+     */
+    template<typename Fn>
+    requires std::is_invocable_r_v<void, std::decay_t<Fn> &>
+    node_id add(std::string name, Fn &&fn) {
+        m_nodes.push_back(node{
+                std::move(name),
+                std::packaged_task<void(std::atomic<bool> &)>(
+                        [fn = std::forward<Fn>(fn)](std::atomic<bool> &failed) mutable {
+                            try {
+                                fn();
+                            } catch (...) {
+                                failed.store(true, std::memory_order_relaxed);
+                                throw;
+                            }
+                        }),
+        });
+        return m_nodes.size() - 1;
+    }
+
+    /**
+     * Declare that the node `after` depends on the node `before`.
+     */
+    void precede(node_id const before, node_id const after) {
+        if (before >= m_nodes.size() || after >= m_nodes.size()) {
+            throw std::out_of_range("task_graph::precede: no such node");
+        }
+        m_nodes[before].successors.push_back(after);
+        ++m_nodes[after].predecessors;
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_nodes.size(); }
+
+    [[nodiscard]] std::string const &name(node_id const id) const { return m_nodes.at(id).name; }
+
+    /**
+     * Run all the nodes one by one on the calling thread, in the order of
+     * their dependencies.
+     *
+     * @throw cycle_error if the edges make a cycle, before running any node
+     */
+    task_graph_report run() {
+        auto const order = topological_order();
+        auto state = run_state(*this);
+        for (auto const id: order) {
+            run_node(state, id);
+        }
+        return finish(state, order);
+    }
+
+    /**
+     * Run the nodes on the threads of `pool`, each as soon as its
+     * dependencies have finished. The calling thread waits for the whole run.
+     *
+     * @throw cycle_error if the edges make a cycle, before running any node
+     */
+    task_graph_report run(thread_pool &pool) {
+        auto const order = topological_order();
+        auto state = run_state(*this);
+        if (!m_nodes.empty()) {
+            for (auto id = node_id{0}; id < m_nodes.size(); ++id) {
+                if (m_nodes[id].predecessors == 0) {
+                    submit(pool, state, id);
+                }
+            }
+            state.done.get_future().wait();
+            // the tasks of the pool may still be returning, which must be done
+            // with the state before it goes
+            for (auto &future: state.submitted) {
+                if (future.valid()) {
+                    future.get();
+                }
+            }
+        }
+        return finish(state, order);
+    }
+
+private:
+    struct node {
+        std::string name;
+        std::packaged_task<void(std::atomic<bool> &)> task;
+        std::vector<node_id> successors{};
+        std::size_t predecessors = 0;
+    };
+
+    static constexpr auto no_node = std::numeric_limits<node_id>::max();
+
+    /**
+     * Everything of a single run. Every slot of the vectors is written by the
+     * thread running the node of that slot, or releasing it, and read by the
+     * calling thread after the run.
+     */
+    struct run_state {
+        explicit run_state(task_graph &graph) :
+                pending(std::make_unique<std::atomic<std::size_t>[]>(graph.size())),
+                unfinished(graph.size()),
+                timings(graph.size()),
+                results(graph.size()),
+                submitted(graph.size()),
+                start(std::chrono::steady_clock::now()) {
+            for (auto id = node_id{0}; id < graph.size(); ++id) {
+                auto &n = graph.m_nodes[id];
+                pending[id].store(n.predecessors, std::memory_order_relaxed);
+                timings[id].name = n.name;
+                n.task.reset();
+                results[id] = n.task.get_future();
+            }
+        }
+
+        std::unique_ptr<std::atomic<std::size_t>[]> pending;
+        std::atomic<std::size_t> unfinished;
+        std::atomic<bool> failed{false};
+        std::promise<void> done;
+        std::vector<task_timing> timings;
+        std::vector<std::future<void>> results;
+        std::vector<cancellable_future<void>> submitted;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void submit(thread_pool &pool, run_state &state, node_id const id) {
+        state.submitted[id] = pool.submit([this, &pool, &state, id] { execute(pool, state, id); });
+    }
+
+    /**
+     * Run the node `id`, then release its successors, going on with one of
+     * the released nodes until none is left.
+     */
+    void execute(thread_pool &pool, run_state &state, node_id id) {
+        while (true) {
+            run_node(state, id);
+            auto next = no_node;
+            for (auto const successor: m_nodes[id].successors) {
+                if (state.pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (next != no_node) {
+                        submit(pool, state, next);
+                    }
+                    next = successor;
+                }
+            }
+            // the last one to finish tells the caller, which may destroy the
+            // state right away
+            if (state.unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                state.done.set_value();
+                return;
+            }
+            if (next == no_node) {
+                return;
+            }
+            id = next;
+        }
+    }
+
+    void run_node(run_state &state, node_id const id) {
+        auto &timing = state.timings[id];
+        if (state.failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        timing.thread = std::this_thread::get_id();
+        timing.start = std::chrono::steady_clock::now() - state.start;
+        m_nodes[id].task(state.failed);
+        timing.finish = std::chrono::steady_clock::now() - state.start;
+        timing.ran = true;
+    }
+
+    /**
+     * The nodes in an order where every node comes after its predecessors, by
+     * Kahn's algorithm.
+     */
+    [[nodiscard]] std::vector<node_id> topological_order() const {
+        auto order = std::vector<node_id>();
+        order.reserve(m_nodes.size());
+        auto pending = std::vector<std::size_t>(m_nodes.size());
+        for (auto id = node_id{0}; id < m_nodes.size(); ++id) {
+            pending[id] = m_nodes[id].predecessors;
+            if (pending[id] == 0) {
+                order.push_back(id);
+            }
+        }
+        for (auto i = std::size_t{0}; i < order.size(); ++i) {
+            for (auto const successor: m_nodes[order[i]].successors) {
+                if (--pending[successor] == 0) {
+                    order.push_back(successor);
+                }
+            }
+        }
+        if (order.size() != m_nodes.size()) {
+            throw cycle_error();
+        }
+        return order;
+    }
+
+    /**
+     * Rethrow the first exception if any, otherwise make up the report, with
+     * the critical path found by the longest path over the topological order.
+     */
+    task_graph_report finish(run_state &state, std::vector<node_id> const &order) {
+        for (auto id = node_id{0}; id < m_nodes.size(); ++id) {
+            if (state.timings[id].ran) {
+                state.results[id].get();
+            }
+        }
+
+        auto report = task_graph_report();
+        report.nodes = std::move(state.timings);
+        // the longest path ending at every node, and the node before it there
+        auto longest = std::vector<std::chrono::nanoseconds>(m_nodes.size());
+        auto via = std::vector<node_id>(m_nodes.size(), no_node);
+        auto last = no_node;
+        auto first_start = std::chrono::nanoseconds::max();
+        for (auto const id: order) {
+            auto const &timing = report.nodes[id];
+            longest[id] += timing.duration();
+            report.work += timing.duration();
+            if (timing.ran) {
+                first_start = std::min(first_start, timing.start);
+                report.wall = std::max(report.wall, timing.finish);
+            }
+            if (last == no_node || longest[id] > longest[last]) {
+                last = id;
+            }
+            for (auto const successor: m_nodes[id].successors) {
+                if (via[successor] == no_node || longest[id] > longest[successor]) {
+                    longest[successor] = longest[id];
+                    via[successor] = id;
+                }
+            }
+        }
+        if (last != no_node) {
+            report.span = longest[last];
+            report.wall -= std::min(first_start, report.wall);
+            for (auto id = last; id != no_node; id = via[id]) {
+                report.critical_path.push_back(id);
+            }
+            std::reverse(report.critical_path.begin(), report.critical_path.end());
+        }
+        return report;
+    }
+
+    std::vector<node> m_nodes;
+};
+
+}
+
+#endif //CPP_XX_DOJO_TASK_GRAPH_H
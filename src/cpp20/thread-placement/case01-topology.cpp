@@ -0,0 +1,101 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "topology.h"
+
+/**
+ * Linux describes the cpus, the cores sharing them as hyper-threads, the
+ * packages (sockets) and the numa nodes in sysfs, mostly as cpu lists such as
+ * "0-3,8". A thread only benefits from being pinned if it's pinned with the
+ * topology in mind, e.g. one worker per physical core, or the workers of a
+ * node near the memory they use.
+ */
+
+TEST(TestTopology, test_parse_cpu_list) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    ASSERT_EQ(dojo::parse_cpu_list("0"), (std::vector<unsigned>{0}));
+    ASSERT_EQ(dojo::parse_cpu_list("0-3,8,10-11\n"), (std::vector<unsigned>{0, 1, 2, 3, 8, 10, 11}));
+    ASSERT_EQ(dojo::parse_cpu_list("4,0-1,1"), (std::vector<unsigned>{0, 1, 4}));
+
+    // invalid lists result in nothing rather than a partial guess
+    ASSERT_TRUE(dojo::parse_cpu_list("").empty());
+    ASSERT_TRUE(dojo::parse_cpu_list("3-1").empty());
+    ASSERT_TRUE(dojo::parse_cpu_list("0-x").empty());
+}
+
+/**
+ * Query a fake sysfs of two packages with two hyper-threaded cores each,
+ * where each package is a numa node, and the process is restricted to some
+ * of the cpus as if started by `taskset -c 0-5`.
+ */
+TEST(TestTopology, test_query_fake_sysfs) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const root = std::filesystem::temp_directory_path() / "cppXXdojo-test-topology";
+    std::filesystem::remove_all(root);
+    auto const write = [](std::filesystem::path const &path, std::string const &content) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << content << "\n";
+    };
+
+    write(root / "cpu" / "online", "0-7");
+    for (auto cpu = 0u; cpu < 8; ++cpu) {
+        auto const dir = root / "cpu" / ("cpu" + std::to_string(cpu)) / "topology";
+        // cpu n and cpu n + 2 are hyper-threads of the same core
+        write(dir / "core_id", std::to_string(cpu % 2));
+        write(dir / "physical_package_id", std::to_string(cpu / 4));
+    }
+    write(root / "node" / "node0" / "cpulist", "0-3");
+    write(root / "node" / "node1" / "cpulist", "4-7");
+    write(root / "status", "Name:\tdojo\nCpus_allowed_list:\t0-5\n");
+
+    auto const topology = dojo::cpu_topology::query(root, root / "status");
+    ASSERT_EQ(topology.cpus.size(), 8);
+    ASSERT_EQ(topology.nodes.size(), 2);
+    ASSERT_EQ(topology.nodes.at(1), (std::vector<unsigned>{4, 5, 6, 7}));
+    ASSERT_EQ(topology.cpus[6].package_id, 1);
+    ASSERT_EQ(topology.cpus[6].node_id, 1);
+    ASSERT_FALSE(topology.cpus[6].allowed);
+
+    ASSERT_EQ(topology.allowed_cpus(), (std::vector<unsigned>{0, 1, 2, 3, 4, 5}));
+    ASSERT_EQ(topology.allowed_cpus(1), (std::vector<unsigned>{4, 5}));
+    ASSERT_EQ(topology.one_cpu_per_core(), (std::vector<unsigned>{0, 1, 4, 5}));
+
+    std::filesystem::remove_all(root);
+}
+
+/**
+ * Without sysfs, e.g. in a sandbox, it falls back to a single cpu on a single
+ * node rather than failing.
+ */
+TEST(TestTopology, test_query_without_sysfs) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const topology = dojo::cpu_topology::query("/nonexistent/sys", "/nonexistent/status");
+    ASSERT_EQ(topology.cpus.size(), 1);
+    ASSERT_EQ(topology.nodes.size(), 1);
+    ASSERT_EQ(topology.allowed_cpus(), (std::vector<unsigned>{0}));
+}
+
+TEST(TestTopology, test_query_this_machine) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const topology = dojo::cpu_topology::query();
+    ASSERT_FALSE(topology.cpus.empty());
+    ASSERT_FALSE(topology.allowed_cpus().empty());
+
+    for (auto const &[node, cpus]: topology.nodes) {
+        std::cout << "node " << node << ":";
+        for (auto const cpu: cpus) {
+            std::cout << " " << cpu;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "one cpu per core: " << topology.one_cpu_per_core().size() << std::endl;
+}
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "placed_thread.h"
+
+/**
+ * std::thread and std::jthread take no options: the thread runs wherever the
+ * scheduler likes, with the default stack size and the name of the process.
+ * Placing a thread needs the native attributes of the platform, which is what
+ * dojo::placed_thread hides behind dojo::thread_options.
+ */
+
+TEST(TestPlacedThread, test_pin_to_cpu) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const cpu = dojo::cpu_topology::query().allowed_cpus().back();
+    auto affinity = std::vector<unsigned>();
+    {
+        auto th = dojo::placed_thread({.cpus = {cpu}}, [&] {
+            affinity = dojo::this_thread::get_affinity();
+        });
+    }
+    ASSERT_EQ(affinity, (std::vector<unsigned>{cpu}));
+}
+
+TEST(TestPlacedThread, test_name_and_stack_size) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto name = std::string();
+    auto stack_size = std::size_t{0};
+    {
+        auto th = dojo::placed_thread({.name = "a-name-too-long-for-linux", .stack_size = 1 << 20}, [&] {
+            name = dojo::this_thread::get_name();
+
+            auto attr = pthread_attr_t();
+            pthread_getattr_np(pthread_self(), &attr);
+            pthread_attr_getstacksize(&attr, &stack_size);
+            pthread_attr_destroy(&attr);
+        });
+    }
+    ASSERT_EQ(name, "a-name-too-long");
+    ASSERT_EQ(stack_size, 1 << 20);
+}
+
+/**
+ * A numa node narrows the thread down to the cpus of the node.
+ */
+TEST(TestPlacedThread, test_numa_node) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const topology = dojo::cpu_topology::query();
+    auto const node = topology.nodes.begin()->first;
+
+    auto affinity = std::vector<unsigned>();
+    {
+        auto th = dojo::placed_thread({.numa_node = node}, [&] {
+            affinity = dojo::this_thread::get_affinity();
+        });
+    }
+    ASSERT_EQ(affinity, topology.allowed_cpus(node));
+
+    // nowhere to run
+    ASSERT_THROW(dojo::placed_thread({.numa_node = 1024}, [] {}), std::system_error);
+}
+
+/**
+ * The same as std::jthread, the stop token is passed to the function if it
+ * takes one, and the stop is requested on destruction.
+ */
+TEST(TestPlacedThread, test_stop_on_destruction) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto stopped = std::atomic<bool>(false);
+    {
+        auto th = dojo::placed_thread({.name = "stoppable"}, [&](std::stop_token const &token, int const step) {
+            while (!token.stop_requested()) {
+                std::this_thread::yield();
+            }
+            stopped.store(step > 0);
+        }, 1);
+        ASSERT_TRUE(th.joinable());
+
+        auto moved = std::move(th);
+        ASSERT_FALSE(th.joinable()); // NOLINT(bugprone-use-after-move)
+        ASSERT_TRUE(moved.joinable());
+    }
+    ASSERT_TRUE(stopped.load());
+}
@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <iostream>
+#include <latch>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "placed_thread.h"
+#include "../../../utils.h"
+
+/**
+ * A memory-bound workload: every worker streams over a buffer far larger than
+ * the caches, so its throughput depends on how far the memory is from the
+ * cpu it's running on.
+ *
+ * The buffer is first touched by the worker which owns it, hence allocated
+ * on the numa node the worker is running on at that time. Pinned workers stay
+ * near their memory, while unpinned ones may be migrated away from it by the
+ * scheduler. With more than one node, it also streams from the memory of the
+ * other node on purpose, which is the worst case of an unpinned worker.
+ *
+ * On a single-node machine the numbers are about the same, since there's no
+ * remote memory at all.
+ */
+
+static constexpr auto bytes_per_worker = std::size_t{32} << 20;
+static constexpr auto passes = 4;
+
+/**
+ * @param workers the options of each worker
+ * @param owners the options of the thread touching the buffer of each worker
+ *   first, or the worker itself if nullopt
+ */
+static void stream(char const *name, std::vector<dojo::thread_options> const &workers,
+                   std::optional<std::vector<dojo::thread_options>> const &owners = std::nullopt) {
+    auto const words = bytes_per_worker / sizeof(std::uint64_t);
+    auto buffers = std::vector<std::vector<std::uint64_t>>(workers.size());
+    auto const touch = [&](std::size_t const i) {
+        buffers[i] = std::vector<std::uint64_t>(words);
+        std::iota(buffers[i].begin(), buffers[i].end(), std::uint64_t{0});
+    };
+
+    if (owners) {
+        for (auto i = std::size_t{0}; i < workers.size(); ++i) {
+            dojo::placed_thread((*owners)[i], touch, i).join();
+        }
+    }
+
+    auto touched = std::latch(static_cast<std::ptrdiff_t>(workers.size()));
+    auto start = std::latch(1);
+    auto threads = std::vector<dojo::placed_thread>();
+    for (auto i = std::size_t{0}; i < workers.size(); ++i) {
+        threads.emplace_back(workers[i], [&, i] {
+            if (!owners) {
+                touch(i);
+            }
+            touched.count_down();
+            start.wait();
+
+            auto sum = std::uint64_t{0};
+            for (auto pass = 0; pass < passes; ++pass) {
+                for (auto const word: buffers[i]) {
+                    sum += word;
+                }
+            }
+            do_not_optimize(sum);
+        });
+    }
+    touched.wait();
+
+    benchmark(name, words * passes * workers.size(), [&] {
+        start.count_down();
+        threads.clear();
+    });
+}
+
+TEST(TestPlacedThreadBenchmark, test_pinned_vs_unpinned) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const topology = dojo::cpu_topology::query();
+    auto const cpus = topology.one_cpu_per_core();
+    std::cout << cpus.size() << " workers on " << topology.nodes.size() << " numa node(s), "
+              << "timings per 8-byte word" << std::endl;
+
+    auto unpinned = std::vector<dojo::thread_options>(cpus.size());
+    auto pinned = std::vector<dojo::thread_options>();
+    for (auto const cpu: cpus) {
+        pinned.push_back({.cpus = {cpu}, .name = "pinned-" + std::to_string(cpu)});
+    }
+    stream("unpinned", unpinned);
+    stream("pinned, local memory", pinned);
+
+    if (topology.nodes.size() > 1) {
+        // the buffer of each worker is touched first on the next node
+        auto remote = std::vector<dojo::thread_options>();
+        for (auto const cpu: cpus) {
+            auto node = topology.nodes.upper_bound(topology.cpus[cpu].node_id);
+            if (node == topology.nodes.end()) {
+                node = topology.nodes.begin();
+            }
+            remote.push_back({.numa_node = node->first});
+        }
+        stream("pinned, remote memory", pinned, remote);
+    }
+}
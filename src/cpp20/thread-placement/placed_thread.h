@@ -0,0 +1,318 @@
+#ifndef CPP_XX_DOJO_PLACED_THREAD_H
+#define CPP_XX_DOJO_PLACED_THREAD_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "topology.h"
+#include "../cancellation/cancellation.h"
+
+namespace dojo {
+
+/**
+ * @brief Where and how a placed_thread runs
+ *
+ * Meant for designated initializers, where every field left out keeps the
+ * default of std::thread:
+ *
+ *     auto options = dojo::thread_options{.numa_node = 1, .name = "worker-1"};
+ */
+struct thread_options {
+    // the cpus the thread may run on, or any cpu if empty
+    std::vector<unsigned> cpus;
+    // narrow the cpus down to those of the node, and prefer allocating the
+    // memory touched by the thread on the node
+    std::optional<unsigned> numa_node;
+    // shown by top, gdb and perf; linux truncates it to 15 characters
+    std::string name;
+    // in bytes, or the default of the platform if 0
+    std::size_t stack_size = 0;
+};
+
+namespace detail {
+
+inline cpu_set_t to_cpu_set(std::vector<unsigned> const &cpus) {
+    auto set = cpu_set_t();
+    CPU_ZERO(&set);
+    for (auto const cpu: cpus) {
+        if (cpu >= CPU_SETSIZE) {
+            throw std::system_error(EINVAL, std::system_category(), "cpu id out of range");
+        }
+        CPU_SET(cpu, &set);
+    }
+    return set;
+}
+
+}
+
+namespace this_thread {
+
+inline std::vector<unsigned> get_affinity() {
+    auto set = cpu_set_t();
+    if (auto const err = pthread_getaffinity_np(pthread_self(), sizeof(set), &set)) {
+        throw std::system_error(err, std::system_category(), "pthread_getaffinity_np");
+    }
+    auto cpus = std::vector<unsigned>();
+    for (auto cpu = 0u; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+inline void set_affinity(std::vector<unsigned> const &cpus) {
+    auto const set = detail::to_cpu_set(cpus);
+    if (auto const err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+        throw std::system_error(err, std::system_category(), "pthread_setaffinity_np");
+    }
+}
+
+inline std::string get_name() {
+    char name[16] = {};
+    if (auto const err = pthread_getname_np(pthread_self(), name, sizeof(name))) {
+        throw std::system_error(err, std::system_category(), "pthread_getname_np");
+    }
+    return name;
+}
+
+inline void set_name(std::string const &name) {
+    if (auto const err = pthread_setname_np(pthread_self(), name.substr(0, 15).c_str())) {
+        throw std::system_error(err, std::system_category(), "pthread_setname_np");
+    }
+}
+
+}
+
+namespace detail {
+
+/**
+ * The cpus the options ask for, or empty for any cpu.
+ */
+inline std::vector<unsigned> resolve_cpus(thread_options const &options) {
+    if (!options.numa_node) {
+        return options.cpus;
+    }
+    auto const node_cpus = cpu_topology::query().allowed_cpus(options.numa_node);
+    auto cpus = std::vector<unsigned>();
+    for (auto const cpu: node_cpus) {
+        if (options.cpus.empty() || std::find(options.cpus.begin(), options.cpus.end(), cpu) != options.cpus.end()) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        throw std::system_error(EINVAL, std::system_category(), "no allowed cpu on the numa node");
+    }
+    return cpus;
+}
+
+/**
+ * Prefer allocating the pages first touched by this thread on the node.
+ *
+ * Only a preference, so that the allocations still succeed once the node is
+ * out of memory. Without libnuma, it's the raw syscall. Best effort, since
+ * the syscall may be filtered out in a container.
+ */
+inline void prefer_numa_node(unsigned const node) {
+    auto mask = 0ul;
+    if (node >= sizeof(mask) * CHAR_BIT) {
+        return;
+    }
+    mask |= 1ul << node;
+    // the kernel takes the count of bits plus one
+    syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, sizeof(mask) * CHAR_BIT + 1);
+}
+
+struct thread_start_base {
+    virtual ~thread_start_base() = default;
+
+    virtual void run() = 0;
+
+    std::string name;
+    std::optional<unsigned> numa_node;
+};
+
+template<typename Fn, typename... Args>
+struct thread_start final : thread_start_base {
+    template<typename F, typename... A>
+    explicit thread_start(std::stop_token token, F &&fn, A &&...args) :
+            token(std::move(token)), callable(std::forward<F>(fn), std::forward<A>(args)...) {}
+
+    void run() override {
+        std::apply([this](Fn &fn, Args &...args) {
+            invoke_with_token(std::move(fn), token, std::move(args)...);
+        }, callable);
+    }
+
+    std::stop_token token;
+    std::tuple<Fn, Args...> callable;
+};
+
+/**
+ * An exception escaping from the function terminates the program, the same
+ * as with std::thread.
+ */
+inline void *thread_entry(void *arg) noexcept {
+    auto const start = std::unique_ptr<thread_start_base>(static_cast<thread_start_base *>(arg));
+    if (!start->name.empty()) {
+        pthread_setname_np(pthread_self(), start->name.substr(0, 15).c_str());
+    }
+    if (start->numa_node) {
+        prefer_numa_node(*start->numa_node);
+    }
+    start->run();
+    return nullptr;
+}
+
+inline pthread_t start_thread(thread_options const &options, std::unique_ptr<thread_start_base> start) {
+    auto attr = pthread_attr_t();
+    if (auto const err = pthread_attr_init(&attr)) {
+        throw std::system_error(err, std::system_category(), "pthread_attr_init");
+    }
+    struct attr_guard {
+        pthread_attr_t *attr;
+
+        ~attr_guard() { pthread_attr_destroy(attr); }
+    } const guard{&attr};
+
+    if (options.stack_size != 0) {
+        if (auto const err = pthread_attr_setstacksize(&attr, options.stack_size)) {
+            throw std::system_error(err, std::system_category(), "pthread_attr_setstacksize");
+        }
+    }
+    // the thread starts on the cpus at once, so even its stack is first
+    // touched there
+    if (auto const cpus = resolve_cpus(options); !cpus.empty()) {
+        auto const set = to_cpu_set(cpus);
+        if (auto const err = pthread_attr_setaffinity_np(&attr, sizeof(set), &set)) {
+            throw std::system_error(err, std::system_category(), "pthread_attr_setaffinity_np");
+        }
+    }
+
+    start->name = options.name;
+    start->numa_node = options.numa_node;
+    auto handle = pthread_t();
+    if (auto const err = pthread_create(&handle, &attr, &thread_entry, start.get())) {
+        throw std::system_error(err, std::system_category(), "pthread_create");
+    }
+    // owned by the thread from now on
+    start.release();
+    return handle;
+}
+
+}
+
+/**
+ * @brief A std::jthread which is told where and how to run
+ *
+ * Behaves the same as std::jthread: it requests stop and joins on
+ * destruction, and passes its stop token to the function if the function
+ * takes one as its first parameter. Additionally it's started with the
+ * thread_options, which std::jthread has no way to accept: neither the stack
+ * size nor the cpus can be changed once the thread is running, at least not
+ * before the thread has touched its first memory.
+ *
+ * Linux only, as the placement is done with the pthread attributes.
+ */
+class placed_thread {
+public:
+    using native_handle_type = pthread_t;
+
+    placed_thread() noexcept = default;
+
+    template<typename Fn, typename... Args>
+    requires (!std::is_same_v<std::remove_cvref_t<Fn>, placed_thread>)
+    explicit placed_thread(thread_options const &options, Fn &&fn, Args &&...args) :
+            m_stop_source() {
+        auto start = std::make_unique<detail::thread_start<std::decay_t<Fn>, std::decay_t<Args>...>>(
+                m_stop_source.get_token(), std::forward<Fn>(fn), std::forward<Args>(args)...);
+        m_handle = detail::start_thread(options, std::move(start));
+        m_joinable = true;
+    }
+
+    placed_thread(placed_thread const &) = delete;
+
+    placed_thread &operator=(placed_thread const &) = delete;
+
+    placed_thread(placed_thread &&other) noexcept :
+            m_stop_source(std::exchange(other.m_stop_source, std::stop_source(std::nostopstate))),
+            m_handle(other.m_handle),
+            m_joinable(std::exchange(other.m_joinable, false)) {}
+
+    placed_thread &operator=(placed_thread &&other) noexcept {
+        if (this != &other) {
+            stop_and_join();
+            m_stop_source = std::exchange(other.m_stop_source, std::stop_source(std::nostopstate));
+            m_handle = other.m_handle;
+            m_joinable = std::exchange(other.m_joinable, false);
+        }
+        return *this;
+    }
+
+    ~placed_thread() {
+        stop_and_join();
+    }
+
+    [[nodiscard]] bool joinable() const noexcept { return m_joinable; }
+
+    void join() {
+        if (!m_joinable) {
+            throw std::system_error(EINVAL, std::system_category(), "placed_thread::join");
+        }
+        if (auto const err = pthread_join(m_handle, nullptr)) {
+            throw std::system_error(err, std::system_category(), "pthread_join");
+        }
+        m_joinable = false;
+    }
+
+    void detach() {
+        if (!m_joinable) {
+            throw std::system_error(EINVAL, std::system_category(), "placed_thread::detach");
+        }
+        if (auto const err = pthread_detach(m_handle)) {
+            throw std::system_error(err, std::system_category(), "pthread_detach");
+        }
+        m_joinable = false;
+    }
+
+    [[nodiscard]] native_handle_type native_handle() const noexcept { return m_handle; }
+
+    [[nodiscard]] std::stop_source get_stop_source() const noexcept { return m_stop_source; }
+
+    [[nodiscard]] std::stop_token get_stop_token() const noexcept { return m_stop_source.get_token(); }
+
+    bool request_stop() noexcept { return m_stop_source.request_stop(); }
+
+private:
+    void stop_and_join() noexcept {
+        if (m_joinable) {
+            m_stop_source.request_stop();
+            pthread_join(m_handle, nullptr);
+            m_joinable = false;
+        }
+    }
+
+    std::stop_source m_stop_source{std::nostopstate};
+    pthread_t m_handle{};
+    bool m_joinable{false};
+};
+
+}
+
+#endif //CPP_XX_DOJO_PLACED_THREAD_H
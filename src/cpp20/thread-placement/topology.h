@@ -0,0 +1,188 @@
+#ifndef CPP_XX_DOJO_TOPOLOGY_H
+#define CPP_XX_DOJO_TOPOLOGY_H
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dojo {
+
+/**
+ * Parse a cpu list in the format of the kernel, such as "0-3,8,10-11", into
+ * the sorted cpu ids. An invalid list results in an empty vector.
+ */
+inline std::vector<unsigned> parse_cpu_list(std::string_view list) {
+    auto const parse = [](std::string_view text, unsigned &value) {
+        auto const [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc() && end == text.data() + text.size();
+    };
+
+    auto cpus = std::vector<unsigned>();
+    while (!list.empty() && (list.back() == '\n' || list.back() == ' ')) {
+        list.remove_suffix(1);
+    }
+    while (!list.empty()) {
+        auto const comma = list.find(',');
+        auto const range = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+
+        auto const dash = range.find('-');
+        auto first = 0u, last = 0u;
+        if (!parse(range.substr(0, dash), first)) {
+            return {};
+        }
+        if (dash == std::string_view::npos) {
+            last = first;
+        } else if (!parse(range.substr(dash + 1), last) || last < first) {
+            return {};
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+namespace detail {
+
+inline std::optional<std::string> read_first_line(std::filesystem::path const &path) {
+    auto file = std::ifstream(path);
+    auto line = std::string();
+    if (!file || !std::getline(file, line)) {
+        return std::nullopt;
+    }
+    return line;
+}
+
+inline std::optional<unsigned> read_unsigned(std::filesystem::path const &path) {
+    auto const line = read_first_line(path);
+    auto value = 0u;
+    if (!line || std::from_chars(line->data(), line->data() + line->size(), value).ec != std::errc()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+}
+
+/**
+ * @brief The cpus, cores, packages and numa nodes of this machine
+ *
+ * Queried from the sysfs of linux:
+ *   - /sys/devices/system/cpu/online for the online cpus;
+ *   - /sys/devices/system/cpu/cpuN/topology for the core and the package of
+ *     each cpu, where the cpus sharing a core are hyper-threads;
+ *   - /sys/devices/system/node/nodeN/cpulist for the cpus of each numa node;
+ * and from /proc/self/status for the cpus this process is allowed to run on,
+ * which can be narrower than the online ones under taskset or a cgroup.
+ *
+ * Whatever can't be read falls back to a single core, package or node, so a
+ * container without sysfs still gets a usable, flat topology.
+ */
+struct cpu_topology {
+    struct cpu {
+        unsigned id;
+        unsigned core_id;
+        unsigned package_id;
+        unsigned node_id;
+        bool allowed;
+    };
+
+    std::vector<cpu> cpus;
+    // the numa nodes, each with its sorted cpu ids
+    std::map<unsigned, std::vector<unsigned>> nodes;
+
+    static cpu_topology query(std::filesystem::path const &sys = "/sys/devices/system",
+                              std::filesystem::path const &proc_status = "/proc/self/status") {
+        auto topology = cpu_topology();
+
+        auto online = std::vector<unsigned>();
+        if (auto const line = detail::read_first_line(sys / "cpu" / "online")) {
+            online = parse_cpu_list(*line);
+        }
+        if (online.empty()) {
+            online.push_back(0);
+        }
+
+        auto node_of = std::map<unsigned, unsigned>();
+        auto ec = std::error_code();
+        for (auto const &entry: std::filesystem::directory_iterator(sys / "node", ec)) {
+            auto const name = entry.path().filename().string();
+            auto node = 0u;
+            if (!name.starts_with("node") ||
+                std::from_chars(name.data() + 4, name.data() + name.size(), node).ec != std::errc()) {
+                continue;
+            }
+            if (auto const line = detail::read_first_line(entry.path() / "cpulist")) {
+                for (auto const cpu: parse_cpu_list(*line)) {
+                    node_of[cpu] = node;
+                }
+            }
+        }
+
+        auto allowed = std::vector<unsigned>();
+        auto status = std::ifstream(proc_status);
+        for (auto line = std::string(); std::getline(status, line);) {
+            if (line.starts_with("Cpus_allowed_list:")) {
+                auto list = std::string_view(line).substr(line.find(':') + 1);
+                list.remove_prefix(std::min(list.find_first_not_of(" \t"), list.size()));
+                allowed = parse_cpu_list(list);
+            }
+        }
+
+        for (auto const id: online) {
+            auto const dir = sys / "cpu" / ("cpu" + std::to_string(id)) / "topology";
+            auto const node = node_of.find(id);
+            topology.cpus.push_back(cpu{
+                    .id = id,
+                    .core_id = detail::read_unsigned(dir / "core_id").value_or(id),
+                    .package_id = detail::read_unsigned(dir / "physical_package_id").value_or(0),
+                    .node_id = node == node_of.end() ? 0 : node->second,
+                    .allowed = allowed.empty() || std::binary_search(allowed.begin(), allowed.end(), id),
+            });
+            topology.nodes[topology.cpus.back().node_id].push_back(id);
+        }
+        return topology;
+    }
+
+    /**
+     * The cpus this process may run on, optionally only those of a numa node.
+     */
+    [[nodiscard]] std::vector<unsigned> allowed_cpus(std::optional<unsigned> const node = std::nullopt) const {
+        auto result = std::vector<unsigned>();
+        for (auto const &c: cpus) {
+            if (c.allowed && (!node || c.node_id == *node)) {
+                result.push_back(c.id);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * One cpu per physical core, i.e. without the hyper-thread siblings.
+     */
+    [[nodiscard]] std::vector<unsigned> one_cpu_per_core() const {
+        auto seen = std::vector<std::pair<unsigned, unsigned>>();
+        auto result = std::vector<unsigned>();
+        for (auto const &c: cpus) {
+            auto const core = std::pair(c.package_id, c.core_id);
+            if (c.allowed && std::find(seen.begin(), seen.end(), core) == seen.end()) {
+                seen.push_back(core);
+                result.push_back(c.id);
+            }
+        }
+        return result;
+    }
+};
+
+}
+
+#endif //CPP_XX_DOJO_TOPOLOGY_H
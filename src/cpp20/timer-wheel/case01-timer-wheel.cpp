@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timer_wheel.h"
+
+/**
+ * A hierarchical timer wheel, where scheduling and cancelling a timer are
+ * O(1), checked against a std::multimap of the deadlines.
+ *
+ * reference from http://www.cs.columbia.edu/~nahum/w6998/papers/sosp87-timing-wheels.pdf
+ */
+
+TEST(TestTimerWheel, test_fire_on_deadline) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto wheel = dojo::timer_wheel<int>(1000);
+    wheel.schedule(1001, 1);
+    wheel.schedule(1255, 2);
+    wheel.schedule(1256, 3);
+    wheel.schedule(70000, 4);
+    // not after the current tick, so the next one
+    wheel.schedule(10, 5);
+    ASSERT_EQ(wheel.size(), 5);
+
+    auto fired = std::vector<std::pair<std::uint64_t, int>>();
+    auto const record = [&](int const payload) { fired.emplace_back(wheel.now(), payload); };
+
+    ASSERT_EQ(wheel.advance(1001, record), 2);
+    ASSERT_EQ(wheel.advance(1254, record), 0);
+    ASSERT_EQ(wheel.advance(1300, record), 2);
+    ASSERT_EQ(wheel.advance(69999, record), 0);
+    ASSERT_EQ(wheel.advance(1 << 20, record), 1);
+    ASSERT_EQ(wheel.now(), 1 << 20);
+    ASSERT_TRUE(wheel.empty());
+
+    ASSERT_EQ(fired.size(), 5);
+    ASSERT_EQ(fired[2], std::make_pair(std::uint64_t{1255}, 2));
+    ASSERT_EQ(fired[3], std::make_pair(std::uint64_t{1256}, 3));
+    ASSERT_EQ(fired[4], std::make_pair(std::uint64_t{70000}, 4));
+}
+
+TEST(TestTimerWheel, test_cancel) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto wheel = dojo::timer_wheel<int>();
+    auto const a = wheel.schedule(100, 1);
+    auto const b = wheel.schedule(100, 2);
+    auto const c = wheel.schedule(1 << 30, 3);
+    ASSERT_TRUE(wheel.contains(a));
+
+    ASSERT_EQ(wheel.cancel(a), 1);
+    ASSERT_FALSE(wheel.contains(a));
+    ASSERT_EQ(wheel.cancel(a), std::nullopt);
+    ASSERT_EQ(wheel.cancel(c), 3);
+
+    // the node of c is reused, but the stale id doesn't refer to the new timer
+    auto const d = wheel.schedule(200, 4);
+    ASSERT_EQ(d.index, c.index);
+    ASSERT_EQ(wheel.cancel(c), std::nullopt);
+    ASSERT_TRUE(wheel.contains(d));
+
+    auto fired = std::vector<int>();
+    wheel.advance(1000, [&](int const payload) { fired.push_back(payload); });
+    ASSERT_EQ(fired, (std::vector<int>{2, 4}));
+    ASSERT_EQ(wheel.cancel(b), std::nullopt);
+}
+
+TEST(TestTimerWheel, test_reschedule_on_fire) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // a periodic timer, scheduled again by its own firing
+    auto wheel = dojo::timer_wheel<int>();
+    wheel.schedule(300, 0);
+    auto ticks = std::vector<std::uint64_t>();
+    wheel.advance(2000, [&](int const count) {
+        ticks.push_back(wheel.now());
+        if (count < 4) {
+            wheel.schedule(wheel.now() + 300, count + 1);
+        }
+    });
+    ASSERT_EQ(ticks, (std::vector<std::uint64_t>{300, 600, 900, 1200, 1500}));
+}
+
+TEST(TestTimerWheel, test_against_multimap) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto rng = std::mt19937_64(42);
+    auto wheel = dojo::timer_wheel<std::uint64_t>(rng() >> 24);
+    auto expected = std::multimap<std::uint64_t, std::uint64_t>();
+    auto ids = std::vector<std::pair<dojo::timer_id, std::multimap<std::uint64_t, std::uint64_t>::iterator>>();
+
+    // deadlines spread over all the levels, from a tick to 2^40 ticks away
+    for (auto i = std::uint64_t{0}; i < 20000; ++i) {
+        auto const deadline = wheel.now() + 1 + (rng() >> (24 + rng() % 40));
+        ids.emplace_back(wheel.schedule(deadline, i), expected.emplace(deadline, i));
+    }
+    for (auto i = std::size_t{0}; i < ids.size(); i += 3) {
+        ASSERT_EQ(wheel.cancel(ids[i].first), ids[i].second->second);
+        expected.erase(ids[i].second);
+    }
+
+    // advanced by random steps, every timer fires at its deadline exactly
+    while (!wheel.empty()) {
+        auto const to = wheel.now() + (rng() >> (24 + rng() % 40));
+        wheel.advance(to, [&](std::uint64_t const payload) {
+            ASSERT_FALSE(expected.empty());
+            auto const first = expected.begin();
+            ASSERT_EQ(first->first, wheel.now());
+            auto const same = expected.equal_range(first->first);
+            auto found = false;
+            for (auto it = same.first; it != same.second; ++it) {
+                if (it->second == payload) {
+                    expected.erase(it);
+                    found = true;
+                    break;
+                }
+            }
+            ASSERT_TRUE(found);
+        });
+        ASSERT_TRUE(expected.empty() || expected.begin()->first > wheel.now());
+    }
+    ASSERT_TRUE(expected.empty());
+}
@@ -0,0 +1,91 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <stop_token>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timer_service.h"
+
+/**
+ * Timeouts by a timer service, i.e. a timer wheel and a single thread firing
+ * its timers, rather than a sleeping thread or a wait_for() per timeout.
+ */
+
+using namespace std::chrono_literals;
+
+TEST(TestTimerService, test_callbacks) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto timers = dojo::timer_service();
+    auto mutex = std::mutex();
+    auto order = std::vector<int>();
+    auto const start = std::chrono::steady_clock::now();
+
+    for (auto const i: {3, 1, 2}) {
+        timers.schedule_after(i * 10ms, [&, i] {
+            auto const lock = std::lock_guard(mutex);
+            EXPECT_GE(std::chrono::steady_clock::now() - start, i * 10ms);
+            order.push_back(i);
+        });
+    }
+    auto cancelled = timers.schedule_after(15ms, [&] {
+        auto const lock = std::lock_guard(mutex);
+        order.push_back(-1);
+    });
+    ASSERT_TRUE(timers.cancel(cancelled));
+    ASSERT_FALSE(timers.cancel(cancelled));
+
+    auto done = timers.after(40ms);
+    done.get();
+    auto const late = std::chrono::steady_clock::now() - start - 40ms;
+    std::cout << "  the future of 40ms completed "
+              << std::chrono::duration_cast<std::chrono::microseconds>(late).count() << "us late" << std::endl;
+
+    auto const lock = std::lock_guard(mutex);
+    ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+    ASSERT_EQ(timers.size(), 0);
+}
+
+TEST(TestTimerService, test_stop_token) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto timers = dojo::timer_service();
+
+    // a future of a timer completes with operation_cancelled on stop, right
+    // away rather than at its deadline
+    auto source = std::stop_source();
+    auto future = timers.after(1h, source.get_token());
+    ASSERT_EQ(future.wait_for(10ms), std::future_status::timeout);
+    source.request_stop();
+    ASSERT_EQ(future.wait_for(1s), std::future_status::ready);
+    ASSERT_THROW(future.get(), dojo::operation_cancelled);
+
+    // and a timer stops a token, ending a sleep which takes the token
+    auto const start = std::chrono::steady_clock::now();
+    auto const token = timers.timeout(20ms);
+    ASSERT_FALSE(dojo::this_thread::sleep_for(token, 1h));
+    auto const slept = std::chrono::steady_clock::now() - start;
+    ASSERT_GE(slept, 20ms);
+    ASSERT_LT(slept, 1s);
+}
+
+TEST(TestTimerService, test_drop_pending) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto fired = std::atomic<int>(0);
+    auto future = std::future<void>();
+    {
+        auto timers = dojo::timer_service();
+        for (auto i = 0; i < 1000; ++i) {
+            timers.schedule_after(1h, [&] { ++fired; });
+        }
+        future = timers.after(1h);
+        ASSERT_EQ(timers.size(), 1001);
+    }
+    ASSERT_EQ(fired.load(), 0);
+    ASSERT_THROW(future.get(), dojo::operation_cancelled);
+}
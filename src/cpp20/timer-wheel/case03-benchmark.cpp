@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "timer_service.h"
+#include "timer_wheel.h"
+#include "../../../utils.h"
+
+/**
+ * 1M timers outstanding at once, as many request timeouts would be, in the
+ * timer wheel against the ordered containers usually holding deadlines:
+ *   - std::multimap, whose schedule and cancel are O(log(n));
+ *   - std::priority_queue, whose cancel only marks the timer, which is still
+ *     popped at its deadline, as a binary heap can't remove from the middle.
+ *
+ * Half the timers are cancelled, as the requests which complete in time,
+ * then the rest fire. Firing costs the wheel more than the multimap, since
+ * the timers of a slot of a level above are cascaded, i.e. each timer is
+ * linked again once or twice on its way down, which misses the cache over
+ * 1M nodes; it is the schedule and the cancel which a timeout mostly takes.
+ *
+ * Only printed, not asserted.
+ */
+
+namespace {
+
+constexpr auto timer_count = std::size_t{1} << 20;
+// the deadlines are spread over about 17 minutes of ticks of 1ms
+constexpr auto horizon = std::uint64_t{1} << 20;
+
+std::vector<std::uint64_t> make_deadlines() {
+    auto rng = std::mt19937_64(42);
+    auto deadlines = std::vector<std::uint64_t>(timer_count);
+    for (auto &d: deadlines) {
+        d = 1 + rng() % horizon;
+    }
+    return deadlines;
+}
+
+}
+
+TEST(TestTimerWheelBenchmark, test_outstanding_timers) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    auto const deadlines = make_deadlines();
+    auto fired = std::uint64_t{0};
+
+    {
+        auto wheel = dojo::timer_wheel<std::uint32_t>();
+        auto ids = std::vector<dojo::timer_id>(timer_count);
+        benchmark("timer_wheel, schedule", timer_count, [&] {
+            for (auto i = std::size_t{0}; i < timer_count; ++i) {
+                ids[i] = wheel.schedule(deadlines[i], static_cast<std::uint32_t>(i));
+            }
+        });
+        benchmark("timer_wheel, cancel half", timer_count / 2, [&] {
+            for (auto i = std::size_t{0}; i < timer_count; i += 2) {
+                wheel.cancel(ids[i]);
+            }
+        });
+        benchmark("timer_wheel, fire half, tick by tick", timer_count / 2, [&] {
+            for (auto t = std::uint64_t{1}; t <= horizon; ++t) {
+                wheel.advance(t, [&](std::uint32_t const payload) { fired += payload; });
+            }
+        });
+        do_not_optimize(fired);
+    }
+
+    {
+        auto map = std::multimap<std::uint64_t, std::uint32_t>();
+        auto its = std::vector<std::multimap<std::uint64_t, std::uint32_t>::iterator>(timer_count);
+        benchmark("std::multimap, schedule", timer_count, [&] {
+            for (auto i = std::size_t{0}; i < timer_count; ++i) {
+                its[i] = map.emplace(deadlines[i], static_cast<std::uint32_t>(i));
+            }
+        });
+        benchmark("std::multimap, cancel half", timer_count / 2, [&] {
+            for (auto i = std::size_t{0}; i < timer_count; i += 2) {
+                map.erase(its[i]);
+            }
+        });
+        benchmark("std::multimap, fire half, tick by tick", timer_count / 2, [&] {
+            for (auto t = std::uint64_t{1}; t <= horizon; ++t) {
+                while (!map.empty() && map.begin()->first <= t) {
+                    fired += map.begin()->second;
+                    map.erase(map.begin());
+                }
+            }
+        });
+        do_not_optimize(fired);
+    }
+
+    {
+        using entry = std::pair<std::uint64_t, std::uint32_t>;
+        auto heap = std::priority_queue<entry, std::vector<entry>, std::greater<>>();
+        auto cancelled = std::vector<bool>(timer_count);
+        benchmark("std::priority_queue, schedule", timer_count, [&] {
+            for (auto i = std::size_t{0}; i < timer_count; ++i) {
+                heap.emplace(deadlines[i], static_cast<std::uint32_t>(i));
+            }
+        });
+        benchmark("std::priority_queue, cancel half, lazily", timer_count / 2, [&] {
+            for (auto i = std::size_t{0}; i < timer_count; i += 2) {
+                cancelled[i] = true;
+            }
+        });
+        benchmark("std::priority_queue, fire half, tick by tick", timer_count / 2, [&] {
+            for (auto t = std::uint64_t{1}; t <= horizon; ++t) {
+                while (!heap.empty() && heap.top().first <= t) {
+                    if (!cancelled[heap.top().second]) {
+                        fired += heap.top().second;
+                    }
+                    heap.pop();
+                }
+            }
+        });
+        do_not_optimize(fired);
+    }
+}
+
+TEST(TestTimerWheelBenchmark, test_service_timeouts) { // NOLINT(cert-err58-cpp)
+    std::cout << "Testing " << __PRETTY_FUNCTION__ << " ..." << std::endl;
+
+    // the timeouts of 1M requests, all of which complete in time
+    auto const deadlines = make_deadlines();
+    auto timers = dojo::timer_service();
+    auto ids = std::vector<dojo::timer_id>(timer_count);
+    auto expired = std::uint64_t{0};
+
+    benchmark("timer_service, schedule_after", timer_count, [&] {
+        for (auto i = std::size_t{0}; i < timer_count; ++i) {
+            ids[i] = timers.schedule_after(std::chrono::milliseconds(deadlines[i]) + std::chrono::seconds(1),
+                                           [&expired] { ++expired; });
+        }
+    });
+    std::cout << "  outstanding timers: " << timers.size() << std::endl;
+    benchmark("timer_service, cancel", timer_count, [&] {
+        for (auto const id: ids) {
+            timers.cancel(id);
+        }
+    });
+    ASSERT_EQ(timers.size(), 0);
+    ASSERT_EQ(expired, 0);
+}
@@ -0,0 +1,277 @@
+#ifndef CPP_XX_DOJO_TIMER_SERVICE_H
+#define CPP_XX_DOJO_TIMER_SERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "timer_wheel.h"
+#include "../cancellation/cancellation.h"
+
+namespace dojo {
+
+namespace detail {
+
+/**
+ * A move-only type-erased `void()` callable, since std::function requires the
+ * callable to be copyable while std::promise is not.
+ */
+class timer_callback {
+public:
+    template<typename Fn>
+    requires (!std::is_same_v<std::remove_cvref_t<Fn>, timer_callback>)
+    explicit timer_callback(Fn &&fn) : m_impl(std::make_unique<impl<std::decay_t<Fn>>>(std::forward<Fn>(fn))) {}
+
+    void operator()() { m_impl->call(); }
+
+private:
+    struct base {
+        virtual ~base() = default;
+
+        virtual void call() = 0;
+    };
+
+    template<typename Fn>
+    struct impl final : base {
+        explicit impl(Fn fn) : fn(std::move(fn)) {}
+
+        void call() override { fn(); }
+
+        Fn fn;
+    };
+
+    std::unique_ptr<base> m_impl;
+};
+
+/**
+ * The promise of a timer, which is completed once, either as the timer fires,
+ * or with operation_cancelled as the timer is cancelled, i.e. destroyed
+ * without firing, or as the stop is requested.
+ */
+class timer_promise {
+public:
+    timer_promise() = default;
+
+    timer_promise(timer_promise const &) = delete;
+
+    timer_promise &operator=(timer_promise const &) = delete;
+
+    ~timer_promise() {
+        m_on_stop.reset();
+        cancel();
+    }
+
+    void complete() {
+        if (!m_done.exchange(true, std::memory_order_acq_rel)) {
+            m_promise.set_value();
+        }
+    }
+
+    void cancel() {
+        if (!m_done.exchange(true, std::memory_order_acq_rel)) {
+            m_promise.set_exception(std::make_exception_ptr(operation_cancelled()));
+        }
+    }
+
+    std::future<void> get_future() { return m_promise.get_future(); }
+
+    void cancel_on_stop(std::stop_token const &token) {
+        m_on_stop.emplace(token, [this] { cancel(); });
+    }
+
+private:
+    std::atomic<bool> m_done{false};
+    std::promise<void> m_promise;
+    // the last member, so that a callback running on another thread is waited
+    // for before the promise goes
+    std::optional<std::stop_callback<std::function<void()>>> m_on_stop;
+};
+
+}
+
+/**
+ * @brief Timers of a timer_wheel, fired by a thread of their own
+ *
+ * Millions of timeouts neither take a thread each sleeping, nor a wait_for()
+ * each on a condition variable, but a node each in the wheel: a single thread
+ * sleeps till the next tick at which a timer is due, and runs the callbacks
+ * of the timers due. So the callbacks should be short, and hand long work
+ * over to another thread, e.g. by completing a future.
+ *
+ * The time is cut into ticks of the resolution, and a timer fires at the
+ * first tick at or after its deadline, i.e. late by up to a resolution plus
+ * the latency of waking the thread up, but never early.
+ *
+ * The stop tokens work both ways: a future of after() completes with
+ * operation_cancelled as soon as the given token is stopped, and the token of
+ * timeout() is stopped by a timer, which ends whatever waits on it, e.g.
+ * dojo::this_thread::sleep_for() or a condition_variable_any.
+ *
+ * The pending timers are dropped on destruction, without firing.
+ */
+class timer_service {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit timer_service(clock::duration const resolution = std::chrono::milliseconds(1)) :
+            m_resolution(resolution), m_start(clock::now()),
+            m_thread([this](std::stop_token const &token) { run(token); }) {}
+
+    timer_service(timer_service const &) = delete;
+
+    timer_service &operator=(timer_service const &) = delete;
+
+    ~timer_service() {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+
+    [[nodiscard]] clock::duration resolution() const { return m_resolution; }
+
+    [[nodiscard]] std::size_t size() const {
+        auto const lock = std::lock_guard(m_mutex);
+        return m_wheel.size();
+    }
+
+    /**
+     * Run `fn()` on the thread of the service at `deadline`.
+     */
+    template<typename Fn>
+    timer_id schedule_at(clock::time_point const deadline, Fn &&fn) {
+        auto callback = detail::timer_callback(std::forward<Fn>(fn));
+        auto const tick = to_tick(deadline);
+        auto const lock = std::lock_guard(m_mutex);
+        auto const id = m_wheel.schedule(tick, std::move(callback));
+        // only the first of the timers due earlier than the thread wakes up
+        // has to wake it up
+        if (tick < m_wake_tick) {
+            m_wake_tick = tick;
+            m_changed = true;
+            m_cv.notify_one();
+        }
+        return id;
+    }
+
+    template<typename Fn>
+    timer_id schedule_after(clock::duration const delay, Fn &&fn) {
+        return schedule_at(clock::now() + delay, std::forward<Fn>(fn));
+    }
+
+    /**
+     * Cancel the timer in O(1), if it hasn't fired yet.
+     *
+     * @return true if the timer won't fire
+     */
+    bool cancel(timer_id const id) {
+        auto callback = std::optional<detail::timer_callback>();
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            callback = m_wheel.cancel(id);
+        }
+        // destroyed outside the lock, which may complete a future
+        return callback.has_value();
+    }
+
+    /**
+     * A future completing after `delay`, or with operation_cancelled as soon
+     * as `token` is stopped. A stopped timer stays in the wheel till its
+     * deadline, which is still O(1), then does nothing.
+     */
+    std::future<void> after(clock::duration const delay, std::stop_token const &token = {}) {
+        auto promise = std::make_shared<detail::timer_promise>();
+        auto future = promise->get_future();
+        if (token.stop_possible()) {
+            promise->cancel_on_stop(token);
+        }
+        schedule_after(delay, [promise = std::move(promise)] { promise->complete(); });
+        return future;
+    }
+
+    /**
+     * A stop token stopped after `delay`, for a timeout of anything which
+     * takes a stop token.
+     */
+    std::stop_token timeout(clock::duration const delay) {
+        auto source = std::stop_source();
+        auto token = source.get_token();
+        schedule_after(delay, [source = std::move(source)]() mutable { source.request_stop(); });
+        return token;
+    }
+
+private:
+    using tick = timer_wheel<detail::timer_callback>::tick;
+
+    /**
+     * The first tick at or after the time point.
+     */
+    tick to_tick(clock::time_point const time) const {
+        auto const elapsed = time - m_start;
+        if (elapsed <= clock::duration::zero()) {
+            return 0;
+        }
+        return static_cast<tick>((elapsed + m_resolution - clock::duration(1)) / m_resolution);
+    }
+
+    clock::time_point to_time(tick const t) const {
+        return m_start + m_resolution * static_cast<clock::rep>(t);
+    }
+
+    void run(std::stop_token const &token) {
+        auto due = std::vector<detail::timer_callback>();
+        auto lock = std::unique_lock(m_mutex);
+        while (!token.stop_requested()) {
+            // the last tick which has started
+            auto const now = static_cast<tick>((clock::now() - m_start) / m_resolution);
+            m_wheel.advance(now, [&due](detail::timer_callback &&callback) {
+                due.push_back(std::move(callback));
+            });
+            if (!due.empty()) {
+                lock.unlock();
+                for (auto &callback: due) {
+                    callback();
+                }
+                due.clear();
+                lock.lock();
+                continue;
+            }
+
+            auto const next = m_wheel.next_tick();
+            m_wake_tick = next.value_or(std::numeric_limits<tick>::max());
+            m_changed = false;
+            if (next) {
+                m_cv.wait_until(lock, token, to_time(*next), [this] { return m_changed; });
+            } else {
+                m_cv.wait(lock, token, [this] { return m_changed; });
+            }
+        }
+    }
+
+    clock::duration m_resolution;
+    clock::time_point m_start;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_cv;
+    timer_wheel<detail::timer_callback> m_wheel;
+    // the tick till which the thread sleeps, and whether a timer is due
+    // earlier than that
+    tick m_wake_tick = std::numeric_limits<tick>::max();
+    bool m_changed = false;
+
+    std::jthread m_thread;
+};
+
+}
+
+#endif //CPP_XX_DOJO_TIMER_SERVICE_H
@@ -0,0 +1,266 @@
+#ifndef CPP_XX_DOJO_TIMER_WHEEL_H
+#define CPP_XX_DOJO_TIMER_WHEEL_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace dojo {
+
+/**
+ * A timer of a timer_wheel, which stays valid till the timer fires or is
+ * cancelled; it never refers to another timer reusing the same slot later.
+ */
+struct timer_id {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    friend bool operator==(timer_id const &, timer_id const &) = default;
+};
+
+/**
+ * @brief A hierarchical timer wheel of ticks, holding a payload per timer
+ *
+ * The wheel has 8 levels of 256 slots each, a level per byte of the 64-bit
+ * tick: a timer sits on the level of the highest byte where its deadline
+ * differs from the current tick, in the slot of that byte of its deadline.
+ * So the slots of the level 0 are single ticks, and those of the level L span
+ * 256^L ticks. Then:
+ *   - scheduling a timer links it into its slot, O(1);
+ *   - cancelling it unlinks it from the doubly linked list of the slot, O(1);
+ *   - as the current tick reaches the start of a slot of a level above 0,
+ *     the slot is cascaded, i.e. its timers are linked again one level lower
+ *     or more; each timer is cascaded at most once per level, 8 times at
+ *     most, whereas a heap costs O(log(n)) per schedule and cancel.
+ *
+ * Advancing jumps over the empty slots at once, by a bitmap of the occupied
+ * slots of every level, so it costs nothing when no timer is due, however
+ * far the jump is.
+ *
+ * The timers are nodes of a vector, linked by indices and recycled by a free
+ * list, so no allocation happens once the vector has grown to the most
+ * timers ever outstanding.
+ *
+ * Not thread-safe.
+ *
+ * reference from http://www.cs.columbia.edu/~nahum/w6998/papers/sosp87-timing-wheels.pdf
+ * reference from https://lwn.net/Articles/646950/
+ */
+template<typename T>
+class timer_wheel {
+public:
+    using tick = std::uint64_t;
+
+    static constexpr auto levels = std::size_t{8};
+    static constexpr auto slots = std::size_t{256};
+
+    explicit timer_wheel(tick const now = 0) : m_now(now) {
+        m_heads.fill(nil);
+    }
+
+    /**
+     * The current tick: the timers of the deadlines up to it have fired.
+     */
+    [[nodiscard]] tick now() const { return m_now; }
+
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * Schedule a timer firing as the wheel advances to `deadline`, or to the
+     * next tick if the deadline is not after the current one.
+     */
+    timer_id schedule(tick const deadline, T payload) {
+        auto index = m_free;
+        if (index != nil) {
+            m_free = m_nodes[index].next;
+        } else {
+            index = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+        auto &n = m_nodes[index];
+        n.deadline = deadline > m_now ? deadline : m_now + 1;
+        n.payload.emplace(std::move(payload));
+        link(index);
+        ++m_size;
+        return {index, n.generation};
+    }
+
+    [[nodiscard]] bool contains(timer_id const id) const {
+        return id.index < m_nodes.size() && m_nodes[id.index].generation == id.generation &&
+               m_nodes[id.index].payload.has_value();
+    }
+
+    /**
+     * @return the payload of the timer if it was pending, which never fires
+     * then, or nothing if it has fired or been cancelled
+     */
+    std::optional<T> cancel(timer_id const id) {
+        if (!contains(id)) {
+            return std::nullopt;
+        }
+        unlink(id.index);
+        return release(id.index);
+    }
+
+    /**
+     * The next tick at which advancing has something to do, i.e. fire the
+     * timers of a slot of the level 0, or cascade a slot of a level above,
+     * or nothing if no timer is pending. No timer fires before it.
+     */
+    [[nodiscard]] std::optional<tick> next_tick() const {
+        if (m_size == 0) {
+            return std::nullopt;
+        }
+        // the occupied slots of a level come before those of the levels
+        // above, which only start with the next slot of the level above, so
+        // the lowest level with an occupied slot has the next tick
+        for (auto level = std::size_t{0}; level < levels; ++level) {
+            auto const shift = level * 8;
+            auto const current = static_cast<std::size_t>((m_now >> shift) & (slots - 1));
+            auto const slot = next_occupied(level, current + 1);
+            if (slot != slots) {
+                auto const above = shift + 8;
+                auto const base = above == 64 ? tick{0} : (m_now >> above) << above;
+                return base | (tick{slot} << shift);
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Advance the current tick to `to`, handing the payloads of the timers
+     * which fire over to `on_fire(T &&)` in the order of their deadlines,
+     * though in no particular order among the same deadline. The callback may
+     * schedule and cancel timers.
+     *
+     * @return the count of the timers fired
+     */
+    template<typename Fn>
+    std::size_t advance(tick const to, Fn &&on_fire) {
+        auto fired = std::size_t{0};
+        while (m_now < to) {
+            auto const next = next_tick();
+            if (!next || *next > to) {
+                m_now = to;
+                break;
+            }
+            m_now = *next;
+            // from the top, since a cascaded timer may land in a slot which
+            // is cascaded or fired at the same tick
+            for (auto level = levels - 1; level > 0; --level) {
+                if ((m_now & ((tick{1} << (level * 8)) - 1)) == 0) {
+                    cascade(level, static_cast<std::size_t>((m_now >> (level * 8)) & (slots - 1)));
+                }
+            }
+            auto &head = m_heads[static_cast<std::size_t>(m_now & (slots - 1))];
+            while (head != nil) {
+                auto const index = head;
+                unlink(index);
+                ++fired;
+                on_fire(release(index));
+            }
+        }
+        return fired;
+    }
+
+private:
+    static constexpr auto nil = std::numeric_limits<std::uint32_t>::max();
+
+    struct node {
+        tick deadline = 0;
+        std::uint32_t prev = nil;
+        std::uint32_t next = nil;
+        std::uint32_t generation = 0;
+        // level * slots + slot
+        std::uint32_t slot = 0;
+        std::optional<T> payload;
+    };
+
+    void link(std::uint32_t const index) {
+        auto &n = m_nodes[index];
+        auto const diff = n.deadline ^ m_now;
+        auto const level = diff == 0 ? std::size_t{0} : static_cast<std::size_t>(std::bit_width(diff) - 1) / 8;
+        auto const slot = static_cast<std::size_t>((n.deadline >> (level * 8)) & (slots - 1));
+        n.slot = static_cast<std::uint32_t>(level * slots + slot);
+        n.prev = nil;
+        n.next = m_heads[n.slot];
+        if (n.next != nil) {
+            m_nodes[n.next].prev = index;
+        }
+        m_heads[n.slot] = index;
+        m_occupied[level][slot / 64] |= std::uint64_t{1} << (slot % 64);
+    }
+
+    void unlink(std::uint32_t const index) {
+        auto &n = m_nodes[index];
+        if (n.prev != nil) {
+            m_nodes[n.prev].next = n.next;
+        } else {
+            m_heads[n.slot] = n.next;
+            if (n.next == nil) {
+                auto const slot = n.slot % slots;
+                m_occupied[n.slot / slots][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+            }
+        }
+        if (n.next != nil) {
+            m_nodes[n.next].prev = n.prev;
+        }
+    }
+
+    T release(std::uint32_t const index) {
+        auto &n = m_nodes[index];
+        auto payload = std::move(*n.payload);
+        n.payload.reset();
+        ++n.generation;
+        n.next = m_free;
+        m_free = index;
+        --m_size;
+        return payload;
+    }
+
+    void cascade(std::size_t const level, std::size_t const slot) {
+        // detached at once rather than unlinked node by node
+        auto index = std::exchange(m_heads[level * slots + slot], nil);
+        m_occupied[level][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+        while (index != nil) {
+            auto const next = m_nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    /**
+     * The first occupied slot of the level from `first` on, or `slots` if
+     * none.
+     */
+    [[nodiscard]] std::size_t next_occupied(std::size_t const level, std::size_t const first) const {
+        for (auto word = first / 64; word < slots / 64; ++word) {
+            auto bits = m_occupied[level][word];
+            if (word == first / 64) {
+                bits &= ~std::uint64_t{0} << (first % 64);
+            }
+            if (bits != 0) {
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+        }
+        return slots;
+    }
+
+    tick m_now;
+    std::size_t m_size = 0;
+    std::vector<node> m_nodes;
+    std::uint32_t m_free = nil;
+    std::array<std::uint32_t, levels * slots> m_heads{};
+    std::array<std::array<std::uint64_t, slots / 64>, levels> m_occupied{};
+};
+
+}
+
+#endif //CPP_XX_DOJO_TIMER_WHEEL_H
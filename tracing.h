@@ -0,0 +1,289 @@
+#ifndef CPP_XX_DOJO_TRACING_H_
+#define CPP_XX_DOJO_TRACING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * A scoped-span tracer, cheap enough for the hot paths of the concurrency
+ * cases, whose spans are exported as a Chrome trace to be viewed on a
+ * timeline by chrome://tracing or https://ui.perfetto.dev.
+ *
+ *   - the timestamps come from the time stamp counter of the cpu, which is
+ *     invariant on every x86-64 cpu of the last decade, and converted to
+ *     nanoseconds only on export;
+ *   - every thread appends its spans to its own buffer, which is only ever
+ *     written by that thread and published with a release store, so recording
+ *     takes neither a lock nor a read-modify-write;
+ *   - the buffers are kept alive until the program exits, so that the spans
+ *     of the threads which have already exited can still be exported.
+ *
+ * Only C++11, since the cases of C++11 are traced as well.
+ *
+ * reference from https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+ */
+
+namespace dojo {
+namespace trace {
+
+/**
+ * The ticks of the time stamp counter, or the nanoseconds of the steady clock
+ * where there's none.
+ */
+inline std::uint64_t now_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * A complete span, or an instant one if it begins when it ends.
+ *
+ * The name and the category are never copied, hence must outlive the
+ * export, e.g. string literals.
+ */
+struct event {
+    char const *name;
+    char const *category;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+class thread_buffer {
+public:
+    static constexpr std::size_t chunk_capacity = 256;
+
+    struct chunk {
+        event events[chunk_capacity];
+        std::atomic<std::uint32_t> size{0};
+        std::atomic<chunk *> next{nullptr};
+    };
+
+    explicit thread_buffer(std::uint32_t const tid) : m_last(&m_first), m_tid(tid) {}
+
+    thread_buffer(thread_buffer const &) = delete;
+
+    thread_buffer &operator=(thread_buffer const &) = delete;
+
+    /**
+     * Only called by the owning thread.
+     */
+    void record(event const &e) {
+        auto size = m_last->size.load(std::memory_order_relaxed);
+        if (size == chunk_capacity) {
+            auto *const c = new chunk();
+            m_last->next.store(c, std::memory_order_release);
+            m_last = c;
+            size = 0;
+        }
+        m_last->events[size] = e;
+        m_last->size.store(size + 1, std::memory_order_release);
+    }
+
+    /**
+     * Visit the events recorded so far, from any thread.
+     */
+    template<typename Fn>
+    void for_each(Fn &&fn) const {
+        for (auto const *c = &m_first; c != nullptr; c = c->next.load(std::memory_order_acquire)) {
+            auto const size = c->size.load(std::memory_order_acquire);
+            for (auto i = std::uint32_t{0}; i < size; ++i) {
+                fn(c->events[i]);
+            }
+        }
+    }
+
+    std::uint32_t tid() const { return m_tid; }
+
+    // the buffers are linked into a list, which is only ever prepended
+    std::atomic<thread_buffer *> next_buffer{nullptr};
+
+private:
+    chunk m_first;
+    chunk *m_last;
+    std::uint32_t const m_tid;
+};
+
+namespace detail {
+
+struct registry {
+    std::atomic<thread_buffer *> buffers{nullptr};
+    std::atomic<std::uint32_t> next_tid{1};
+    // for converting the ticks to the time since the start of the tracing
+    std::uint64_t const origin_ticks = now_ticks();
+    std::chrono::steady_clock::time_point const origin_time = std::chrono::steady_clock::now();
+};
+
+inline registry &get_registry() {
+    static auto *const r = new registry();  // never destroyed, see the note of the file
+    return *r;
+}
+
+inline thread_buffer *register_thread() {
+    auto &r = get_registry();
+    auto *const buffer = new thread_buffer(r.next_tid.fetch_add(1, std::memory_order_relaxed));
+    auto *head = r.buffers.load(std::memory_order_relaxed);
+    do {
+        buffer->next_buffer.store(head, std::memory_order_relaxed);
+    } while (!r.buffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+    return buffer;
+}
+
+}
+
+/**
+ * The buffer of the current thread, registered on first use.
+ */
+inline thread_buffer &local_buffer() {
+    // initialized with a constant, which saves the guard on every access
+    thread_local thread_buffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        buffer = detail::register_thread();
+    }
+    return *buffer;
+}
+
+inline void record_instant(char const *const name, char const *const category = "dojo") {
+    auto &buffer = local_buffer();
+    auto const now = now_ticks();
+    buffer.record(event{name, category, now, now});
+}
+
+/**
+ * Record the span from its construction to its destruction.
+ */
+class scoped_span {
+public:
+    explicit scoped_span(char const *const name, char const *const category = "dojo") :
+            m_buffer(local_buffer()), m_name(name), m_category(category), m_begin(now_ticks()) {}
+
+    scoped_span(scoped_span const &) = delete;
+
+    scoped_span &operator=(scoped_span const &) = delete;
+
+    ~scoped_span() {
+        m_buffer.record(event{m_name, m_category, m_begin, now_ticks()});
+    }
+
+private:
+    thread_buffer &m_buffer;
+    char const *const m_name;
+    char const *const m_category;
+    std::uint64_t const m_begin;
+};
+
+namespace detail {
+
+inline void write_json_string(std::ostream &os, char const *s) {
+    os << '"';
+    for (; *s != '\0'; ++s) {
+        auto const c = *s;
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            os << ' ';
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+}
+
+/**
+ * Export every span recorded so far in the Chrome trace event format, with
+ * the timestamps in microseconds since the tracing started.
+ *
+ * Safe while the other threads keep recording, but only their spans which
+ * have ended by then are exported.
+ */
+inline void write_chrome_trace(std::ostream &os) {
+    auto &r = detail::get_registry();
+
+    // calibrate the ticks against the steady clock over the whole run
+    auto const ticks = static_cast<double>(now_ticks() - r.origin_ticks);
+    auto const us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - r.origin_time).count();
+    auto const ticks_per_us = us > 0 && ticks > 0 ? ticks / us : 1.0;
+    auto const to_us = [&](std::uint64_t const t) {
+        return t < r.origin_ticks ? 0.0 : static_cast<double>(t - r.origin_ticks) / ticks_per_us;
+    };
+
+    auto const precision = os.precision();
+    auto const flags = os.flags();
+    os.setf(std::ios::fixed);
+    os.precision(3);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    auto first = true;
+    for (auto const *b = r.buffers.load(std::memory_order_acquire); b != nullptr;
+         b = b->next_buffer.load(std::memory_order_relaxed)) {
+        auto const tid = b->tid();
+        os << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << tid
+           << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+        first = false;
+
+        b->for_each([&](event const &e) {
+            os << ",\n{\"name\":";
+            detail::write_json_string(os, e.name);
+            os << ",\"cat\":";
+            detail::write_json_string(os, e.category);
+            if (e.begin == e.end) {
+                os << ",\"ph\":\"i\",\"s\":\"t\"";
+            } else {
+                os << ",\"ph\":\"X\",\"dur\":" << to_us(e.end) - to_us(e.begin);
+            }
+            os << ",\"ts\":" << to_us(e.begin) << ",\"pid\":1,\"tid\":" << tid << "}";
+        });
+    }
+    os << "\n]}\n";
+
+    os.precision(precision);
+    os.flags(flags);
+}
+
+/**
+ * The file named by the environment variable DOJO_TRACE_FILE, or
+ * dojo-trace.json in the working directory.
+ */
+inline std::string output_path() {
+    auto const *const path = std::getenv("DOJO_TRACE_FILE");
+    return path != nullptr && *path != '\0' ? path : "dojo-trace.json";
+}
+
+inline bool write_chrome_trace_file(std::string const &path) {
+    auto file = std::ofstream(path.c_str());
+    write_chrome_trace(file);
+    return static_cast<bool>(file);
+}
+
+}
+}
+
+/**
+ * Record a span in the current scope, only when built with the cmake option
+ * DOJO_TRACING, otherwise it costs nothing at all.
+ */
+#ifdef DOJO_TRACING
+#define DOJO_TRACE_CONCAT_IMPL(a, b) a##b
+#define DOJO_TRACE_CONCAT(a, b) DOJO_TRACE_CONCAT_IMPL(a, b)
+#define DOJO_TRACE_SPAN(name) ::dojo::trace::scoped_span const DOJO_TRACE_CONCAT(dojo_trace_span_, __LINE__)(name)
+#define DOJO_TRACE_INSTANT(name) ::dojo::trace::record_instant(name)
+#else
+#define DOJO_TRACE_SPAN(name) static_cast<void>(0)
+#define DOJO_TRACE_INSTANT(name) static_cast<void>(0)
+#endif
+
+#endif //CPP_XX_DOJO_TRACING_H_
@@ -1,15 +1,89 @@
 #ifndef CPP_XX_DOJO_UTILS_H_
 #define CPP_XX_DOJO_UTILS_H_
 
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
 #include <iostream>
 #include <thread>
 
+#include "perf_counters.h"
+#include "tracing.h"
+
 inline
 void fake_costly_computing(int const seconds = 3) {
+    DOJO_TRACE_SPAN("fake_costly_computing");
     for (auto i = 0; i < seconds; ++i) {
         std::cout << "computing " << i << " seconds" << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 }
 
+/**
+ * The size of a cache line on the x86-64 and most of the aarch64 machines.
+ *
+ * std::hardware_destructive_interference_size would be the portable choice,
+ * but it's only available since C++17, and gcc warns about it changing
+ * with -mtune.
+ */
+constexpr std::size_t cache_line_size = 64;
+
+/**
+ * Wrap a `T` which is alone on its cache line(s), so that writing to it never
+ * invalidates the cache line of its neighbours, aka. false sharing.
+ */
+template<typename T>
+struct alignas(cache_line_size) cache_line_padded {
+    T value;
+};
+
+/**
+ * Prevent the compiler from optimizing away the computation of `value`.
+ *
+ * Only works with gcc-compatible compilers, which is what this project supports.
+ */
+template<typename T>
+inline
+void do_not_optimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Run `fn` once, which is expected to perform `ops` operations, then print and
+ * return the average wall-clock cost of one operation in nanoseconds.
+ *
+ * With the option DOJO_PERF_COUNTERS, the counters of the cpu per operation
+ * are printed as well, see perf_counters.h.
+ */
+template<typename Fn>
+double benchmark(char const *name, std::size_t const ops, Fn &&fn) {
+#ifdef DOJO_PERF_COUNTERS
+    auto const counters = dojo::perf::counter_group();
+    auto const before = counters.read();
+#endif
+    auto const start = std::chrono::steady_clock::now();
+    fn();
+    auto const stop = std::chrono::steady_clock::now();
+#ifdef DOJO_PERF_COUNTERS
+    auto const counted = counters.read() - before;
+#endif
+
+    auto const ns_per_op = std::chrono::duration<double, std::nano>(stop - start).count()
+                           / static_cast<double>(ops ? ops : 1);
+
+    auto const flags = std::cout.flags();
+    auto const precision = std::cout.precision();
+    std::cout << "  " << std::left << std::setw(56) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(12) << ns_per_op << " ns/op"
+              << std::setw(12) << 1000.0 / ns_per_op << " Mops/s"
+              << std::endl;
+#ifdef DOJO_PERF_COUNTERS
+    std::cout << "    per op: ";
+    counted.write(std::cout, static_cast<double>(ops ? ops : 1)) << std::endl;
+#endif
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+    return ns_per_op;
+}
+
 #endif //CPP_XX_DOJO_UTILS_H_